@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "PipeEncoder.h"
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+// Larger pipes let ffmpeg fall behind by a few frames without blocking the writers.
+constexpr int PIPE_SIZE = 1024 * 1024;
+constexpr size_t VIDEO_RING_BUDGET = 256 * 1024 * 1024;
+constexpr size_t VIDEO_RING_MAX_SLOTS = 16;
+constexpr size_t AUDIO_RING_SLOTS = 64;
+constexpr size_t AUDIO_RING_SLOT_SIZE = 0x8000;
+constexpr char Y4M_FRAME_HEADER[] = "FRAME\n";
+
+/**
+ * \brief Writes a whole buffer to a file descriptor, retrying after partial writes and interruptions.
+ */
+static bool write_all(const int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+/**
+ * \brief Writes the rows of a bottom-up image top-down, gathering as many rows per call as the OS allows.
+ */
+static bool write_rows_flipped(const int fd, const uint8_t *image, const size_t stride, const size_t rows)
+{
+    std::array<iovec, 256> iov{};
+    size_t row = 0;
+    while (row < rows)
+    {
+        const size_t count = std::min(iov.size(), rows - row);
+        for (size_t i = 0; i < count; ++i)
+        {
+            iov[i].iov_base = const_cast<uint8_t *>(image + (rows - 1 - row - i) * stride);
+            iov[i].iov_len = stride;
+        }
+
+        auto written = writev(fd, iov.data(), static_cast<int>(count));
+        if (written < 0 && errno != EINTR)
+        {
+            return false;
+        }
+        written = std::max<ssize_t>(written, 0);
+
+        // Finish a partially written batch row by row.
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto done = std::min<size_t>(written, stride);
+            written -= done;
+            if (done < stride && !write_all(fd, static_cast<const uint8_t *>(iov[i].iov_base) + done, stride - done))
+            {
+                return false;
+            }
+        }
+        row += count;
+    }
+    return true;
+}
+
+/**
+ * \brief Makes writes to a closed pipe fail with EPIPE on the calling thread instead of killing the process.
+ */
+static void block_sigpipe()
+{
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, nullptr);
+}
+
+static void close_fd(int &fd)
+{
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+/**
+ * \brief Creates a pipe whose ends aren't inherited by child processes.
+ */
+static bool create_pipe(int (&fds)[2])
+{
+    if (pipe(fds) != 0)
+    {
+        return false;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#ifdef F_SETPIPE_SZ
+    fcntl(fds[1], F_SETPIPE_SZ, PIPE_SIZE);
+#endif
+    return true;
+}
+
+void PipeEncoder::convert_bgr24_to_yuv444(uint8_t *dst, const uint8_t *src, const uint32_t width,
+                                          const uint32_t height)
+{
+    const size_t plane = static_cast<size_t>(width) * height;
+    uint8_t *y_plane = dst;
+    uint8_t *u_plane = dst + plane;
+    uint8_t *v_plane = dst + plane * 2;
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t *row = src + static_cast<size_t>(height - 1 - y) * width * 3;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            const int32_t b = row[x * 3 + 0];
+            const int32_t g = row[x * 3 + 1];
+            const int32_t r = row[x * 3 + 2];
+
+            *y_plane++ = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            *u_plane++ = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            *v_plane++ = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+std::vector<std::string> PipeEncoder::build_args(const params &params)
+{
+    std::vector<std::string> args = {params.ffmpeg_path.string(), "-y", "-hide_banner"};
+
+    if (params.format == video_format::y4m)
+    {
+        args.insert(args.end(), {"-f", "yuv4mpegpipe"});
+    }
+    else
+    {
+        args.insert(args.end(), {"-f", "rawvideo", "-pixel_format", "bgr24", "-video_size",
+                                 std::format("{}x{}", params.width, params.height), "-framerate",
+                                 std::to_string(params.fps)});
+    }
+    args.insert(args.end(), {"-i", "pipe:0"});
+
+    args.insert(args.end(), {"-f", "s16le", "-sample_rate", std::to_string(params.arate), "-ac", "2", "-i", "pipe:3"});
+
+    args.insert(args.end(), params.output_args.begin(), params.output_args.end());
+    args.push_back(params.path.string());
+    return args;
+}
+
+PipeEncoder::encoder::~encoder()
+{
+    stop();
+}
+
+std::optional<std::string> PipeEncoder::encoder::start(const params &params)
+{
+    if (m_pid >= 0)
+    {
+        return "The encoder is already running.";
+    }
+
+    m_params = params;
+    m_failed = false;
+
+    int video[2];
+    int audio[2];
+    if (!create_pipe(video))
+    {
+        return std::format("Failed to create video pipe ({}).", strerror(errno));
+    }
+    if (!create_pipe(audio))
+    {
+        const auto error = std::format("Failed to create audio pipe ({}).", strerror(errno));
+        close(video[0]);
+        close(video[1]);
+        return error;
+    }
+
+    const auto args = build_args(m_params);
+    std::vector<char *> argv;
+    for (const auto &arg : args)
+    {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // The dup'd descriptors lose FD_CLOEXEC, so ffmpeg only inherits its two inputs.
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, video[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, audio[0], 3);
+
+    pid_t pid;
+    const int result = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(video[0]);
+    close(audio[0]);
+
+    if (result != 0)
+    {
+        close(video[1]);
+        close(audio[1]);
+        return std::format("Failed to start ffmpeg process! Does ffmpeg exist at '{}'? ({})",
+                           m_params.ffmpeg_path.string(), strerror(result));
+    }
+
+    m_pid = pid;
+    m_video_fd = video[1];
+    m_audio_fd = audio[1];
+
+    const size_t frame_size = static_cast<size_t>(m_params.width) * m_params.height * 3;
+    const size_t video_slots = std::clamp<size_t>(VIDEO_RING_BUDGET / frame_size, 2, VIDEO_RING_MAX_SLOTS);
+    m_video_ring = std::make_unique<CaptureRing::ring>(video_slots, frame_size);
+    m_audio_ring = std::make_unique<CaptureRing::ring>(AUDIO_RING_SLOTS, AUDIO_RING_SLOT_SIZE);
+
+    m_video_thread = std::thread(&encoder::write_video_thread, this);
+    m_audio_thread = std::thread(&encoder::write_audio_thread, this);
+
+    return std::nullopt;
+}
+
+bool PipeEncoder::encoder::stop()
+{
+    if (m_pid < 0)
+    {
+        return true;
+    }
+
+    // The writer threads drain the rings and close their pipes, which ends ffmpeg's inputs.
+    m_video_ring->close();
+    m_audio_ring->close();
+    m_video_thread.join();
+    m_audio_thread.join();
+
+    int status = 0;
+    while (waitpid(m_pid, &status, 0) < 0 && errno == EINTR)
+    {
+    }
+    m_pid = -1;
+
+    return !m_failed && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+uint8_t *PipeEncoder::encoder::acquire_video_buffer()
+{
+    return m_video_ring->acquire();
+}
+
+bool PipeEncoder::encoder::append_video(const uint8_t *image)
+{
+    const auto slot = m_video_ring->acquire();
+    if (!slot || m_failed)
+    {
+        return false;
+    }
+
+    if (image != slot)
+    {
+        memcpy(slot, image, m_video_ring->slot_size());
+    }
+    m_video_ring->commit(m_video_ring->slot_size());
+    return true;
+}
+
+bool PipeEncoder::encoder::append_audio(const uint8_t *audio, size_t length)
+{
+    while (length > 0)
+    {
+        const auto slot = m_audio_ring->acquire();
+        if (!slot || m_failed)
+        {
+            return false;
+        }
+
+        const size_t size = std::min(length, m_audio_ring->slot_size());
+        memcpy(slot, audio, size);
+        m_audio_ring->commit(size);
+        audio += size;
+        length -= size;
+    }
+    return true;
+}
+
+void PipeEncoder::encoder::write_video_thread()
+{
+    block_sigpipe();
+
+    const size_t stride = static_cast<size_t>(m_params.width) * 3;
+    std::vector<uint8_t> yuv;
+
+    if (m_params.format == video_format::y4m)
+    {
+        const auto header = std::format("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C444\n", m_params.width, m_params.height,
+                                        m_params.fps);
+        m_failed = m_failed || !write_all(m_video_fd, reinterpret_cast<const uint8_t *>(header.data()), header.size());
+
+        // The frame header and planes are written with a single call.
+        yuv.resize(sizeof(Y4M_FRAME_HEADER) - 1 + stride * m_params.height);
+        memcpy(yuv.data(), Y4M_FRAME_HEADER, sizeof(Y4M_FRAME_HEADER) - 1);
+    }
+
+    // After a failed write the frames are still consumed, so the producer never waits on a dead pipe.
+    while (const auto frame = m_video_ring->front())
+    {
+        if (!m_failed)
+        {
+            bool ok;
+            if (m_params.format == video_format::y4m)
+            {
+                convert_bgr24_to_yuv444(yuv.data() + sizeof(Y4M_FRAME_HEADER) - 1, frame->data, m_params.width,
+                                        m_params.height);
+                ok = write_all(m_video_fd, yuv.data(), yuv.size());
+            }
+            else
+            {
+                ok = write_rows_flipped(m_video_fd, frame->data, stride, m_params.height);
+            }
+            m_failed = m_failed || !ok;
+        }
+        m_video_ring->release();
+    }
+
+    close_fd(m_video_fd);
+}
+
+void PipeEncoder::encoder::write_audio_thread()
+{
+    block_sigpipe();
+
+    std::vector<uint8_t> batch;
+    batch.reserve(m_params.audio_batch_size + m_audio_ring->slot_size());
+
+    // Chunks are small, so whatever is queued is gathered up and written at once.
+    while (const auto first = m_audio_ring->front())
+    {
+        batch.assign(first->data, first->data + first->size);
+        m_audio_ring->release();
+
+        while (batch.size() < m_params.audio_batch_size)
+        {
+            const auto next = m_audio_ring->try_front();
+            if (!next)
+            {
+                break;
+            }
+            batch.insert(batch.end(), next->data, next->data + next->size);
+            m_audio_ring->release();
+        }
+
+        if (!m_failed && !write_all(m_audio_fd, batch.data(), batch.size()))
+        {
+            m_failed = true;
+        }
+    }
+
+    close_fd(m_audio_fd);
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing a capture backend which streams video and audio to an ffmpeg child process over POSIX
+ * pipes.
+ * \remarks Video goes to the child's stdin and audio to its fd 3, each fed by its own writer thread from a
+ * <c>CaptureRing::ring</c>. The frames are 24-bit BGR stored bottom-up, as produced by the readscreen functions, and
+ * the samples are 16-bit stereo PCM as found in RDRAM.
+ */
+namespace PipeEncoder
+{
+enum class video_format
+{
+    /**
+     * \brief Frames are converted to YUV 4:4:4 and streamed as YUV4MPEG2, which carries its own size and rate.
+     */
+    y4m,
+
+    /**
+     * \brief Frames are streamed as raw top-down BGR24.
+     */
+    bgr24,
+};
+
+struct params
+{
+    /**
+     * \brief The ffmpeg executable. Looked up in PATH if it has no directory component.
+     */
+    std::filesystem::path ffmpeg_path = "ffmpeg";
+
+    /**
+     * \brief The output options, e.g. the codecs, placed before the output path.
+     */
+    std::vector<std::string> output_args = {"-c:v", "libx264", "-preset", "veryfast", "-crf", "23",
+                                            "-c:a", "aac",     "-b:a",    "128k"};
+
+    /**
+     * \brief The video file's path.
+     */
+    std::filesystem::path path;
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t fps;
+
+    /**
+     * \brief The audio stream's sample rate.
+     */
+    uint32_t arate;
+
+    video_format format = video_format::y4m;
+
+    /**
+     * \brief The size audio chunks are gathered up to before they are written to the pipe.
+     */
+    size_t audio_batch_size = 64 * 1024;
+};
+
+/**
+ * \brief Converts a bottom-up BGR24 image to top-down planar YUV 4:4:4 with the BT.601 limited-range coefficients.
+ * \param dst The destination, <c>width * height * 3</c> bytes holding the Y, U and V planes in order.
+ * \param src The source image.
+ */
+void convert_bgr24_to_yuv444(uint8_t *dst, const uint8_t *src, uint32_t width, uint32_t height);
+
+/**
+ * \brief Builds the command line the ffmpeg process is started with.
+ */
+std::vector<std::string> build_args(const params &params);
+
+class encoder
+{
+  public:
+    encoder() = default;
+    ~encoder();
+
+    encoder(const encoder &) = delete;
+    encoder &operator=(const encoder &) = delete;
+
+    /**
+     * \brief Starts the ffmpeg process and the writer threads.
+     * \return The error message if the operation failed, or an empty optional if it succeeded.
+     */
+    std::optional<std::string> start(const params &params);
+
+    /**
+     * \brief Stops encoding, flushing everything appended so far and waiting for ffmpeg to exit.
+     * \return Whether all data was written and ffmpeg exited successfully.
+     */
+    bool stop();
+
+    /**
+     * \brief Gets a buffer the next frame can be written into, so <c>append_video</c> doesn't have to copy it.
+     * \return The buffer, or nullptr if encoding was stopped.
+     */
+    uint8_t *acquire_video_buffer();
+
+    /**
+     * \brief Adds one frame of video data.
+     * \param image The frame, <c>width * height * 3</c> bytes. May be the buffer from <c>acquire_video_buffer</c>.
+     * \return Whether the operation succeeded. Fails once a pipe was broken, e.g. because ffmpeg exited.
+     */
+    bool append_video(const uint8_t *image);
+
+    /**
+     * \brief Adds samples of audio data.
+     * \param audio The samples.
+     * \param length The length of the samples in bytes.
+     * \return Whether the operation succeeded. Fails once a pipe was broken, e.g. because ffmpeg exited.
+     */
+    bool append_audio(const uint8_t *audio, size_t length);
+
+    CaptureRing::stats video_stats() const
+    {
+        return m_video_ring->get_stats();
+    }
+
+    CaptureRing::stats audio_stats() const
+    {
+        return m_audio_ring->get_stats();
+    }
+
+  private:
+    void write_video_thread();
+    void write_audio_thread();
+
+    params m_params{};
+    int m_pid = -1;
+    int m_video_fd = -1;
+    int m_audio_fd = -1;
+    std::atomic<bool> m_failed = false;
+
+    std::unique_ptr<CaptureRing::ring> m_video_ring;
+    std::unique_ptr<CaptureRing::ring> m_audio_ring;
+    std::thread m_video_thread;
+    std::thread m_audio_thread;
+};
+} // namespace PipeEncoder
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_RESAMPLER_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AUDIO_RESAMPLER_NEON
+#endif
+
+// The resampler itself needs speexdsp, the sample conversions are usable without it.
+#if __has_include(<speex/speex_resampler.h>)
+#include <speex/speex_resampler.h>
+#define AUDIO_RESAMPLER_SPEEX
+#endif
+
+/**
+ * \brief A module providing the conversion of AI output to interleaved 16-bit stereo at an arbitrary rate.
+ */
+namespace AudioResampler
+{
+/**
+ * \brief Swaps the left and right samples of interleaved 16-bit stereo frames.
+ * \param dst The destination frames. May be the same as <c>src</c>, but mustn't partially overlap it.
+ * \param src The source frames.
+ * \param frames The amount of frames.
+ * \remarks The AI's samples are big-endian halfwords within host-order words, so they come out as R/L pairs.
+ */
+inline void swap_channels(int16_t *dst, const int16_t *src, const size_t frames)
+{
+    EndianUtils::swap32_halves(dst, src, frames * 2 * sizeof(int16_t));
+}
+
+/**
+ * \brief Converts signed 8-bit samples to 16-bit.
+ * \param dst The destination samples. Mustn't overlap <c>src</c>.
+ * \param src The source samples.
+ * \param count The amount of samples.
+ */
+inline void widen8(int16_t *dst, const int8_t *src, const size_t count)
+{
+    size_t i = 0;
+#if defined(AUDIO_RESAMPLER_SSE2)
+    // Interleaving zero below every byte shifts it into the high half of a halfword.
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi8(zero, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_unpackhi_epi8(zero, v));
+    }
+#elif defined(AUDIO_RESAMPLER_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_s16(dst + i, vshll_n_s8(vld1_s8(src + i), 8));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = static_cast<int16_t>(src[i] * 256);
+    }
+}
+
+/**
+ * \brief Calculates the length of resampled audio.
+ * \param dst_freq The destination frequency.
+ * \param src_freq The source frequency.
+ * \param src_bitrate The source sample size in bits.
+ * \param src_len The length of the source in bytes.
+ * \return The length of the resampled 16-bit audio in bytes, or -1 if the sample size isn't supported.
+ */
+inline int get_resample_len(const int dst_freq, const int src_freq, const int src_bitrate, int src_len)
+{
+    if (src_bitrate != 16)
+    {
+        if (src_bitrate != 4 && src_bitrate != 8) return -1;
+
+        src_len = src_len * (16 / src_bitrate);
+    }
+
+    const long double ratio = src_freq / (long double)dst_freq;
+    return (int)(src_len / ratio);
+}
+
+#if defined(AUDIO_RESAMPLER_SPEEX)
+/**
+ * \brief A stereo resampler which keeps its filter state across calls, so consecutive chunks join seamlessly.
+ * \remarks Every capture owns its own instance, so several can run at once.
+ */
+class resampler
+{
+  public:
+    /**
+     * \brief Creates a resampler.
+     * \param quality The speexdsp quality from 0 to 10. Higher values sound better but take longer.
+     */
+    explicit resampler(const int quality = 6) : m_quality(std::clamp(quality, 0, 10))
+    {
+    }
+
+    ~resampler()
+    {
+        if (m_state)
+        {
+            speex_resampler_destroy(m_state);
+        }
+    }
+
+    resampler(const resampler &) = delete;
+    resampler &operator=(const resampler &) = delete;
+
+    /**
+     * \brief Sets the quality, resetting the filter state if it changed.
+     */
+    void set_quality(const int quality)
+    {
+        const int clamped = std::clamp(quality, 0, 10);
+        if (clamped != m_quality && m_state)
+        {
+            speex_resampler_destroy(m_state);
+            m_state = nullptr;
+        }
+        m_quality = clamped;
+    }
+
+    /**
+     * \brief Converts AI output to interleaved L/R 16-bit stereo at the destination frequency.
+     * \param src The samples. 16-bit samples have their channels swapped in place.
+     * \param len The length of the samples in bytes.
+     * \param src_freq The source frequency.
+     * \param dst_freq The destination frequency.
+     * \param bits The sample size, 8 or 16 bits.
+     * \return The converted frames, valid until the next call, or an empty span if the sample size isn't supported.
+     * When both frequencies match, the span refers to <c>src</c>.
+     */
+    std::span<const int16_t> process(void *src, const size_t len, const uint32_t src_freq, const uint32_t dst_freq,
+                                     const uint32_t bits)
+    {
+        int16_t *in;
+        size_t frames;
+
+        if (bits == 16)
+        {
+            in = static_cast<int16_t *>(src);
+            frames = len / 4;
+            swap_channels(in, in, frames);
+        }
+        else if (bits == 8)
+        {
+            frames = len / 2;
+            m_in.resize(frames * 2);
+            widen8(m_in.data(), static_cast<const int8_t *>(src), frames * 2);
+            in = m_in.data();
+        }
+        else
+        {
+            return {};
+        }
+
+        if (src_freq == dst_freq)
+        {
+            return {in, frames * 2};
+        }
+
+        if (!m_state)
+        {
+            int err = 0;
+            m_state = speex_resampler_init(2, src_freq, dst_freq, m_quality, &err);
+            if (!m_state)
+            {
+                return {};
+            }
+        }
+        else if (src_freq != m_src_freq || dst_freq != m_dst_freq)
+        {
+            speex_resampler_set_rate(m_state, src_freq, dst_freq);
+        }
+        m_src_freq = src_freq;
+        m_dst_freq = dst_freq;
+
+        // Leaves room for the samples the filter held back from the previous call.
+        const size_t capacity = frames * dst_freq / src_freq + 64;
+        m_out.resize(capacity * 2);
+
+        auto in_len = static_cast<spx_uint32_t>(frames);
+        auto out_len = static_cast<spx_uint32_t>(capacity);
+        speex_resampler_process_interleaved_int(m_state, in, &in_len, m_out.data(), &out_len);
+
+        return {m_out.data(), out_len * 2};
+    }
+
+  private:
+    int m_quality;
+    SpeexResamplerState *m_state{};
+    uint32_t m_src_freq{};
+    uint32_t m_dst_freq{};
+    std::vector<int16_t> m_in;
+    std::vector<int16_t> m_out;
+};
+#endif
+} // namespace AudioResampler
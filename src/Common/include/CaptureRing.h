@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing the buffers which carry captured frames and samples from the emulator to an encoder.
+ */
+namespace CaptureRing
+{
+/**
+ * \brief Counters describing how a ring was used.
+ */
+struct stats
+{
+    /**
+     * \brief The amount of slots the producer committed.
+     */
+    uint64_t produced;
+
+    /**
+     * \brief The amount of slots the consumer released.
+     */
+    uint64_t consumed;
+
+    /**
+     * \brief The amount of times the producer found the ring full and had to wait for the consumer.
+     */
+    uint64_t stalls;
+
+    /**
+     * \brief The total time the producer spent waiting for the consumer.
+     */
+    std::chrono::nanoseconds stall_time;
+
+    /**
+     * \brief The highest amount of slots that were committed but not yet released at once.
+     */
+    size_t high_water;
+};
+
+/**
+ * \brief A single-producer single-consumer ring of preallocated, fixed-size slots.
+ * \remarks The producer writes into a slot in place and commits it, and the consumer reads it in place and releases
+ * it, so no data is copied or allocated after construction. A full ring blocks the producer until the consumer
+ * catches up, which shows up in the stall counters. Only the waits on an empty or full ring involve the OS.
+ */
+class ring
+{
+  public:
+    /**
+     * \brief A committed slot.
+     */
+    struct view
+    {
+        const uint8_t *data;
+        size_t size;
+    };
+
+    /**
+     * \brief Creates a ring.
+     * \param slot_count The amount of slots, at least 1.
+     * \param slot_size The capacity of each slot in bytes.
+     */
+    ring(const size_t slot_count, const size_t slot_size)
+        : m_slot_count(std::max<size_t>(slot_count, 1)), m_slot_stride((slot_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1)),
+          m_slot_size(slot_size), m_sizes(m_slot_count)
+    {
+        m_data.reset(static_cast<uint8_t *>(::operator new(m_slot_count * m_slot_stride, std::align_val_t{ALIGNMENT})));
+    }
+
+    ring(const ring &) = delete;
+    ring &operator=(const ring &) = delete;
+
+    size_t slot_size() const
+    {
+        return m_slot_size;
+    }
+
+    size_t slot_count() const
+    {
+        return m_slot_count;
+    }
+
+    /**
+     * \brief Gets the slot the producer writes into next, waiting for the consumer to free one if the ring is full.
+     * \return The slot, or nullptr if the ring was closed. Until it's committed, the same slot is returned again.
+     */
+    uint8_t *acquire()
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == m_slot_count)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            wait([&] { return head - m_tail.load(std::memory_order_acquire) < m_slot_count; });
+            ++m_stalls;
+            m_stall_time += std::chrono::steady_clock::now() - start;
+
+            if (m_closed.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+        }
+        return slot(head);
+    }
+
+    /**
+     * \brief Gets the slot the producer writes into next.
+     * \return The slot, or nullptr if the ring is full or closed.
+     */
+    uint8_t *try_acquire()
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (m_closed.load(std::memory_order_acquire) || head - m_tail.load(std::memory_order_acquire) == m_slot_count)
+        {
+            return nullptr;
+        }
+        return slot(head);
+    }
+
+    /**
+     * \brief Publishes the acquired slot to the consumer.
+     * \param size The amount of bytes written to the slot, at most <c>slot_size()</c>.
+     */
+    void commit(const size_t size)
+    {
+        assert(size <= m_slot_size);
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        m_sizes[head % m_slot_count] = size;
+        m_high_water = std::max<size_t>(m_high_water, head + 1 - m_tail.load(std::memory_order_acquire));
+        m_head.store(head + 1, std::memory_order_release);
+        signal();
+    }
+
+    /**
+     * \brief Gets the oldest committed slot, waiting for the producer to commit one if the ring is empty.
+     * \return The slot, or an empty optional if the ring was closed and everything committed before was released.
+     */
+    std::optional<view> front()
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail)
+        {
+            wait([&] { return m_head.load(std::memory_order_acquire) != tail; });
+
+            if (m_head.load(std::memory_order_acquire) == tail)
+            {
+                return std::nullopt;
+            }
+        }
+        return view{slot(tail), m_sizes[tail % m_slot_count]};
+    }
+
+    /**
+     * \brief Gets the oldest committed slot.
+     * \return The slot, or an empty optional if the ring is empty.
+     */
+    std::optional<view> try_front()
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail)
+        {
+            return std::nullopt;
+        }
+        return view{slot(tail), m_sizes[tail % m_slot_count]};
+    }
+
+    /**
+     * \brief Returns the slot obtained from <c>front</c> or <c>try_front</c> to the producer.
+     */
+    void release()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        signal();
+    }
+
+    /**
+     * \brief Closes the ring, making waiting producers give up and the consumer stop once the ring is drained.
+     */
+    void close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        signal();
+    }
+
+    /**
+     * \brief Gets the usage counters. Must be called from the producer thread or after both sides stopped.
+     */
+    stats get_stats() const
+    {
+        return stats{
+            .produced = m_head.load(std::memory_order_acquire),
+            .consumed = m_tail.load(std::memory_order_acquire),
+            .stalls = m_stalls,
+            .stall_time = m_stall_time,
+            .high_water = m_high_water,
+        };
+    }
+
+  private:
+    static constexpr size_t ALIGNMENT = 64;
+
+    struct aligned_delete
+    {
+        void operator()(uint8_t *p) const
+        {
+            ::operator delete(p, std::align_val_t{ALIGNMENT});
+        }
+    };
+
+    uint8_t *slot(const uint64_t index) const
+    {
+        return m_data.get() + (index % m_slot_count) * m_slot_stride;
+    }
+
+    /**
+     * \brief Blocks until the predicate holds or the ring is closed.
+     */
+    template <typename T> void wait(const T &ready)
+    {
+        m_waiters.fetch_add(1);
+        while (true)
+        {
+            // The event counter is read before the predicate, so a signal in between makes the wait return at once.
+            const uint32_t events = m_events.load();
+            if (ready() || m_closed.load(std::memory_order_acquire))
+            {
+                break;
+            }
+            m_events.wait(events);
+        }
+        m_waiters.fetch_sub(1);
+    }
+
+    void signal()
+    {
+        m_events.fetch_add(1);
+        if (m_waiters.load() != 0)
+        {
+            m_events.notify_all();
+        }
+    }
+
+    size_t m_slot_count;
+    size_t m_slot_stride;
+    size_t m_slot_size;
+    std::unique_ptr<uint8_t, aligned_delete> m_data;
+    std::vector<size_t> m_sizes;
+
+    alignas(64) std::atomic<uint64_t> m_head{};
+    alignas(64) std::atomic<uint64_t> m_tail{};
+    alignas(64) std::atomic<uint32_t> m_events{};
+    std::atomic<uint32_t> m_waiters{};
+    std::atomic<bool> m_closed{};
+
+    // Only touched by the producer.
+    uint64_t m_stalls{};
+    std::chrono::nanoseconds m_stall_time{};
+    size_t m_high_water{};
+};
+} // namespace CaptureRing
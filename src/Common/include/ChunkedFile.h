@@ -0,0 +1,416 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <libdeflate.h>
+
+/**
+ * \brief A module providing a container of independently compressed sections with a table of contents.
+ * \remarks The layout is a fixed-size header, the table of contents, then the sections' data:
+ * <code>
+ * header:  magic "M64C", format version, content version, section count, table of contents checksum
+ * toc:     per section: id, compression, offset, stored size, size, checksum
+ * data:    the sections, in the order they were added
+ * </code>
+ * All values are little-endian. Checksums are XXH64 digests of the uncompressed data, so a single section can be read
+ * and verified without touching the rest of the file.
+ */
+namespace ChunkedFile
+{
+/**
+ * \brief Creates a section id from its four-character name.
+ */
+constexpr uint32_t make_id(const char (&name)[5])
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(name[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(name[2])) << 16 |
+           static_cast<uint32_t>(static_cast<uint8_t>(name[3])) << 24;
+}
+
+enum class compression_method : uint32_t
+{
+    none,
+    deflate,
+};
+
+/**
+ * \brief An entry of the table of contents.
+ */
+struct section_info
+{
+    uint32_t id;
+    compression_method compression;
+
+    /**
+     * \brief The offset of the section's data from the start of the file.
+     */
+    uint64_t offset;
+
+    /**
+     * \brief The size of the section's data in the file.
+     */
+    uint64_t stored_size;
+
+    /**
+     * \brief The size of the section once decompressed.
+     */
+    uint64_t size;
+
+    /**
+     * \brief The XXH64 digest of the decompressed section.
+     */
+    uint64_t checksum;
+};
+
+static_assert(sizeof(section_info) == 40);
+
+constexpr char MAGIC[4] = {'M', '6', '4', 'C'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+/**
+ * \brief The maximum amount of sections in a container, which bounds what a corrupt header can make a reader allocate.
+ */
+constexpr uint32_t MAX_SECTIONS = 1024;
+
+/**
+ * \brief The maximum decompressed size of a section, which bounds what a corrupt table of contents can make a reader
+ * allocate. Comfortably above the largest savestate section, the 8 MB of RDRAM.
+ */
+constexpr uint64_t MAX_SECTION_SIZE = 64 * 1024 * 1024;
+
+struct file_header
+{
+    char magic[4];
+    uint32_t format_version;
+    uint32_t content_version;
+    uint32_t section_count;
+    uint64_t toc_checksum;
+};
+
+static_assert(sizeof(file_header) == 24);
+
+/**
+ * \brief Gets whether a buffer starts with a container header.
+ */
+inline bool is_container(const std::span<const uint8_t> buffer)
+{
+    return buffer.size() >= sizeof(file_header) && memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+ * \brief Builds a container in memory.
+ */
+class writer
+{
+  public:
+    /**
+     * \brief Creates an empty container.
+     * \param content_version The version of the sections' contents, which is up to the container's user.
+     * \param level The libdeflate compression level of compressed sections.
+     */
+    explicit writer(const uint32_t content_version, const int32_t level = 6)
+        : m_content_version(content_version), m_level(level)
+    {
+    }
+
+    /**
+     * \brief Adds a section. The data is copied.
+     * \param id The section's id, which must be unique in the container.
+     * \param data The section's data.
+     * \param compression How the section is stored.
+     */
+    void add(const uint32_t id, const std::span<const uint8_t> data, const compression_method compression)
+    {
+        assert(std::ranges::none_of(m_sections, [=](const auto &s) { return s.id == id; }));
+        m_sections.push_back({id, compression, {data.begin(), data.end()}});
+    }
+
+    /**
+     * \brief Compresses the sections and lays out the container. Sections are compressed in parallel.
+     * \return The container's bytes, or an empty buffer if compression failed.
+     */
+    std::vector<uint8_t> finish() const
+    {
+        std::vector<std::vector<uint8_t>> stored(m_sections.size());
+        std::atomic<size_t> next = 0;
+        std::atomic<bool> failed = false;
+        const auto compress = [&] {
+            const auto compressor = libdeflate_alloc_compressor(m_level);
+            for (size_t i = next++; i < m_sections.size(); i = next++)
+            {
+                const auto &s = m_sections[i];
+                if (s.compression == compression_method::none)
+                {
+                    continue;
+                }
+
+                auto &out = stored[i];
+                out.resize(libdeflate_deflate_compress_bound(compressor, s.data.size()));
+                const auto size =
+                    libdeflate_deflate_compress(compressor, s.data.data(), s.data.size(), out.data(), out.size());
+                if (size == 0 && !s.data.empty())
+                {
+                    failed = true;
+                }
+                out.resize(size);
+            }
+            libdeflate_free_compressor(compressor);
+        };
+
+        const auto compressed_count =
+            std::ranges::count(m_sections, compression_method::deflate, &section::compression);
+        const auto thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                                                   std::max<size_t>(compressed_count, 1));
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; ++i)
+        {
+            threads.emplace_back(compress);
+        }
+        compress();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        if (failed)
+        {
+            return {};
+        }
+
+        std::vector<section_info> toc(m_sections.size());
+        uint64_t offset = sizeof(file_header) + toc.size() * sizeof(section_info);
+        for (size_t i = 0; i < m_sections.size(); ++i)
+        {
+            const auto &s = m_sections[i];
+            const auto &data = s.compression == compression_method::none ? s.data : stored[i];
+            toc[i] = {
+                .id = s.id,
+                .compression = s.compression,
+                .offset = offset,
+                .stored_size = data.size(),
+                .size = s.data.size(),
+                .checksum = HashUtils::xxh64(s.data.data(), s.data.size()),
+            };
+            offset += data.size();
+        }
+
+        file_header header{};
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.format_version = FORMAT_VERSION;
+        header.content_version = m_content_version;
+        header.section_count = static_cast<uint32_t>(toc.size());
+        header.toc_checksum = HashUtils::xxh64(toc.data(), toc.size() * sizeof(section_info));
+
+        std::vector<uint8_t> out;
+        out.reserve(offset);
+        MiscHelpers::vecwrite(out, &header, sizeof(header));
+        MiscHelpers::vecwrite(out, toc.data(), toc.size() * sizeof(section_info));
+        for (size_t i = 0; i < m_sections.size(); ++i)
+        {
+            const auto &s = m_sections[i];
+            const auto &data = s.compression == compression_method::none ? s.data : stored[i];
+            MiscHelpers::vecwrite(out, data.data(), data.size());
+        }
+        return out;
+    }
+
+  private:
+    struct section
+    {
+        uint32_t id;
+        compression_method compression;
+        std::vector<uint8_t> data;
+    };
+
+    uint32_t m_content_version;
+    int32_t m_level;
+    std::vector<section> m_sections;
+};
+
+/**
+ * \brief Reads sections from a container on demand.
+ * \remarks Opening a container only reads its header and table of contents. Each section is read, decompressed and
+ * verified when it's requested.
+ */
+class reader
+{
+  public:
+    reader() = default;
+    reader(const reader &) = delete;
+    reader &operator=(const reader &) = delete;
+    reader(reader &&) = default;
+    reader &operator=(reader &&) = default;
+
+    /**
+     * \brief Opens a container file.
+     * \return Whether the file is a valid container.
+     */
+    bool open(const std::filesystem::path &path)
+    {
+        close();
+        m_file.open(path, std::ios::binary | std::ios::ate);
+        if (!m_file)
+        {
+            return false;
+        }
+        m_size = static_cast<uint64_t>(m_file.tellg());
+        return read_toc();
+    }
+
+    /**
+     * \brief Opens a container held in memory.
+     * \param buffer The container's bytes, which must outlive the reader.
+     * \return Whether the buffer is a valid container.
+     */
+    bool open(const std::span<const uint8_t> buffer)
+    {
+        close();
+        m_buffer = buffer;
+        m_size = buffer.size();
+        return read_toc();
+    }
+
+    void close()
+    {
+        m_file = {};
+        m_buffer = {};
+        m_size = 0;
+        m_header = {};
+        m_sections.clear();
+    }
+
+    /**
+     * \brief Gets the content version the container was written with.
+     */
+    uint32_t content_version() const
+    {
+        return m_header.content_version;
+    }
+
+    /**
+     * \brief Gets the table of contents.
+     */
+    const std::vector<section_info> &sections() const
+    {
+        return m_sections;
+    }
+
+    /**
+     * \brief Gets a section's table of contents entry, or null if the container has no such section.
+     */
+    const section_info *find(const uint32_t id) const
+    {
+        const auto it = std::ranges::find(m_sections, id, &section_info::id);
+        return it == m_sections.end() ? nullptr : &*it;
+    }
+
+    /**
+     * \brief Reads a section.
+     * \param id The section's id.
+     * \param out The section's decompressed data.
+     * \return Whether the section exists, was read and matches its checksum.
+     */
+    bool read(const uint32_t id, std::vector<uint8_t> &out)
+    {
+        const auto section = find(id);
+        if (!section)
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> stored;
+        if (!read_at(section->offset, section->stored_size, stored))
+        {
+            return false;
+        }
+
+        switch (section->compression)
+        {
+        case compression_method::none:
+            out = std::move(stored);
+            break;
+        case compression_method::deflate: {
+            out.resize(section->size);
+            const auto decompressor = libdeflate_alloc_decompressor();
+            const auto result = libdeflate_deflate_decompress(decompressor, stored.data(), stored.size(), out.data(),
+                                                              out.size(), nullptr);
+            libdeflate_free_decompressor(decompressor);
+            if (result != LIBDEFLATE_SUCCESS)
+            {
+                return false;
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+
+        return out.size() == section->size && HashUtils::xxh64(out.data(), out.size()) == section->checksum;
+    }
+
+  private:
+    bool read_at(const uint64_t offset, const uint64_t size, std::vector<uint8_t> &out)
+    {
+        if (!in_bounds(offset, size))
+        {
+            return false;
+        }
+
+        if (!m_file.is_open())
+        {
+            out.assign(m_buffer.begin() + offset, m_buffer.begin() + offset + size);
+            return true;
+        }
+
+        out.resize(size);
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        return static_cast<bool>(m_file.read(reinterpret_cast<char *>(out.data()), static_cast<std::streamsize>(size)));
+    }
+
+    bool read_toc()
+    {
+        std::vector<uint8_t> bytes;
+        if (!read_at(0, sizeof(file_header), bytes))
+        {
+            return false;
+        }
+        memcpy(&m_header, bytes.data(), sizeof(file_header));
+        if (memcmp(m_header.magic, MAGIC, sizeof(MAGIC)) != 0 || m_header.format_version != FORMAT_VERSION ||
+            m_header.section_count > MAX_SECTIONS)
+        {
+            return false;
+        }
+
+        if (!read_at(sizeof(file_header), m_header.section_count * sizeof(section_info), bytes) ||
+            HashUtils::xxh64(bytes.data(), bytes.size()) != m_header.toc_checksum)
+        {
+            return false;
+        }
+        m_sections.resize(m_header.section_count);
+        memcpy(m_sections.data(), bytes.data(), bytes.size());
+
+        // Sections which don't fit in the file, e.g. because it was truncated, are treated as missing.
+        std::erase_if(m_sections, [&](const section_info &section) {
+            return !in_bounds(section.offset, section.stored_size) || section.size > MAX_SECTION_SIZE;
+        });
+        return true;
+    }
+
+    bool in_bounds(const uint64_t offset, const uint64_t size) const
+    {
+        return offset <= m_size && size <= m_size - offset;
+    }
+
+    std::ifstream m_file;
+    std::span<const uint8_t> m_buffer;
+    uint64_t m_size = 0;
+    file_header m_header{};
+    std::vector<section_info> m_sections;
+};
+} // namespace ChunkedFile
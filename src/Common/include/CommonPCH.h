@@ -7,6 +7,7 @@
 #include <bit>
 #include <concepts>
 #include <charconv>
+#include <chrono>
 #include <cassert>
 #include <cctype>
 #include <cfloat>
@@ -28,6 +29,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <queue>
 #include <ranges>
 #include <span>
@@ -42,4 +44,9 @@
 #include "MiscHelpers.h"
 #include "StrUtils.h"
 #include "IOUtils.h"
+#include "HashUtils.h"
+#include "EndianUtils.h"
+#include "CaptureRing.h"
+#include "EventQueue.h"
+#include "ChunkedFile.h"
 // #include "PlatformService.h"
\ No newline at end of file
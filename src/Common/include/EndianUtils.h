@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ENDIAN_UTILS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENDIAN_UTILS_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ENDIAN_UTILS_NEON
+#endif
+
+/**
+ * \brief A module providing bulk byte order conversions.
+ * \remarks The N64 is big-endian. The emulator keeps its memories as host-order 32-bit words, so a byte at address
+ * <c>a</c> lives at <c>a ^ 3</c> on little-endian hosts.
+ */
+namespace EndianUtils
+{
+enum class swap_kind
+{
+    // Swaps the bytes of every 16-bit halfword.
+    swap16,
+    // Reverses the bytes of every 32-bit word.
+    swap32,
+    // Swaps the 16-bit halves of every 32-bit word.
+    swap32_halves,
+};
+
+namespace detail
+{
+template <swap_kind Kind> uint32_t swap_word(const uint32_t w)
+{
+    if constexpr (Kind == swap_kind::swap16)
+    {
+        return (w & 0xFF00FF00) >> 8 | (w & 0x00FF00FF) << 8;
+    }
+    else if constexpr (Kind == swap_kind::swap32)
+    {
+        return std::byteswap(w);
+    }
+    else
+    {
+        return std::rotl(w, 16);
+    }
+}
+
+#if defined(ENDIAN_UTILS_AVX2)
+template <swap_kind Kind> __m256i shuffle_mask()
+{
+    if constexpr (Kind == swap_kind::swap16)
+    {
+        return _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11,
+                                10, 13, 12, 15, 14);
+    }
+    else if constexpr (Kind == swap_kind::swap32)
+    {
+        return _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9,
+                                8, 15, 14, 13, 12);
+    }
+    else
+    {
+        return _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8,
+                                9, 14, 15, 12, 13);
+    }
+}
+#endif
+
+template <swap_kind Kind> void swap(void *dst, const void *src, const size_t len)
+{
+    auto d = static_cast<uint8_t *>(dst);
+    auto s = static_cast<const uint8_t *>(src);
+    size_t i = 0;
+
+#if defined(ENDIAN_UTILS_AVX2)
+    const __m256i mask = shuffle_mask<Kind>();
+    for (; i + 32 <= len; i += 32)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(d + i), _mm256_shuffle_epi8(v, mask));
+    }
+#elif defined(ENDIAN_UTILS_SSE2)
+    // SSE2 has no byte shuffle, so the swaps are built from 16-bit shifts and halfword shuffles.
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        if constexpr (Kind != swap_kind::swap32_halves)
+        {
+            v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        }
+        if constexpr (Kind != swap_kind::swap16)
+        {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), v);
+    }
+#elif defined(ENDIAN_UTILS_NEON)
+    for (; i + 16 <= len; i += 16)
+    {
+        const uint8x16_t v = vld1q_u8(s + i);
+        if constexpr (Kind == swap_kind::swap16)
+        {
+            vst1q_u8(d + i, vrev16q_u8(v));
+        }
+        else if constexpr (Kind == swap_kind::swap32)
+        {
+            vst1q_u8(d + i, vrev32q_u8(v));
+        }
+        else
+        {
+            vst1q_u8(d + i, vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(v))));
+        }
+    }
+#endif
+
+    for (; i + 4 <= len; i += 4)
+    {
+        uint32_t w;
+        memcpy(&w, s + i, 4);
+        w = swap_word<Kind>(w);
+        memcpy(d + i, &w, 4);
+    }
+
+    if (Kind == swap_kind::swap16 && i + 2 <= len)
+    {
+        const uint8_t lo = s[i];
+        d[i] = s[i + 1];
+        d[i + 1] = lo;
+        i += 2;
+    }
+
+    // Trailing bytes which don't form a full unit are copied as-is.
+    if (d != s)
+    {
+        memcpy(d + i, s + i, len - i);
+    }
+}
+} // namespace detail
+
+/**
+ * \brief Swaps the bytes of every 16-bit halfword, e.g. to convert between .v64 and .z64 images.
+ * \param dst The destination buffer. May be the same as <c>src</c>, but mustn't partially overlap it.
+ * \param src The source buffer.
+ * \param len The length in bytes.
+ */
+inline void swap16(void *dst, const void *src, const size_t len)
+{
+    detail::swap<swap_kind::swap16>(dst, src, len);
+}
+
+/**
+ * \brief Reverses the bytes of every 32-bit word, e.g. to convert between big-endian data and host-order words.
+ * \param dst The destination buffer. May be the same as <c>src</c>, but mustn't partially overlap it.
+ * \param src The source buffer.
+ * \param len The length in bytes.
+ */
+inline void swap32(void *dst, const void *src, const size_t len)
+{
+    detail::swap<swap_kind::swap32>(dst, src, len);
+}
+
+/**
+ * \brief Swaps the 16-bit halves of every 32-bit word, e.g. to convert a .v64 image into host-order words.
+ * \param dst The destination buffer. May be the same as <c>src</c>, but mustn't partially overlap it.
+ * \param src The source buffer.
+ * \param len The length in bytes.
+ */
+inline void swap32_halves(void *dst, const void *src, const size_t len)
+{
+    detail::swap<swap_kind::swap32_halves>(dst, src, len);
+}
+
+/**
+ * \brief Copies bytes between two memories stored as host-order 32-bit words, such as RDRAM and the SP memories.
+ * Equivalent to <c>dst[(dst_addr + i) ^ 3] = src[(src_addr + i) ^ 3]</c> for every <c>i</c> in <c>[0, len)</c>.
+ * \param dst The destination memory.
+ * \param dst_addr The N64 byte address to copy to, relative to <c>dst</c>.
+ * \param src The source memory.
+ * \param src_addr The N64 byte address to copy from, relative to <c>src</c>.
+ * \param len The length in bytes.
+ * \remarks When both addresses sit at the same offset within a word, the whole words in between keep their layout
+ * and are copied in bulk.
+ */
+inline void xor_copy(uint8_t *dst, size_t dst_addr, const uint8_t *src, size_t src_addr, size_t len)
+{
+    if ((dst_addr & 3) == (src_addr & 3))
+    {
+        for (; len && (dst_addr & 3); ++dst_addr, ++src_addr, --len)
+        {
+            dst[dst_addr ^ 3] = src[src_addr ^ 3];
+        }
+
+        const size_t bulk = len & ~static_cast<size_t>(3);
+        memmove(dst + dst_addr, src + src_addr, bulk);
+        dst_addr += bulk;
+        src_addr += bulk;
+        len -= bulk;
+    }
+
+    for (; len; ++dst_addr, ++src_addr, --len)
+    {
+        dst[dst_addr ^ 3] = src[src_addr ^ 3];
+    }
+}
+} // namespace EndianUtils
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing the queue which carries small event records from the emulator to the UI.
+ */
+namespace EventQueue
+{
+/**
+ * \brief Counters describing how a queue was used.
+ */
+struct stats
+{
+    /**
+     * \brief The amount of records producers pushed.
+     */
+    uint64_t pushed;
+
+    /**
+     * \brief The amount of records producers dropped because the queue was full.
+     */
+    uint64_t dropped;
+};
+
+/**
+ * \brief A bounded multiple-producer single-consumer queue of trivially copyable records.
+ * \remarks Every cell carries a sequence number telling whether it's free for the producer claiming its position or
+ * holds a record for the consumer, so pushing and popping never lock or allocate. A full queue drops the record
+ * instead of waiting, which shows up in the counters.
+ */
+template <typename T> class queue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Records are copied in and out of the queue");
+
+  public:
+    /**
+     * \brief Creates a queue.
+     * \param capacity The amount of records the queue holds, rounded up to a power of two.
+     */
+    explicit queue(const size_t capacity)
+        : m_mask(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), m_cells(std::make_unique<cell[]>(m_mask + 1))
+    {
+        for (size_t i = 0; i <= m_mask; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    queue(const queue &) = delete;
+    queue &operator=(const queue &) = delete;
+
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    /**
+     * \brief Appends a record. May be called from any thread.
+     * \return Whether the record was appended, false if the queue is full.
+     */
+    bool try_push(const T &value)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell &c = m_cells[pos & m_mask];
+            const size_t sequence = c.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    c.value = value;
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    m_pushed.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * \brief Removes the oldest record. Must only be called from the consumer thread.
+     * \return Whether a record was removed, false if the queue is empty.
+     */
+    bool try_pop(T &value)
+    {
+        cell &c = m_cells[m_head & m_mask];
+        const size_t sequence = c.sequence.load(std::memory_order_acquire);
+        if (sequence != m_head + 1)
+        {
+            return false;
+        }
+
+        value = c.value;
+        c.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        ++m_head;
+        return true;
+    }
+
+    stats get_stats() const
+    {
+        return stats{
+            .pushed = m_pushed.load(std::memory_order_relaxed),
+            .dropped = m_dropped.load(std::memory_order_relaxed),
+        };
+    }
+
+  private:
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t m_mask;
+    const std::unique_ptr<cell[]> m_cells;
+
+    alignas(64) std::atomic<size_t> m_tail{};
+    alignas(64) size_t m_head{};
+
+    std::atomic<uint64_t> m_pushed{};
+    std::atomic<uint64_t> m_dropped{};
+};
+} // namespace EventQueue
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing hashing helpers for large buffers.
+ */
+namespace HashUtils
+{
+/**
+ * \brief An incremental XXH64 hasher.
+ * \remarks Produces the same digests as <c>xxh64::hash</c>, but processes the input iteratively with the four
+ * accumulator lanes kept independent, so it's suitable for hashing multi-megabyte buffers at runtime.
+ */
+class xxh64_state
+{
+  public:
+    explicit xxh64_state(const uint64_t seed = 0)
+    {
+        reset(seed);
+    }
+
+    void reset(const uint64_t seed = 0)
+    {
+        m_seed = seed;
+        m_v[0] = seed + PRIME1 + PRIME2;
+        m_v[1] = seed + PRIME2;
+        m_v[2] = seed;
+        m_v[3] = seed - PRIME1;
+        m_total = 0;
+        m_buf_len = 0;
+    }
+
+    void update(const void *data, size_t len)
+    {
+        auto p = static_cast<const uint8_t *>(data);
+        m_total += len;
+
+        if (m_buf_len)
+        {
+            const size_t take = std::min(len, sizeof(m_buf) - m_buf_len);
+            memcpy(m_buf + m_buf_len, p, take);
+            m_buf_len += take;
+            p += take;
+            len -= take;
+
+            if (m_buf_len < sizeof(m_buf))
+            {
+                return;
+            }
+
+            consume_stripes(m_buf, 1);
+            m_buf_len = 0;
+        }
+
+        const size_t stripes = len / sizeof(m_buf);
+        consume_stripes(p, stripes);
+        p += stripes * sizeof(m_buf);
+        len -= stripes * sizeof(m_buf);
+
+        memcpy(m_buf, p, len);
+        m_buf_len = len;
+    }
+
+    template <typename T> void update(const T &value)
+        requires std::is_trivially_copyable_v<T>
+    {
+        update(&value, sizeof(T));
+    }
+
+    [[nodiscard]] uint64_t digest() const
+    {
+        uint64_t h;
+        if (m_total >= sizeof(m_buf))
+        {
+            h = std::rotl(m_v[0], 1) + std::rotl(m_v[1], 7) + std::rotl(m_v[2], 12) + std::rotl(m_v[3], 18);
+            for (const auto v : m_v)
+            {
+                h = (h ^ round(0, v)) * PRIME1 + PRIME4;
+            }
+        }
+        else
+        {
+            h = m_seed + PRIME5;
+        }
+
+        h += m_total;
+
+        const uint8_t *p = m_buf;
+        size_t len = m_buf_len;
+        for (; len >= 8; p += 8, len -= 8)
+        {
+            h = std::rotl(h ^ round(0, load64(p)), 27) * PRIME1 + PRIME4;
+        }
+        if (len >= 4)
+        {
+            h = std::rotl(h ^ load32(p) * PRIME1, 23) * PRIME2 + PRIME3;
+            p += 4;
+            len -= 4;
+        }
+        for (; len; ++p, --len)
+        {
+            h = std::rotl(h ^ *p * PRIME5, 11) * PRIME1;
+        }
+
+        h = (h ^ (h >> 33)) * PRIME2;
+        h = (h ^ (h >> 29)) * PRIME3;
+        return h ^ (h >> 32);
+    }
+
+  private:
+    static constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+    static constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+    static constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+    static constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+    static constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+    static uint64_t round(const uint64_t acc, const uint64_t input)
+    {
+        return std::rotl(acc + input * PRIME2, 31) * PRIME1;
+    }
+
+    static uint64_t load64(const uint8_t *p)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return std::endian::native == std::endian::little ? v : std::byteswap(v);
+    }
+
+    static uint64_t load32(const uint8_t *p)
+    {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return std::endian::native == std::endian::little ? v : std::byteswap(v);
+    }
+
+    void consume_stripes(const uint8_t *p, const size_t count)
+    {
+        // Keeping the lanes in locals lets the compiler keep them in registers and interleave the multiplies.
+        uint64_t v0 = m_v[0], v1 = m_v[1], v2 = m_v[2], v3 = m_v[3];
+        for (size_t i = 0; i < count; ++i, p += 32)
+        {
+            v0 = round(v0, load64(p));
+            v1 = round(v1, load64(p + 8));
+            v2 = round(v2, load64(p + 16));
+            v3 = round(v3, load64(p + 24));
+        }
+        m_v[0] = v0;
+        m_v[1] = v1;
+        m_v[2] = v2;
+        m_v[3] = v3;
+    }
+
+    uint64_t m_seed{};
+    uint64_t m_v[4]{};
+    uint64_t m_total{};
+    uint8_t m_buf[32]{};
+    size_t m_buf_len{};
+};
+
+/**
+ * \brief Computes the XXH64 digest of a buffer.
+ */
+inline uint64_t xxh64(const void *data, const size_t len, const uint64_t seed = 0)
+{
+    xxh64_state state(seed);
+    state.update(data, len);
+    return state.digest();
+}
+} // namespace HashUtils
@@ -12,6 +12,13 @@
 #include <stdio.h>
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace IOUtils
 {
 
@@ -287,6 +294,120 @@ inline FILE *path_fopen_shared(const std::filesystem::path &path, const char *mo
 #endif
 }
 
+// How a file is mapped.
+enum class map_mode
+{
+    // The mapping is read-only.
+    read,
+    // The mapping is writable, but writes are private to the process and never reach the file.
+    copy_on_write,
+    // The mapping is writable and writes go to the file.
+    read_write,
+};
+
+// A memory mapping of an entire file.
+class mapped_file
+{
+  public:
+    explicit mapped_file(const std::filesystem::path &path, const map_mode mode = map_mode::read) : m_mode(mode)
+    {
+        const bool writable = mode == map_mode::read_write;
+#ifdef _WIN32
+        m_file = CreateFileW(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | (writable ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN),
+                             nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+        {
+            return;
+        }
+
+        const DWORD protection = writable                           ? PAGE_READWRITE
+                                 : mode == map_mode::copy_on_write ? PAGE_WRITECOPY
+                                                                   : PAGE_READONLY;
+        m_mapping = CreateFileMappingW(m_file, nullptr, protection, 0, 0, nullptr);
+        if (!m_mapping)
+        {
+            return;
+        }
+
+        const DWORD access = writable                           ? FILE_MAP_WRITE
+                             : mode == map_mode::copy_on_write ? FILE_MAP_COPY
+                                                               : FILE_MAP_READ;
+        m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping, access, 0, 0, 0));
+        if (m_data)
+        {
+            m_size = static_cast<size_t>(size.QuadPart);
+        }
+#else
+        m_fd = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (m_fd < 0)
+        {
+            return;
+        }
+
+        struct stat st{};
+        if (fstat(m_fd, &st) != 0 || st.st_size == 0)
+        {
+            return;
+        }
+
+        void *data = mmap(nullptr, st.st_size, mode == map_mode::read ? PROT_READ : PROT_READ | PROT_WRITE,
+                          mode == map_mode::copy_on_write ? MAP_PRIVATE : MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED)
+        {
+            return;
+        }
+        m_data = static_cast<const uint8_t *>(data);
+        m_size = static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    ~mapped_file()
+    {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+        if (m_data) munmap(const_cast<uint8_t *>(m_data), m_size);
+        if (m_fd >= 0) close(m_fd);
+#endif
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    // Whether the file was mapped successfully. Empty files can't be mapped.
+    bool valid() const { return m_data != nullptr; }
+
+    const uint8_t *data() const { return m_data; }
+
+    // Gets a writable view of the mapping, or nullptr if it's read-only.
+    uint8_t *mutable_data() const { return m_mode != map_mode::read ? const_cast<uint8_t *>(m_data) : nullptr; }
+
+    size_t size() const { return m_size; }
+
+    std::span<const uint8_t> span() const { return {m_data, m_size}; }
+
+  private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+    map_mode m_mode = map_mode::read;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
 // Gets the path of the current executable file.
 inline std::filesystem::path exe_path()
 {
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing an index of the headers of a ROM library.
+ */
+namespace RomIndex
+{
+/**
+ * \brief The amount of header bytes read from a ROM, covering its CRCs, name, cartridge ID and country code.
+ */
+constexpr size_t HEADER_SIZE = 0x40;
+
+using header_bytes = std::array<uint8_t, HEADER_SIZE>;
+
+/**
+ * \brief A file in the index.
+ */
+struct entry
+{
+    std::filesystem::path path;
+    uint64_t size;
+    int64_t mtime;
+
+    /**
+     * \brief Whether the file starts with a ROM header.
+     */
+    bool valid;
+
+    /**
+     * \brief The start of the ROM header in the big-endian order, as stored in a .z64 file. Zeroed if not valid.
+     */
+    header_bytes header;
+};
+
+/**
+ * \brief Reads the start of a ROM's header, converting it from the file's byte order.
+ * \param path The ROM's path. Gzip-compressed ROMs are decompressed in full, others are only read up to the header.
+ * \param header The header bytes, in the big-endian order.
+ * \return Whether the file starts with a ROM header.
+ */
+inline bool read_header(const std::filesystem::path &path, header_bytes &header)
+{
+    header_bytes raw{};
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char *>(raw.data()), raw.size()))
+        {
+            return false;
+        }
+    }
+
+    if (raw[0] == 0x1F && raw[1] == 0x8B)
+    {
+        const auto decompressed = MiscHelpers::auto_decompress(IOUtils::read_entire_file(path), 8000000);
+        if (decompressed.size() < raw.size())
+        {
+            return false;
+        }
+        std::copy_n(decompressed.begin(), raw.size(), raw.begin());
+    }
+
+    // The byte order is told apart the same way the core does when loading the ROM.
+    switch (raw[0])
+    {
+    case 0x80:
+        header = raw;
+        break;
+    case 0x37:
+        EndianUtils::swap16(header.data(), raw.data(), raw.size());
+        break;
+    case 0x40:
+        EndianUtils::swap32(header.data(), raw.data(), raw.size());
+        break;
+    default:
+        return false;
+    }
+
+    // The first byte only picks the byte order, so the whole magic is checked once the header is in z64 order.
+    return header[0] == 0x80 && header[1] == 0x37 && header[2] == 0x12 && header[3] == 0x40;
+}
+
+/**
+ * \brief An index of ROM headers which is persisted to a file.
+ * \remarks Entries are keyed by path, size and modification time, so updating the index only reads the headers of
+ * files which were added or changed since. The headers are read on all hardware threads. All members are thread-safe.
+ */
+class index
+{
+  public:
+    /**
+     * \brief Creates an empty index.
+     * \param file The file the index is persisted to.
+     */
+    explicit index(std::filesystem::path file) : m_file(std::move(file))
+    {
+    }
+
+    index(const index &) = delete;
+    index &operator=(const index &) = delete;
+
+    /**
+     * \brief Replaces the entries with the persisted ones. A missing or unreadable file empties the index.
+     */
+    void load()
+    {
+        std::lock_guard lock(m_mutex);
+        m_entries.clear();
+        m_dirty = false;
+
+        std::ifstream file(m_file, std::ios::binary);
+        char magic[4]{};
+        uint32_t version{};
+        uint64_t count{};
+        if (!read(file, magic) || !read(file, version) || !read(file, count) ||
+            memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || version != FILE_VERSION)
+        {
+            return;
+        }
+
+        std::vector<entry> entries;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            entry e{};
+            uint8_t valid{};
+            uint32_t path_size{};
+            if (!read(file, e.size) || !read(file, e.mtime) || !read(file, valid) || !read(file, e.header) ||
+                !read(file, path_size))
+            {
+                return;
+            }
+            e.valid = valid != 0;
+
+            std::u8string path(path_size, u8'\0');
+            if (!file.read(reinterpret_cast<char *>(path.data()), path_size))
+            {
+                return;
+            }
+            e.path = std::move(path);
+            entries.push_back(std::move(e));
+        }
+
+        m_entries = std::move(entries);
+    }
+
+    /**
+     * \brief Persists the entries, unless they haven't changed since they were last loaded or saved.
+     * \return Whether the entries are persisted.
+     */
+    bool save()
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_dirty)
+        {
+            return true;
+        }
+
+        std::ofstream file(m_file, std::ios::binary | std::ios::trunc);
+        write(file, FILE_MAGIC);
+        write(file, FILE_VERSION);
+        write(file, static_cast<uint64_t>(m_entries.size()));
+        for (const auto &e : m_entries)
+        {
+            const auto path = e.path.u8string();
+            write(file, e.size);
+            write(file, e.mtime);
+            write(file, static_cast<uint8_t>(e.valid));
+            write(file, e.header);
+            write(file, static_cast<uint32_t>(path.size()));
+            file.write(reinterpret_cast<const char *>(path.data()), path.size());
+        }
+
+        m_dirty = !file.good();
+        return !m_dirty;
+    }
+
+    /**
+     * \brief Updates the index to hold exactly the specified files.
+     * \param paths The files' paths.
+     * \return The amount of headers which were read.
+     */
+    size_t update(const std::vector<std::filesystem::path> &paths)
+    {
+        std::lock_guard lock(m_mutex);
+
+        std::unordered_map<std::filesystem::path, const entry *> known;
+        for (const auto &e : m_entries)
+        {
+            known.emplace(e.path, &e);
+        }
+
+        std::vector<entry> entries(paths.size());
+        std::vector<entry *> stale;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            auto &e = entries[i];
+            std::error_code ec;
+            e.path = paths[i];
+            e.size = static_cast<uint64_t>(std::filesystem::file_size(e.path, ec));
+            e.mtime = static_cast<int64_t>(std::filesystem::last_write_time(e.path, ec).time_since_epoch().count());
+
+            const auto it = known.find(e.path);
+            if (it != known.end() && it->second->size == e.size && it->second->mtime == e.mtime)
+            {
+                e = *it->second;
+                continue;
+            }
+            stale.push_back(&e);
+        }
+
+        std::atomic<size_t> next = 0;
+        const auto read_stale = [&] {
+            for (size_t i = next++; i < stale.size(); i = next++)
+            {
+                stale[i]->valid = read_header(stale[i]->path, stale[i]->header);
+                if (!stale[i]->valid)
+                {
+                    stale[i]->header = {};
+                }
+            }
+        };
+
+        const auto thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), stale.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; ++i)
+        {
+            threads.emplace_back(read_stale);
+        }
+        read_stale();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        m_dirty |= !stale.empty() || entries.size() != m_entries.size();
+        m_entries = std::move(entries);
+        return stale.size();
+    }
+
+    /**
+     * \brief Gets the entries, in the order of the paths last passed to <c>update</c>.
+     */
+    std::vector<entry> entries() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_entries;
+    }
+
+  private:
+    static constexpr char FILE_MAGIC[4] = {'R', 'I', 'D', 'X'};
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    template <typename T> static bool read(std::istream &stream, T &value)
+    {
+        return static_cast<bool>(stream.read(reinterpret_cast<char *>(&value), sizeof(T)));
+    }
+
+    template <typename T> static void write(std::ostream &stream, const T &value)
+    {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    const std::filesystem::path m_file;
+    mutable std::mutex m_mutex;
+    std::vector<entry> m_entries;
+    bool m_dirty{};
+};
+} // namespace RomIndex
@@ -9,7 +9,9 @@
 #include <memory/memory.h>
 #include <memory/pif.h>
 #include <memory/savestates.h>
+#include <memory/st_preview.h>
 #include <r4300/debugger.h>
+#include <r4300/desync.h>
 #include <r4300/disasm.h>
 #include <r4300/r4300.h>
 #include <r4300/rom.h>
@@ -130,9 +132,13 @@ core_result core_create(core_params *params, core_ctx **ctx)
     g_ctx.tl_active = tl_active;
     g_ctx.tl_start = tl_start;
     g_ctx.tl_stop = tl_stop;
+    g_ctx.ds_begin = ds_begin;
+    g_ctx.ds_active = ds_active;
+    g_ctx.ds_cancel = ds_cancel;
     g_ctx.st_do_file = st_do_file;
     g_ctx.st_do_memory = st_do_memory;
     g_ctx.st_get_undo_savestate = st_get_undo_savestate;
+    g_ctx.st_read_preview = st_read_preview;
     g_ctx.dbg_get_resumed = dbg_get_resumed;
     g_ctx.dbg_set_is_resumed = dbg_set_is_resumed;
     g_ctx.dbg_step = dbg_step;
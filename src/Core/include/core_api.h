@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "core_events.h"
 #include "core_types.h"
 
 #ifdef __cplusplus
@@ -17,46 +18,6 @@ extern "C"
 {
 #endif
 
-    /**
-     * \brief Callbacks for the core to call into the host.
-     */
-    struct core_callbacks
-    {
-        std::function<void()> vi = [] {};
-        std::function<void(core_buttons *input, int index)> input = [](core_buttons *, int) {};
-        std::function<void()> frame = [] {};
-        std::function<void()> interval = [] {};
-        std::function<void()> ai_len_changed = [] {};
-        std::function<void()> play_movie = [] {};
-        std::function<void()> stop_movie = [] {};
-        std::function<void()> loop_movie = [] {};
-        std::function<void()> save_state = [] {};
-        std::function<void()> load_state = [] {};
-        std::function<void()> reset = [] {};
-        std::function<void()> seek_completed = [] {};
-        std::function<void(bool)> core_executing_changed = [](bool) {};
-        std::function<void(bool)> emu_paused_changed = [](bool) {};
-        std::function<void(bool)> emu_launched_changed = [](bool) {};
-        std::function<void(bool)> emu_starting_changed = [](bool) {};
-        std::function<void()> emu_starting = [] {};
-        std::function<void()> emu_stopped = [] {};
-        std::function<void()> emu_stopping = [] {};
-        std::function<void()> reset_completed = [] {};
-        std::function<void(int32_t)> speed_modifier_changed = [](int32_t) {};
-        std::function<void(bool)> warp_modify_status_changed = [](bool) {};
-        std::function<void(int32_t)> current_sample_changed = [](int32_t) {};
-        std::function<void(core_vcr_task)> task_changed = [](core_vcr_task) {};
-        std::function<void(uint64_t)> rerecords_changed = [](uint64_t) {};
-        std::function<void()> unfreeze_completed = [] {};
-        std::function<void(size_t)> seek_savestate_changed = [](size_t) {};
-        std::function<void(bool)> readonly_changed = [](bool) {};
-        std::function<void(core_system_type)> dacrate_changed = [](core_system_type) {};
-        std::function<void(bool)> debugger_resumed_changed = [](bool) {};
-        std::function<void(core_dbg_cpu_state *)> debugger_cpu_state_changed = [](core_dbg_cpu_state *) {};
-        std::function<void()> lag_limit_exceeded = [] {};
-        std::function<void()> seek_status_changed = [] {};
-    };
-
 #pragma region Dialog IDs
 
 #define CORE_DLG_FLOAT_EXCEPTION "CORE_DLG_FLOAT_EXCEPTION"
@@ -88,12 +49,20 @@ extern "C"
         // PlatformService *io_service;
 
         /**
-         * \brief The core callbacks.
+         * \brief The bus the core raises its events on. The host subscribes to the events it handles.
          */
-        core_callbacks callbacks;
+        core_event_bus events;
 
         core_controller controls[4]{};
 
+        /**
+         * \brief The plugins replaced by the core's null implementations, as a combination of
+         * <c>core_null_plugin</c> flags. The host doesn't need to provide the functions of replaced plugins, and the
+         * core skips the work which only exists to feed them, such as screen updates and audio length tracking.
+         * Meant for runs which only care about the state of the emulated machine.
+         */
+        uint32_t null_plugins{};
+
         /**
          * \brief Logs the specified message at the trace level.
          */
@@ -251,6 +220,12 @@ extern "C"
         FBWRITE video_fb_write;
         FBGETFRAMEBUFFERINFO video_fb_get_frame_buffer_info;
 
+        /**
+         * \brief Tells the video plugin whether the display lists processed from now on belong to a frame which will
+         * never be shown, so it can skip rasterizing them. Optional.
+         */
+        SETFRAMEHIDDEN video_set_frame_hidden;
+
         AIDACRATECHANGED audio_ai_dacrate_changed;
         AILENCHANGED audio_ai_len_changed;
         AIREADLENGTH audio_ai_read_length;
@@ -262,7 +237,20 @@ extern "C"
         SETKEYS input_set_keys;
         READCONTROLLER input_read_controller;
 
+        /**
+         * \brief Gets the state of all four controllers at once. Optional, used in place of <c>input_get_keys</c> if
+         * present.
+         */
+        GETALLKEYS input_get_all_keys;
+
         DORSPCYCLES rsp_do_rsp_cycles;
+
+        /**
+         * \brief Tells the RSP plugin that a DMA or a savestate load wrote to RDRAM, DMEM or IMEM, so it can drop
+         * what it derived from the old contents. Optional. The address is physical, so DMEM starts at 0x04000000 and
+         * IMEM at 0x04001000.
+         */
+        DMAWRITTEN rsp_dma_written;
     };
 
     struct core_ctx
@@ -618,7 +606,8 @@ extern "C"
         /**
          * \brief Starts trace logging to the specified file.
          * \param path The output path.
-         * \param binary Whether log output is in a binary format.
+         * \param binary Whether log output is in a binary format. Binary logs get an index written next to them (see
+         * <c>tracelog_index.h</c>) when logging stops.
          * \param append Whether log output will be appended to the file.
          */
         std::function<void(std::filesystem::path path, bool binary, bool append)> tl_start;
@@ -630,6 +619,34 @@ extern "C"
 
 #pragma endregion
 
+#pragma region Desync Bisection
+
+        /**
+         * \brief Begins a desync bisection. The movie is played back under the reference configuration while the
+         * machine state is hashed at every checkpoint, then played back under the compared configuration until the
+         * hashes diverge. The diverging sample is bisected by playing both configurations from the savestate of the
+         * last matching checkpoint. Optionally, the frame leading up to the divergence is traced under both
+         * configurations to find the first diverging instruction.
+         * \param params The bisection parameters.
+         * \param callback The callback to call when the bisection completes.
+         * \return The operation result.
+         * \remarks The bisection runs asynchronously via <c>submit_task</c>. The host's config is temporarily replaced
+         * and restored afterwards.
+         */
+        std::function<core_result(const core_ds_params &params, const core_ds_callback &callback)> ds_begin;
+
+        /**
+         * \brief Gets whether a desync bisection is running.
+         */
+        std::function<bool()> ds_active;
+
+        /**
+         * \brief Requests the running desync bisection to stop. The callback is invoked with <c>DS_Cancelled</c>.
+         */
+        std::function<void()> ds_cancel;
+
+#pragma endregion
+
 #pragma region Savestates
 
         /**
@@ -662,6 +679,15 @@ extern "C"
          */
         std::function<void(std::vector<uint8_t> &buffer)> st_get_undo_savestate;
 
+        /**
+         * \brief Reads the preview of a savestate file, i.e. its thumbnail and metadata, without reading the savestate.
+         * Previews are written next to savestate files when <c>core_cfg::st_preview</c> is enabled.
+         * \param path The savestate's path.
+         * \param preview The preview.
+         * \return Whether the savestate has a valid preview.
+         */
+        std::function<bool(const std::filesystem::path &path, core_st_preview &preview)> st_read_preview;
+
 #pragma endregion
 
 #pragma region Debugger
@@ -0,0 +1,475 @@
+﻿/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Describes the events the core raises towards the host.
+ */
+
+#pragma once
+
+#include "core_types.h"
+
+/**
+ * \brief An event raised by the core.
+ */
+enum class core_event : uint8_t
+{
+    vi,
+    input,
+    frame,
+    interval,
+    ai_len_changed,
+    play_movie,
+    stop_movie,
+    loop_movie,
+    save_state,
+    load_state,
+    reset,
+    seek_completed,
+    core_executing_changed,
+    emu_paused_changed,
+    emu_launched_changed,
+    emu_starting_changed,
+    emu_starting,
+    emu_stopped,
+    emu_stopping,
+    reset_completed,
+    speed_modifier_changed,
+    warp_modify_status_changed,
+    current_sample_changed,
+    task_changed,
+    rerecords_changed,
+    unfreeze_completed,
+    seek_savestate_changed,
+    readonly_changed,
+    dacrate_changed,
+    debugger_resumed_changed,
+    debugger_cpu_state_changed,
+    lag_limit_exceeded,
+    seek_status_changed,
+    state_digest_mismatch,
+    count,
+};
+
+/**
+ * \brief The arguments of an event, as a function type. Events without a specialization have none.
+ */
+template <core_event E> struct core_event_signature
+{
+    using type = void();
+};
+
+#define CORE_EVENT_SIGNATURE(event, ...)                                                                               \
+    template <> struct core_event_signature<core_event::event>                                                         \
+    {                                                                                                                  \
+        using type = void(__VA_ARGS__);                                                                                \
+    }
+
+CORE_EVENT_SIGNATURE(input, core_buttons *input, int index);
+CORE_EVENT_SIGNATURE(core_executing_changed, bool);
+CORE_EVENT_SIGNATURE(emu_paused_changed, bool);
+CORE_EVENT_SIGNATURE(emu_launched_changed, bool);
+CORE_EVENT_SIGNATURE(emu_starting_changed, bool);
+CORE_EVENT_SIGNATURE(speed_modifier_changed, int32_t);
+CORE_EVENT_SIGNATURE(warp_modify_status_changed, bool);
+CORE_EVENT_SIGNATURE(current_sample_changed, int32_t);
+CORE_EVENT_SIGNATURE(task_changed, core_vcr_task);
+CORE_EVENT_SIGNATURE(rerecords_changed, uint64_t);
+CORE_EVENT_SIGNATURE(seek_savestate_changed, size_t);
+CORE_EVENT_SIGNATURE(readonly_changed, bool);
+CORE_EVENT_SIGNATURE(dacrate_changed, core_system_type);
+CORE_EVENT_SIGNATURE(debugger_resumed_changed, bool);
+CORE_EVENT_SIGNATURE(debugger_cpu_state_changed, core_dbg_cpu_state *);
+CORE_EVENT_SIGNATURE(state_digest_mismatch, size_t);
+
+#undef CORE_EVENT_SIGNATURE
+
+template <typename Signature> struct core_event_traits_of;
+
+template <typename... Args> struct core_event_traits_of<void(Args...)>
+{
+    using handler = void (*)(void *user, Args...);
+
+    /**
+     * \brief Whether notifications can be coalesced, which requires them to carry at most one value.
+     */
+    static constexpr bool batchable =
+        sizeof...(Args) <= 1 && ((std::is_trivially_copyable_v<Args> && !std::is_pointer_v<Args>) && ...);
+
+    static void store([[maybe_unused]] std::byte *payload, const Args... args)
+    {
+        (memcpy(payload, &args, sizeof(args)), ...);
+    }
+
+    static void invoke(const handler handler, void *user, [[maybe_unused]] const std::byte *payload)
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            handler(user);
+        }
+        else
+        {
+            std::tuple_element_t<0, std::tuple<Args...>> value;
+            memcpy(&value, payload, sizeof(value));
+            handler(user, value);
+        }
+    }
+};
+
+template <core_event E> using core_event_traits = core_event_traits_of<typename core_event_signature<E>::type>;
+
+/**
+ * \brief A handler for an event. The first argument is the user data passed when subscribing.
+ */
+template <core_event E> using core_event_handler = typename core_event_traits<E>::handler;
+
+/**
+ * \brief Delivers the core's events to any number of subscribers.
+ * \remarks Publishing an event nobody subscribed to costs one branch. Subscribers are stored in immutable lists which
+ * are replaced on every change, so publishing never locks and subscriptions may change on any thread at any time.
+ * Publishers count themselves in while reading a list, and replaced lists are freed by the first change made while
+ * no publisher is reading.
+ * Batched subscribers keep the latest value they were sent in a slot of their own. Only the first notification
+ * since the last flush pushes a small record into a lock-free queue, so publishing never allocates or waits for the
+ * thread which flushes them, and the queue only ever holds one record per batched subscriber.
+ */
+class core_event_bus
+{
+  public:
+    using subscription = uint64_t;
+
+    core_event_bus() = default;
+    core_event_bus(const core_event_bus &) = delete;
+    core_event_bus &operator=(const core_event_bus &) = delete;
+
+    /**
+     * \brief Subscribes to an event. The handler runs on the thread which publishes the event.
+     * \param handler The handler.
+     * \param user The user data passed to the handler.
+     * \return The subscription, which can be passed to <c>unsubscribe</c>.
+     */
+    template <core_event E> subscription subscribe(const core_event_handler<E> handler, void *user = nullptr)
+    {
+        return add(E, reinterpret_cast<erased_handler>(handler), user, nullptr);
+    }
+
+    /**
+     * \brief Subscribes to an event, coalescing its notifications until the next call to <c>flush</c>.
+     * The handler only sees the latest value published since the previous flush.
+     * \param handler The handler.
+     * \param user The user data passed to the handler.
+     * \return The subscription, which can be passed to <c>unsubscribe</c>.
+     */
+    template <core_event E> subscription subscribe_batched(const core_event_handler<E> handler, void *user = nullptr)
+    {
+        static_assert(core_event_traits<E>::batchable, "Only events carrying at most one value can be batched");
+        return add(E, reinterpret_cast<erased_handler>(handler), user, &invoke_erased<E>);
+    }
+
+    /**
+     * \brief Removes a subscription. Unknown subscriptions are ignored.
+     */
+    void unsubscribe(const subscription id)
+    {
+        std::lock_guard lock(m_mutex);
+        for (size_t i = 0; i < std::size(m_lists); ++i)
+        {
+            const auto subscribers = m_lists[i].load(std::memory_order_relaxed);
+            if (!subscribers || std::ranges::none_of(*subscribers, [=](const auto &s) { return s.id == id; }))
+            {
+                continue;
+            }
+
+            auto list = std::make_unique<subscriber_list>(*subscribers);
+            std::erase_if(*list, [=](const auto &s) { return s.id == id; });
+            replace(i, std::move(list));
+        }
+    }
+
+    /**
+     * \brief Removes all subscriptions. Their pending notifications are discarded by the next flush.
+     */
+    void clear()
+    {
+        std::lock_guard lock(m_mutex);
+        for (size_t i = 0; i < std::size(m_lists); ++i)
+        {
+            replace(i, nullptr);
+        }
+    }
+
+    /**
+     * \brief Gets whether an event has any subscribers.
+     */
+    bool has_subscribers(const core_event event) const
+    {
+        return m_mask.load(std::memory_order_relaxed) & bit(event);
+    }
+
+    /**
+     * \brief Raises an event.
+     * \param args The event's arguments.
+     */
+    template <core_event E, typename... Args> void publish(Args &&...args)
+    {
+        if (!has_subscribers(E))
+        {
+            return;
+        }
+
+        const reader_guard guard(m_readers);
+        const auto subscribers = m_lists[static_cast<size_t>(E)].load(std::memory_order_seq_cst);
+        if (!subscribers)
+        {
+            return;
+        }
+
+        for (const auto &s : *subscribers)
+        {
+            if constexpr (core_event_traits<E>::batchable)
+            {
+                if (s.invoke_pending)
+                {
+                    enqueue<E>(s, args...);
+                    continue;
+                }
+            }
+            reinterpret_cast<core_event_handler<E>>(s.handler)(s.user, args...);
+        }
+    }
+
+    /**
+     * \brief Runs the batched handlers which have notifications pending, with the latest value each one was sent.
+     * Must always be called from the same thread.
+     */
+    void flush()
+    {
+        m_flush_requested.store(false, std::memory_order_relaxed);
+
+        m_flushing.clear();
+        pending record;
+        while (m_pending.try_pop(record))
+        {
+            m_flushing.push_back(record);
+        }
+
+        for (const auto &p : m_flushing)
+        {
+            // Clearing the flag first makes a notification published from here on push a new record, so it can't be
+            // lost. One racing with the read below just shows the same value again on the next flush.
+            p.slot->queued.store(false, std::memory_order_seq_cst);
+            const auto value = p.slot->value.load(std::memory_order_seq_cst);
+
+            if (is_subscribed(p.event, p.id))
+            {
+                alignas(8) std::byte payload[8];
+                memcpy(payload, &value, sizeof(value));
+                p.invoke(p.handler, p.user, payload);
+            }
+        }
+    }
+
+    /**
+     * \brief Sets the function called when a batched notification is published after the last flush, e.g. to
+     * schedule a flush on another thread. It runs on the publishing thread. Must be set before events are published.
+     */
+    void set_batch_notifier(void (*notifier)(void *user), void *user = nullptr)
+    {
+        m_notifier = notifier;
+        m_notifier_user = user;
+    }
+
+    /**
+     * \brief Gets the usage counters of the queue carrying batched notifications.
+     */
+    EventQueue::stats batch_stats() const
+    {
+        return m_pending.get_stats();
+    }
+
+    /**
+     * \brief Gets the number of subscriber lists held by the bus, including replaced ones which aren't freed yet.
+     */
+    size_t list_count()
+    {
+        std::lock_guard lock(m_mutex);
+        return m_retired.size();
+    }
+
+  private:
+    using erased_handler = void (*)();
+    using erased_invoker = void (*)(erased_handler handler, void *user, const std::byte *payload);
+
+    /**
+     * \brief The latest notification sent to a batched subscriber.
+     */
+    struct batch_slot
+    {
+        // Large enough for any value a batchable event carries.
+        std::atomic<uint64_t> value{};
+        // Whether a record for the slot is in the queue.
+        std::atomic<bool> queued{};
+    };
+
+    struct subscriber
+    {
+        subscription id;
+        erased_handler handler;
+        void *user;
+
+        // Set for batched subscribers.
+        erased_invoker invoke_pending;
+        batch_slot *slot;
+    };
+
+    struct pending
+    {
+        subscription id;
+        core_event event;
+        erased_handler handler;
+        void *user;
+        erased_invoker invoke;
+        batch_slot *slot;
+    };
+
+    using subscriber_list = std::vector<subscriber>;
+
+    /**
+     * \brief Counts a publisher in while it reads a subscriber list, so the list isn't freed under it.
+     */
+    struct reader_guard
+    {
+        explicit reader_guard(std::atomic<uint32_t> &readers) : readers(readers)
+        {
+            readers.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~reader_guard()
+        {
+            readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        reader_guard(const reader_guard &) = delete;
+        reader_guard &operator=(const reader_guard &) = delete;
+
+        std::atomic<uint32_t> &readers;
+    };
+
+    static constexpr uint64_t bit(const core_event event)
+    {
+        return 1ULL << static_cast<size_t>(event);
+    }
+
+    static_assert(static_cast<size_t>(core_event::count) <= 64, "The subscription mask has a bit per event");
+
+    template <core_event E> static void invoke_erased(erased_handler handler, void *user, const std::byte *payload)
+    {
+        core_event_traits<E>::invoke(reinterpret_cast<core_event_handler<E>>(handler), user, payload);
+    }
+
+    subscription add(const core_event event, const erased_handler handler, void *user, const erased_invoker invoker)
+    {
+        std::lock_guard lock(m_mutex);
+        const auto index = static_cast<size_t>(event);
+        const auto current = m_lists[index].load(std::memory_order_relaxed);
+
+        auto list = current ? std::make_unique<subscriber_list>(*current) : std::make_unique<subscriber_list>();
+        const auto id = ++m_next_id;
+
+        // Slots are kept until the bus is destroyed, as queued records may still point to them.
+        batch_slot *slot = nullptr;
+        if (invoker)
+        {
+            slot = m_slots.emplace_back(std::make_unique<batch_slot>()).get();
+        }
+
+        list->push_back({id, handler, user, invoker, slot});
+        replace(index, std::move(list));
+        return id;
+    }
+
+    // Must be called with m_mutex held.
+    void replace(const size_t index, std::unique_ptr<subscriber_list> list)
+    {
+        const auto event = static_cast<core_event>(index);
+        if (list && !list->empty())
+        {
+            m_mask.fetch_or(bit(event), std::memory_order_relaxed);
+        }
+        else
+        {
+            m_mask.fetch_and(~bit(event), std::memory_order_relaxed);
+        }
+
+        m_lists[index].store(list.get(), std::memory_order_seq_cst);
+        if (list)
+        {
+            m_retired.push_back(std::move(list));
+        }
+
+        // A publisher counted in after this point can only see the current lists, so with none counted in now the
+        // replaced ones are unreachable. Otherwise they're left for a later change.
+        if (m_readers.load(std::memory_order_seq_cst) != 0)
+        {
+            return;
+        }
+        std::erase_if(m_retired, [this](const auto &retired) {
+            return std::ranges::none_of(m_lists, [&](const auto &current) {
+                return current.load(std::memory_order_relaxed) == retired.get();
+            });
+        });
+    }
+
+    bool is_subscribed(const core_event event, const subscription id)
+    {
+        const reader_guard guard(m_readers);
+        const auto subscribers = m_lists[static_cast<size_t>(event)].load(std::memory_order_seq_cst);
+        return subscribers && std::ranges::find(*subscribers, id, &subscriber::id) != subscribers->end();
+    }
+
+    template <core_event E, typename... Args> void enqueue(const subscriber &s, const Args &...args)
+    {
+        alignas(8) std::byte payload[8]{};
+        core_event_traits<E>::store(payload, args...);
+        uint64_t value;
+        memcpy(&value, payload, sizeof(value));
+        s.slot->value.store(value, std::memory_order_seq_cst);
+
+        if (s.slot->queued.exchange(true, std::memory_order_seq_cst))
+        {
+            return;
+        }
+
+        if (!m_pending.try_push({s.id, E, s.handler, s.user, s.invoke_pending, s.slot}))
+        {
+            // Only happens with more batched subscribers than the queue holds. The next notification tries again.
+            s.slot->queued.store(false, std::memory_order_seq_cst);
+            return;
+        }
+
+        if (!m_flush_requested.exchange(true, std::memory_order_acq_rel) && m_notifier)
+        {
+            m_notifier(m_notifier_user);
+        }
+    }
+
+    std::atomic<uint64_t> m_mask{};
+    std::atomic<const subscriber_list *> m_lists[static_cast<size_t>(core_event::count)]{};
+    // Every list the bus owns: the current ones and replaced ones which a publisher may still be reading.
+    std::vector<std::unique_ptr<subscriber_list>> m_retired{};
+    std::atomic<uint32_t> m_readers{};
+    std::vector<std::unique_ptr<batch_slot>> m_slots{};
+    subscription m_next_id{};
+    std::mutex m_mutex{};
+
+    EventQueue::queue<pending> m_pending{256};
+    std::atomic<bool> m_flush_requested{};
+    void (*m_notifier)(void *user){};
+    void *m_notifier_user{};
+
+    // The records drained by the last flush, kept to reuse their storage.
+    std::vector<pending> m_flushing{};
+};
@@ -242,6 +242,7 @@ extern "C"
     typedef void(CALL *FBREAD)(uint32_t);
     typedef void(CALL *FBWRITE)(uint32_t addr, uint32_t size);
     typedef void(CALL *FBGETFRAMEBUFFERINFO)(void *);
+    typedef void(CALL *SETFRAMEHIDDEN)(int32_t hidden);
 
     typedef void(CALL *AIDACRATECHANGED)(int32_t system_type);
     typedef void(CALL *AILENCHANGED)();
@@ -251,10 +252,12 @@ extern "C"
 
     typedef void(CALL *CONTROLLERCOMMAND)(int32_t controller, unsigned char *command);
     typedef void(CALL *GETKEYS)(int32_t controller, core_buttons *keys);
+    typedef void(CALL *GETALLKEYS)(core_buttons *keys);
     typedef void(CALL *SETKEYS)(int32_t controller, core_buttons keys);
     typedef void(CALL *READCONTROLLER)(int32_t controller, unsigned char *command);
 
     typedef uint32_t(CALL *DORSPCYCLES)(uint32_t);
+    typedef void(CALL *DMAWRITTEN)(uint32_t address, uint32_t len);
 }
 
 inline bool operator==(const core_buttons &lhs, const core_buttons &rhs)
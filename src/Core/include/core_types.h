@@ -96,6 +96,14 @@ typedef enum
     // The CPU registers contained invalid values
     ST_InvalidRegisters,
 
+    // Desync bisection
+    // ==========================================
+
+    // Another bisection is already running
+    DS_AlreadyRunning,
+    // The bisection was cancelled before completing
+    DS_Cancelled,
+
     // Plugins
     // ==========================================
 
@@ -149,6 +157,13 @@ struct core_cfg
     /// </summary>
     int32_t frame_skip_frequency = 8;
 
+    /// <summary>
+    /// The amount of frames rendered before a seek finishes
+    /// <para/>
+    /// Display lists of earlier frames in the seek aren't processed at all, unless the ROM depends on its frame buffer
+    /// </summary>
+    int32_t seek_render_frames = 2;
+
     /// <summary>
     /// Whether fast-forward will mute audio
     /// This option improves performance by skipping additional do_rsp_cycles calls, but may cause issues
@@ -156,17 +171,25 @@ struct core_cfg
     int32_t fastforward_silent;
 
     /// <summary>
-    /// Maximum number of entries into the rom cache
+    /// Maximum number of entries into the rom cache. The converted images of as many recently used ROMs are also
+    /// kept on disk, shared between instances.
     /// <para/>
     /// 0 = disabled
     /// </summary>
     int32_t rom_cache_size;
 
     /// <summary>
-    /// Saves video buffer to savestates, slow!
+    /// Saves the video buffer to savestates, so loading them restores the screen immediately.
+    /// The frame is compressed separately from, and in parallel with, the rest of the savestate.
     /// </summary>
     int32_t st_screenshot;
 
+    /// <summary>
+    /// Whether saving a savestate file also writes a preview sidecar holding a thumbnail and metadata.
+    /// The preview is produced in the background.
+    /// </summary>
+    int32_t st_preview;
+
     /// <summary>
     /// Whether a playing movie will loop upon ending
     /// </summary>
@@ -261,6 +284,12 @@ struct core_cfg
     /// </summary>
     int32_t wait_at_movie_end{};
 
+    /// <summary>
+    /// Whether a digest of the machine state is taken every VI while a movie is active.
+    /// The digests are stored next to the movie and verified against when it's played back.
+    /// </summary>
+    int32_t vcr_state_digests{};
+
     /// <summary>
     /// The maximum amount of VIs allowed to be generated since the last input poll before a warning dialog is shown
     /// 0 - no warning
@@ -463,6 +492,18 @@ typedef enum
     sys_pal,
 } core_system_type;
 
+/**
+ * \brief Plugins which the core can replace with built-in null implementations.
+ */
+typedef enum
+{
+    null_plugin_video = 1 << 0,
+    null_plugin_audio = 1 << 1,
+    null_plugin_input = 1 << 2,
+    null_plugin_rsp = 1 << 3,
+    null_plugin_all = null_plugin_video | null_plugin_audio | null_plugin_input | null_plugin_rsp,
+} core_null_plugin;
+
 typedef struct
 {
     uint8_t init_PI_BSB_DOM1_LAT_REG;
@@ -796,6 +837,127 @@ struct core_st_callback_info
 
 using core_st_callback = std::function<void(const core_st_callback_info &, const std::vector<uint8_t> &)>;
 
+/**
+ * \brief The sections of a savestate file.
+ * \remarks Savestate files are <c>ChunkedFile</c> containers. The sections present in a file, joined in this order,
+ * form the uncompressed savestate buffer passed to <c>core_st_callback</c>. Tools can read a single section, e.g. the
+ * movie freeze data, without decompressing the rest of the file.
+ */
+typedef enum : uint32_t
+{
+    // The ROM's MD5 hash as 32 hex characters.
+    core_st_section_header = ChunkedFile::make_id("HEAD"),
+    // The RDRAM, MI, PI, SP, RSP, SI, VI, RI, AI, DPC and DPS registers.
+    core_st_section_registers = ChunkedFile::make_id("REGS"),
+    // The RDRAM contents.
+    core_st_section_rdram = ChunkedFile::make_id("RDRM"),
+    // The RSP memories, PIF RAM, flashram state and TLB lookup tables.
+    core_st_section_memory = ChunkedFile::make_id("MEMS"),
+    // The CPU registers, TLB entries, program counter and VI timing.
+    core_st_section_cpu = ChunkedFile::make_id("CPU "),
+    // The interrupt event queue, terminated by 0xFFFFFFFF.
+    core_st_section_event_queue = ChunkedFile::make_id("EVTQ"),
+    // Whether a movie was active, followed by its freeze data if so.
+    core_st_section_movie = ChunkedFile::make_id("MOVI"),
+    // The optional "SCR" screenshot section. Absent if no screenshot was taken.
+    core_st_section_screen = ChunkedFile::make_id("SCRN"),
+} core_st_section;
+
+/**
+ * \brief The version of the savestate files' contents.
+ */
+constexpr uint32_t core_st_version = 2;
+
+/**
+ * \brief The preview of a savestate file, which is stored in a small sidecar file next to it.
+ */
+typedef struct
+{
+    /// The amount of frames emulated since the ROM was started.
+    uint64_t total_frames;
+
+    /// The UID of the movie active when saving, or 0 if none was.
+    uint32_t movie_uid;
+
+    /// The movie's current sample when saving, or -1 if no movie was active.
+    int32_t movie_sample;
+
+    /// The movie's current VI when saving, or -1 if no movie was active.
+    int32_t movie_vi;
+
+    /// The time the savestate was saved at, in seconds since the Unix epoch.
+    int64_t timestamp;
+
+    /// The thumbnail's dimensions. Zero if the savestate has no thumbnail.
+    int32_t thumbnail_width;
+    int32_t thumbnail_height;
+
+    /// The thumbnail in the 24bpp format used by <c>copy_video</c>. Empty if the savestate has no thumbnail.
+    std::vector<uint8_t> thumbnail;
+} core_st_preview;
+
+#pragma endregion
+
+// #pragma region Desync Bisection
+// ==========================================
+
+/**
+ * \brief Parameters for a desync bisection.
+ */
+struct core_ds_params
+{
+    /// The movie to play back under both configurations.
+    std::filesystem::path movie_path{};
+
+    /// The reference configuration.
+    core_cfg cfg_a{};
+
+    /// The configuration to compare against the reference.
+    core_cfg cfg_b{};
+
+    /// The number of samples between the checkpoints hashed during the full playbacks. The diverging sample is then
+    /// bisected between the last matching checkpoint and the first differing one.
+    size_t checkpoint_interval = 300;
+
+    /// Whether the diverging frame is traced under both configurations to find the first diverging instruction. The
+    /// frame is traced on the pure interpreter, so divergences caused by the core type alone can't be pinpointed.
+    bool find_instruction = true;
+
+    /// The directory the instruction traces are written to. If empty, the system's temporary directory is used.
+    std::filesystem::path trace_directory{};
+};
+
+/**
+ * \brief The outcome of a desync bisection.
+ */
+struct core_ds_result
+{
+    core_result result{};
+
+    /// The first movie sample at which the machine states differ, or SIZE_MAX if the runs stayed in sync.
+    size_t frame = SIZE_MAX;
+
+    /// The state hashes of both configurations at the diverging frame.
+    uint64_t hash_a{};
+    uint64_t hash_b{};
+
+    /// The index of the first differing record within the traces of the frame leading up to the divergence, or
+    /// UINT64_MAX if no instruction could be determined.
+    uint64_t record = UINT64_MAX;
+
+    /// The PC and opcode of the first differing record in both traces.
+    uint32_t pc_a{};
+    uint32_t pc_b{};
+    uint32_t w_a{};
+    uint32_t w_b{};
+
+    /// The binary traces of the frame leading up to the divergence.
+    std::filesystem::path trace_path_a{};
+    std::filesystem::path trace_path_b{};
+};
+
+using core_ds_callback = std::function<void(const core_ds_result &)>;
+
 #pragma endregion
 
 // #pragma region Host API Types
@@ -42,9 +42,8 @@ void dma_pi_read()
             fseek(g_sram_file, 0, SEEK_SET);
             fread(sram, 1, 0x8000, g_sram_file);
 
-            for (i = 0; i < (pi_register.pi_rd_len_reg & 0xFFFFFF) + 1; i++)
-                sram[((pi_register.pi_cart_addr_reg - 0x08000000) + i) ^ S8] =
-                    ((unsigned char *)rdram)[(pi_register.pi_dram_addr_reg + i) ^ S8];
+            EndianUtils::xor_copy(sram, pi_register.pi_cart_addr_reg - 0x08000000, (uint8_t *)rdram,
+                                  pi_register.pi_dram_addr_reg, (pi_register.pi_rd_len_reg & 0xFFFFFF) + 1);
 
             fseek(g_sram_file, 0, SEEK_SET);
             fwrite(sram, 1, 0x8000, g_sram_file);
@@ -104,9 +103,9 @@ void dma_pi_write()
                 fseek(g_sram_file, 0, SEEK_SET);
                 fread(sram, 1, 0x8000, g_sram_file);
 
-                for (i = 0; i < (pi_register.pi_wr_len_reg & 0xFFFFFF) + 1; i++)
-                    ((unsigned char *)rdram)[(pi_register.pi_dram_addr_reg + i) ^ S8] =
-                        sram[(((pi_register.pi_cart_addr_reg - 0x08000000) & 0xFFFF) + i) ^ S8];
+                EndianUtils::xor_copy((uint8_t *)rdram, pi_register.pi_dram_addr_reg, sram,
+                                      (pi_register.pi_cart_addr_reg - 0x08000000) & 0xFFFF,
+                                      (pi_register.pi_wr_len_reg & 0xFFFFFF) + 1);
                 use_flashram = -1;
             }
             else
@@ -164,17 +163,29 @@ void dma_pi_write()
         return;
     }
 
-    if (!interpcore)
+    if (dbg_get_dma_read_enabled())
+    {
+        EndianUtils::xor_copy((uint8_t *)rdram, pi_register.pi_dram_addr_reg, rom,
+                              (pi_register.pi_cart_addr_reg - 0x10000000) & 0x3FFFFFF, longueur);
+    }
+    else
     {
         for (i = 0; i < longueur; i++)
         {
-            uint32_t rdram_address1 = pi_register.pi_dram_addr_reg + i + 0x80000000;
-            uint32_t rdram_address2 = pi_register.pi_dram_addr_reg + i + 0xa0000000;
+            ((unsigned char *)rdram)[(pi_register.pi_dram_addr_reg + i) ^ S8] = 0xFF;
+        }
+    }
 
-            ((unsigned char *)rdram)[(pi_register.pi_dram_addr_reg + i) ^ S8] =
-                !g_ctx.dbg_get_dma_read_enabled()
-                    ? 0xFF
-                    : rom[(((pi_register.pi_cart_addr_reg - 0x10000000) & 0x3FFFFFF) + i) ^ S8];
+    dma_notify_rsp(pi_register.pi_dram_addr_reg, longueur);
+
+    if (!interpcore)
+    {
+        // Every word touched by the DMA needs checking, not every byte.
+        const uint32_t first = pi_register.pi_dram_addr_reg & ~3;
+        for (uint32_t addr = first; addr < pi_register.pi_dram_addr_reg + longueur; addr += 4)
+        {
+            uint32_t rdram_address1 = addr + 0x80000000;
+            uint32_t rdram_address2 = addr + 0xa0000000;
 
             if (!invalid_code[rdram_address1 >> 12])
                 if (blocks[rdram_address1 >> 12]->block[(rdram_address1 & 0xFFF) / 4].ops != NOTCOMPILED)
@@ -185,16 +196,6 @@ void dma_pi_write()
                     invalid_code[rdram_address2 >> 12] = 1;
         }
     }
-    else
-    {
-        for (i = 0; i < longueur; i++)
-        {
-            ((unsigned char *)rdram)[(pi_register.pi_dram_addr_reg + i) ^ S8] =
-                !g_ctx.dbg_get_dma_read_enabled()
-                    ? 0xFF
-                    : rom[(((pi_register.pi_cart_addr_reg - 0x10000000) & 0x3FFFFFF) + i) ^ S8];
-        }
-    }
 
     /*for (i=0; i<=((longueur+0x800)>>12); i++)
       invalid_code[(((pi_register.pi_dram_addr_reg&0xFFFFFF)|0x80000000)>>12)+i] = 1;*/
@@ -223,35 +224,25 @@ void dma_pi_write()
 
 void dma_sp_write()
 {
-    int32_t i;
-    if ((sp_register.sp_mem_addr_reg & 0x1000) > 0)
-    {
-        for (i = 0; i < ((sp_register.sp_rd_len_reg & 0xFFF) + 1); i++)
-            ((unsigned char *)(SP_IMEM))[((sp_register.sp_mem_addr_reg & 0xFFF) + i) ^ S8] =
-                ((unsigned char *)(rdram))[((sp_register.sp_dram_addr_reg & 0xFFFFFF) + i) ^ S8];
-    }
-    else
-    {
-        for (i = 0; i < ((sp_register.sp_rd_len_reg & 0xFFF) + 1); i++)
-            ((unsigned char *)(SP_DMEM))[((sp_register.sp_mem_addr_reg & 0xFFF) + i) ^ S8] =
-                ((unsigned char *)(rdram))[((sp_register.sp_dram_addr_reg & 0xFFFFFF) + i) ^ S8];
-    }
+    auto mem = (uint8_t *)((sp_register.sp_mem_addr_reg & 0x1000) > 0 ? SP_IMEM : SP_DMEM);
+    EndianUtils::xor_copy(mem, sp_register.sp_mem_addr_reg & 0xFFF, (uint8_t *)rdram,
+                          sp_register.sp_dram_addr_reg & 0xFFFFFF, (sp_register.sp_rd_len_reg & 0xFFF) + 1);
+    dma_notify_rsp(0x04000000 | (sp_register.sp_mem_addr_reg & 0x1FFF), (sp_register.sp_rd_len_reg & 0xFFF) + 1);
 }
 
 void dma_sp_read()
 {
-    int32_t i;
-    if ((sp_register.sp_mem_addr_reg & 0x1000) > 0)
-    {
-        for (i = 0; i < ((sp_register.sp_wr_len_reg & 0xFFF) + 1); i++)
-            ((unsigned char *)(rdram))[((sp_register.sp_dram_addr_reg & 0xFFFFFF) + i) ^ S8] =
-                ((unsigned char *)(SP_IMEM))[((sp_register.sp_mem_addr_reg & 0xFFF) + i) ^ S8];
-    }
-    else
+    auto mem = (uint8_t *)((sp_register.sp_mem_addr_reg & 0x1000) > 0 ? SP_IMEM : SP_DMEM);
+    EndianUtils::xor_copy((uint8_t *)rdram, sp_register.sp_dram_addr_reg & 0xFFFFFF, mem,
+                          sp_register.sp_mem_addr_reg & 0xFFF, (sp_register.sp_wr_len_reg & 0xFFF) + 1);
+    dma_notify_rsp(sp_register.sp_dram_addr_reg & 0xFFFFFF, (sp_register.sp_wr_len_reg & 0xFFF) + 1);
+}
+
+void dma_notify_rsp(const uint32_t address, const uint32_t len)
+{
+    if (g_core->rsp_dma_written)
     {
-        for (i = 0; i < ((sp_register.sp_wr_len_reg & 0xFFF) + 1); i++)
-            ((unsigned char *)(rdram))[((sp_register.sp_dram_addr_reg & 0xFFFFFF) + i) ^ S8] =
-                ((unsigned char *)(SP_DMEM))[((sp_register.sp_mem_addr_reg & 0xFFF) + i) ^ S8];
+        g_core->rsp_dma_written(address, len);
     }
 }
 
@@ -266,7 +257,7 @@ void dma_si_write()
         critical_stop("Invalid SI register contents in dma_si_write");
         return;
     }
-    for (int32_t i = 0; i < (64 / 4); i++) PIF_RAM[i] = std::byteswap(rdram[si_register.si_dram_addr / 4 + i]);
+    EndianUtils::swap32(PIF_RAM, &rdram[si_register.si_dram_addr / 4], 64);
     update_pif_write();
     update_count();
     add_interrupt_event(SI_INT, /*0x100*/ 0x900);
@@ -287,7 +278,7 @@ void dma_si_read()
         return;
     }
 
-    for (int32_t i = 0; i < (64 / 4); i++) rdram[si_register.si_dram_addr / 4 + i] = std::byteswap(PIF_RAM[i]);
+    EndianUtils::swap32(&rdram[si_register.si_dram_addr / 4], PIF_RAM, 64);
 
     if (!g_st_skip_dma) // st already did this, see savestates.cpp, we still copy pif ram tho because it has new inputs
     {
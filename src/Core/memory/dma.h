@@ -12,3 +12,10 @@ void dma_si_write();
 void dma_si_read();
 void dma_sp_write();
 void dma_sp_read();
+
+/**
+ * \brief Tells the RSP plugin that memory was written.
+ * \param address The physical address of the first byte written.
+ * \param len The amount of bytes written.
+ */
+void dma_notify_rsp(uint32_t address, uint32_t len);
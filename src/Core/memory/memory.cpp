@@ -16,8 +16,10 @@
 #include <r4300/ops.h>
 #include <r4300/r4300.h>
 #include <r4300/recomph.h>
+#include <r4300/rom.h>
 #include <r4300/timers.h>
 #include <r4300/vcr.h>
+#include <null_plugins.h>
 
 static int32_t frame;
 
@@ -1130,9 +1132,17 @@ void update_SP()
             // screen_updates and thus are stuck in incorrect state
             g_total_frames++;
             g_core->cfg->total_frames++;
-            g_vr_frame_skipped = vcr_is_frame_skipped();
-            if (!g_vr_frame_skipped)
+            // Without a video plugin, no frame is ever shown.
+            g_vr_frame_skipped = null_plugin_active(null_plugin_video) || vcr_is_frame_skipped();
+
+            // Frames which are never shown aren't processed at all, unless the game reads them back. The video plugin
+            // is still told about them then, so it can skip the rasterization.
+            if (!g_vr_frame_skipped || (rom_depends_on_frame_buffer() && !null_plugin_active(null_plugin_video)))
             {
+                if (g_core->video_set_frame_hidden)
+                {
+                    g_core->video_set_frame_hidden(g_vr_frame_skipped);
+                }
                 g_core->rsp_do_rsp_cycles(100);
             }
 
@@ -1211,7 +1221,7 @@ void update_SP()
             // processAList();
             rsp_register.rsp_pc &= 0xFFF;
 
-            if (!g_vr_fast_forward || !g_core->cfg->fastforward_silent)
+            if ((!g_vr_fast_forward || !g_core->cfg->fastforward_silent) && !null_plugin_active(null_plugin_audio))
             {
                 g_core->rsp_do_rsp_cycles(100);
             }
@@ -2487,6 +2497,17 @@ void read_aid()
     *rdword = ((uint64_t)(*readai[*address_low]) << 32) | *readai[*address_low + 4];
 }
 
+static void ai_len_changed()
+{
+    // Without an audio plugin, nobody tracks the buffer lengths.
+    if (!null_plugin_active(null_plugin_audio))
+    {
+        g_core->audio_ai_len_changed();
+        audio_thread_notify();
+    }
+    g_core->events.publish<core_event::ai_len_changed>();
+}
+
 void write_ai()
 {
     uint32_t delay = 0;
@@ -2494,8 +2515,7 @@ void write_ai()
     {
     case 0x4:
         ai_register.ai_len = word;
-        g_core->audio_ai_len_changed();
-        g_core->callbacks.ai_len_changed();
+        ai_len_changed();
         switch (ROM_HEADER.Country_code & 0xFF)
         {
         case 0x44:
@@ -2546,7 +2566,7 @@ void write_ai()
         {
             ai_register.ai_dacrate = word;
             g_core->audio_ai_dacrate_changed(g_sys_type);
-            g_core->callbacks.dacrate_changed(g_sys_type);
+            g_core->events.publish<core_event::dacrate_changed>(g_sys_type);
         }
         return;
         break;
@@ -2567,8 +2587,7 @@ void write_aib()
         temp = ai_register.ai_len;
         *((unsigned char *)&temp + ((*address_low & 3) ^ S8)) = g_byte;
         ai_register.ai_len = temp;
-        g_core->audio_ai_len_changed();
-        g_core->callbacks.ai_len_changed();
+        ai_len_changed();
         switch (ROM_HEADER.Country_code & 0xFF)
         {
         case 0x44:
@@ -2625,7 +2644,7 @@ void write_aib()
         {
             ai_register.ai_dacrate = temp;
             g_core->audio_ai_dacrate_changed(g_sys_type);
-            g_core->callbacks.dacrate_changed(g_sys_type);
+            g_core->events.publish<core_event::dacrate_changed>(g_sys_type);
         }
         return;
         break;
@@ -2644,8 +2663,7 @@ void write_aih()
         temp = ai_register.ai_len;
         *((uint16_t *)((unsigned char *)&temp + ((*address_low & 3) ^ S16))) = hword;
         ai_register.ai_len = temp;
-        g_core->audio_ai_len_changed();
-        g_core->callbacks.ai_len_changed();
+        ai_len_changed();
         switch (ROM_HEADER.Country_code & 0xFF)
         {
         case 0x44:
@@ -2698,7 +2716,7 @@ void write_aih()
         {
             ai_register.ai_dacrate = temp;
             g_core->audio_ai_dacrate_changed(g_sys_type);
-            g_core->callbacks.dacrate_changed(g_sys_type);
+            g_core->events.publish<core_event::dacrate_changed>(g_sys_type);
         }
         return;
         break;
@@ -2714,8 +2732,7 @@ void write_aid()
     case 0x0:
         ai_register.ai_dram_addr = dword >> 32;
         ai_register.ai_len = dword & 0xFFFFFFFF;
-        g_core->audio_ai_len_changed();
-        g_core->callbacks.ai_len_changed();
+        ai_len_changed();
         switch (ROM_HEADER.Country_code & 0xFF)
         {
         case 0x44:
@@ -2765,7 +2782,7 @@ void write_aid()
         {
             ai_register.ai_dacrate = dword >> 32;
             g_core->audio_ai_dacrate_changed(g_sys_type);
-            g_core->callbacks.dacrate_changed(g_sys_type);
+            g_core->events.publish<core_event::dacrate_changed>(g_sys_type);
         }
         ai_register.ai_bitrate = dword & 0xFFFFFFFF;
         return;
@@ -17,6 +17,30 @@
 // Amount of VIs since last input poll
 size_t lag_count;
 
+// The controller states reported by the plugin during the current poll, if it can report all of them at once.
+static struct
+{
+    bool polling;
+    bool taken;
+    core_buttons keys[4];
+} key_snapshot;
+
+void pif_get_keys(const int32_t index, core_buttons *keys)
+{
+    if (!g_core->input_get_all_keys)
+    {
+        g_core->input_get_keys(index, keys);
+        return;
+    }
+
+    if (!key_snapshot.taken)
+    {
+        g_core->input_get_all_keys(key_snapshot.keys);
+        key_snapshot.taken = key_snapshot.polling;
+    }
+    *keys = key_snapshot.keys[index];
+}
+
 #ifdef DEBUG_PIF
 void print_pif()
 {
@@ -285,13 +309,16 @@ void update_pif_write()
         switch (PIF_RAMb[0x3F])
         {
         case 0x02:
-            for (i = 0; i < sizeof(g_pif_lut) / 32; i++)
+        {
+            uint8_t *challenge = PIF_RAMb + 64 - CIC_CHALLENGE_SIZE;
+            if (const uint8_t *response = pif_lut_find(challenge))
             {
-                if (!memcmp(PIF_RAMb + 64 - 2 * 8, g_pif_lut[i][0], 16))
-                {
-                    memcpy(PIF_RAMb + 64 - 2 * 8, g_pif_lut[i][1], 16);
-                    return;
-                }
+                memcpy(challenge, response, CIC_CHALLENGE_SIZE);
+                return;
+            }
+            if (g_cic_solver && g_cic_solver(challenge, challenge))
+            {
+                return;
             }
             g_core->log_info("unknown pif2 code:");
             for (i = (64 - 2 * 8) / 8; i < (64 / 8); i++)
@@ -302,6 +329,7 @@ void update_pif_write()
                                              PIF_RAMb[i * 8 + 6], PIF_RAMb[i * 8 + 7]));
             }
             break;
+        }
         case 0x08:
             PIF_RAMb[0x3F] = 0;
             break;
@@ -362,6 +390,13 @@ void update_pif_read()
     bool once = emu_paused || (frame_advance_outstanding > 0) ||
                 g_wait_counter; // used to pause only once during controller routine
     bool stAllowed = true;      // used to disallow .st being loaded after any controller has already been read
+
+    // The snapshot is taken on the first read, so it sees the input entered while paused for frame advance.
+    struct snapshot_scope
+    {
+        snapshot_scope() { key_snapshot = {.polling = true}; }
+        ~snapshot_scope() { key_snapshot = {}; }
+    } snapshot;
 #ifdef DEBUG_PIF
     g_core->log_info("---------- before read ----------");
     print_pif();
@@ -425,7 +460,7 @@ void update_pif_read()
                         {
                             std::this_thread::sleep_for(std::chrono::milliseconds(10));
 
-                            g_core->callbacks.interval();
+                            g_core->events.publish<core_event::interval>();
 
                             if (stAllowed)
                             {
@@ -451,11 +486,11 @@ void update_pif_read()
                     // we handle raw data-mode controllers here:
                     // this is incompatible with VCR!
                     if (g_core->controls[channel].Present && g_core->controls[channel].RawData &&
-                        g_ctx.vcr_get_task() == task_idle)
+                        vcr_get_task() == task_idle)
                     {
                         g_core->input_read_controller(channel, &PIF_RAMb[i]);
                         auto ptr = (core_buttons *)&PIF_RAMb[i + 3];
-                        g_core->callbacks.input(ptr, channel);
+                        g_core->events.publish<core_event::input>(ptr, channel);
                     }
                     else
                         internal_ReadController(channel, &PIF_RAMb[i]);
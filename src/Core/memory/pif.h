@@ -9,4 +9,11 @@
 void update_pif_write();
 void update_pif_read();
 
+/**
+ * \brief Gets a controller's state from the input plugin.
+ * \remarks If the plugin can report all controllers at once, it's asked once per controller poll and the states of
+ * the other controllers are reused for the rest of the poll.
+ */
+void pif_get_keys(int32_t index, core_buttons *keys);
+
 extern size_t lag_count;
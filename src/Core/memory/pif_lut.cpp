@@ -7,7 +7,11 @@
 #include <CommonPCH.h>
 #include "pif_lut.h"
 
-const uint8_t g_pif_lut[269][2][16] = {
+/**
+ * \brief The known CIC challenges and their responses. Some of the responses differ from what the CIC-NUS-6105
+ * algorithm yields, so the table takes precedence over it.
+ */
+static constexpr uint8_t PIF_LUT[][2][CIC_CHALLENGE_SIZE] = {
     {{0xEC, 0x3C, 0xB6, 0x76, 0xB8, 0x1D, 0xBB, 0x8F, 0x6B, 0x3A, 0x80, 0xEC, 0xED, 0xEA, 0x5B, 0x02},
      {0x13, 0x6A, 0xF7, 0x4C, 0xDB, 0x4F, 0xB0, 0xDE, 0x45, 0x40, 0xC6, 0x4A, 0xE7, 0x73, 0x0B, 0x00}},
 
@@ -814,3 +818,113 @@ const uint8_t g_pif_lut[269][2][16] = {
 
     {{0xAA, 0x00, 0x6A, 0x00, 0x1A, 0x00, 0x06, 0x00, 0x01, 0x00, 0x80, 0x00, 0xA0, 0x00, 0x00, 0x02},
      {0xD5, 0x55, 0x39, 0x99, 0xEE, 0x6E, 0xC4, 0xE6, 0xE1, 0x71, 0xF9, 0xF9, 0x17, 0x17, 0x17, 0x00}}};
+
+static constexpr uint32_t hash_challenge(const uint8_t *challenge)
+{
+    // FNV-1a
+    uint32_t hash = 0x811C9DC5;
+    for (size_t i = 0; i < CIC_CHALLENGE_SIZE; ++i)
+    {
+        hash = (hash ^ challenge[i]) * 0x01000193;
+    }
+    return hash;
+}
+
+static constexpr bool challenges_equal(const uint8_t *a, const uint8_t *b)
+{
+    for (size_t i = 0; i < CIC_CHALLENGE_SIZE; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static constexpr size_t PIF_HASH_SIZE = std::bit_ceil(std::size(PIF_LUT) * 2);
+static constexpr uint16_t PIF_HASH_EMPTY = UINT16_MAX;
+
+/**
+ * \brief An open-addressing hash table of indices into <c>PIF_LUT</c>, built at compile time.
+ * \remarks Only the first entry of a challenge is inserted, so lookups find the same response as a linear scan would.
+ */
+static constexpr auto PIF_HASH = [] {
+    std::array<uint16_t, PIF_HASH_SIZE> table{};
+    table.fill(PIF_HASH_EMPTY);
+
+    for (size_t i = 0; i < std::size(PIF_LUT); ++i)
+    {
+        size_t slot = hash_challenge(PIF_LUT[i][0]) & (PIF_HASH_SIZE - 1);
+        while (table[slot] != PIF_HASH_EMPTY && !challenges_equal(PIF_LUT[table[slot]][0], PIF_LUT[i][0]))
+        {
+            slot = (slot + 1) & (PIF_HASH_SIZE - 1);
+        }
+        if (table[slot] == PIF_HASH_EMPTY)
+        {
+            table[slot] = static_cast<uint16_t>(i);
+        }
+    }
+    return table;
+}();
+
+cic_solver g_cic_solver = pif_cic_6105_solve;
+
+const uint8_t *pif_lut_find(const uint8_t *challenge)
+{
+    size_t slot = hash_challenge(challenge) & (PIF_HASH_SIZE - 1);
+    while (PIF_HASH[slot] != PIF_HASH_EMPTY)
+    {
+        const auto &entry = PIF_LUT[PIF_HASH[slot]];
+        if (memcmp(entry[0], challenge, CIC_CHALLENGE_SIZE) == 0)
+        {
+            return entry[1];
+        }
+        slot = (slot + 1) & (PIF_HASH_SIZE - 1);
+    }
+    return nullptr;
+}
+
+bool pif_cic_6105_solve(const uint8_t *challenge, uint8_t *response)
+{
+    static constexpr uint8_t LUT0[16] = {0x4, 0x7, 0xA, 0x7, 0xE, 0x5, 0xE, 0x1,
+                                         0xC, 0xF, 0x8, 0xF, 0x6, 0x3, 0x6, 0x9};
+    static constexpr uint8_t LUT1[16] = {0x4, 0x1, 0xA, 0x7, 0xE, 0x5, 0xE, 0x1,
+                                         0xC, 0x9, 0x8, 0x5, 0x6, 0x3, 0xC, 0x9};
+
+    // The chip works on the nibbles of the first 15 bytes; the last byte holds the command.
+    uint8_t nibbles[30];
+    for (size_t i = 0; i < 15; ++i)
+    {
+        nibbles[i * 2] = challenge[i] >> 4;
+        nibbles[i * 2 + 1] = challenge[i] & 0xF;
+    }
+
+    uint8_t key = 0xB;
+    const uint8_t *lut = LUT0;
+    for (auto &nibble : nibbles)
+    {
+        nibble = (key + 5 * nibble) & 0xF;
+        key = lut[nibble];
+
+        const bool sign = nibble & 0x8;
+        const int magnitude = (sign ? ~nibble : nibble) & 0x7;
+        bool mod = magnitude % 3 == 1 ? sign : !sign;
+        if (lut == LUT1 && (nibble == 0x1 || nibble == 0x9))
+        {
+            mod = true;
+        }
+        if (lut == LUT1 && (nibble == 0xB || nibble == 0xE))
+        {
+            mod = false;
+        }
+        lut = mod ? LUT1 : LUT0;
+    }
+
+    for (size_t i = 0; i < 15; ++i)
+    {
+        response[i] = static_cast<uint8_t>(nibbles[i * 2] << 4 | nibbles[i * 2 + 1]);
+    }
+    response[15] = 0;
+    return true;
+}
@@ -6,4 +6,33 @@
 
 #pragma once
 
-extern const uint8_t g_pif_lut[269][2][16];
+/**
+ * \brief The size of a CIC challenge and its response in bytes. Both occupy the end of PIF RAM.
+ */
+constexpr size_t CIC_CHALLENGE_SIZE = 16;
+
+/**
+ * \brief Computes the response to a CIC challenge.
+ * \param challenge The challenge.
+ * \param response The buffer receiving the response. May be the same as <c>challenge</c>.
+ * \return Whether the response could be computed.
+ */
+using cic_solver = bool (*)(const uint8_t *challenge, uint8_t *response);
+
+/**
+ * \brief Looks up the response to a CIC challenge in the table of known challenges.
+ * \param challenge The challenge.
+ * \return The response, or nullptr if the challenge isn't in the table.
+ */
+const uint8_t *pif_lut_find(const uint8_t *challenge);
+
+/**
+ * \brief Computes the response to a challenge with the algorithm of the CIC-NUS-6105.
+ */
+bool pif_cic_6105_solve(const uint8_t *challenge, uint8_t *response);
+
+/**
+ * \brief The solver for challenges which aren't in the table, or nullptr if those are left unanswered.
+ * Defaults to <c>pif_cic_6105_solve</c>.
+ */
+extern cic_solver g_cic_solver;
@@ -7,16 +7,18 @@
 #include <CommonPCH.h>
 #include <Core.h>
 // #include <PlatformService.h>
-#include <libdeflate.h>
 #include <include/core_api.h>
+#include <memory/dma.h>
 #include <memory/flashram.h>
 #include <memory/memory.h>
 #include <memory/savestates.h>
+#include <memory/st_preview.h>
 #include <memory/summercart.h>
 #include <r4300/interrupt.h>
 #include <r4300/r4300.h>
 #include <r4300/rom.h>
 #include <r4300/vcr.h>
+#include <null_plugins.h>
 
 constexpr auto RDRAM_DEVICE_MANUF_NEW_FIX_BIT = (1 << 31);
 
@@ -65,6 +67,30 @@ uint8_t g_first_block[0xA02BB4 - 32]{};
 
 // The undo savestate buffer.
 std::vector<uint8_t> g_undo_savestate;
+
+// The sections of a savestate file, in the order they appear in the uncompressed savestate, and how they're stored.
+constexpr std::pair<core_st_section, ChunkedFile::compression_method> st_sections[] = {
+    {core_st_section_header, ChunkedFile::compression_method::none},
+    {core_st_section_registers, ChunkedFile::compression_method::none},
+    {core_st_section_rdram, ChunkedFile::compression_method::deflate},
+    {core_st_section_memory, ChunkedFile::compression_method::deflate},
+    {core_st_section_cpu, ChunkedFile::compression_method::none},
+    {core_st_section_event_queue, ChunkedFile::compression_method::none},
+    {core_st_section_movie, ChunkedFile::compression_method::deflate},
+    {core_st_section_screen, ChunkedFile::compression_method::deflate},
+};
+
+// The end offsets of the sections in an uncompressed savestate.
+using st_section_ends = std::array<size_t, std::size(st_sections)>;
+
+// A copy of the screen in the 24bpp format.
+struct st_frame
+{
+    std::vector<uint8_t> pixels;
+    int32_t width{};
+    int32_t height{};
+};
+
 void get_paths_for_task(const t_savestate_task &task, std::filesystem::path &st_path, std::filesystem::path &sd_path)
 {
     sd_path = g_core->get_saves_directory() / (const char *)ROM_HEADER.nom;
@@ -93,6 +119,8 @@ void load_memory_from_buffer(uint8_t *p)
     MiscHelpers::memread(&p, SP_DMEM, 0x1000);
     MiscHelpers::memread(&p, SP_IMEM, 0x1000);
     MiscHelpers::memread(&p, PIF_RAM, 0x40);
+    dma_notify_rsp(0, 0x800000);
+    dma_notify_rsp(0x04000000, 0x2000);
 
     char buf[4 * 32];
     MiscHelpers::memread(&p, buf, 24);
@@ -129,9 +157,40 @@ void load_memory_from_buffer(uint8_t *p)
     MiscHelpers::memread(&p, &vi_field, 4);
 }
 
-std::vector<uint8_t> generate_savestate()
+/**
+ * \brief Copies the screen. The frame is left empty if video capture isn't available.
+ */
+st_frame capture_frame()
+{
+    st_frame frame;
+    if (null_plugin_active(null_plugin_video) || !g_core->mge_available())
+    {
+        return frame;
+    }
+
+    g_core->video_get_video_size(&frame.width, &frame.height);
+    frame.pixels.resize(frame.width * frame.height * 3);
+    g_core->copy_video(frame.pixels.data());
+    return frame;
+}
+
+/**
+ * \brief Generates an uncompressed savestate.
+ * \param frame The screen, which is stored in the savestate if screenshots are enabled. May be empty.
+ * \param section_ends If not null, receives the end offsets of the savestate's sections.
+ * \param preview If not null, receives the savestate's metadata. The thumbnail and timestamp aren't set.
+ */
+std::vector<uint8_t> generate_savestate(const st_frame &frame, st_section_ends *section_ends = nullptr,
+                                        core_st_preview *preview = nullptr)
 {
     std::vector<uint8_t> b;
+    size_t section = 0;
+    const auto end_section = [&] {
+        if (section_ends)
+        {
+            (*section_ends)[section++] = b.size();
+        }
+    };
 
     b.reserve(0xB624F0);
 
@@ -141,13 +200,21 @@ std::vector<uint8_t> generate_savestate()
     vcr_freeze_info freeze{};
     uint32_t movie_active = vcr_freeze(freeze);
 
+    if (preview)
+    {
+        preview->total_frames = g_total_frames;
+        preview->movie_uid = movie_active ? freeze.uid : 0;
+        preview->movie_sample = movie_active ? static_cast<int32_t>(freeze.current_sample) : -1;
+        preview->movie_vi = movie_active ? static_cast<int32_t>(freeze.current_vi) : -1;
+    }
+
     // NOTE: Some savestates don't have an SI interrupt in the queue, which means that a dma_si_read call which should
     // have happened prior to the save didn't happen. In that case, we "finish up" the dma by performing its final part
     // manually.
     if (get_event(SI_INT) == 0)
     {
         g_core->log_warn("[ST] Finishing up DMA...");
-        for (size_t i = 0; i < 64 / 4; i++) rdram[si_register.si_dram_addr / 4 + i] = std::byteswap(PIF_RAM[i]);
+        EndianUtils::swap32(&rdram[si_register.si_dram_addr / 4], PIF_RAM, 64);
         update_count();
         add_interrupt_event(SI_INT, 0x900);
         g_st_skip_dma = true;
@@ -159,6 +226,7 @@ std::vector<uint8_t> generate_savestate()
     const int32_t event_queue_len = save_eventqueue_infos(g_event_queue_buf);
 
     MiscHelpers::vecwrite(b, rom_md5, 32);
+    end_section();
     MiscHelpers::vecwrite(b, &rdram_register, sizeof(core_rdram_reg));
     MiscHelpers::vecwrite(b, &MI_register, sizeof(core_mips_reg));
     MiscHelpers::vecwrite(b, &pi_register, sizeof(core_pi_reg));
@@ -170,13 +238,16 @@ std::vector<uint8_t> generate_savestate()
     MiscHelpers::vecwrite(b, &ai_register, sizeof(core_ai_reg));
     MiscHelpers::vecwrite(b, &dpc_register, sizeof(core_dpc_reg));
     MiscHelpers::vecwrite(b, &dps_register, sizeof(core_dps_reg));
+    end_section();
     MiscHelpers::vecwrite(b, rdram, 0x800000);
+    end_section();
     MiscHelpers::vecwrite(b, SP_DMEM, 0x1000);
     MiscHelpers::vecwrite(b, SP_IMEM, 0x1000);
     MiscHelpers::vecwrite(b, PIF_RAM, 0x40);
     MiscHelpers::vecwrite(b, g_flashram_buf, 24);
     MiscHelpers::vecwrite(b, tlb_LUT_r, 0x100000);
     MiscHelpers::vecwrite(b, tlb_LUT_w, 0x100000);
+    end_section();
     MiscHelpers::vecwrite(b, &llbit, 4);
     MiscHelpers::vecwrite(b, reg, 32 * 8);
     for (size_t i = 0; i < 32; i++)
@@ -194,7 +265,9 @@ std::vector<uint8_t> generate_savestate()
     MiscHelpers::vecwrite(b, &next_interrupt, 4);
     MiscHelpers::vecwrite(b, &next_vi, 4);
     MiscHelpers::vecwrite(b, &vi_field, 4);
+    end_section();
     MiscHelpers::vecwrite(b, g_event_queue_buf, event_queue_len);
+    end_section();
     MiscHelpers::vecwrite(b, &movie_active, sizeof(movie_active));
     if (movie_active)
     {
@@ -205,33 +278,88 @@ std::vector<uint8_t> generate_savestate()
         MiscHelpers::vecwrite(b, &freeze.length_samples, sizeof(freeze.length_samples));
         MiscHelpers::vecwrite(b, freeze.input_buffer.data(), freeze.input_buffer.size() * sizeof(core_buttons));
     }
+    end_section();
 
-    if (g_core->mge_available() && g_core->cfg->st_screenshot)
+    if (g_core->cfg->st_screenshot && !frame.pixels.empty())
     {
-        int32_t width;
-        int32_t height;
-        g_core->video_get_video_size(&width, &height);
-        g_core->log_trace(std::format("Writing screen buffer to savestate, width: {}, height: {}", width, height));
-
-        void *video = malloc(width * height * 3);
-        g_core->copy_video(video);
+        g_core->log_trace(
+            std::format("Writing screen buffer to savestate, width: {}, height: {}", frame.width, frame.height));
 
         MiscHelpers::vecwrite(b, screen_section, sizeof(screen_section));
-        MiscHelpers::vecwrite(b, &width, sizeof(width));
-        MiscHelpers::vecwrite(b, &height, sizeof(height));
-        MiscHelpers::vecwrite(b, video, width * height * 3);
-
-        free(video);
+        MiscHelpers::vecwrite(b, &frame.width, sizeof(frame.width));
+        MiscHelpers::vecwrite(b, &frame.height, sizeof(frame.height));
+        MiscHelpers::vecwrite(b, frame.pixels.data(), frame.pixels.size());
     }
+    end_section();
 
     return b;
 }
 
+/**
+ * \brief Lays out an uncompressed savestate as a savestate file, storing each section separately.
+ */
+std::vector<uint8_t> savestate_to_container(const std::vector<uint8_t> &st, const st_section_ends &section_ends)
+{
+    ChunkedFile::writer writer(core_st_version);
+    size_t start = 0;
+    for (size_t i = 0; i < std::size(st_sections); ++i)
+    {
+        const auto [id, compression] = st_sections[i];
+        const auto end = section_ends[i];
+        if (end > start)
+        {
+            writer.add(id, std::span(st).subspan(start, end - start), compression);
+        }
+        start = end;
+    }
+    return writer.finish();
+}
+
+/**
+ * \brief Joins the sections of a savestate file into an uncompressed savestate.
+ * \return Whether all sections were read. Only the screen section may be missing.
+ */
+bool savestate_from_container(ChunkedFile::reader &reader, std::vector<uint8_t> &st)
+{
+    if (reader.content_version() != core_st_version)
+    {
+        return false;
+    }
+
+    size_t size = 0;
+    for (const auto &section : reader.sections())
+    {
+        size += section.size;
+    }
+
+    st.clear();
+    st.reserve(size);
+    std::vector<uint8_t> data;
+    for (const auto id : st_sections | std::views::keys)
+    {
+        if (!reader.find(id) && id == core_st_section_screen)
+        {
+            continue;
+        }
+        if (!reader.read(id, data))
+        {
+            return false;
+        }
+        st.insert(st.end(), data.begin(), data.end());
+    }
+    return true;
+}
+
 void savestates_save_immediate_impl(const t_savestate_task &task)
 {
     // TODO: Reimplement timing
 
-    const auto st = generate_savestate();
+    const bool write_preview = task.medium == core_st_medium_path && g_core->cfg->st_preview;
+    auto frame = g_core->cfg->st_screenshot || write_preview ? capture_frame() : st_frame{};
+
+    st_section_ends section_ends{};
+    core_st_preview preview{};
+    const auto st = generate_savestate(frame, &section_ends, &preview);
 
     if (task.medium == core_st_medium_path)
     {
@@ -241,18 +369,9 @@ void savestates_save_immediate_impl(const t_savestate_task &task)
         get_paths_for_task(task, new_st_path, new_sd_path);
         if (g_core->cfg->use_summercart) save_summercart(new_sd_path);
 
-        // Generate compressed buffer
-        std::vector<uint8_t> compressed_buffer;
-        compressed_buffer.resize(st.size());
-
-        const auto compressor = libdeflate_alloc_compressor(6);
-        const size_t final_size = libdeflate_gzip_compress(compressor, st.data(), st.size(), compressed_buffer.data(),
-                                                           compressed_buffer.size());
-        libdeflate_free_compressor(compressor);
-        compressed_buffer.resize(final_size);
+        auto container = savestate_to_container(st, section_ends);
 
-        // write compressed st to disk
-        if (!IOUtils::write_entire_file(new_st_path, compressed_buffer))
+        if (container.empty() || !IOUtils::write_entire_file(new_st_path, container))
         {
             task.callback(
                 core_st_callback_info{
@@ -260,11 +379,29 @@ void savestates_save_immediate_impl(const t_savestate_task &task)
                 st);
             return;
         }
+
+        // The thumbnail is downscaled, compressed and written in the background, so previews cost the save no more
+        // than copying the screen.
+        if (write_preview)
+        {
+            preview.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+            st_preview_write_async(new_st_path, std::move(preview), std::move(frame.pixels), frame.width,
+                                   frame.height);
+        }
+        else
+        {
+            // A preview left over from an earlier save would describe another state.
+            st_preview_wait();
+            std::error_code ec;
+            std::filesystem::remove(st_preview_path(new_st_path), ec);
+        }
     }
 
     task.callback(
         core_st_callback_info{.result = Res_Ok, .job = task.job, .medium = task.medium, .params = task.params}, st);
-    g_core->callbacks.save_state();
+    g_core->events.publish<core_event::save_state>();
 }
 
 void savestates_load_immediate_impl(const t_savestate_task &task)
@@ -305,7 +442,21 @@ void savestates_load_immediate_impl(const t_savestate_task &task)
         return;
     }
 
-    std::vector<uint8_t> decompressed_buf = MiscHelpers::auto_decompress(st_buf, 0xB624F0);
+    // Savestate files are containers since version 2. Older ones are the whole savestate, optionally gzipped.
+    std::vector<uint8_t> decompressed_buf;
+    if (ChunkedFile::is_container(st_buf))
+    {
+        ChunkedFile::reader reader;
+        if (!reader.open(st_buf) || !savestate_from_container(reader, decompressed_buf))
+        {
+            decompressed_buf.clear();
+        }
+    }
+    else
+    {
+        decompressed_buf = MiscHelpers::auto_decompress(st_buf, 0xB624F0);
+    }
+
     if (decompressed_buf.empty())
     {
         task.callback(
@@ -476,7 +627,7 @@ void savestates_load_immediate_impl(const t_savestate_task &task)
 
         // NOTE: We don't want to restore screen buffer while seeking, since it creates a int16_t ugly flicker when the
         // movie restarts by loading state
-        if (g_core->mge_available() && video_buffer && !vcr_is_seeking())
+        if (!null_plugin_active(null_plugin_video) && g_core->mge_available() && video_buffer && !vcr_is_seeking())
         {
             int32_t current_width, current_height;
             g_core->video_get_video_size(&current_width, &current_height);
@@ -488,7 +639,7 @@ void savestates_load_immediate_impl(const t_savestate_task &task)
         }
     }
 
-    g_core->callbacks.load_state();
+    g_core->events.publish<core_event::load_state>();
     task.callback(
         core_st_callback_info{.result = Res_Ok, .job = task.job, .medium = task.medium, .params = task.params},
         decompressed_buf);
@@ -689,6 +840,7 @@ void st_on_core_stop()
     std::scoped_lock lock(g_task_mutex);
     g_tasks.clear();
     g_undo_savestate.clear();
+    st_preview_wait();
 }
 
 /**
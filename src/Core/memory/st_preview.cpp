@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include <Core.h>
+#include <future>
+#include <memory/st_preview.h>
+
+constexpr uint32_t PREVIEW_VERSION = 1;
+constexpr auto METADATA_SECTION = ChunkedFile::make_id("META");
+constexpr auto THUMBNAIL_SECTION = ChunkedFile::make_id("THMB");
+
+// The last preview write, which the next one waits for so previews of the same slot land in order.
+std::future<void> g_preview_write;
+std::mutex g_preview_write_mutex;
+
+std::filesystem::path st_preview_path(const std::filesystem::path &st_path)
+{
+    auto path = st_path;
+    path += ".preview";
+    return path;
+}
+
+void st_preview_set_thumbnail(core_st_preview &preview, const uint8_t *frame, const int32_t width,
+                              const int32_t height)
+{
+    preview.thumbnail.clear();
+    preview.thumbnail_width = 0;
+    preview.thumbnail_height = 0;
+    if (!frame || width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    const int32_t factor = std::max((width + ST_THUMBNAIL_MAX_WIDTH - 1) / ST_THUMBNAIL_MAX_WIDTH,
+                                    (height + ST_THUMBNAIL_MAX_HEIGHT - 1) / ST_THUMBNAIL_MAX_HEIGHT);
+    preview.thumbnail_width = std::max(width / factor, 1);
+    preview.thumbnail_height = std::max(height / factor, 1);
+    preview.thumbnail.resize(preview.thumbnail_width * preview.thumbnail_height * 3);
+
+    const int32_t block_width = std::min(factor, width);
+    const int32_t block_height = std::min(factor, height);
+    const uint32_t block_size = block_width * block_height;
+    auto out = preview.thumbnail.data();
+    for (int32_t y = 0; y < preview.thumbnail_height; ++y)
+    {
+        for (int32_t x = 0; x < preview.thumbnail_width; ++x)
+        {
+            uint32_t sum[3]{};
+            for (int32_t by = 0; by < block_height; ++by)
+            {
+                const auto row = frame + ((y * factor + by) * width + x * factor) * 3;
+                for (int32_t i = 0; i < block_width * 3; i += 3)
+                {
+                    sum[0] += row[i];
+                    sum[1] += row[i + 1];
+                    sum[2] += row[i + 2];
+                }
+            }
+            for (const auto channel : sum)
+            {
+                *out++ = static_cast<uint8_t>(channel / block_size);
+            }
+        }
+    }
+}
+
+bool st_preview_write(const std::filesystem::path &st_path, const core_st_preview &preview)
+{
+    std::vector<uint8_t> metadata;
+    MiscHelpers::vecwrite(metadata, &preview.total_frames, sizeof(preview.total_frames));
+    MiscHelpers::vecwrite(metadata, &preview.movie_uid, sizeof(preview.movie_uid));
+    MiscHelpers::vecwrite(metadata, &preview.movie_sample, sizeof(preview.movie_sample));
+    MiscHelpers::vecwrite(metadata, &preview.movie_vi, sizeof(preview.movie_vi));
+    MiscHelpers::vecwrite(metadata, &preview.timestamp, sizeof(preview.timestamp));
+    MiscHelpers::vecwrite(metadata, &preview.thumbnail_width, sizeof(preview.thumbnail_width));
+    MiscHelpers::vecwrite(metadata, &preview.thumbnail_height, sizeof(preview.thumbnail_height));
+
+    ChunkedFile::writer writer(PREVIEW_VERSION);
+    writer.add(METADATA_SECTION, metadata, ChunkedFile::compression_method::none);
+    if (!preview.thumbnail.empty())
+    {
+        writer.add(THUMBNAIL_SECTION, preview.thumbnail, ChunkedFile::compression_method::deflate);
+    }
+
+    auto file = writer.finish();
+    return !file.empty() && IOUtils::write_entire_file(st_preview_path(st_path), file);
+}
+
+void st_preview_write_async(const std::filesystem::path &st_path, core_st_preview preview, std::vector<uint8_t> frame,
+                            const int32_t width, const int32_t height)
+{
+    std::lock_guard lock(g_preview_write_mutex);
+    g_preview_write = std::async(std::launch::async, [=, previous = std::move(g_preview_write),
+                                                      preview = std::move(preview), frame = std::move(frame)] mutable {
+        if (previous.valid())
+        {
+            previous.wait();
+        }
+
+        st_preview_set_thumbnail(preview, frame.empty() ? nullptr : frame.data(), width, height);
+        if (!st_preview_write(st_path, preview))
+        {
+            g_core->log_warn(std::format("[ST] Failed to write the preview of {}", st_path.string()));
+        }
+    });
+}
+
+void st_preview_wait()
+{
+    std::lock_guard lock(g_preview_write_mutex);
+    if (g_preview_write.valid())
+    {
+        g_preview_write.wait();
+    }
+}
+
+bool st_read_preview(const std::filesystem::path &st_path, core_st_preview &preview)
+{
+    ChunkedFile::reader reader;
+    std::vector<uint8_t> metadata;
+    if (!reader.open(st_preview_path(st_path)) || reader.content_version() != PREVIEW_VERSION ||
+        !reader.read(METADATA_SECTION, metadata))
+    {
+        return false;
+    }
+
+    core_st_preview result{};
+    constexpr size_t metadata_size = sizeof(result.total_frames) + sizeof(result.movie_uid) +
+                                     sizeof(result.movie_sample) + sizeof(result.movie_vi) + sizeof(result.timestamp) +
+                                     sizeof(result.thumbnail_width) + sizeof(result.thumbnail_height);
+    if (metadata.size() < metadata_size)
+    {
+        return false;
+    }
+
+    auto ptr = metadata.data();
+    MiscHelpers::memread(&ptr, &result.total_frames, sizeof(result.total_frames));
+    MiscHelpers::memread(&ptr, &result.movie_uid, sizeof(result.movie_uid));
+    MiscHelpers::memread(&ptr, &result.movie_sample, sizeof(result.movie_sample));
+    MiscHelpers::memread(&ptr, &result.movie_vi, sizeof(result.movie_vi));
+    MiscHelpers::memread(&ptr, &result.timestamp, sizeof(result.timestamp));
+    MiscHelpers::memread(&ptr, &result.thumbnail_width, sizeof(result.thumbnail_width));
+    MiscHelpers::memread(&ptr, &result.thumbnail_height, sizeof(result.thumbnail_height));
+
+    if (reader.find(THUMBNAIL_SECTION))
+    {
+        if (!reader.read(THUMBNAIL_SECTION, result.thumbnail) ||
+            result.thumbnail.size() != static_cast<size_t>(result.thumbnail_width) * result.thumbnail_height * 3)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        result.thumbnail_width = 0;
+        result.thumbnail_height = 0;
+    }
+
+    preview = std::move(result);
+    return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <include/core_api.h>
+
+/**
+ * \brief The maximum dimensions of a savestate thumbnail. Larger frames are downscaled by an integer factor to fit.
+ */
+constexpr int32_t ST_THUMBNAIL_MAX_WIDTH = 160;
+constexpr int32_t ST_THUMBNAIL_MAX_HEIGHT = 120;
+
+/**
+ * \brief Gets the path of a savestate file's preview sidecar.
+ */
+std::filesystem::path st_preview_path(const std::filesystem::path &st_path);
+
+/**
+ * \brief Downscales a 24bpp frame into a preview's thumbnail by averaging blocks of pixels.
+ */
+void st_preview_set_thumbnail(core_st_preview &preview, const uint8_t *frame, int32_t width, int32_t height);
+
+/**
+ * \brief Writes a savestate file's preview sidecar.
+ * \return Whether the sidecar was written.
+ */
+bool st_preview_write(const std::filesystem::path &st_path, const core_st_preview &preview);
+
+/**
+ * \brief Downscales the frame and writes a savestate file's preview sidecar on a background thread. Previews are
+ * written in the order they're requested.
+ * \param st_path The savestate file's path.
+ * \param preview The preview's metadata.
+ * \param frame The frame the thumbnail is made from, in the 24bpp format. May be empty.
+ */
+void st_preview_write_async(const std::filesystem::path &st_path, core_st_preview preview, std::vector<uint8_t> frame,
+                            int32_t width, int32_t height);
+
+/**
+ * \brief Waits until all previews requested with <c>st_preview_write_async</c> are written.
+ */
+void st_preview_wait();
+
+/**
+ * \brief Reads a savestate file's preview sidecar.
+ * \return Whether the sidecar exists and is valid.
+ */
+bool st_read_preview(const std::filesystem::path &st_path, core_st_preview &preview);
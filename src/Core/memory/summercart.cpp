@@ -32,19 +32,44 @@ struct vhd
     char pad[427];
 };
 
-static void vhd_copy(struct vhd *vhd, FILE *dst, FILE *src, void *buf, uint32_t n)
+static constexpr uint32_t SD_SECTOR_SIZE = 512;
+
+/**
+ * \brief The header of an SD state file. Files without it hold a copy of the whole image instead of its dirty sectors.
+ * \remarks Version 2 states hold the sectors which differ from the baseline identified by <c>base_hash</c>. Version 1
+ * states hold the sectors written since the image was mapped, against no known baseline.
+ */
+struct sd_state_header
 {
-    uint64_t len;
-    fseek(src, -512, SEEK_END);
-    fread(vhd, 1, sizeof(struct vhd), src);
-    fseek(src, 0, SEEK_SET);
-    for (len = std::byteswap(vhd->disk_size) / 512; len > 0; len -= n)
-    {
-        if (n > len) n = len;
-        fread(buf, n, 512, src);
-        fwrite(buf, n, 512, dst);
-    }
-}
+    char magic[4];
+    uint32_t version;
+    uint32_t dirty_sectors;
+    uint32_t pad;
+};
+
+static constexpr char SD_STATE_MAGIC[4] = {'S', 'C', 'S', 'D'};
+static constexpr uint32_t SD_STATE_VERSION = 2;
+
+using sd_sector = std::array<uint8_t, SD_SECTOR_SIZE>;
+
+/**
+ * \brief The SD image, mapped on the first SD command and kept until the ROM is closed.
+ * \remarks The image's contents when it was mapped are the baseline. It outlives resets, so savestates taken before
+ * them can still roll back every sector written since. Savestates taken against an earlier mapping are restored from
+ * a copy of their baseline, which is kept next to the image once per baseline.
+ */
+static struct
+{
+    std::unique_ptr<IOUtils::mapped_file> file;
+    std::filesystem::path path;
+    uint64_t sectors{};
+
+    // The baseline contents of the sectors written since the image was mapped.
+    std::map<uint32_t, sd_sector> originals;
+
+    // The XXH64 digest of the baseline, computed when first needed.
+    std::optional<uint64_t> base_hash;
+} sd;
 
 struct summercart summercart;
 
@@ -54,169 +79,492 @@ static int32_t sd_error(const char *text, const char *caption)
     return -1;
 }
 
-static int32_t sd_seek(FILE *fp, const char *caption)
+/**
+ * \brief Gets the SD image, mapping and validating it if that hasn't happened yet.
+ * \return The image, or nullptr if it couldn't be mapped.
+ */
+static uint8_t *sd_image(const char *caption)
 {
+    const auto path = g_core->get_summercart_path();
+    if (sd.file && sd.path == path)
+    {
+        return sd.file->mutable_data();
+    }
+
+    sd.file.reset();
+    sd.sectors = 0;
+    sd.originals.clear();
+    sd.base_hash.reset();
+
+    auto file = std::make_unique<IOUtils::mapped_file>(path, IOUtils::map_mode::read_write);
+    if (!file->valid())
+    {
+        sd_error("Could not open SD image file.", caption);
+        return nullptr;
+    }
+
     struct vhd vhd;
-    uint32_t sector = summercart.sd_sector;
-    uint32_t count = summercart.data1;
-    if (fseek(fp, -512, SEEK_END)) return sd_error("Seek(1) error.", caption);
-    if (fread(&vhd, 1, sizeof(struct vhd), fp) != sizeof(struct vhd)) return sd_error("Read error.", caption);
-    if (memcmp(vhd.cookie, "conectix", 8)) return sd_error("Invalid VHD file.", caption);
-    if (std::byteswap(vhd.type) != 2) return sd_error("Invalid VHD type: must be a fixed disk.", caption);
-    if ((int64_t)sector + count > std::byteswap(vhd.disk_size) / 512) return -1;
-    if (fseek(fp, 512 * (int64_t)sector, SEEK_SET)) return sd_error("Seek(2) error.", caption);
-    return 0;
+    if (file->size() < sizeof(vhd))
+    {
+        sd_error("Invalid VHD file.", caption);
+        return nullptr;
+    }
+    memcpy(&vhd, file->data() + file->size() - sizeof(vhd), sizeof(vhd));
+    if (memcmp(vhd.cookie, "conectix", 8))
+    {
+        sd_error("Invalid VHD file.", caption);
+        return nullptr;
+    }
+    if (std::byteswap(vhd.type) != 2)
+    {
+        sd_error("Invalid VHD type: must be a fixed disk.", caption);
+        return nullptr;
+    }
+    if (std::byteswap(vhd.disk_size) > file->size() - sizeof(vhd))
+    {
+        sd_error("Invalid VHD file.", caption);
+        return nullptr;
+    }
+
+    sd.sectors = std::byteswap(vhd.disk_size) / SD_SECTOR_SIZE;
+    sd.file = std::move(file);
+    sd.path = path;
+    return sd.file->mutable_data();
 }
 
-static void sd_read()
+/**
+ * \brief Calls a function with consecutive runs of the baseline's bytes, in order.
+ */
+template <typename F> static void sd_for_each_base_run(const uint8_t *image, F &&f)
 {
-    uint32_t i;
-    FILE *fp = nullptr;
-    const auto path = g_core->get_summercart_path();
-    char *ptr = NULL;
-    uint32_t addr = summercart.data0 & 0x1fffffff;
-    uint32_t count = summercart.data1;
-    uint32_t size = 512 * count;
+    uint64_t sector = 0;
+    for (const auto &[dirty, original] : sd.originals)
+    {
+        if (dirty > sector)
+        {
+            f(image + sector * SD_SECTOR_SIZE, (dirty - sector) * SD_SECTOR_SIZE);
+        }
+        f(original.data(), original.size());
+        sector = dirty + 1;
+    }
+    if (sd.sectors > sector)
+    {
+        f(image + sector * SD_SECTOR_SIZE, (sd.sectors - sector) * SD_SECTOR_SIZE);
+    }
+}
 
-    if (count > 131072) return;
+static uint64_t sd_base_hash(const uint8_t *image)
+{
+    if (!sd.base_hash)
+    {
+        HashUtils::xxh64_state state;
+        sd_for_each_base_run(image, [&](const uint8_t *data, const size_t size) { state.update(data, size); });
+        sd.base_hash = state.digest();
+    }
+    return *sd.base_hash;
+}
 
-    if (IOUtils::path_fopen_s(fp, path, "rb"))
+/**
+ * \brief Gets the path of the copy of a baseline, which is stored next to the SD image and shared by all SD state files
+ * saved against it.
+ */
+static std::filesystem::path sd_base_copy_path(const uint64_t hash)
+{
+    auto path = sd.path;
+    path += std::format(".{:016x}.base", hash);
+    return path;
+}
+
+/**
+ * \brief Gets the path of the file listing which baseline each SD state file was saved against.
+ */
+static std::filesystem::path sd_base_index_path()
+{
+    auto path = sd.path;
+    path += ".bases";
+    return path;
+}
+
+/**
+ * \brief Writes a copy of the baseline next to the SD image, unless one already exists.
+ */
+static bool sd_write_base_copy(const uint8_t *image)
+{
+    const auto path = sd_base_copy_path(sd_base_hash(image));
+    if (std::filesystem::exists(path))
     {
-        sd_error("Could not open SD image file.", "SD read error");
+        return true;
     }
-    else
+
+    auto temp_path = path;
+    temp_path += ".tmp";
     {
-        char s = S8;
-        if (!sd_seek(fp, "SD read error"))
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        sd_for_each_base_run(image, [&](const uint8_t *data, const size_t size) {
+            file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+        });
+        if (!file.good())
         {
-            if (addr >= 0x1ffe0000 && addr + size <= 0x1ffe2000)
-            {
-                addr -= 0x1ffe0000;
-                ptr = summercart.buffer;
-            }
-            if (addr >= 0x10000000 && addr + size <= 0x14000000)
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    return !ec;
+}
+
+/**
+ * \brief Records the baseline an SD state file was saved against, then deletes the baseline copies which no
+ * existing SD state file was saved against anymore.
+ */
+static void sd_update_base_index(const std::filesystem::path &state_path, const uint64_t hash)
+{
+    std::map<std::filesystem::path, uint64_t> index;
+    {
+        std::ifstream file(sd_base_index_path());
+        std::string line;
+        while (std::getline(file, line))
+        {
+            uint64_t entry_hash{};
+            if (line.size() < 18 || std::from_chars(line.data(), line.data() + 16, entry_hash, 16).ec != std::errc{})
             {
-                s ^= summercart.sd_byteswap;
-                addr -= 0x10000000;
-                ptr = (char *)rom;
+                continue;
             }
+            index[std::u8string(line.begin() + 17, line.end())] = entry_hash;
+        }
+    }
+
+    std::error_code ec;
+    index[std::filesystem::weakly_canonical(state_path, ec)] = hash;
+    std::erase_if(index, [&](const auto &entry) { return !std::filesystem::exists(entry.first, ec); });
+
+    {
+        std::ofstream file(sd_base_index_path(), std::ios::trunc);
+        for (const auto &[path, entry_hash] : index)
+        {
+            const auto utf8 = path.u8string();
+            file << std::format("{:016x} {}\n", entry_hash,
+                                std::string_view(reinterpret_cast<const char *>(utf8.data()), utf8.size()));
+        }
+    }
+
+    const auto prefix = sd.path.filename().string() + ".";
+    for (const auto &entry : std::filesystem::directory_iterator(sd.path.parent_path(), ec))
+    {
+        const auto name = entry.path().filename().string();
+        uint64_t entry_hash{};
+        if (name.size() != prefix.size() + 16 + 5 || !name.starts_with(prefix) || !name.ends_with(".base") ||
+            std::from_chars(name.data() + prefix.size(), name.data() + prefix.size() + 16, entry_hash, 16).ec !=
+                std::errc{})
+        {
+            continue;
         }
-        if (ptr)
+        if (std::ranges::none_of(index, [&](const auto &pair) { return pair.second == entry_hash; }))
         {
-            for (i = 0; i < size; i++) ptr[(addr + i) ^ s] = fgetc(fp);
-            summercart.status = 0;
+            std::filesystem::remove(entry.path(), ec);
         }
-        fclose(fp);
     }
 }
 
+/**
+ * \brief Makes the image match a baseline copy, which becomes the baseline.
+ * \return Whether a copy of the baseline was found and restored.
+ */
+static bool sd_restore_base_copy(uint8_t *image, const uint64_t hash)
+{
+    std::ifstream file(sd_base_copy_path(hash), std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> base(sd.sectors * SD_SECTOR_SIZE);
+    if (!file.read(reinterpret_cast<char *>(base.data()), static_cast<std::streamsize>(base.size())) ||
+        HashUtils::xxh64(base.data(), base.size()) != hash)
+    {
+        return false;
+    }
+
+    for (uint64_t offset = 0; offset < base.size(); offset += SD_SECTOR_SIZE)
+    {
+        if (memcmp(image + offset, base.data() + offset, SD_SECTOR_SIZE))
+        {
+            memcpy(image + offset, base.data() + offset, SD_SECTOR_SIZE);
+        }
+    }
+    sd.originals.clear();
+    sd.base_hash = hash;
+    return true;
+}
+
+/**
+ * \brief Remembers the contents of sectors before they are overwritten for the first time.
+ */
+static void sd_track(const uint8_t *image, const uint32_t sector, const uint32_t count)
+{
+    for (uint32_t i = sector; i < sector + count; ++i)
+    {
+        if (const auto [it, inserted] = sd.originals.try_emplace(i); inserted)
+        {
+            memcpy(it->second.data(), image + (uint64_t)i * SD_SECTOR_SIZE, SD_SECTOR_SIZE);
+        }
+    }
+}
+
+/**
+ * \brief Copies bytes with their addresses XORed, as in <c>dst[i ^ s] = src[i]</c>.
+ * \param size The amount of bytes, a multiple of 4.
+ */
+static void sd_copy(uint8_t *dst, const uint8_t *src, const size_t size, const int32_t s)
+{
+    switch (s)
+    {
+    case 0:
+        memcpy(dst, src, size);
+        break;
+    case 1:
+        EndianUtils::swap16(dst, src, size);
+        break;
+    case 2:
+        EndianUtils::swap32_halves(dst, src, size);
+        break;
+    default:
+        EndianUtils::swap32(dst, src, size);
+        break;
+    }
+}
+
+/**
+ * \brief Resolves the target of an SD transfer.
+ * \param addr The address, made relative to the returned memory.
+ * \param size The size of the transfer in bytes.
+ * \return The memory, or nullptr if the range isn't in the buffer or the ROM.
+ */
+static uint8_t *sd_target(uint32_t &addr, const uint32_t size)
+{
+    if (addr >= 0x1ffe0000 && addr + size <= 0x1ffe2000)
+    {
+        addr -= 0x1ffe0000;
+        return (uint8_t *)summercart.buffer;
+    }
+    if (addr >= 0x10000000 && addr + size <= 0x14000000)
+    {
+        addr -= 0x10000000;
+        return (uint8_t *)rom;
+    }
+    return nullptr;
+}
+
+static void sd_read()
+{
+    uint32_t addr = summercart.data0 & 0x1fffffff;
+    const uint32_t count = summercart.data1;
+    const uint32_t size = SD_SECTOR_SIZE * count;
+
+    if (count > 131072) return;
+
+    const uint8_t *image = sd_image("SD read error");
+    if (!image || (uint64_t)summercart.sd_sector + count > sd.sectors) return;
+
+    uint8_t *ptr = sd_target(addr, size);
+    if (!ptr) return;
+
+    int32_t s = S8;
+    if (ptr == (uint8_t *)rom) s ^= summercart.sd_byteswap;
+
+    const uint8_t *src = image + (uint64_t)summercart.sd_sector * SD_SECTOR_SIZE;
+    if (addr % 4 == 0)
+    {
+        sd_copy(ptr + addr, src, size, s);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < size; i++) ptr[(addr + i) ^ s] = src[i];
+    }
+    summercart.status = 0;
+}
+
 static void sd_write()
 {
-    uint32_t i;
-    FILE *fp = nullptr;
-    const auto path = g_core->get_summercart_path();
-    char *ptr = NULL;
     uint32_t addr = summercart.data0 & 0x1fffffff;
-    uint32_t count = summercart.data1;
-    uint32_t size = 512 * count;
+    const uint32_t count = summercart.data1;
+    const uint32_t size = SD_SECTOR_SIZE * count;
 
     if (count > 131072) return;
 
-    if (IOUtils::path_fopen_s(fp, path, "r+b"))
+    uint8_t *image = sd_image("SD write error");
+    if (!image || (uint64_t)summercart.sd_sector + count > sd.sectors) return;
+
+    const uint8_t *ptr = sd_target(addr, size);
+    if (!ptr) return;
+
+    sd_track(image, summercart.sd_sector, count);
+
+    uint8_t *dst = image + (uint64_t)summercart.sd_sector * SD_SECTOR_SIZE;
+    if (addr % 4 == 0)
     {
-        sd_error("Could not open SD image file.", "SD write error");
+        sd_copy(dst, ptr + addr, size, S8);
     }
     else
     {
-        if (!sd_seek(fp, "SD write error"))
-        {
-            if (addr >= 0x1ffe0000 && addr + size <= 0x1ffe2000)
-            {
-                addr -= 0x1ffe0000;
-                ptr = summercart.buffer;
-            }
-            if (addr >= 0x10000000 && addr + size <= 0x14000000)
-            {
-                addr -= 0x10000000;
-                ptr = (char *)rom;
-            }
-        }
-        if (ptr)
-        {
-            for (i = 0; i < size; i++) fputc(ptr[(addr + i) ^ S8], fp);
-            summercart.status = 0;
-        }
-        fclose(fp);
+        for (uint32_t i = 0; i < size; i++) dst[i] = ptr[(addr + i) ^ S8];
     }
+    summercart.status = 0;
 }
 
 void save_summercart(const std::filesystem::path &path)
 {
-    uint32_t n;
-    void *buf;
-    FILE *sdf = nullptr;
-    FILE *stf = nullptr;
-    struct vhd vhd;
-    const auto smc_path = g_core->get_summercart_path();
+    const uint8_t *image = sd_image("Save error");
+    if (!image) return;
+
+    FILE *f = nullptr;
+    if (IOUtils::path_fopen_s(f, path, "wb"))
+    {
+        sd_error("Could not open SD state file.", "Save error");
+        return;
+    }
 
-    if ((buf = malloc(512 * (n = 128))))
+    // Only the sectors which differ from the baseline are stored. A copy of the baseline is kept once per image, so
+    // the state can still be restored once the image was mapped again with other contents.
+    const uint64_t base_hash = sd_base_hash(image);
+    if (!sd_write_base_copy(image))
     {
-        if (IOUtils::path_fopen_s(sdf, smc_path, "rb") == 0)
+        sd_error("Could not write the SD image's baseline.", "Save error");
+    }
+
+    sd_state_header header{};
+    memcpy(header.magic, SD_STATE_MAGIC, sizeof(header.magic));
+    header.version = SD_STATE_VERSION;
+    header.dirty_sectors = (uint32_t)sd.originals.size();
+
+    fwrite(&header, 1, sizeof(header), f);
+    fwrite(&base_hash, 1, sizeof(base_hash), f);
+    fwrite(&summercart, 1, sizeof(struct summercart), f);
+    for (const auto sector : sd.originals | std::views::keys)
+    {
+        fwrite(&sector, 1, sizeof(sector), f);
+        fwrite(image + (uint64_t)sector * SD_SECTOR_SIZE, 1, SD_SECTOR_SIZE, f);
+    }
+    fclose(f);
+
+    sd_update_base_index(path, base_hash);
+}
+
+/**
+ * \brief Restores the image from a state file holding a copy of the whole image, as older versions wrote.
+ */
+static void load_summercart_image(FILE *f, uint8_t *image)
+{
+    sd_sector buf;
+    for (uint32_t sector = 0; sector < sd.sectors; ++sector)
+    {
+        if (fread(buf.data(), 1, buf.size(), f) != buf.size())
         {
-            if (IOUtils::path_fopen_s(stf, path, "wb") == 0)
-            {
-                vhd_copy(&vhd, stf, sdf, buf, n);
-                fwrite(&summercart, 1, sizeof(struct summercart), stf);
-                fwrite(&vhd, 1, sizeof(struct vhd), stf);
-                fclose(stf);
-            }
-            else
-                sd_error("Could not open SD state file.", "Save error");
-            fclose(sdf);
+            sd_error("Could not read SD state file.", "Load error");
+            return;
+        }
+
+        uint8_t *dst = image + (uint64_t)sector * SD_SECTOR_SIZE;
+        if (memcmp(dst, buf.data(), buf.size()))
+        {
+            sd_track(image, sector, 1);
+            memcpy(dst, buf.data(), buf.size());
         }
-        else
-            sd_error("Could not open SD image file.", "Save error");
     }
-    else
-        sd_error("Could not allocate buffer.", "Save error");
+    fread(&summercart, 1, sizeof(struct summercart), f);
 }
 
 void load_summercart(const std::filesystem::path &path)
 {
-    uint32_t n;
-    void *buf;
-    FILE *stf = nullptr;
-    FILE *sdf = nullptr;
-    struct vhd vhd;
-    const auto smc_path = g_core->get_summercart_path();
-    if ((buf = malloc(512 * (n = 128))))
+    uint8_t *image = sd_image("Load error");
+    if (!image) return;
+
+    FILE *f = nullptr;
+    if (IOUtils::path_fopen_s(f, path, "rb"))
+    {
+        sd_error("Could not open SD state file.", "Load error");
+        return;
+    }
+
+    sd_state_header header{};
+    if (fread(&header, 1, sizeof(header), f) != sizeof(header) ||
+        memcmp(header.magic, SD_STATE_MAGIC, sizeof(header.magic)) || header.version < 1 ||
+        header.version > SD_STATE_VERSION)
+    {
+        fseek(f, 0, SEEK_SET);
+        load_summercart_image(f, image);
+        fclose(f);
+        return;
+    }
+
+    uint64_t base_hash{};
+    if (header.version >= 2 && fread(&base_hash, 1, sizeof(base_hash), f) != sizeof(base_hash))
     {
-        if (IOUtils::path_fopen_s(stf, smc_path, "rb") == 0)
+        sd_error("Could not read SD state file.", "Load error");
+        fclose(f);
+        return;
+    }
+
+    fread(&summercart, 1, sizeof(struct summercart), f);
+
+    std::map<uint32_t, sd_sector> saved;
+    for (uint32_t i = 0; i < header.dirty_sectors; ++i)
+    {
+        uint32_t sector;
+        sd_sector data;
+        if (fread(&sector, 1, sizeof(sector), f) != sizeof(sector) ||
+            fread(data.data(), 1, data.size(), f) != data.size() || sector >= sd.sectors)
         {
-            if (IOUtils::path_fopen_s(sdf, path, "wb") == 0)
-            {
-                vhd_copy(&vhd, sdf, stf, buf, n);
-                fread(&summercart, 1, sizeof(struct summercart), stf);
-                fwrite(&vhd, 1, sizeof(struct vhd), sdf);
-                fclose(sdf);
-            }
-            else
-                sd_error("Could not open SD image file.", "Load error");
-            fclose(stf);
+            sd_error("Could not read SD state file.", "Load error");
+            fclose(f);
+            return;
         }
-        else
-            sd_error("Could not open SD state file.", "Load error");
-        free(buf);
+        saved[sector] = data;
+    }
+    fclose(f);
+
+    // The state was saved against another baseline, e.g. in an earlier session, so that baseline is restored first.
+    if (header.version >= 2 && base_hash != sd_base_hash(image) && !sd_restore_base_copy(image, base_hash))
+    {
+        sd_error("Could not find the SD image's baseline the state was saved against.", "Load error");
+        return;
+    }
+
+    // Sectors written since the state was saved go back to their original contents.
+    for (auto it = sd.originals.begin(); it != sd.originals.end();)
+    {
+        if (saved.contains(it->first))
+        {
+            ++it;
+            continue;
+        }
+        memcpy(image + (uint64_t)it->first * SD_SECTOR_SIZE, it->second.data(), SD_SECTOR_SIZE);
+        it = sd.originals.erase(it);
+    }
+
+    for (const auto &[sector, data] : saved)
+    {
+        sd_track(image, sector, 1);
+        memcpy(image + (uint64_t)sector * SD_SECTOR_SIZE, data.data(), SD_SECTOR_SIZE);
     }
-    else
-        sd_error("Could not allocate buffer.", "Load error");
 }
 
 void init_summercart()
 {
+    // The image stays mapped with its baseline, see sd.
     memset(&summercart, 0, sizeof(struct summercart));
 }
 
+void close_summercart()
+{
+    sd.file.reset();
+    sd.path.clear();
+    sd.sectors = 0;
+    sd.originals.clear();
+    sd.base_hash.reset();
+}
+
 uint32_t read_summercart(uint32_t address)
 {
     switch (address & 0xFFFC)
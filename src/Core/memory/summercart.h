@@ -27,5 +27,10 @@ extern struct summercart summercart;
 void save_summercart(const std::filesystem::path &path);
 void load_summercart(const std::filesystem::path &path);
 void init_summercart();
+
+/**
+ * \brief Unmaps the SD image. Called when the ROM is closed.
+ */
+void close_summercart();
 uint32_t read_summercart(uint32_t address);
 void write_summercart(uint32_t address, uint32_t value);
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include <Core.h>
+#include <null_plugins.h>
+
+static void null_void()
+{
+}
+
+static void null_get_video_size(int32_t *width, int32_t *height)
+{
+    *width = 0;
+    *height = 0;
+}
+
+static void null_ai_dacrate_changed(int32_t)
+{
+}
+
+static uint32_t null_ai_read_length()
+{
+    return 0;
+}
+
+static void null_ai_update(int32_t)
+{
+}
+
+static void null_controller_command(int32_t, unsigned char *)
+{
+}
+
+static void null_get_keys(int32_t, core_buttons *keys)
+{
+    keys->value = 0;
+}
+
+static void null_get_all_keys(core_buttons *keys)
+{
+    std::fill_n(keys, 4, core_buttons{});
+}
+
+static void null_set_keys(int32_t, core_buttons)
+{
+}
+
+static uint32_t null_do_rsp_cycles(const uint32_t cycles)
+{
+    return cycles;
+}
+
+void null_plugins_install()
+{
+    if (null_plugin_active(null_plugin_video))
+    {
+        g_core->video_process_dlist = null_void;
+        g_core->video_process_rdp_list = null_void;
+        g_core->video_show_cfb = null_void;
+        g_core->video_vi_status_changed = null_void;
+        g_core->video_vi_width_changed = null_void;
+        g_core->video_get_video_size = null_get_video_size;
+        // Without frame buffer functions, the core doesn't track accesses to the frame buffer.
+        g_core->video_fb_read = nullptr;
+        g_core->video_fb_write = nullptr;
+        g_core->video_fb_get_frame_buffer_info = nullptr;
+        g_core->video_set_frame_hidden = nullptr;
+    }
+
+    if (null_plugin_active(null_plugin_audio))
+    {
+        g_core->audio_ai_dacrate_changed = null_ai_dacrate_changed;
+        g_core->audio_ai_len_changed = null_void;
+        g_core->audio_ai_read_length = null_ai_read_length;
+        g_core->audio_process_alist = null_void;
+        g_core->audio_ai_update = null_ai_update;
+    }
+
+    if (null_plugin_active(null_plugin_input))
+    {
+        g_core->input_controller_command = null_controller_command;
+        g_core->input_get_keys = null_get_keys;
+        g_core->input_get_all_keys = null_get_all_keys;
+        g_core->input_set_keys = null_set_keys;
+        g_core->input_read_controller = null_controller_command;
+    }
+
+    if (null_plugin_active(null_plugin_rsp))
+    {
+        g_core->rsp_do_rsp_cycles = null_do_rsp_cycles;
+        g_core->rsp_dma_written = nullptr;
+    }
+
+    if (g_core->null_plugins)
+    {
+        g_core->log_info(std::format("[Core] Using null plugins: {:#x}", g_core->null_plugins));
+    }
+}
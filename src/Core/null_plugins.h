@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <Core.h>
+
+/**
+ * \brief Gets whether a plugin is replaced by the core's null implementation.
+ */
+inline bool null_plugin_active(const core_null_plugin plugin)
+{
+    return g_core->null_plugins & plugin;
+}
+
+/**
+ * \brief Replaces the functions of the plugins selected in <c>core_params::null_plugins</c> with the core's null
+ * implementations. Must be called after the host initiated its plugins.
+ */
+void null_plugins_install();
@@ -32,7 +32,7 @@ void dbg_set_is_resumed(bool value)
         g_instruction_advancing = false;
     }
     g_resumed = value;
-    g_core->callbacks.debugger_resumed_changed(g_resumed);
+    g_core->events.publish<core_event::debugger_resumed_changed>(g_resumed);
 }
 
 void dbg_step()
@@ -83,8 +83,8 @@ void Debugger::on_late_cycle(uint32_t opcode, uint32_t address)
     {
         g_instruction_advancing = false;
         g_resumed = false;
-        g_core->callbacks.debugger_cpu_state_changed(&g_cpu_state);
-        g_core->callbacks.debugger_resumed_changed(g_resumed);
+        g_core->events.publish<core_event::debugger_cpu_state_changed>(&g_cpu_state);
+        g_core->events.publish<core_event::debugger_resumed_changed>(g_resumed);
     }
 
     while (!g_resumed)
@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include <Core.h>
+#include <condition_variable>
+#include <r4300/desync.h>
+#include <r4300/r4300.h>
+#include <r4300/state_digest.h>
+#include <r4300/tracelog.h>
+#include <r4300/tracelog_index.h>
+#include <r4300/vcr.h>
+
+enum class ds_pass
+{
+    none,
+    // Records the reference hashes at the checkpoints.
+    record,
+    // Compares against the reference hashes at the checkpoints until they diverge.
+    compare,
+    // Hashes the state at the target sample.
+    probe,
+    // Traces the sample leading up to the target sample.
+    trace,
+};
+
+/**
+ * \brief A point a pass can start from.
+ */
+struct t_ds_checkpoint
+{
+    size_t frame{};
+    // The savestate taken at the frame. If empty, the pass starts from the beginning of the movie.
+    std::vector<uint8_t> st{};
+};
+
+struct t_ds_state
+{
+    std::atomic<bool> active{};
+    std::atomic<bool> cancel{};
+
+    std::mutex mtx{};
+    std::condition_variable cv{};
+    ds_pass pass = ds_pass::none;
+    bool pass_done{};
+    core_result pass_result{};
+
+    size_t interval{};
+    size_t end_frame{};
+
+    // The checkpoint the current pass starts from, and whether it has been loaded yet.
+    t_ds_checkpoint start{};
+    bool loading{};
+    bool loaded{};
+
+    // Samples are polled once per controller, so repeated polls of the same sample are ignored.
+    size_t last_sample = SIZE_MAX;
+
+    // The savestate taken right before the sample it belongs to was polled.
+    std::vector<uint8_t> pending_st{};
+    size_t pending_frame = SIZE_MAX;
+
+    std::unordered_map<size_t, uint64_t> hashes{};
+    t_ds_checkpoint matched{};
+    size_t matched_frame{};
+    size_t diverged_frame = SIZE_MAX;
+    uint64_t diverged_hash{};
+
+    size_t target{};
+    bool keep_state{};
+    uint64_t target_hash{};
+    t_ds_checkpoint target_st{};
+
+    std::filesystem::path trace_path{};
+};
+
+static t_ds_state ds{};
+
+static bool is_checkpoint(const size_t frame)
+{
+    return frame % ds.interval == 0 || frame == ds.end_frame;
+}
+
+/**
+ * \brief Takes the pending savestate if it belongs to the specified frame.
+ */
+static bool take_pending_st(const size_t frame, t_ds_checkpoint &checkpoint)
+{
+    if (ds.pending_frame != frame || ds.pending_st.empty())
+    {
+        return false;
+    }
+
+    checkpoint = {frame, std::move(ds.pending_st)};
+    ds.pending_st.clear();
+    ds.pending_frame = SIZE_MAX;
+    return true;
+}
+
+void ds_on_sample(int32_t sample)
+{
+    if (!ds.active || sample < 0)
+    {
+        return;
+    }
+
+    const auto frame = static_cast<size_t>(sample);
+
+    std::vector<uint8_t> load_st;
+    bool save = false;
+
+    {
+        std::scoped_lock lock(ds.mtx);
+
+        if (ds.pass == ds_pass::none || ds.pass_done || ds.loading || frame == ds.last_sample)
+        {
+            return;
+        }
+
+        ds.last_sample = frame;
+
+        if (!ds.loaded)
+        {
+            // The load is done before the next poll, after which the samples continue from the checkpoint's frame.
+            ds.loading = true;
+            load_st = ds.start.st;
+        }
+        else
+        {
+            switch (ds.pass)
+            {
+            case ds_pass::record:
+                if (is_checkpoint(frame))
+                {
+                    ds.hashes[frame] = dg_compute();
+                }
+                break;
+            case ds_pass::compare:
+                if (is_checkpoint(frame))
+                {
+                    const auto it = ds.hashes.find(frame);
+                    if (it == ds.hashes.end())
+                    {
+                        ds.pass_done = true;
+                        break;
+                    }
+
+                    if (const auto hash = dg_compute(); hash != it->second)
+                    {
+                        ds.diverged_frame = frame;
+                        ds.diverged_hash = hash;
+                        ds.pass_done = true;
+                        break;
+                    }
+
+                    // The states match, so either configuration can continue from here.
+                    ds.matched_frame = frame;
+                    if (frame == 0)
+                    {
+                        ds.matched = {};
+                    }
+                    else
+                    {
+                        take_pending_st(frame, ds.matched);
+                    }
+                }
+                save = is_checkpoint(frame + 1);
+                break;
+            case ds_pass::probe:
+                if (frame >= ds.target)
+                {
+                    ds.target_hash = dg_compute();
+                    if (!ds.keep_state || !take_pending_st(frame, ds.target_st))
+                    {
+                        ds.target_st = {};
+                    }
+                    ds.pass_done = true;
+                    break;
+                }
+                save = ds.keep_state && frame + 1 == ds.target;
+                break;
+            case ds_pass::trace:
+                if (frame + 1 == ds.target && !tl_active())
+                {
+                    tl_start(ds.trace_path, true, false);
+                }
+                else if (frame >= ds.target && tl_active())
+                {
+                    tl_stop();
+                    ds.pass_done = true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (save)
+        {
+            ds.pending_frame = frame + 1;
+        }
+
+        if (ds.pass_done)
+        {
+            ds.cv.notify_all();
+        }
+    }
+
+    // The jobs are done by the emu thread at the start of the next poll, before its sample reaches us.
+    if (!load_st.empty())
+    {
+        g_ctx.st_do_memory(
+            load_st, core_st_job_load,
+            [](const core_st_callback_info &info, const auto &) {
+                std::scoped_lock lock(ds.mtx);
+                ds.loading = false;
+                ds.loaded = info.result == Res_Ok;
+                ds.last_sample = SIZE_MAX;
+                if (info.result != Res_Ok)
+                {
+                    ds.pass_result = info.result;
+                    ds.pass_done = true;
+                    ds.cv.notify_all();
+                }
+            },
+            true);
+    }
+
+    if (save)
+    {
+        g_ctx.st_do_memory(
+            {}, core_st_job_save,
+            [](const core_st_callback_info &info, const std::vector<uint8_t> &buf) {
+                std::scoped_lock lock(ds.mtx);
+                if (info.result == Res_Ok)
+                {
+                    ds.pending_st = buf;
+                }
+            },
+            true);
+    }
+}
+
+/**
+ * \brief Plays the movie back under the specified configuration until the pass completes or the movie ends.
+ * \param start The checkpoint the playback starts from.
+ */
+static core_result run_pass(const std::filesystem::path &movie_path, const core_cfg &cfg, ds_pass pass,
+                            const t_ds_checkpoint &start = {})
+{
+    // The config can only be swapped while the emulator is stopped, as some options are only read on startup.
+    (void)g_ctx.vr_close_rom(true);
+
+    *g_core->cfg = cfg;
+    g_core->cfg->is_movie_loop_enabled = 0;
+    g_core->cfg->wait_at_movie_end = 0;
+    g_core->cfg->pause_at_last_frame = 0;
+    g_core->cfg->pause_at_frame = -1;
+    g_core->cfg->vcr_readonly = 1;
+    // The passes take their own checkpoints.
+    g_core->cfg->seek_savestate_interval = 0;
+
+    // Only the pure interpreter logs every instruction. The cached interpreter and the dynarec only trace blocks
+    // compiled after tracing starts, which would leave holes in the traces.
+    if (pass == ds_pass::trace)
+    {
+        g_core->cfg->core_type = 2;
+    }
+
+    {
+        std::scoped_lock lock(ds.mtx);
+        ds.pass = pass;
+        ds.pass_done = false;
+        ds.pass_result = Res_Ok;
+        ds.start = start;
+        ds.loading = false;
+        ds.loaded = start.st.empty();
+        ds.last_sample = SIZE_MAX;
+        ds.pending_st.clear();
+        ds.pending_frame = SIZE_MAX;
+    }
+
+    auto result = g_ctx.vcr_start_playback(movie_path);
+
+    if (result == Res_Ok)
+    {
+        g_ctx.vr_set_fast_forward(true);
+
+        std::unique_lock lock(ds.mtx);
+        while (!ds.pass_done && !ds.cancel)
+        {
+            ds.cv.wait_for(lock, std::chrono::milliseconds(100));
+
+            if (g_ctx.vcr_get_task() == task_idle)
+            {
+                break;
+            }
+        }
+        ds.pass = ds_pass::none;
+        result = ds.pass_result;
+    }
+
+    if (tl_active())
+    {
+        g_ctx.tl_stop();
+    }
+
+    (void)g_ctx.vr_close_rom(true);
+
+    if (result == Res_Ok && ds.cancel)
+    {
+        result = DS_Cancelled;
+    }
+
+    return result;
+}
+
+/**
+ * \brief Plays the movie back from a checkpoint and hashes the state at the target sample.
+ * \param keep_state Whether the savestate at the target sample is kept in <c>ds.target_st</c>.
+ */
+static core_result probe(const std::filesystem::path &movie_path, const core_cfg &cfg, const t_ds_checkpoint &from,
+                         const size_t target, const bool keep_state)
+{
+    ds.target = target;
+    ds.keep_state = keep_state;
+    ds.target_st = {};
+
+    const auto result = run_pass(movie_path, cfg, ds_pass::probe, from);
+    if (result == Res_Ok && !ds.pass_done)
+    {
+        g_core->log_error(std::format("[DS] Playback ended before reaching sample {}", target));
+        return VCR_InvalidFrame;
+    }
+    return result;
+}
+
+/**
+ * \brief Finds the first differing record of two binary traces.
+ */
+static void diff_traces(core_ds_result &res)
+{
+    t_tl_trace trace_a;
+    t_tl_trace trace_b;
+    if (!tl_trace_open(res.trace_path_a, trace_a) || !tl_trace_open(res.trace_path_b, trace_b))
+    {
+        g_core->log_error("[DS] Failed to open the divergence traces");
+        return;
+    }
+
+    const auto records_a = trace_a.records();
+    const auto records_b = trace_b.records();
+    const auto count = std::min(records_a.size(), records_b.size());
+
+    for (uint64_t i = 0; i <= count; ++i)
+    {
+        const bool a_ended = i == records_a.size();
+        const bool b_ended = i == records_b.size();
+        if (a_ended && b_ended)
+        {
+            break;
+        }
+
+        if (a_ended || b_ended || memcmp(&records_a[i], &records_b[i], sizeof(t_tl_record)))
+        {
+            res.record = i;
+            res.pc_a = a_ended ? 0 : records_a[i].pc;
+            res.w_a = a_ended ? 0 : records_a[i].w;
+            res.pc_b = b_ended ? 0 : records_b[i].pc;
+            res.w_b = b_ended ? 0 : records_b[i].w;
+            return;
+        }
+    }
+}
+
+static core_ds_result run_bisection(const core_ds_params &params)
+{
+    core_ds_result res{};
+
+    core_vcr_movie_header hdr{};
+    res.result = g_ctx.vcr_parse_header(params.movie_path, &hdr);
+    if (res.result != Res_Ok)
+    {
+        return res;
+    }
+
+    ds.interval = std::max<size_t>(params.checkpoint_interval, 1);
+    ds.end_frame = hdr.length_samples ? hdr.length_samples - 1 : 0;
+
+    g_core->log_info(std::format("[DS] Recording reference hashes for {}", params.movie_path.string()));
+    res.result = run_pass(params.movie_path, params.cfg_a, ds_pass::record);
+    if (res.result != Res_Ok)
+    {
+        return res;
+    }
+
+    g_core->log_info(std::format("[DS] Recorded {} reference hashes, comparing...", ds.hashes.size()));
+    res.result = run_pass(params.movie_path, params.cfg_b, ds_pass::compare);
+    if (res.result != Res_Ok || ds.diverged_frame == SIZE_MAX)
+    {
+        return res;
+    }
+
+    size_t lo = ds.matched_frame;
+    size_t hi = ds.diverged_frame;
+    auto from = std::move(ds.matched);
+    res.hash_a = ds.hashes[hi];
+    res.hash_b = ds.diverged_hash;
+
+    // The states at the first sample can't be told apart any further, as there is no previous sample to start from.
+    if (hi == 0)
+    {
+        res.frame = 0;
+        return res;
+    }
+
+    // Both configurations agree at lo and disagree at hi. Each step plays both from the latest checkpoint at or
+    // before lo, so the state under the compared configuration is kept whenever a step agrees.
+    g_core->log_info(std::format("[DS] Checkpoints diverge between samples {} and {}, bisecting...", lo, hi));
+    while (hi - lo > 1)
+    {
+        const auto mid = lo + (hi - lo) / 2;
+
+        res.result = probe(params.movie_path, params.cfg_a, from, mid, false);
+        if (res.result != Res_Ok)
+        {
+            return res;
+        }
+        const auto hash_a = ds.target_hash;
+
+        res.result = probe(params.movie_path, params.cfg_b, from, mid, true);
+        if (res.result != Res_Ok)
+        {
+            return res;
+        }
+        const auto hash_b = ds.target_hash;
+
+        if (hash_a == hash_b)
+        {
+            lo = mid;
+            if (!ds.target_st.st.empty())
+            {
+                from = std::move(ds.target_st);
+            }
+        }
+        else
+        {
+            hi = mid;
+            res.hash_a = hash_a;
+            res.hash_b = hash_b;
+        }
+    }
+
+    res.frame = hi;
+    g_core->log_info(std::format("[DS] States diverge at frame {} ({:016X} vs {:016X})", res.frame, res.hash_a,
+                                 res.hash_b));
+
+    if (!params.find_instruction)
+    {
+        return res;
+    }
+
+    const auto dir =
+        params.trace_directory.empty() ? std::filesystem::temp_directory_path() : params.trace_directory;
+    res.trace_path_a = dir / std::format("ds_{}_a.trace", res.frame);
+    res.trace_path_b = dir / std::format("ds_{}_b.trace", res.frame);
+
+    ds.target = res.frame;
+    ds.trace_path = res.trace_path_a;
+    res.result = run_pass(params.movie_path, params.cfg_a, ds_pass::trace, from);
+    if (res.result != Res_Ok)
+    {
+        return res;
+    }
+
+    ds.trace_path = res.trace_path_b;
+    res.result = run_pass(params.movie_path, params.cfg_b, ds_pass::trace, from);
+    if (res.result != Res_Ok)
+    {
+        return res;
+    }
+
+    diff_traces(res);
+
+    if (res.record != UINT64_MAX)
+    {
+        g_core->log_info(std::format("[DS] First diverging instruction at record {}: {:08X} ({:08X}) vs {:08X} ({:08X})",
+                                     res.record, res.pc_a, res.w_a, res.pc_b, res.w_b));
+    }
+
+    return res;
+}
+
+core_result ds_begin(const core_ds_params &params, const core_ds_callback &callback)
+{
+    if (ds.active.exchange(true))
+    {
+        return DS_AlreadyRunning;
+    }
+
+    ds.cancel = false;
+    ds.hashes.clear();
+    ds.matched = {};
+    ds.matched_frame = 0;
+    ds.diverged_frame = SIZE_MAX;
+    ds.diverged_hash = 0;
+
+    g_core->submit_task([=] {
+        const auto original_cfg = *g_core->cfg;
+        const auto original_fast_forward = g_vr_fast_forward;
+
+        const auto res = run_bisection(params);
+
+        *g_core->cfg = original_cfg;
+        g_ctx.vr_set_fast_forward(original_fast_forward);
+        ds.active = false;
+
+        callback(res);
+    });
+
+    return Res_Ok;
+}
+
+bool ds_active()
+{
+    return ds.active;
+}
+
+void ds_cancel()
+{
+    ds.cancel = true;
+    ds.cv.notify_all();
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <include/core_api.h>
+
+/**
+ * \brief Notifies the desync bisection about a movie sample being polled during playback.
+ * \param sample The sample about to be consumed.
+ * \remarks Called from the emu thread with the VCR lock held.
+ */
+void ds_on_sample(int32_t sample);
+
+core_result ds_begin(const core_ds_params &params, const core_ds_callback &callback);
+bool ds_active();
+void ds_cancel();
@@ -15,7 +15,9 @@
 #include <r4300/exception.h>
 #include <r4300/vcr.h>
 #include <r4300/timers.h>
+#include <r4300/tracelog.h>
 #include <memory/pif.h>
+#include <null_plugins.h>
 
 typedef struct _interrupt_queue
 {
@@ -380,6 +382,15 @@ int32_t save_eventqueue_infos(char *buf)
     return len + 4;
 }
 
+void hash_eventqueue(HashUtils::xxh64_state &state)
+{
+    for (const interrupt_queue *aux = q; aux != NULL; aux = aux->next)
+    {
+        state.update(aux->type);
+        state.update(aux->count);
+    }
+}
+
 void load_eventqueue_infos(char *buf)
 {
     int32_t len = 0;
@@ -485,15 +496,16 @@ void gen_interrupt()
 
         // NOTE: When frame advancing, screen_invalidated has a higher change of being false despite the fact it should
         // be true The update-limiting logic doesn't apply in frameadvance because there are no high-frequency updates
-        if (update || frame_advance_outstanding)
+        if ((update || frame_advance_outstanding) && !null_plugin_active(null_plugin_video))
         {
             g_core->update_screen();
             screen_invalidated = false;
         }
 
-        g_core->callbacks.vi();
+        g_core->events.publish<core_event::vi>();
 
         vcr_on_vi();
+        tl_on_vi();
 
         timer_new_vi();
 
@@ -571,6 +583,7 @@ void gen_interrupt()
             MI_register.mi_intr_reg |= 0x04; // this too
             // return;
         }
+        audio_thread_notify();
         break;
 
     case SP_INT: // related to rsp
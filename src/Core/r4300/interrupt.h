@@ -22,6 +22,11 @@ uint32_t get_event(int32_t type);
 int32_t save_eventqueue_infos(char *buf);
 void load_eventqueue_infos(char *buf);
 
+/**
+ * \brief Feeds the pending events into a hash.
+ */
+void hash_eventqueue(HashUtils::xxh64_state &state);
+
 #define VI_INT 0x001
 #define COMPARE_INT 0x002
 #define CHECK_INT 0x004
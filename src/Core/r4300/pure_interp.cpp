@@ -3065,7 +3065,7 @@ void prefetch()
         interp_addr = addr;
         return;
     }
-    if (g_ctx.tl_active()) tracelog_log_pure();
+    if (tl_active()) tracelog_log_pure();
 }
 
 void pure_interpreter()
@@ -3075,7 +3075,7 @@ void pure_interpreter()
     PC = (precomp_instr *)malloc(sizeof(precomp_instr));
     last_addr = interp_addr;
     core_executing = true;
-    g_core->callbacks.core_executing_changed(core_executing);
+    g_core->events.publish<core_event::core_executing_changed>(core_executing);
     g_core->log_info(std::format("core_executing: {}", (bool)core_executing));
     while (!stop)
     {
@@ -3083,7 +3083,7 @@ void pure_interpreter()
         interp_ops[((vr_op >> 26) & 0x3F)]();
         g_vr_beq_ignore_jmp = false;
 
-        while (!g_ctx.dbg_get_resumed())
+        while (!dbg_get_resumed())
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
@@ -3100,7 +3100,7 @@ void interprete_section(uint32_t addr)
     while (!stop && (addr >> 12) == (interp_addr >> 12))
     {
         prefetch();
-        if (g_ctx.tl_active()) tracelog_log_pure();
+        if (tl_active()) tracelog_log_pure();
         PC->addr = interp_addr;
         interp_ops[((vr_op >> 26) & 0x3F)]();
     }
@@ -7,10 +7,12 @@
 #include "rom.h"
 #include <CommonPCH.h>
 #include <Core.h>
+#include <condition_variable>
 #include <format>
 #include <memory/memory.h>
 #include <memory/pif.h>
 #include <memory/savestates.h>
+#include <memory/summercart.h>
 #include <r4300/exception.h>
 #include <r4300/interrupt.h>
 #include <r4300/macros.h>
@@ -20,6 +22,7 @@
 #include <r4300/timers.h>
 #include <r4300/vcr.h>
 #include <alloc.h>
+#include <null_plugins.h>
 
 #ifdef _BIG_ENDIAN
 #error "Big Endian builds aren't supported"
@@ -133,7 +136,7 @@ void vr_resume_emu_impl(bool force)
         emu_paused = 0;
     }
 
-    g_core->callbacks.emu_paused_changed(emu_paused);
+    g_core->events.publish<core_event::emu_paused_changed>(emu_paused);
 }
 
 void vr_wait_increment()
@@ -163,7 +166,7 @@ void vr_pause_emu()
         emu_paused = 1;
     }
 
-    g_core->callbacks.emu_paused_changed(emu_paused);
+    g_core->events.publish<core_event::emu_paused_changed>(emu_paused);
 }
 
 void vr_frame_advance(size_t count)
@@ -1881,7 +1884,7 @@ void core_start()
         init_blocks();
         last_addr = PC->addr;
         core_executing = true;
-        g_core->callbacks.core_executing_changed(core_executing);
+        g_core->events.publish<core_event::core_executing_changed>(core_executing);
         g_core->log_info(std::format("core_executing: {}", (bool)core_executing));
         while (!stop)
         {
@@ -1943,7 +1946,7 @@ void core_start()
     }
     if (!dynacore && interpcore) free(PC);
     core_executing = false;
-    g_core->callbacks.core_executing_changed(core_executing);
+    g_core->events.publish<core_event::core_executing_changed>(core_executing);
 }
 
 bool open_core_file_stream(const std::filesystem::path &path, FILE **file)
@@ -1997,18 +2000,51 @@ void clear_save_data()
     fclose(g_mpak_file);
 }
 
+// The audio thread sleeps until the AI reports progress, polling at a decreasing rate while it doesn't.
+constexpr auto AUDIO_POLL_MIN = std::chrono::milliseconds(1);
+constexpr auto AUDIO_POLL_MAX = std::chrono::milliseconds(32);
+
+static struct
+{
+    std::mutex mtx{};
+    std::condition_variable cv{};
+    std::atomic<bool> pending{};
+} audio_signal;
+
+void audio_thread_notify()
+{
+    if (audio_signal.pending.exchange(true))
+    {
+        return;
+    }
+
+    // Taking the lock orders the flag before a waiter's predicate check, so the wakeup can't be lost.
+    {
+        std::scoped_lock lock(audio_signal.mtx);
+    }
+    audio_signal.cv.notify_one();
+}
+
 void audio_thread()
 {
     g_core->log_info("Sound thread entering...");
+    auto timeout = AUDIO_POLL_MIN;
     while (true)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        {
+            std::unique_lock lock(audio_signal.mtx);
+            audio_signal.cv.wait_for(lock, timeout,
+                                     [] { return audio_signal.pending.load() || audio_thread_stop_requested.load(); });
+        }
 
         if (audio_thread_stop_requested == true)
         {
             break;
         }
 
+        // Poll quickly while the AI is busy, and back off while it's idle, e.g. when paused.
+        timeout = audio_signal.pending.exchange(false) ? AUDIO_POLL_MIN : std::min(timeout * 2, AUDIO_POLL_MAX);
+
         if (g_vr_fast_forward && g_core->cfg->fastforward_silent)
         {
             continue;
@@ -2029,18 +2065,23 @@ void emu_thread()
     auto start_time = std::chrono::high_resolution_clock::now();
 
     g_core->initiate_plugins();
+    null_plugins_install();
 
     init_memory();
 
-    g_core->callbacks.emu_starting();
+    g_core->events.publish<core_event::emu_starting>();
 
     dynacore = g_core->cfg->core_type;
 
-    audio_thread_handle = std::thread(audio_thread);
+    // Without an audio plugin, nothing consumes the AI.
+    if (!null_plugin_active(null_plugin_audio))
+    {
+        audio_thread_handle = std::thread(audio_thread);
+    }
 
-    g_core->callbacks.emu_launched_changed(true);
-    g_core->callbacks.emu_starting_changed(false);
-    g_core->callbacks.reset();
+    g_core->events.publish<core_event::emu_launched_changed>(true);
+    g_core->events.publish<core_event::emu_starting_changed>(false);
+    g_core->events.publish<core_event::reset>();
 
     g_core->log_info(std::format(
         "[Core] Emu thread entry took {}ms",
@@ -2049,14 +2090,14 @@ void emu_thread()
 
     st_on_core_stop();
 
-    g_core->callbacks.emu_stopped();
+    g_core->events.publish<core_event::emu_stopped>();
 
     emu_paused = true;
     emu_launched = false;
 
     if (!emu_resetting)
     {
-        g_core->callbacks.emu_launched_changed(false);
+        g_core->events.publish<core_event::emu_launched_changed>(false);
     }
 }
 
@@ -2069,16 +2110,21 @@ core_result vr_close_rom_impl(bool stop_vcr)
 
     vr_resume_emu_impl(true);
 
-    audio_thread_stop_requested = true;
-    audio_thread_handle.join();
-    audio_thread_stop_requested = false;
+    if (audio_thread_handle.joinable())
+    {
+        audio_thread_stop_requested = true;
+        audio_thread_notify();
+        audio_thread_handle.join();
+        audio_thread_stop_requested = false;
+    }
+    audio_signal.pending = false;
 
     if (stop_vcr)
     {
         g_ctx.vcr_stop_all();
     }
 
-    g_core->callbacks.emu_stopping();
+    g_core->events.publish<core_event::emu_stopping>();
 
     g_core->log_info("[Core] Stopping emulation thread...");
 
@@ -2094,6 +2140,7 @@ core_result vr_close_rom_impl(bool stop_vcr)
     fclose(g_sram_file);
     fclose(g_fram_file);
     fclose(g_mpak_file);
+    close_summercart();
 
     return Res_Ok;
 }
@@ -2113,7 +2160,7 @@ core_result vr_start_rom_impl(std::filesystem::path path)
         }
     }
 
-    g_core->callbacks.emu_starting_changed(true);
+    g_core->events.publish<core_event::emu_starting_changed>(true);
 
     // If we get a movie instead of a rom, we try to search the available rom lists to find one matching the movie
     if (path.extension().compare(MUPEN64_PATH_T(".m64")) == 0)
@@ -2122,7 +2169,7 @@ core_result vr_start_rom_impl(std::filesystem::path path)
         const auto result = g_ctx.vcr_parse_header(path, &movie_header);
         if (result != Res_Ok)
         {
-            g_core->callbacks.emu_starting_changed(false);
+            g_core->events.publish<core_event::emu_starting_changed>(false);
             return result;
         }
 
@@ -2134,7 +2181,7 @@ core_result vr_start_rom_impl(std::filesystem::path path)
 
         if (matching_rom.empty())
         {
-            g_core->callbacks.emu_starting_changed(false);
+            g_core->events.publish<core_event::emu_starting_changed>(false);
             return VR_NoMatchingRom;
         }
 
@@ -2145,13 +2192,13 @@ core_result vr_start_rom_impl(std::filesystem::path path)
 
     if (!g_core->load_plugins())
     {
-        g_core->callbacks.emu_starting_changed(false);
+        g_core->events.publish<core_event::emu_starting_changed>(false);
         return VR_PluginError;
     }
 
     if (!rom_load(path.string().c_str()))
     {
-        g_core->callbacks.emu_starting_changed(false);
+        g_core->events.publish<core_event::emu_starting_changed>(false);
         return VR_RomInvalid;
     }
 
@@ -2161,7 +2208,7 @@ core_result vr_start_rom_impl(std::filesystem::path path)
         !open_core_file_stream(get_flashram_path(), &g_fram_file) ||
         !open_core_file_stream(get_mempak_path(), &g_mpak_file))
     {
-        g_core->callbacks.emu_starting_changed(false);
+        g_core->events.publish<core_event::emu_starting_changed>(false);
         return VR_FileOpenFailed;
     }
 
@@ -2220,7 +2267,7 @@ core_result vr_reset_rom_impl(bool reset_save_data, bool stop_vcr, bool skip_res
     if (result != Res_Ok)
     {
         emu_resetting = false;
-        g_core->callbacks.reset_completed();
+        g_core->events.publish<core_event::reset_completed>();
         return result;
     }
 
@@ -2233,12 +2280,12 @@ core_result vr_reset_rom_impl(bool reset_save_data, bool stop_vcr, bool skip_res
     if (result != Res_Ok)
     {
         emu_resetting = false;
-        g_core->callbacks.reset_completed();
+        g_core->events.publish<core_event::reset_completed>();
         return result;
     }
 
     emu_resetting = false;
-    g_core->callbacks.reset_completed();
+    g_core->events.publish<core_event::reset_completed>();
     return Res_Ok;
 }
 
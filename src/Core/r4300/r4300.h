@@ -68,6 +68,10 @@ void pure_interpreter();
 extern void jump_to_func();
 void update_count();
 int32_t check_cop1_unusable();
+/**
+ * \brief Wakes the audio thread up to update the audio plugin. Called when the AI's state changes.
+ */
+void audio_thread_notify();
 void critical_stop(std::string_view message = "Unknown error");
 
 core_result vr_reset_rom_impl(bool reset_save_data, bool stop_vcr, bool skip_reset_recording_check = false);
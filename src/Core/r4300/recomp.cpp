@@ -2939,7 +2939,7 @@ void recompile_block(int32_t *source, precomp_block *block, uint32_t func)
         dst->reg_cache_infos.need_map = 0;
         dst->local_addr = code_length;
         recomp_ops[((src >> 26) & 0x3F)]();
-        if (g_ctx.tl_active())
+        if (tl_active())
         {
             dst->s_ops = dst->ops;
             dst->ops = tracelog_log_interp_ops;
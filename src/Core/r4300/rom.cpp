@@ -13,8 +13,6 @@
 #include <r4300/r4300.h>
 #include <r4300/rom.h>
 
-std::unordered_map<std::filesystem::path, std::pair<uint8_t *, size_t>> rom_cache;
-
 uint8_t *rom;
 size_t rom_size;
 char rom_md5[33];
@@ -86,6 +84,21 @@ core_rom_header *rom_get_rom_header()
     return &ROM_HEADER;
 }
 
+bool rom_depends_on_frame_buffer()
+{
+    // Games which copy their rendered frames back into RDRAM, e.g. for photos or pause screen backgrounds. They're
+    // identified by the cartridge ID, which is shared by all regions and revisions.
+    static constexpr std::string_view ids[] = {
+        "PF", // Pokemon Snap
+        "ZS", // The Legend of Zelda: Majora's Mask
+        "MQ", // Paper Mario
+        "B7", // Banjo-Tooie
+    };
+
+    const std::string_view id(reinterpret_cast<const char *>(&ROM_HEADER.Cartridge_ID), 2);
+    return std::ranges::find(ids, id) != std::end(ids);
+}
+
 uint32_t rom_get_vis_per_second(uint16_t country_code)
 {
     switch (country_code & 0xFF)
@@ -111,95 +124,443 @@ uint32_t rom_get_vis_per_second(uint16_t country_code)
 
 void rom_byteswap(uint8_t *rom)
 {
-    uint8_t tmp = 0;
-
     if (rom[0] == 0x37)
     {
-        for (size_t i = 0; i < (0x40 / 2); i++)
-        {
-            tmp = rom[i * 2];
-            rom[i * 2] = rom[i * 2 + 1];
-            rom[i * 2 + 1] = tmp;
-        }
+        EndianUtils::swap16(rom, rom, 0x40);
     }
     if (rom[0] == 0x40)
     {
-        for (size_t i = 0; i < (0x40 / 4); i++)
+        EndianUtils::swap32(rom, rom, 0x40);
+    }
+}
+
+/**
+ * \brief The byte orders a ROM image can be stored in.
+ */
+enum class rom_order
+{
+    invalid,
+    // Big-endian, the cartridge's native order (.z64).
+    z64,
+    // Halfword-swapped (.v64).
+    v64,
+    // Little-endian words (.n64).
+    n64,
+};
+
+static rom_order get_rom_order(const uint8_t *data, const size_t size)
+{
+    if (size < sizeof(core_rom_header))
+    {
+        return rom_order::invalid;
+    }
+    if (data[0] == 0x37)
+    {
+        return rom_order::v64;
+    }
+    if (data[0] == 0x40)
+    {
+        return rom_order::n64;
+    }
+    if (data[0] == 0x80 && data[1] == 0x37 && data[2] == 0x12 && data[3] == 0x40)
+    {
+        return rom_order::z64;
+    }
+    return rom_order::invalid;
+}
+
+/**
+ * \brief Converts a ROM image from the specified order into the host's word order.
+ */
+static void convert_rom_to_native(const uint8_t *src, uint8_t *dst, const size_t size, const rom_order order)
+{
+    switch (order)
+    {
+    case rom_order::z64:
+        EndianUtils::swap32(dst, src, size);
+        break;
+    case rom_order::v64:
+        EndianUtils::swap32_halves(dst, src, size);
+        break;
+    default:
+        memcpy(dst, src, size);
+        break;
+    }
+}
+
+/**
+ * \brief Converts a ROM image from the specified order into the big-endian order.
+ */
+static void convert_rom_to_z64(const uint8_t *src, uint8_t *dst, const size_t size, const rom_order order)
+{
+    switch (order)
+    {
+    case rom_order::v64:
+        EndianUtils::swap16(dst, src, size);
+        break;
+    case rom_order::n64:
+        EndianUtils::swap32(dst, src, size);
+        break;
+    default:
+        memcpy(dst, src, size);
+        break;
+    }
+}
+
+/**
+ * \brief Computes the MD5 of a ROM image in its big-endian order.
+ */
+static void compute_rom_md5(const uint8_t *src, const size_t size, const rom_order order, char (&md5)[33])
+{
+    md5_state_t state;
+    md5_byte_t digest[16];
+    md5_init(&state);
+
+    if (order == rom_order::z64)
+    {
+        md5_append(&state, src, size);
+    }
+    else
+    {
+        constexpr size_t chunk_size = 0x10000;
+        std::vector<uint8_t> chunk(chunk_size);
+        for (size_t offset = 0; offset < size; offset += chunk_size)
         {
-            tmp = rom[i * 4];
-            rom[i * 4] = rom[i * 4 + 3];
-            rom[i * 4 + 3] = tmp;
-            tmp = rom[i * 4 + 1];
-            rom[i * 4 + 1] = rom[i * 4 + 2];
-            rom[i * 4 + 2] = tmp;
+            const size_t len = std::min(chunk_size, size - offset);
+            convert_rom_to_z64(src + offset, chunk.data(), len, order);
+            md5_append(&state, chunk.data(), len);
         }
     }
+
+    md5_finish(&state, digest);
+
+    char *sp = md5;
+    for (size_t i = 0; i < 16; i++)
+    {
+        sp = std::format_to(sp, "{:02X}", digest[i]);
+    }
+    *sp = '\0';
 }
 
-bool rom_load(std::filesystem::path path)
+/**
+ * \brief A ROM image converted to the host's word order.
+ */
+struct t_rom_image
 {
-    if (rom)
+    // The mapping of the converted image in the shared ROM cache, if it could be used.
+    std::unique_ptr<IOUtils::mapped_file> file;
+    std::filesystem::path cache_path;
+    // The converted image, if it isn't mapped.
+    std::vector<uint8_t> buffer;
+    size_t size{};
+    char md5[33]{};
+    uint64_t source_size{};
+    int64_t source_time{};
+
+    uint8_t *data()
     {
-        free(rom);
-        g_ctx.rom = rom = nullptr;
+        return file ? file->mutable_data() : buffer.data();
     }
+};
 
-    if (rom_cache.contains(path))
+#define ROM_CACHE_MAGIC "M64ROMC"
+#define ROM_CACHE_VERSION 1
+
+/**
+ * \brief Trailer of a converted image in the shared ROM cache. Stored after the image so the image itself can be
+ * mapped from the start of the file.
+ */
+struct t_rom_cache_trailer
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t source_size;
+    int64_t source_time;
+    uint64_t size;
+    char md5[40];
+};
+
+// The cached images are never handed to the emulator, so they stay as they were loaded.
+static std::unordered_map<std::filesystem::path, std::shared_ptr<t_rom_image>> rom_cache;
+static std::shared_ptr<t_rom_image> rom_image;
+// A private copy of the image, used when the ROM is writable.
+static std::vector<uint8_t> rom_private;
+
+/**
+ * \brief Gets the path in the shared ROM cache for the converted image of a ROM.
+ */
+static std::filesystem::path get_shared_cache_path(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    const auto absolute = std::filesystem::absolute(path, ec).u8string();
+    const auto hash = HashUtils::xxh64(absolute.data(), absolute.size());
+    return std::filesystem::temp_directory_path(ec) / "mupen64-roms" / std::format("{:016X}.rom", hash);
+}
+
+/**
+ * \brief Maps a converted image from the shared ROM cache.
+ * \return The image, or nullptr if there is no up-to-date image for the ROM.
+ */
+static std::shared_ptr<t_rom_image> open_shared_image(const std::filesystem::path &cache_path,
+                                                      const uint64_t source_size, const int64_t source_time)
+{
+    auto file = std::make_unique<IOUtils::mapped_file>(cache_path, IOUtils::map_mode::copy_on_write);
+    if (!file->valid() || file->size() < sizeof(t_rom_cache_trailer))
     {
-        g_core->log_info("[Core] Loading cached ROM...");
-        g_ctx.rom = rom = (unsigned char *)malloc(rom_cache[path].second);
-        memcpy(rom, rom_cache[path].first, rom_cache[path].second);
-        return true;
+        return nullptr;
+    }
+
+    t_rom_cache_trailer trailer{};
+    memcpy(&trailer, file->data() + file->size() - sizeof(trailer), sizeof(trailer));
+    if (memcmp(trailer.magic, ROM_CACHE_MAGIC, sizeof(trailer.magic)) || trailer.version != ROM_CACHE_VERSION ||
+        trailer.source_size != source_size || trailer.source_time != source_time ||
+        trailer.size != file->size() - sizeof(trailer))
+    {
+        return nullptr;
+    }
+
+    // The modification time orders the images for eviction.
+    std::error_code ec;
+    std::filesystem::last_write_time(cache_path, std::filesystem::file_time_type::clock::now(), ec);
+
+    auto image = std::make_shared<t_rom_image>();
+    image->file = std::move(file);
+    image->cache_path = cache_path;
+    image->size = trailer.size;
+    memcpy(image->md5, trailer.md5, sizeof(image->md5) - 1);
+    image->source_size = source_size;
+    image->source_time = source_time;
+    return image;
+}
+
+/**
+ * \brief Removes the least recently used images from the shared ROM cache until at most the specified amount is left.
+ */
+static void evict_shared_images(const std::filesystem::path &directory, const size_t max_count)
+{
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> images;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec))
+    {
+        if (entry.path().extension() == ".rom")
+        {
+            images.emplace_back(entry.last_write_time(ec), entry.path());
+        }
+    }
+
+    if (images.size() <= max_count)
+    {
+        return;
     }
 
-    auto rom_buf = IOUtils::read_entire_file(path);
-    auto decompressed_rom = MiscHelpers::auto_decompress(rom_buf, 8000000);
+    std::ranges::sort(images, std::greater{}, &decltype(images)::value_type::first);
+    for (size_t i = max_count; i < images.size(); ++i)
+    {
+        // Images mapped by other instances stay readable through their mappings, or can't be removed at all.
+        std::filesystem::remove(images[i].second, ec);
+    }
+}
 
-    if (decompressed_rom.empty())
+/**
+ * \brief Writes a converted image to the shared ROM cache.
+ */
+static bool write_shared_image(const std::filesystem::path &cache_path, const t_rom_image &image,
+                               const uint64_t source_size, const int64_t source_time)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(cache_path.parent_path(), ec);
+
+    t_rom_cache_trailer trailer{};
+    memcpy(trailer.magic, ROM_CACHE_MAGIC, sizeof(trailer.magic));
+    trailer.version = ROM_CACHE_VERSION;
+    trailer.source_size = source_size;
+    trailer.source_time = source_time;
+    trailer.size = image.size;
+    memcpy(trailer.md5, image.md5, sizeof(image.md5));
+
+    // Other instances may be mapping the same image, so it's written to a temporary file and swapped in.
+    auto tmp_path = cache_path;
+    tmp_path += std::format(".{}.tmp", std::chrono::steady_clock::now().time_since_epoch().count());
+
+    FILE *f = nullptr;
+    if (IOUtils::path_fopen_s(f, tmp_path, "wb"))
     {
         return false;
     }
+    bool ok = fwrite(image.buffer.data(), 1, image.size, f) == image.size;
+    ok &= fwrite(&trailer, sizeof(trailer), 1, f) == 1;
+    fclose(f);
+
+    if (ok)
+    {
+        std::filesystem::rename(tmp_path, cache_path, ec);
+        ok = !ec;
+    }
+    if (!ok)
+    {
+        std::filesystem::remove(tmp_path, ec);
+    }
+    return ok;
+}
 
-    rom_size = decompressed_rom.size();
-    uint32_t taille = rom_size;
-    if (g_core->cfg->use_summercart && taille < 0x4000000) taille = 0x4000000;
+/**
+ * \brief Converts a ROM into the host's word order, computing its MD5 alongside.
+ */
+static std::shared_ptr<t_rom_image> convert_image(const uint8_t *src, const size_t size)
+{
+    const auto order = get_rom_order(src, size);
+    if (order == rom_order::invalid)
+    {
+        g_core->log_info("wrong file format!");
+        return nullptr;
+    }
 
-    g_ctx.rom = rom = (unsigned char *)malloc(taille);
-    memcpy(rom, decompressed_rom.data(), rom_size);
+    auto image = std::make_shared<t_rom_image>();
+    image->size = size;
+    image->buffer.resize(size);
 
-    uint8_t tmp;
-    if (rom[0] == 0x37)
+    // Both passes only read from the source, so the MD5 doesn't have to wait for the conversion.
+    std::thread md5_thread([&] { compute_rom_md5(src, size, order, image->md5); });
+    convert_rom_to_native(src, image->buffer.data(), size, order);
+    md5_thread.join();
+
+    return image;
+}
+
+/**
+ * \brief Loads and converts a ROM.
+ * \param path The ROM's path.
+ * \param shared_cache_size The amount of images kept in the shared ROM cache. If 0, the shared cache isn't used.
+ */
+static std::shared_ptr<t_rom_image> load_image(const std::filesystem::path &path, const size_t shared_cache_size)
+{
+    std::error_code ec;
+    const auto source_size = static_cast<uint64_t>(std::filesystem::file_size(path, ec));
+    if (ec)
     {
-        for (size_t i = 0; i < (rom_size / 2); i++)
+        return nullptr;
+    }
+    const auto source_time =
+        static_cast<int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+
+    const auto cache_path = get_shared_cache_path(path);
+    if (shared_cache_size > 0)
+    {
+        if (auto image = open_shared_image(cache_path, source_size, source_time))
         {
-            tmp = rom[i * 2];
-            rom[i * 2] = rom[i * 2 + 1];
-            rom[i * 2 + 1] = (unsigned char)tmp;
+            g_core->log_info("[Core] Mapped ROM from the shared cache");
+            return image;
         }
     }
-    if (rom[0] == 0x40)
+
+    std::shared_ptr<t_rom_image> image;
     {
-        for (size_t i = 0; i < (rom_size / 4); i++)
+        IOUtils::mapped_file file(path);
+        if (!file.valid())
+        {
+            return nullptr;
+        }
+
+        if (file.size() >= 2 && file.data()[0] == 0x1F && file.data()[1] == 0x8B)
+        {
+            const auto decompressed = MiscHelpers::auto_decompress(IOUtils::read_entire_file(path), 8000000);
+            image = convert_image(decompressed.data(), decompressed.size());
+        }
+        else
         {
-            tmp = rom[i * 4];
-            rom[i * 4] = rom[i * 4 + 3];
-            rom[i * 4 + 3] = (unsigned char)tmp;
-            tmp = rom[i * 4 + 1];
-            rom[i * 4 + 1] = rom[i * 4 + 2];
-            rom[i * 4 + 2] = (unsigned char)tmp;
+            image = convert_image(file.data(), file.size());
         }
     }
-    else if ((rom[0] != 0x80) || (rom[1] != 0x37) || (rom[2] != 0x12) || (rom[3] != 0x40)
 
-    )
+    if (!image || shared_cache_size == 0)
     {
-        g_core->log_info("wrong file format!");
-        return false;
+        return image;
+    }
+
+    // Once the image is in the shared cache, it's swapped for the mapping so instances share the same pages.
+    if (write_shared_image(cache_path, *image, source_size, source_time))
+    {
+        evict_shared_images(cache_path.parent_path(), shared_cache_size);
+        if (auto shared = open_shared_image(cache_path, source_size, source_time))
+        {
+            return shared;
+        }
+    }
+
+    return image;
+}
+
+/**
+ * \brief Gets a copy of a cached image which the emulator can write to without changing the cached image.
+ */
+static std::shared_ptr<t_rom_image> make_private_image(t_rom_image &image)
+{
+    // A new copy-on-write mapping starts out with the file's contents, so it shares the pages but not the writes.
+    if (image.file)
+    {
+        if (auto view = open_shared_image(image.cache_path, image.source_size, image.source_time))
+        {
+            return view;
+        }
+    }
+
+    auto copy = std::make_shared<t_rom_image>();
+    copy->buffer.assign(image.data(), image.data() + image.size);
+    copy->size = image.size;
+    memcpy(copy->md5, image.md5, sizeof(copy->md5));
+    return copy;
+}
+
+bool rom_load(std::filesystem::path path)
+{
+    g_ctx.rom = rom = nullptr;
+    rom_image = nullptr;
+    rom_private.clear();
+
+    const auto cache_size = static_cast<size_t>(std::max(g_core->cfg->rom_cache_size, 0));
+
+    if (rom_cache.contains(path))
+    {
+        g_core->log_info("[Core] Loading cached ROM...");
+        rom_image = make_private_image(*rom_cache[path]);
+    }
+    else
+    {
+        rom_image = load_image(path, cache_size);
+        if (!rom_image)
+        {
+            return false;
+        }
+
+        if (rom_cache.size() < cache_size)
+        {
+            g_core->log_info(
+                std::format("[Core] Putting ROM in cache... ({}/{} full)\n", rom_cache.size(), cache_size));
+            rom_cache[path] = rom_image;
+            rom_image = make_private_image(*rom_image);
+        }
+    }
+
+    rom_size = rom_image->size;
+    memcpy(rom_md5, rom_image->md5, sizeof(rom_md5));
+
+    // The SummerCart can write to the ROM and expects the full 64MB to be addressable, so it gets a private copy.
+    if (g_core->cfg->use_summercart)
+    {
+        rom_private.resize(std::max(rom_size, (size_t)0x4000000));
+        memcpy(rom_private.data(), rom_image->data(), rom_size);
+        g_ctx.rom = rom = rom_private.data();
+    }
+    else
+    {
+        g_ctx.rom = rom = rom_image->data();
     }
 
     g_core->log_info("rom loaded succesfully");
 
-    memcpy(&ROM_HEADER, rom, sizeof(core_rom_header));
+    // The header is kept in the big-endian order.
+    EndianUtils::swap32(&ROM_HEADER, rom, sizeof(core_rom_header));
     ROM_HEADER.unknown = 0;
     // Clean up ROMs that accidentally set the unused bytes (ensuring previous fields are null terminated)
     ROM_HEADER.Unknown[0] = 0;
@@ -208,26 +569,6 @@ bool rom_load(std::filesystem::path path)
     // trim header
     MiscHelpers::strtrim((char *)ROM_HEADER.nom, sizeof(ROM_HEADER.nom));
 
-    {
-        md5_state_t state;
-        md5_byte_t digest[16];
-        md5_init(&state);
-        md5_append(&state, rom, rom_size);
-        md5_finish(&state, digest);
-
-        // extra insurance for weird safety bugs
-        char str_temp[256] = {0};
-        char* sp = &str_temp[0];
-        for (size_t i = 0; i < 16; i++) {
-            sp = std::format_to(sp, "{:02X}", digest[i]);
-        }
-        *sp = '\0';
-        strncpy(rom_md5, str_temp, sizeof(rom_md5));
-    }
-
-    auto roml = (uint32_t *)rom;
-    for (size_t i = 0; i < (rom_size / 4); i++) roml[i] = std::byteswap(roml[i]);
-
     switch (ROM_HEADER.Country_code & 0xFF)
     {
     case 0x44:
@@ -252,14 +593,5 @@ bool rom_load(std::filesystem::path path)
         break;
     }
 
-    if (rom_cache.size() < g_core->cfg->rom_cache_size)
-    {
-        g_core->log_info(std::format("[Core] Putting ROM in cache... ({}/{} full)\n", rom_cache.size(),
-                                     g_core->cfg->rom_cache_size));
-        auto data = (uint8_t *)malloc(taille);
-        memcpy(data, rom, taille);
-        rom_cache[path] = std::make_pair(data, taille);
-    }
-
     return true;
 }
@@ -23,5 +23,11 @@ bool rom_load(std::filesystem::path path);
 void rom_byteswap(uint8_t *rom);
 
 core_rom_header *rom_get_rom_header();
+
+/**
+ * \brief Gets whether the loaded rom reads back the frames it rendered, so its display lists must be processed even
+ * for frames which are never shown.
+ */
+bool rom_depends_on_frame_buffer();
 uint32_t rom_get_vis_per_second(uint16_t country_code);
 std::string rom_country_code_to_country_name(uint16_t country_code);
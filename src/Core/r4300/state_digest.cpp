@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include <memory/memory.h>
+#include <r4300/interrupt.h>
+#include <r4300/r4300.h>
+#include <r4300/state_digest.h>
+
+uint64_t dg_compute()
+{
+    // NOTE: RDRAM is rehashed in full every time. Plugins, the dynarec and the host all write to it directly, so there
+    // is no reliable way of knowing which pages changed since the last VI.
+    HashUtils::xxh64_state state;
+    state.update(rdram, sizeof(rdram));
+    state.update(reg);
+    state.update(hi);
+    state.update(lo);
+    state.update(reg_cop0);
+    state.update(reg_cop1_fgr_64);
+    state.update(FCR31);
+    state.update(llbit);
+    state.update(!dynacore && interpcore ? interp_addr : PC->addr);
+    hash_eventqueue(state);
+    return state.digest();
+}
+
+std::filesystem::path dg_sidecar_path(const std::filesystem::path &movie_path)
+{
+    auto path = movie_path;
+    path.replace_extension(".dgst");
+    return path;
+}
+
+bool dg_read(const std::filesystem::path &path, const uint32_t movie_uid, std::vector<uint64_t> &digests)
+{
+    const auto buf = IOUtils::read_entire_file(path);
+    if (buf.size() < sizeof(t_dg_header))
+    {
+        return false;
+    }
+
+    t_dg_header header{};
+    memcpy(&header, buf.data(), sizeof(header));
+    if (memcmp(header.magic, DG_MAGIC, sizeof(header.magic)) || header.version != DG_VERSION ||
+        header.movie_uid != movie_uid)
+    {
+        return false;
+    }
+
+    if (buf.size() != sizeof(header) + (size_t)header.count * sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    digests.resize(header.count);
+    memcpy(digests.data(), buf.data() + sizeof(header), header.count * sizeof(uint64_t));
+    return true;
+}
+
+bool dg_write(const std::filesystem::path &path, const uint32_t movie_uid, const std::vector<uint64_t> &digests)
+{
+    FILE *f = nullptr;
+    if (IOUtils::path_fopen_s(f, path, "wb"))
+    {
+        return false;
+    }
+
+    t_dg_header header{};
+    memcpy(header.magic, DG_MAGIC, sizeof(header.magic));
+    header.version = DG_VERSION;
+    header.movie_uid = movie_uid;
+    header.count = digests.size();
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok &= fwrite(digests.data(), sizeof(uint64_t), digests.size(), f) == digests.size();
+    fclose(f);
+    return ok;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Per-VI state digests.
+ *
+ * A digest is a 64-bit hash of the machine state which matters for sync. While a movie is recorded or played back
+ * with digests enabled, one digest is taken per VI and the stream is stored next to the movie as a sidecar file
+ * (<movie>.dgst). Playing the movie back later compares the live digests against the stored ones, so a desync is
+ * noticed on the VI it happens instead of whenever it becomes visible.
+ */
+
+#define DG_MAGIC "M64DGST"
+#define DG_VERSION 1
+
+struct t_dg_header
+{
+    char magic[8];
+    uint32_t version;
+    // The UID of the movie the digests were taken from.
+    uint32_t movie_uid;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+/**
+ * \brief Computes a digest of the current machine state: RDRAM, the CPU registers and the pending events.
+ * \remarks Must be called from the emu thread.
+ */
+uint64_t dg_compute();
+
+/**
+ * \brief Gets the path of the digest sidecar belonging to a movie.
+ */
+std::filesystem::path dg_sidecar_path(const std::filesystem::path &movie_path);
+
+/**
+ * \brief Reads a digest sidecar.
+ * \param path The sidecar path.
+ * \param movie_uid The UID of the movie the sidecar must belong to.
+ * \param digests The digests read from the sidecar.
+ * \return Whether the operation succeeded. Fails if the sidecar belongs to another movie.
+ */
+bool dg_read(const std::filesystem::path &path, uint32_t movie_uid, std::vector<uint64_t> &digests);
+
+/**
+ * \brief Writes a digest sidecar.
+ * \param path The sidecar path.
+ * \param movie_uid The UID of the movie the digests were taken from.
+ * \param digests The digests to write.
+ * \return Whether the operation succeeded.
+ */
+bool dg_write(const std::filesystem::path &path, uint32_t movie_uid, const std::vector<uint64_t> &digests);
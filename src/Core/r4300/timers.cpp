@@ -87,7 +87,7 @@ void timer_new_frame()
     timer.frame_deltas_mtx.unlock();
     timer.frame_deltas_ptr = (timer.frame_deltas_ptr + 1) % core_timer_max_deltas;
 
-    g_core->callbacks.frame();
+    g_core->events.publish<core_event::frame>();
     timer.last_frame_time = std::chrono::high_resolution_clock::now();
 }
 
@@ -95,7 +95,7 @@ void timer_new_vi()
 {
     if (g_core->cfg->max_lag != 0 && lag_count >= g_core->cfg->max_lag)
     {
-        g_core->callbacks.lag_limit_exceeded();
+        g_core->events.publish<core_event::lag_limit_exceeded>();
     }
 
     auto current_vi_time = std::chrono::high_resolution_clock::now();
@@ -5,13 +5,18 @@
  */
 
 #include <CommonPCH.h>
+#include <Core.h>
 #include "tracelog.h"
+#include "tracelog_index.h"
 #include "disasm.h"
 #include "r4300.h"
 
 bool enabled = false;
 bool use_binary = false;
 
+std::filesystem::path log_path;
+t_tl_index_builder index_builder;
+
 FILE *log_file;
 char traceLoggingBuf[0x10000];
 char *traceLoggingPointer = traceLoggingBuf;
@@ -136,6 +141,7 @@ void log_bin(uint32_t pc, uint32_t w)
         NONE;
         break;
     }
+    index_builder.push(*(t_tl_record *)(p - sizeof(t_tl_record)));
     write_buf();
 #undef HEX8
 #undef REGCPU
@@ -328,9 +334,19 @@ void tracelog_log_interp_ops()
     PC->s_ops();
 }
 
+void tl_on_vi()
+{
+    if (enabled && use_binary)
+    {
+        index_builder.on_vi();
+    }
+}
+
 void tl_start(std::filesystem::path path, bool binary, bool append)
 {
     use_binary = binary;
+    log_path = path;
+    index_builder.reset();
     IOUtils::path_fopen_s(log_file, path, "wb");
 
     enabled = true;
@@ -345,4 +361,10 @@ void tl_stop()
     enabled = false;
     flush_buf();
     fclose(log_file);
+
+    if (use_binary && !index_builder.save(tl_index_path(log_path)))
+    {
+        g_core->log_error(std::format("[TL] Failed to write trace index for {}", log_path.string()));
+    }
+    index_builder.reset();
 }
@@ -18,5 +18,10 @@ void tracelog_log_pure();
 
 bool tl_active();
 
+/**
+ * \brief Notifies the tracelogger about a VI. Used to build the trace index.
+ */
+void tl_on_vi();
+
 void tl_start(std::filesystem::path path, bool binary, bool append);
 void tl_stop();
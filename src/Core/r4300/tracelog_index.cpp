@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "tracelog_index.h"
+#include "disasm.h"
+
+static size_t page_of(uint32_t addr)
+{
+    return (addr >> TL_INDEX_PAGE_SHIFT) & (TL_INDEX_PAGE_BITS - 1);
+}
+
+static void set_page(uint64_t *pages, uint32_t addr)
+{
+    const auto page = page_of(addr);
+    pages[page / 64] |= 1ULL << (page % 64);
+}
+
+static bool test_page(const uint64_t *pages, uint32_t addr)
+{
+    const auto page = page_of(addr);
+    return pages[page / 64] & (1ULL << (page % 64));
+}
+
+static bool is_store(uint32_t w)
+{
+    const auto format = InstFormat[GetInstruction(w)];
+    return format == INSTF_ADDRW || format == INSTF_LFW;
+}
+
+/**
+ * \brief Gets the access width of a store instruction in bytes.
+ */
+static uint32_t store_size(uint32_t w)
+{
+    switch (GetInstruction(w))
+    {
+    case INST_SB:
+        return 1;
+    case INST_SH:
+        return 2;
+    case INST_SD:
+    case INST_SDL:
+    case INST_SDR:
+    case INST_SCD:
+    case INST_SDC1:
+        return 8;
+    default:
+        return 4;
+    }
+}
+
+static t_tl_chunk make_chunk(uint64_t first_record, uint32_t vi)
+{
+    t_tl_chunk chunk{};
+    chunk.first_record = first_record;
+    chunk.first_vi = vi;
+    chunk.last_vi = vi;
+    chunk.pc_min = UINT32_MAX;
+    chunk.write_min = UINT32_MAX;
+    return chunk;
+}
+
+void t_tl_index_builder::reset()
+{
+    chunks.clear();
+    vi_records.clear();
+    record_count = 0;
+}
+
+void t_tl_index_builder::push(const t_tl_record &record)
+{
+    const auto vi = static_cast<uint32_t>(vi_records.size());
+
+    if (chunks.empty() || chunks.back().record_count == TL_INDEX_CHUNK_RECORDS)
+    {
+        chunks.push_back(make_chunk(record_count, vi));
+    }
+
+    auto &chunk = chunks.back();
+    chunk.record_count++;
+    chunk.last_vi = vi;
+    chunk.pc_min = std::min(chunk.pc_min, record.pc);
+    chunk.pc_max = std::max(chunk.pc_max, record.pc);
+    set_page(chunk.pc_pages, record.pc);
+
+    if (is_store(record.w))
+    {
+        chunk.write_min = std::min(chunk.write_min, record.operand1);
+        chunk.write_max = std::max(chunk.write_max, record.operand1 + store_size(record.w) - 1);
+        set_page(chunk.write_pages, record.operand1);
+    }
+
+    record_count++;
+}
+
+void t_tl_index_builder::on_vi()
+{
+    vi_records.push_back(record_count);
+}
+
+bool t_tl_index_builder::save(const std::filesystem::path &path) const
+{
+    FILE *f = nullptr;
+    if (IOUtils::path_fopen_s(f, path, "wb"))
+    {
+        return false;
+    }
+
+    t_tl_index_header header{};
+    memcpy(header.magic, TL_INDEX_MAGIC, sizeof(header.magic));
+    header.version = TL_INDEX_VERSION;
+    header.record_size = sizeof(t_tl_record);
+    header.chunk_records = TL_INDEX_CHUNK_RECORDS;
+    header.chunk_count = chunks.size();
+    header.vi_count = vi_records.size();
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok &= fwrite(chunks.data(), sizeof(t_tl_chunk), chunks.size(), f) == chunks.size();
+    ok &= fwrite(vi_records.data(), sizeof(uint64_t), vi_records.size(), f) == vi_records.size();
+    fclose(f);
+    return ok;
+}
+
+std::span<const t_tl_record> t_tl_trace::records() const
+{
+    if (!file || !file->valid())
+    {
+        return {};
+    }
+    return {reinterpret_cast<const t_tl_record *>(file->data()), file->size() / sizeof(t_tl_record)};
+}
+
+std::filesystem::path tl_index_path(const std::filesystem::path &trace_path)
+{
+    auto path = trace_path;
+    path += ".tlidx";
+    return path;
+}
+
+static void build_index(std::span<const t_tl_record> records, t_tl_index_builder &builder)
+{
+    builder.reset();
+    for (const auto &record : records)
+    {
+        builder.push(record);
+    }
+}
+
+bool tl_index_build(const std::filesystem::path &trace_path, t_tl_index_builder &builder)
+{
+    IOUtils::mapped_file file(trace_path);
+    if (!file.valid())
+    {
+        return false;
+    }
+
+    build_index({reinterpret_cast<const t_tl_record *>(file.data()), file.size() / sizeof(t_tl_record)}, builder);
+    return true;
+}
+
+/**
+ * \brief Loads a sidecar index, verifying that it matches the given record count.
+ */
+static bool load_index(const std::filesystem::path &path, uint64_t record_count, t_tl_trace &trace)
+{
+    const auto buf = IOUtils::read_entire_file(path);
+    if (buf.size() < sizeof(t_tl_index_header))
+    {
+        return false;
+    }
+
+    t_tl_index_header header{};
+    memcpy(&header, buf.data(), sizeof(header));
+    if (memcmp(header.magic, TL_INDEX_MAGIC, sizeof(header.magic)) || header.version != TL_INDEX_VERSION ||
+        header.record_size != sizeof(t_tl_record))
+    {
+        return false;
+    }
+
+    const size_t expected_size = sizeof(header) + (size_t)header.chunk_count * sizeof(t_tl_chunk) +
+                                 (size_t)header.vi_count * sizeof(uint64_t);
+    if (buf.size() != expected_size)
+    {
+        return false;
+    }
+
+    trace.chunks.resize(header.chunk_count);
+    trace.vi_records.resize(header.vi_count);
+    memcpy(trace.chunks.data(), buf.data() + sizeof(header), header.chunk_count * sizeof(t_tl_chunk));
+    memcpy(trace.vi_records.data(), buf.data() + sizeof(header) + header.chunk_count * sizeof(t_tl_chunk),
+           header.vi_count * sizeof(uint64_t));
+
+    // The trace may have been appended to or truncated since the index was written.
+    uint64_t indexed = 0;
+    for (const auto &chunk : trace.chunks)
+    {
+        indexed += chunk.record_count;
+    }
+    return indexed == record_count;
+}
+
+bool tl_trace_open(const std::filesystem::path &path, t_tl_trace &trace)
+{
+    trace.file = std::make_unique<IOUtils::mapped_file>(path);
+    trace.chunks.clear();
+    trace.vi_records.clear();
+
+    if (!trace.file->valid())
+    {
+        return false;
+    }
+
+    if (load_index(tl_index_path(path), trace.records().size(), trace))
+    {
+        return true;
+    }
+
+    t_tl_index_builder builder;
+    build_index(trace.records(), builder);
+    builder.save(tl_index_path(path));
+
+    trace.chunks = std::move(builder.chunks);
+    trace.vi_records = std::move(builder.vi_records);
+    return true;
+}
+
+void tl_query_pc(const t_tl_trace &trace, uint32_t pc, const tl_query_callback &callback)
+{
+    const auto records = trace.records();
+
+    for (const auto &chunk : trace.chunks)
+    {
+        if (pc < chunk.pc_min || pc > chunk.pc_max || !test_page(chunk.pc_pages, pc))
+        {
+            continue;
+        }
+
+        for (uint64_t i = chunk.first_record; i < chunk.first_record + chunk.record_count; ++i)
+        {
+            if (records[i].pc == pc && !callback(i, records[i]))
+            {
+                return;
+            }
+        }
+    }
+}
+
+void tl_query_writes(const t_tl_trace &trace, uint32_t addr, uint32_t size, const tl_query_callback &callback)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    const auto records = trace.records();
+    const uint32_t last = addr + size - 1;
+
+    for (const auto &chunk : trace.chunks)
+    {
+        if (chunk.write_min > chunk.write_max || last < chunk.write_min || addr > chunk.write_max)
+        {
+            continue;
+        }
+
+        bool any_page = false;
+        for (uint64_t page_addr = addr & ~((1ULL << TL_INDEX_PAGE_SHIFT) - 1); page_addr <= last && !any_page;
+             page_addr += 1ULL << TL_INDEX_PAGE_SHIFT)
+        {
+            // Stores are indexed by their start address, so a store can straddle into the range from the page
+            // before it.
+            any_page = test_page(chunk.write_pages, (uint32_t)page_addr) ||
+                       test_page(chunk.write_pages, (uint32_t)page_addr - (1U << TL_INDEX_PAGE_SHIFT));
+        }
+        if (!any_page)
+        {
+            continue;
+        }
+
+        for (uint64_t i = chunk.first_record; i < chunk.first_record + chunk.record_count; ++i)
+        {
+            const auto &record = records[i];
+            if (!is_store(record.w))
+            {
+                continue;
+            }
+
+            const uint32_t store_last = record.operand1 + store_size(record.w) - 1;
+            if (record.operand1 <= last && store_last >= addr && !callback(i, record))
+            {
+                return;
+            }
+        }
+    }
+}
+
+uint32_t tl_record_vi(const t_tl_trace &trace, uint64_t record)
+{
+    return std::upper_bound(trace.vi_records.begin(), trace.vi_records.end(), record) - trace.vi_records.begin();
+}
+
+std::span<const t_tl_record> tl_vi_records(const t_tl_trace &trace, uint32_t vi)
+{
+    const auto records = trace.records();
+
+    if (vi > trace.vi_records.size())
+    {
+        return {};
+    }
+
+    const uint64_t first = vi == 0 ? 0 : trace.vi_records[vi - 1];
+    const uint64_t end = vi == trace.vi_records.size() ? records.size() : trace.vi_records[vi];
+    if (first > end || end > records.size())
+    {
+        return {};
+    }
+
+    return records.subspan(first, end - first);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * Index for binary tracelogs.
+ *
+ * A binary tracelog is a flat stream of fixed-size records. The index is stored next to it as a sidecar file
+ * (<trace>.tlidx) and splits the stream into chunks of TL_INDEX_CHUNK_RECORDS records. Each chunk carries its PC
+ * range, the VIs it spans, and coarse page bitmaps of executed and written addresses, so queries only have to
+ * touch the chunks which can possibly match.
+ */
+
+#define TL_INDEX_MAGIC "M64TLIX"
+#define TL_INDEX_VERSION 1
+#define TL_INDEX_CHUNK_RECORDS 0x10000
+#define TL_INDEX_PAGE_SHIFT 12
+#define TL_INDEX_PAGE_BITS 2048
+
+/**
+ * \brief A single record of a binary tracelog, as written by <c>log_bin</c>.
+ */
+struct t_tl_record
+{
+    uint32_t pc;
+    uint32_t w;
+    uint32_t operand1;
+    uint32_t operand2;
+};
+
+static_assert(sizeof(t_tl_record) == 16);
+
+struct t_tl_index_header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t chunk_records;
+    uint32_t chunk_count;
+    uint32_t vi_count;
+    uint32_t reserved;
+};
+
+/**
+ * \brief Describes a chunk of consecutive records.
+ */
+struct t_tl_chunk
+{
+    uint64_t first_record;
+    uint32_t record_count;
+    // The VI count at the first and last record of the chunk.
+    uint32_t first_vi;
+    uint32_t last_vi;
+    uint32_t pc_min;
+    uint32_t pc_max;
+    // Write address range. write_min > write_max if the chunk contains no stores.
+    uint32_t write_min;
+    uint32_t write_max;
+    uint32_t reserved;
+    // Bitmaps of 4KB pages (modulo 8MB) which were executed from or written to.
+    uint64_t pc_pages[TL_INDEX_PAGE_BITS / 64];
+    uint64_t write_pages[TL_INDEX_PAGE_BITS / 64];
+};
+
+/**
+ * \brief Accumulates index information while a trace is being written or scanned.
+ */
+struct t_tl_index_builder
+{
+    std::vector<t_tl_chunk> chunks;
+    // The index of the first record executed after each VI.
+    std::vector<uint64_t> vi_records;
+    uint64_t record_count = 0;
+
+    /**
+     * \brief Resets the builder to an empty state.
+     */
+    void reset();
+
+    /**
+     * \brief Adds a record to the index.
+     */
+    void push(const t_tl_record &record);
+
+    /**
+     * \brief Marks a VI boundary at the current record.
+     */
+    void on_vi();
+
+    /**
+     * \brief Writes the index to the specified path.
+     * \return Whether the operation succeeded.
+     */
+    bool save(const std::filesystem::path &path) const;
+};
+
+/**
+ * \brief An opened binary tracelog with its index.
+ */
+struct t_tl_trace
+{
+    std::unique_ptr<IOUtils::mapped_file> file;
+    std::vector<t_tl_chunk> chunks;
+    std::vector<uint64_t> vi_records;
+
+    std::span<const t_tl_record> records() const;
+};
+
+/**
+ * \brief Callback for trace queries. Receives the record index and record, returns whether to continue.
+ */
+typedef std::function<bool(uint64_t, const t_tl_record &)> tl_query_callback;
+
+/**
+ * \brief Gets the path of the index sidecar belonging to a trace.
+ */
+std::filesystem::path tl_index_path(const std::filesystem::path &trace_path);
+
+/**
+ * \brief Builds an index by scanning a trace. VI boundaries can't be recovered from the trace alone, so the
+ * resulting index places every record in VI 0.
+ */
+bool tl_index_build(const std::filesystem::path &trace_path, t_tl_index_builder &builder);
+
+/**
+ * \brief Maps a binary tracelog and loads its index. If the index is missing or stale, it is rebuilt from the trace.
+ * \param path The trace path.
+ * \param trace The trace to open into.
+ * \return Whether the operation succeeded.
+ */
+bool tl_trace_open(const std::filesystem::path &path, t_tl_trace &trace);
+
+/**
+ * \brief Finds every execution of the specified PC.
+ */
+void tl_query_pc(const t_tl_trace &trace, uint32_t pc, const tl_query_callback &callback);
+
+/**
+ * \brief Finds every store which overlaps the range <c>[addr, addr + size)</c>.
+ */
+void tl_query_writes(const t_tl_trace &trace, uint32_t addr, uint32_t size, const tl_query_callback &callback);
+
+/**
+ * \brief Gets the VI count at the specified record.
+ */
+uint32_t tl_record_vi(const t_tl_trace &trace, uint64_t record);
+
+/**
+ * \brief Gets the records executed during the specified VI.
+ */
+std::span<const t_tl_record> tl_vi_records(const t_tl_trace &trace, uint32_t vi);
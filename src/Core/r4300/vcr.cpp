@@ -14,8 +14,11 @@
 #include <format>
 #include <include/core_api.h>
 #include <iterator>
+#include <memory/pif.h>
+#include <r4300/desync.h>
 #include <r4300/r4300.h>
 #include <r4300/rom.h>
+#include <r4300/state_digest.h>
 #include <r4300/vcr.h>
 
 using namespace std::string_view_literals;
@@ -106,6 +109,20 @@ bool write_movie()
     return write_movie_impl(&vcr.hdr, vcr.inputs, vcr.movie_path);
 }
 
+// Writes the state digests of the current movie to its sidecar, unless they were read from it
+static void write_digests()
+{
+    if (vcr.digests.empty() || vcr.digests_verifying)
+    {
+        return;
+    }
+
+    if (!dg_write(dg_sidecar_path(vcr.movie_path), vcr.hdr.uid, vcr.digests))
+    {
+        g_core->log_error(std::format("[VCR] Failed to write state digests for {}", vcr.movie_path.string()));
+    }
+}
+
 bool write_backup_impl()
 {
     g_core->log_info("[VCR] Backing up movie...");
@@ -486,11 +503,11 @@ core_result vcr_unfreeze(const vcr_freeze_info &freeze)
 
 finish: {
     vcr_anti_lock bypass;
-    g_core->callbacks.task_changed(vcr.task);
-    g_core->callbacks.current_sample_changed(vcr.current_sample);
-    g_core->callbacks.rerecords_changed(get_rerecord_count());
-    g_core->callbacks.frame();
-    g_core->callbacks.unfreeze_completed();
+    g_core->events.publish<core_event::task_changed>(vcr.task);
+    g_core->events.publish<core_event::current_sample_changed>(vcr.current_sample);
+    g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
+    g_core->events.publish<core_event::frame>();
+    g_core->events.publish<core_event::unfreeze_completed>();
 }
     return Res_Ok;
 }
@@ -528,8 +545,7 @@ void vcr_create_n_frame_savestate(size_t frame)
             {
                 g_core->log_info(std::format("[VCR] Map too large! Purging seek savestate at frame {}...", i));
                 vcr.seek_savestates.erase(i);
-                vcr.post_controller_poll_callbacks.emplace(
-                    [=] { g_core->callbacks.seek_savestate_changed((size_t)i); });
+                vcr.post_controller_poll_events.push_back({core_event::seek_savestate_changed, (int64_t)i});
                 break;
             }
         }
@@ -553,7 +569,7 @@ void vcr_create_n_frame_savestate(size_t frame)
 
             {
                 vcr_anti_lock bypass;
-                g_core->callbacks.seek_savestate_changed(frame);
+                g_core->events.publish<core_event::seek_savestate_changed>(frame);
             }
         },
         false);
@@ -589,9 +605,9 @@ void vcr_handle_starting_tasks(int32_t index, core_buttons *input)
 
             {
                 vcr_anti_lock bypass;
-                g_core->callbacks.task_changed(vcr.task);
-                g_core->callbacks.current_sample_changed(vcr.current_sample);
-                g_core->callbacks.rerecords_changed(get_rerecord_count());
+                g_core->events.publish<core_event::task_changed>(vcr.task);
+                g_core->events.publish<core_event::current_sample_changed>(vcr.current_sample);
+                g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
             }
         });
     }
@@ -624,9 +640,9 @@ void vcr_handle_starting_tasks(int32_t index, core_buttons *input)
 
             {
                 vcr_anti_lock bypass;
-                g_core->callbacks.task_changed(vcr.task);
-                g_core->callbacks.current_sample_changed(vcr.current_sample);
-                g_core->callbacks.rerecords_changed(get_rerecord_count());
+                g_core->events.publish<core_event::task_changed>(vcr.task);
+                g_core->events.publish<core_event::current_sample_changed>(vcr.current_sample);
+                g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
             }
         });
     }
@@ -661,16 +677,16 @@ void vcr_handle_recording(int32_t index, core_buttons *input)
 
             {
                 vcr_anti_lock bypass;
-                g_core->callbacks.input(&dummy_input, index);
+                g_core->events.publish<core_event::input>(&dummy_input, index);
             }
         }
         else
         {
-            g_core->input_get_keys(index, input);
+            pif_get_keys(index, input);
 
             {
                 vcr_anti_lock bypass;
-                g_core->callbacks.input(input, index);
+                g_core->events.publish<core_event::input>(input, index);
             }
         }
     }
@@ -712,7 +728,7 @@ void vcr_handle_recording(int32_t index, core_buttons *input)
         });
     }
 
-    vcr.post_controller_poll_callbacks.emplace([=] { g_core->callbacks.current_sample_changed(vcr.current_sample); });
+    vcr.post_controller_poll_events.push_back({core_event::current_sample_changed, vcr.current_sample});
 }
 
 void vcr_handle_playback(int32_t index, core_buttons *input)
@@ -744,12 +760,12 @@ void vcr_handle_playback(int32_t index, core_buttons *input)
                 g_ctx.vcr_start_playback(vcr.movie_path);
             }
 
-            vcr.post_controller_poll_callbacks.emplace([=] { g_core->callbacks.loop_movie(); });
+            vcr.post_controller_poll_events.push_back({core_event::loop_movie});
             return;
         }
 
         g_core->input_set_keys(index, {0});
-        g_core->input_get_keys(index, input);
+        pif_get_keys(index, input);
         return;
     }
 
@@ -794,13 +810,13 @@ void vcr_handle_playback(int32_t index, core_buttons *input)
 
     {
         vcr_anti_lock bypass;
-        g_core->callbacks.input(input, index);
+        g_core->events.publish<core_event::input>(input, index);
     }
     // We don't need to account for state changes during the unlocked period here, as we don't do any more immediate
     // state-dependent work.
 
     vcr.current_sample++;
-    vcr.post_controller_poll_callbacks.emplace([=] { g_core->callbacks.current_sample_changed(vcr.current_sample); });
+    vcr.post_controller_poll_events.push_back({core_event::current_sample_changed, vcr.current_sample});
 }
 
 void vcr_stop_seek_if_needed()
@@ -875,8 +891,37 @@ void vcr_create_seek_savestates()
     }
 }
 
+static void vcr_publish(const vcr_event &event)
+{
+    switch (event.type)
+    {
+    case core_event::current_sample_changed:
+        g_core->events.publish<core_event::current_sample_changed>((int32_t)event.value);
+        break;
+    case core_event::seek_savestate_changed:
+        g_core->events.publish<core_event::seek_savestate_changed>((size_t)event.value);
+        break;
+    case core_event::loop_movie:
+        g_core->events.publish<core_event::loop_movie>();
+        break;
+    default:
+        assert(false);
+        break;
+    }
+}
+
 void vcr_on_controller_poll(int32_t index, core_buttons *input)
 {
+    // Without a movie, polls only forward the plugin's input, so they don't need the lock. Some games poll several
+    // times per frame, which made the lock show up in profiles. Racing with a task change is harmless, as the poll
+    // would've been ordered before it anyway.
+    if (vcr.task == task_idle && !vcr.reset_pending && !vcr.seek_savestate_loading)
+    {
+        pif_get_keys(index, input);
+        g_core->events.publish<core_event::input>(input, index);
+        return;
+    }
+
     std::unique_lock lock(vcr_mtx);
 
     // NOTE: When we call reset_rom from another thread, we only request a reset to happen in the future.
@@ -897,11 +942,11 @@ void vcr_on_controller_poll(int32_t index, core_buttons *input)
 
     if (vcr.task == task_idle)
     {
-        g_core->input_get_keys(index, input);
+        pif_get_keys(index, input);
 
         {
             vcr_anti_lock bypass;
-            g_core->callbacks.input(input, index);
+            g_core->events.publish<core_event::input>(input, index);
         }
 
         return;
@@ -914,6 +959,11 @@ void vcr_on_controller_poll(int32_t index, core_buttons *input)
 
     vcr_create_seek_savestates();
 
+    if (vcr.task == task_playback)
+    {
+        ds_on_sample(vcr.current_sample);
+    }
+
     vcr_handle_recording(index, input);
 
     vcr_handle_playback(index, input);
@@ -921,14 +971,17 @@ void vcr_on_controller_poll(int32_t index, core_buttons *input)
     // Since the callback might want to call VCR functions, we have to release the lock to avoid deadlocking in
     // situations with interlocked threads (e.g. UI and Emu) In addition, we have to be careful to only call this
     // function after we're done with VCR work as to avoid reentrancy issues.
+    // Both buffers keep their capacity, so polls don't allocate once they're warmed up.
+    static std::vector<vcr_event> events;
+    events.swap(vcr.post_controller_poll_events);
     {
         vcr_anti_lock bypass;
-        while (!vcr.post_controller_poll_callbacks.empty())
+        for (const auto &event : events)
         {
-            vcr.post_controller_poll_callbacks.front()();
-            vcr.post_controller_poll_callbacks.pop();
+            vcr_publish(event);
         }
     }
+    events.clear();
 }
 
 // Generates a savestate path for a newly created movie.
@@ -1092,13 +1145,16 @@ core_result vcr_start_record(std::filesystem::path path, uint16_t flags, std::st
 
     vcr.current_sample = 0;
     vcr.current_vi = 0;
+    vcr.digests.clear();
+    vcr.digests_verifying = false;
+    vcr.digests_mismatched = false;
 
     {
         vcr_anti_lock bypass;
-        g_core->callbacks.task_changed(vcr.task);
-        g_core->callbacks.current_sample_changed(vcr.current_sample);
-        g_core->callbacks.rerecords_changed(get_rerecord_count());
-        g_core->callbacks.readonly_changed((bool)g_core->cfg->vcr_readonly);
+        g_core->events.publish<core_event::task_changed>(vcr.task);
+        g_core->events.publish<core_event::current_sample_changed>(vcr.current_sample);
+        g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
+        g_core->events.publish<core_event::readonly_changed>((bool)g_core->cfg->vcr_readonly);
     }
 
     return Res_Ok;
@@ -1378,6 +1434,11 @@ core_result vcr_start_playback(std::filesystem::path path)
     vcr.inputs = movie_inputs;
     vcr.hdr = header;
 
+    vcr.digests.clear();
+    vcr.digests_mismatched = false;
+    vcr.digests_verifying =
+        g_core->cfg->vcr_state_digests && dg_read(dg_sidecar_path(path), header.uid, vcr.digests);
+
     if (header.startFlags & MOVIE_START_FROM_SNAPSHOT)
     {
         g_core->log_info("[VCR] Loading state...");
@@ -1417,9 +1478,9 @@ core_result vcr_start_playback(std::filesystem::path path)
 
                     {
                         vcr_anti_lock bypass;
-                        g_core->callbacks.task_changed(vcr.task);
-                        g_core->callbacks.current_sample_changed(vcr.current_sample);
-                        g_core->callbacks.rerecords_changed(get_rerecord_count());
+                        g_core->events.publish<core_event::task_changed>(vcr.task);
+                        g_core->events.publish<core_event::current_sample_changed>(vcr.current_sample);
+                        g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
                     }
                 },
                 true);
@@ -1432,10 +1493,10 @@ core_result vcr_start_playback(std::filesystem::path path)
 
     {
         vcr_anti_lock bypass;
-        g_core->callbacks.task_changed(vcr.task);
-        g_core->callbacks.current_sample_changed(vcr.current_sample);
-        g_core->callbacks.rerecords_changed(get_rerecord_count());
-        g_core->callbacks.play_movie();
+        g_core->events.publish<core_event::task_changed>(vcr.task);
+        g_core->events.publish<core_event::current_sample_changed>(vcr.current_sample);
+        g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
+        g_core->events.publish<core_event::play_movie>();
     }
 
     return Res_Ok;
@@ -1620,7 +1681,7 @@ static core_result vcr_begin_seek_impl(std::string str, bool pause_at_end, bool
 
             {
                 vcr_anti_lock bypass;
-                g_core->callbacks.seek_status_changed();
+                g_core->events.publish<core_event::seek_status_changed>();
             }
 
             return result;
@@ -1658,7 +1719,7 @@ static core_result vcr_begin_seek_impl(std::string str, bool pause_at_end, bool
             {
                 g_core->log_info(std::format("[VCR] Erasing now-invalidated seek savestate at frame {}...", sample));
                 vcr.seek_savestates.erase(sample);
-                post_unlock_callbacks.push([=] { g_core->callbacks.seek_savestate_changed(sample); });
+                post_unlock_callbacks.push([=] { g_core->events.publish<core_event::seek_savestate_changed>(sample); });
             }
         }
 
@@ -1703,8 +1764,8 @@ finish: {
         post_unlock_callbacks.pop();
     }
 
-    g_core->callbacks.readonly_changed((bool)g_core->cfg->vcr_readonly);
-    g_core->callbacks.seek_status_changed();
+    g_core->events.publish<core_event::readonly_changed>((bool)g_core->cfg->vcr_readonly);
+    g_core->events.publish<core_event::seek_status_changed>();
 }
     return Res_Ok;
 }
@@ -1735,9 +1796,9 @@ void vcr_stop_seek()
 
     {
         vcr_anti_lock bypass;
-        g_core->callbacks.seek_status_changed();
-        g_core->callbacks.seek_completed();
-        g_core->callbacks.warp_modify_status_changed(vcr.warp_modify_active);
+        g_core->events.publish<core_event::seek_status_changed>();
+        g_core->events.publish<core_event::seek_completed>();
+        g_core->events.publish<core_event::warp_modify_status_changed>(vcr.warp_modify_active);
     }
 }
 
@@ -1768,7 +1829,7 @@ static void vcr_clear_seek_savestates(std::queue<std::function<void()>> &post_un
 
     for (const auto frame : prev_seek_savestate_keys)
     {
-        post_unlock_callbacks.emplace([=] { g_core->callbacks.seek_savestate_changed(frame); });
+        post_unlock_callbacks.emplace([=] { g_core->events.publish<core_event::seek_savestate_changed>(frame); });
     }
 }
 
@@ -1816,6 +1877,7 @@ core_result vcr_stop_all()
         if (vcr.task == task_recording)
         {
             write_movie();
+            write_digests();
 
             vcr.task = task_idle;
 
@@ -1826,7 +1888,7 @@ core_result vcr_stop_all()
         {
             vcr_anti_lock bypass;
             execute_post_unlock_callbacks(post_unlock_callbacks);
-            g_core->callbacks.task_changed(vcr.task);
+            g_core->events.publish<core_event::task_changed>(vcr.task);
         }
 
         return Res_Ok;
@@ -1834,14 +1896,15 @@ core_result vcr_stop_all()
 
     if (is_playback)
     {
+        write_digests();
         vcr.task = task_idle;
         cht_layer_pop();
 
         {
             vcr_anti_lock bypass;
             execute_post_unlock_callbacks(post_unlock_callbacks);
-            g_core->callbacks.task_changed(vcr.task);
-            g_core->callbacks.stop_movie();
+            g_core->events.publish<core_event::task_changed>(vcr.task);
+            g_core->events.publish<core_event::stop_movie>();
         }
 
         return Res_Ok;
@@ -1940,7 +2003,7 @@ core_result vcr_begin_warp_modify(const std::vector<core_buttons> &inputs)
 
         {
             vcr_anti_lock bypass;
-            g_core->callbacks.warp_modify_status_changed(vcr.warp_modify_active);
+            g_core->events.publish<core_event::warp_modify_status_changed>(vcr.warp_modify_active);
         }
 
         return Res_Ok;
@@ -1960,8 +2023,8 @@ core_result vcr_begin_warp_modify(const std::vector<core_buttons> &inputs)
 
         {
             vcr_anti_lock bypass;
-            g_core->callbacks.warp_modify_status_changed(vcr.warp_modify_active);
-            g_core->callbacks.rerecords_changed(get_rerecord_count());
+            g_core->events.publish<core_event::warp_modify_status_changed>(vcr.warp_modify_active);
+            g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
         }
 
         return Res_Ok;
@@ -1988,8 +2051,8 @@ core_result vcr_begin_warp_modify(const std::vector<core_buttons> &inputs)
 
     {
         vcr_anti_lock bypass;
-        g_core->callbacks.warp_modify_status_changed(vcr.warp_modify_active);
-        g_core->callbacks.rerecords_changed(get_rerecord_count());
+        g_core->events.publish<core_event::warp_modify_status_changed>(vcr.warp_modify_active);
+        g_core->events.publish<core_event::rerecords_changed>(get_rerecord_count());
     }
 
     return Res_Ok;
@@ -2027,6 +2090,45 @@ bool vcr_has_seek_savestate_at_frame(const size_t frame)
     return vcr.seek_savestates.contains(frame);
 }
 
+/**
+ * \brief Takes the state digest of the VI which just ended, either storing it or comparing it against the stored one.
+ */
+static void vcr_update_digests()
+{
+    if (vcr.current_vi <= 0)
+    {
+        return;
+    }
+
+    const auto index = static_cast<size_t>(vcr.current_vi - 1);
+    const auto digest = dg_compute();
+
+    // Without a reference, the digests are authored instead. Rewinding makes everything after the current VI stale.
+    if (vcr.task == task_recording || !vcr.digests_verifying)
+    {
+        vcr.digests_verifying = false;
+        vcr.digests.resize(index);
+        vcr.digests.push_back(digest);
+        return;
+    }
+
+    // A digest of 0 marks a VI which wasn't digested while recording.
+    if (vcr.digests_mismatched || index >= vcr.digests.size() || vcr.digests[index] == 0 ||
+        vcr.digests[index] == digest)
+    {
+        return;
+    }
+
+    vcr.digests_mismatched = true;
+    g_core->log_warn(std::format("[VCR] State digest mismatch at VI {} (expected {:016X}, got {:016X})", index,
+                                 vcr.digests[index], digest));
+
+    {
+        vcr_anti_lock bypass;
+        g_core->events.publish<core_event::state_digest_mismatch>(index);
+    }
+}
+
 void vcr_on_vi()
 {
     std::unique_lock lock(vcr_mtx);
@@ -2035,6 +2137,11 @@ void vcr_on_vi()
 
     if (vcr.task == task_recording && !vcr.warp_modify_active) vcr.hdr.length_vis = vcr.current_vi;
 
+    if (g_core->cfg->vcr_state_digests && (vcr.task == task_recording || vcr.task == task_playback))
+    {
+        vcr_update_digests();
+    }
+
     if (vcr.task != task_playback) return;
 
     bool pausing_at_last = (g_core->cfg->pause_at_last_frame && vcr.current_sample == vcr.hdr.length_samples);
@@ -2073,7 +2180,9 @@ bool vcr_is_frame_skipped()
 
     if (vcr.seek_to_frame.has_value())
     {
-        return true;
+        // The last frames are rendered, so the screen is up to date once the seek finishes.
+        const auto render_frames = static_cast<size_t>(std::max(g_core->cfg->seek_render_frames, 0));
+        return vcr.current_sample + render_frames < vcr.seek_to_frame.value();
     }
 
     if (!g_vr_fast_forward)
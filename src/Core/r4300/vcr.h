@@ -8,17 +8,62 @@
 
 #include <core_api.h>
 
+/**
+ * \brief A field of the VCR state which may be read without holding <c>vcr_mtx</c>, e.g. to skip the lock when no
+ * movie is active. Writes still happen with the lock held.
+ */
+template <typename T> class vcr_shared
+{
+  public:
+    vcr_shared(T value = {}) : m_value(value)
+    {
+    }
+
+    vcr_shared(const vcr_shared &other) : m_value(other.m_value.load())
+    {
+    }
+
+    vcr_shared &operator=(const vcr_shared &other)
+    {
+        m_value = other.m_value.load();
+        return *this;
+    }
+
+    vcr_shared &operator=(T value)
+    {
+        m_value = value;
+        return *this;
+    }
+
+    operator T() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<T> m_value;
+};
+
+/**
+ * \brief An event the VCR engine raises after releasing its lock.
+ */
+struct vcr_event
+{
+    core_event type;
+    int64_t value;
+};
+
 struct t_vcr_state
 {
     std::filesystem::path movie_path{};
-    core_vcr_task task = task_idle;
+    vcr_shared<core_vcr_task> task = task_idle;
 
-    bool reset_pending{};
+    vcr_shared<bool> reset_pending{};
 
     std::optional<size_t> seek_to_frame{};
     size_t seek_start_sample{};
     bool seek_pause_at_end{};
-    bool seek_savestate_loading{};
+    vcr_shared<bool> seek_savestate_loading{};
     std::unordered_map<size_t, std::vector<uint8_t>> seek_savestates{};
 
     bool warp_modify_active{};
@@ -31,7 +76,14 @@ struct t_vcr_state
     int32_t current_vi = -1;
 
     bool reset_requested{};
-    std::queue<std::function<void()>> post_controller_poll_callbacks{};
+
+    // The per-VI state digests of the movie. See state_digest.h.
+    std::vector<uint64_t> digests{};
+    // Whether the digests were read from the movie's sidecar and the live digests are compared against them.
+    bool digests_verifying{};
+    bool digests_mismatched{};
+    // The events raised during the current controller poll, published once the poll released the lock.
+    std::vector<vcr_event> post_controller_poll_events{};
 };
 
 /**
@@ -25,7 +25,7 @@ jmp_buf g_jmp_state;
 void dyna_start(void (*code)())
 {
     core_executing = true;
-    g_core->callbacks.core_executing_changed(core_executing);
+    g_core->events.publish<core_event::core_executing_changed>(core_executing);
     g_core->log_info(std::format("core_executing: {}", (bool)core_executing));
     if (setjmp(g_jmp_state) == 0)
     {
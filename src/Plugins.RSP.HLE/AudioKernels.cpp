@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "AudioKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AUDIO_KERNELS_AVX2
+#elif defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#define AUDIO_KERNELS_SSE41
+#endif
+
+static int16_t clamp16(const int32_t x)
+{
+    return (int16_t)std::clamp(x, -32768, 32767);
+}
+
+/**
+ * \brief Whether two arrays overlap without being the same array. The vectorised kernels process several samples
+ * before storing them, which would observe such arrays differently from the references.
+ */
+static bool overlaps_partially(const void *a, const void *b, const size_t len)
+{
+    const auto pa = reinterpret_cast<uintptr_t>(a);
+    const auto pb = reinterpret_cast<uintptr_t>(b);
+    return pa != pb && pa < pb + len && pb < pa + len;
+}
+
+static bool has_partial_overlap(const int16_t *src, int16_t *const *dst, const size_t streams, const size_t count)
+{
+    for (size_t j = 0; j < streams; ++j)
+    {
+        if (overlaps_partially(src, dst[j], count * sizeof(int16_t)))
+        {
+            return true;
+        }
+        for (size_t k = j + 1; k < streams; ++k)
+        {
+            if (overlaps_partially(dst[j], dst[k], count * sizeof(int16_t)))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+#pragma region Scalar
+
+void AudioKernels::scalar::mix(int16_t *dst, const int16_t *src, const int16_t gain, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = clamp16(dst[i] + ((src[i] * gain) >> 15));
+    }
+}
+
+void AudioKernels::scalar::envmix(const int16_t *src, int16_t *const *dst, const int32_t *const *vol,
+                                  const size_t streams, const size_t count)
+{
+    int16_t out[4];
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t j = 0; j < streams; ++j)
+        {
+            out[j] = clamp16(dst[j][i] + ((src[i] * vol[j][i] + 0x4000) >> 15));
+        }
+        for (size_t j = 0; j < streams; ++j)
+        {
+            dst[j][i] = out[j];
+        }
+    }
+}
+
+uint32_t AudioKernels::scalar::resample(int16_t *dst, const int16_t *src, const int16_t *lut, uint32_t pos,
+                                        const uint32_t pitch, const size_t count)
+{
+    for (size_t k = 0; k < count; ++k, pos += pitch)
+    {
+        const int16_t *s = src + (pos >> 16);
+        const int16_t *l = lut + ((pos & 0xFFFF) >> 10) * 4;
+
+        int32_t accum = (s[0] * l[0]) >> 15;
+        accum += (s[1] * l[1]) >> 15;
+        accum += (s[2] * l[2]) >> 15;
+        accum += (s[3] * l[3]) >> 15;
+
+        dst[k] = clamp16(accum);
+    }
+    return pos;
+}
+
+int32_t AudioKernels::scalar::dewindow(const int16_t *src, const int16_t *win, const size_t count, const bool alternate)
+{
+    int32_t sum = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int32_t term = (src[i] * win[i] + 0x4000) >> 15;
+        sum += alternate && (i & 1) ? -term : term;
+    }
+    return sum;
+}
+
+#pragma endregion
+
+#pragma region Vectorised
+
+#if defined(AUDIO_KERNELS_AVX2)
+
+AudioKernels::isa AudioKernels::compiled_isa()
+{
+    return isa::avx2;
+}
+
+void AudioKernels::mix(int16_t *dst, const int16_t *src, const int16_t gain, const size_t count)
+{
+    if (overlaps_partially(src, dst, count * sizeof(int16_t)))
+    {
+        scalar::mix(dst, src, gain, count);
+        return;
+    }
+
+    const __m256i g = _mm256_set1_epi16(gain);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+
+        // The unpacks and the pack both work within 128-bit lanes, so the samples come out in their original order.
+        const __m256i lo = _mm256_mullo_epi16(s, g);
+        const __m256i hi = _mm256_mulhi_epi16(s, g);
+        const __m256i p0 = _mm256_srai_epi32(_mm256_unpacklo_epi16(lo, hi), 15);
+        const __m256i p1 = _mm256_srai_epi32(_mm256_unpackhi_epi16(lo, hi), 15);
+        const __m256i d0 = _mm256_srai_epi32(_mm256_unpacklo_epi16(d, d), 16);
+        const __m256i d1 = _mm256_srai_epi32(_mm256_unpackhi_epi16(d, d), 16);
+
+        const __m256i r = _mm256_packs_epi32(_mm256_add_epi32(d0, p0), _mm256_add_epi32(d1, p1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), r);
+    }
+
+    scalar::mix(dst + i, src + i, gain, count - i);
+}
+
+void AudioKernels::envmix(const int16_t *src, int16_t *const *dst, const int32_t *const *vol, const size_t streams,
+                          const size_t count)
+{
+    if (has_partial_overlap(src, dst, streams, count))
+    {
+        scalar::envmix(src, dst, vol, streams, count);
+        return;
+    }
+
+    const __m256i round = _mm256_set1_epi32(0x4000);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i s0 = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+        const __m256i s1 = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8)));
+
+        __m256i out[4];
+        for (size_t j = 0; j < streams; ++j)
+        {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vol[j] + i));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(vol[j] + i + 8));
+            const __m256i d0 = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(dst[j] + i)));
+            const __m256i d1 =
+                _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(dst[j] + i + 8)));
+
+            const __m256i m0 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(s0, v0), round), 15);
+            const __m256i m1 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(s1, v1), round), 15);
+
+            // The pack interleaves the 128-bit lanes of its operands, so the quadwords are put back in order after.
+            const __m256i r = _mm256_packs_epi32(_mm256_add_epi32(d0, m0), _mm256_add_epi32(d1, m1));
+            out[j] = _mm256_permute4x64_epi64(r, _MM_SHUFFLE(3, 1, 2, 0));
+        }
+        for (size_t j = 0; j < streams; ++j)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst[j] + i), out[j]);
+        }
+    }
+
+    const int32_t *tail_vol[4];
+    int16_t *tail_dst[4];
+    for (size_t j = 0; j < streams; ++j)
+    {
+        tail_vol[j] = vol[j] + i;
+        tail_dst[j] = dst[j] + i;
+    }
+    scalar::envmix(src + i, tail_dst, tail_vol, streams, count - i);
+}
+
+/**
+ * \brief Computes the tap sums of the 4 outputs whose taps and coefficients are held in two pairs of quadwords.
+ * \return The sums of each 128-bit lane, in the order of the lane's taps.
+ */
+static __m256i resample_taps(const __m256i s, const __m256i l)
+{
+    const __m256i lo = _mm256_mullo_epi16(s, l);
+    const __m256i hi = _mm256_mulhi_epi16(s, l);
+    const __m256i p0 = _mm256_srai_epi32(_mm256_unpacklo_epi16(lo, hi), 15);
+    const __m256i p1 = _mm256_srai_epi32(_mm256_unpackhi_epi16(lo, hi), 15);
+    return _mm256_hadd_epi32(p0, p1);
+}
+
+uint32_t AudioKernels::resample(int16_t *dst, const int16_t *src, const int16_t *lut, uint32_t pos,
+                                const uint32_t pitch, const size_t count)
+{
+    const auto src_base = reinterpret_cast<const long long *>(src);
+    const auto lut_base = reinterpret_cast<const long long *>(lut);
+    const __m256i steps = _mm256_mullo_epi32(_mm256_set1_epi32((int)pitch), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i frac = _mm256_set1_epi32(0xFFFF);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t k = 0;
+    for (; k + 8 <= count; k += 8, pos += 8 * pitch)
+    {
+        const __m256i p = _mm256_add_epi32(_mm256_set1_epi32((int)pos), steps);
+        const __m256i idx = _mm256_srli_epi32(p, 16);
+        const __m256i row = _mm256_srli_epi32(_mm256_and_si256(p, frac), 10);
+
+        // Every output's 4 taps and 4 coefficients are one quadword each, so they're gathered as such.
+        const __m256i s0 = _mm256_i32gather_epi64(src_base, _mm256_castsi256_si128(idx), 2);
+        const __m256i s1 = _mm256_i32gather_epi64(src_base, _mm256_extracti128_si256(idx, 1), 2);
+        const __m256i l0 = _mm256_i32gather_epi64(lut_base, _mm256_castsi256_si128(row), 8);
+        const __m256i l1 = _mm256_i32gather_epi64(lut_base, _mm256_extracti128_si256(row, 1), 8);
+
+        // Lane 0 holds outputs 0, 1, 4, 5 and lane 1 holds outputs 2, 3, 6, 7.
+        const __m256i sums = _mm256_hadd_epi32(resample_taps(s0, l0), resample_taps(s1, l1));
+        const __m256i packed = _mm256_packs_epi32(sums, sums);
+        const __m256i r = _mm256_permutevar8x32_epi32(packed, order);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + k), _mm256_castsi256_si128(r));
+    }
+
+    return scalar::resample(dst + k, src, lut, pos, pitch, count - k);
+}
+
+int32_t AudioKernels::dewindow(const int16_t *src, const int16_t *win, const size_t count, const bool alternate)
+{
+    // The unpacks keep every product at a position of the same parity, so the signs can be applied by position.
+    const __m256i round = _mm256_set1_epi32(0x4000);
+    const __m256i signs = alternate ? _mm256_setr_epi32(1, -1, 1, -1, 1, -1, 1, -1) : _mm256_set1_epi32(1);
+    __m256i acc = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(win + i));
+        const __m256i lo = _mm256_mullo_epi16(s, w);
+        const __m256i hi = _mm256_mulhi_epi16(s, w);
+        const __m256i p0 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), round), 15);
+        const __m256i p1 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), round), 15);
+        acc = _mm256_add_epi32(acc, _mm256_sign_epi32(_mm256_add_epi32(p0, p1), signs));
+    }
+
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    return _mm_cvtsi128_si32(sum) + scalar::dewindow(src + i, win + i, count - i, alternate);
+}
+
+#elif defined(AUDIO_KERNELS_SSE41)
+
+AudioKernels::isa AudioKernels::compiled_isa()
+{
+    return isa::sse41;
+}
+
+void AudioKernels::mix(int16_t *dst, const int16_t *src, const int16_t gain, const size_t count)
+{
+    if (overlaps_partially(src, dst, count * sizeof(int16_t)))
+    {
+        scalar::mix(dst, src, gain, count);
+        return;
+    }
+
+    const __m128i g = _mm_set1_epi16(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+
+        const __m128i lo = _mm_mullo_epi16(s, g);
+        const __m128i hi = _mm_mulhi_epi16(s, g);
+        const __m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+        const __m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+        const __m128i d0 = _mm_cvtepi16_epi32(d);
+        const __m128i d1 = _mm_cvtepi16_epi32(_mm_srli_si128(d, 8));
+
+        const __m128i r = _mm_packs_epi32(_mm_add_epi32(d0, p0), _mm_add_epi32(d1, p1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), r);
+    }
+
+    scalar::mix(dst + i, src + i, gain, count - i);
+}
+
+void AudioKernels::envmix(const int16_t *src, int16_t *const *dst, const int32_t *const *vol, const size_t streams,
+                          const size_t count)
+{
+    if (has_partial_overlap(src, dst, streams, count))
+    {
+        scalar::envmix(src, dst, vol, streams, count);
+        return;
+    }
+
+    const __m128i round = _mm_set1_epi32(0x4000);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i s0 = _mm_cvtepi16_epi32(s);
+        const __m128i s1 = _mm_cvtepi16_epi32(_mm_srli_si128(s, 8));
+
+        __m128i out[4];
+        for (size_t j = 0; j < streams; ++j)
+        {
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(vol[j] + i));
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(vol[j] + i + 4));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst[j] + i));
+
+            const __m128i m0 = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(s0, v0), round), 15);
+            const __m128i m1 = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(s1, v1), round), 15);
+            const __m128i d0 = _mm_cvtepi16_epi32(d);
+            const __m128i d1 = _mm_cvtepi16_epi32(_mm_srli_si128(d, 8));
+
+            out[j] = _mm_packs_epi32(_mm_add_epi32(d0, m0), _mm_add_epi32(d1, m1));
+        }
+        for (size_t j = 0; j < streams; ++j)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst[j] + i), out[j]);
+        }
+    }
+
+    const int32_t *tail_vol[4];
+    int16_t *tail_dst[4];
+    for (size_t j = 0; j < streams; ++j)
+    {
+        tail_vol[j] = vol[j] + i;
+        tail_dst[j] = dst[j] + i;
+    }
+    scalar::envmix(src + i, tail_dst, tail_vol, streams, count - i);
+}
+
+/**
+ * \brief Computes the tap sums of the 2 outputs whose taps and coefficients are held in two quadwords.
+ */
+static __m128i resample_taps(const __m128i s, const __m128i l)
+{
+    const __m128i lo = _mm_mullo_epi16(s, l);
+    const __m128i hi = _mm_mulhi_epi16(s, l);
+    const __m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+    const __m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+    return _mm_hadd_epi32(p0, p1);
+}
+
+static __m128i load_quadwords(const int16_t *a, const int16_t *b)
+{
+    return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a)),
+                              _mm_loadl_epi64(reinterpret_cast<const __m128i *>(b)));
+}
+
+uint32_t AudioKernels::resample(int16_t *dst, const int16_t *src, const int16_t *lut, uint32_t pos,
+                                const uint32_t pitch, const size_t count)
+{
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4)
+    {
+        uint32_t p[4];
+        for (auto &x : p)
+        {
+            x = pos;
+            pos += pitch;
+        }
+
+        const __m128i s01 = load_quadwords(src + (p[0] >> 16), src + (p[1] >> 16));
+        const __m128i s23 = load_quadwords(src + (p[2] >> 16), src + (p[3] >> 16));
+        const __m128i l01 = load_quadwords(lut + ((p[0] & 0xFFFF) >> 10) * 4, lut + ((p[1] & 0xFFFF) >> 10) * 4);
+        const __m128i l23 = load_quadwords(lut + ((p[2] & 0xFFFF) >> 10) * 4, lut + ((p[3] & 0xFFFF) >> 10) * 4);
+
+        const __m128i sums = _mm_hadd_epi32(resample_taps(s01, l01), resample_taps(s23, l23));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + k), _mm_packs_epi32(sums, sums));
+    }
+
+    return scalar::resample(dst + k, src, lut, pos, pitch, count - k);
+}
+
+int32_t AudioKernels::dewindow(const int16_t *src, const int16_t *win, const size_t count, const bool alternate)
+{
+    // The unpacks keep every product at a position of the same parity, so the signs can be applied by position.
+    const __m128i round = _mm_set1_epi32(0x4000);
+    const __m128i signs = alternate ? _mm_setr_epi32(1, -1, 1, -1) : _mm_set1_epi32(1);
+    __m128i acc = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(win + i));
+        const __m128i lo = _mm_mullo_epi16(s, w);
+        const __m128i hi = _mm_mulhi_epi16(s, w);
+        const __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), round), 15);
+        const __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), round), 15);
+        acc = _mm_add_epi32(acc, _mm_sign_epi32(_mm_add_epi32(p0, p1), signs));
+    }
+
+    acc = _mm_hadd_epi32(acc, acc);
+    acc = _mm_hadd_epi32(acc, acc);
+    return _mm_cvtsi128_si32(acc) + scalar::dewindow(src + i, win + i, count - i, alternate);
+}
+
+#else
+
+AudioKernels::isa AudioKernels::compiled_isa()
+{
+    return isa::scalar;
+}
+
+void AudioKernels::mix(int16_t *dst, const int16_t *src, const int16_t gain, const size_t count)
+{
+    scalar::mix(dst, src, gain, count);
+}
+
+void AudioKernels::envmix(const int16_t *src, int16_t *const *dst, const int32_t *const *vol, const size_t streams,
+                          const size_t count)
+{
+    scalar::envmix(src, dst, vol, streams, count);
+}
+
+uint32_t AudioKernels::resample(int16_t *dst, const int16_t *src, const int16_t *lut, const uint32_t pos,
+                                const uint32_t pitch, const size_t count)
+{
+    return scalar::resample(dst, src, lut, pos, pitch, count);
+}
+
+int32_t AudioKernels::dewindow(const int16_t *src, const int16_t *win, const size_t count, const bool alternate)
+{
+    return scalar::dewindow(src, win, count, alternate);
+}
+
+#endif
+
+#pragma endregion
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing the sample processing kernels of the audio microcode HLE.
+ * \remarks The kernels work on linear arrays of host-order samples. The vectorised implementations are picked at
+ * compile time, and each of them must match its reference in <c>AudioKernels::scalar</c> bit for bit.
+ */
+namespace AudioKernels
+{
+enum class isa
+{
+    scalar,
+    sse41,
+    avx2,
+};
+
+/**
+ * \brief Gets the instruction set the kernels were compiled for.
+ */
+isa compiled_isa();
+
+/**
+ * \brief Mixes a scaled source into a destination, saturating the result.
+ * Equivalent to <c>dst[i] = clamp(dst[i] + ((src[i] * gain) >> 15))</c>.
+ * \param dst The destination samples.
+ * \param src The source samples. May be the same as <c>dst</c>.
+ * \param gain The gain as a signed Q15 value.
+ * \param count The amount of samples.
+ */
+void mix(int16_t *dst, const int16_t *src, int16_t gain, size_t count);
+
+/**
+ * \brief Mixes a source into several destinations with a per-sample volume each, saturating the results.
+ * Equivalent to <c>dst[j][i] = clamp(dst[j][i] + ((src[i] * vol[j][i] + 0x4000) >> 15))</c>.
+ * \param src The source samples.
+ * \param dst The destination sample arrays.
+ * \param vol The volume arrays, one per destination.
+ * \param streams The amount of destinations, at most 4.
+ * \param count The amount of samples.
+ * \remarks All destinations of a sample are read before any of them is written, so destinations may be the same
+ * array.
+ */
+void envmix(const int16_t *src, int16_t *const *dst, const int32_t *const *vol, size_t streams, size_t count);
+
+/**
+ * \brief Resamples a source with the 4-tap interpolation filter.
+ * Output <c>k</c> is the saturated sum of <c>(src[p + t] * lut[r * 4 + t]) >> 15</c> over the taps <c>t</c>, where
+ * <c>p</c> and <c>r</c> are the integer part and top 6 fractional bits of <c>pos + k * pitch</c>.
+ * \param dst The output samples.
+ * \param src The input samples.
+ * \param lut The filter coefficients, 4 per row.
+ * \param pos The 16.16 fixed-point position of the first output, relative to <c>src</c>.
+ * \param pitch The 16.16 fixed-point step between outputs.
+ * \param count The amount of samples to produce.
+ * \return The position after the last sample.
+ */
+uint32_t resample(int16_t *dst, const int16_t *src, const int16_t *lut, uint32_t pos, uint32_t pitch, size_t count);
+
+/**
+ * \brief Computes the dot product of samples and window coefficients with every product rounded separately, as the
+ * MP3 microcode's synthesis filter does.
+ * Equivalent to the sum of <c>(src[i] * win[i] + 0x4000) >> 15</c>, with the odd terms subtracted if <c>alternate</c>
+ * is set.
+ * \param src The samples.
+ * \param win The window coefficients.
+ * \param count The amount of terms.
+ * \param alternate Whether the odd terms are subtracted instead of added.
+ */
+int32_t dewindow(const int16_t *src, const int16_t *win, size_t count, bool alternate);
+
+/**
+ * \brief The reference implementations of the kernels.
+ */
+namespace scalar
+{
+void mix(int16_t *dst, const int16_t *src, int16_t gain, size_t count);
+void envmix(const int16_t *src, int16_t *const *dst, const int32_t *const *vol, size_t streams, size_t count);
+uint32_t resample(int16_t *dst, const int16_t *src, const int16_t *lut, uint32_t pos, uint32_t pitch, size_t count);
+int32_t dewindow(const int16_t *src, const int16_t *win, size_t count, bool alternate);
+} // namespace scalar
+} // namespace AudioKernels
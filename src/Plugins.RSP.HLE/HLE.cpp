@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "HLE.h"
+#include "AudioKernels.h"
+
+core_rsp_info rsp;
+
+static void print_error(const std::wstring &message)
+{
+    fwprintf(stderr, L"[RSP HLE] %ls\n", message.c_str());
+}
+
+void (*g_hle_error)(const std::wstring &message) = print_error;
+
+extern uint32_t SEGMENTS[0x10];
+extern int16_t Vol_Left, Vol_Right;
+extern int16_t VolTrg_Left, VolTrg_Right;
+extern int32_t VolRamp_Left, VolRamp_Right;
+extern int16_t Env_Dry, Env_Wet;
+extern short hleMixerWorkArea[256];
+extern uint16_t adpcmtable[0x88];
+extern bool isMKABI, isZeldaABI;
+extern uint32_t t3, s5, s6;
+extern uint16_t env[8];
+extern uint32_t setaddr;
+void mp3_reset();
+
+void hle_run_alist(const hle_alist_handler *abi, const uint32_t *alist, const size_t words)
+{
+    for (size_t i = 0; i + 1 < words; i += 2)
+    {
+        abi[alist[i] >> 24](alist[i], alist[i + 1]);
+    }
+}
+
+void hle_reset()
+{
+    memset(BufferSpace, 0, sizeof(BufferSpace));
+    memset(SEGMENTS, 0, sizeof(SEGMENTS));
+    memset(hleMixerWorkArea, 0, sizeof(hleMixerWorkArea));
+    memset(adpcmtable, 0, sizeof(adpcmtable));
+    memset(env, 0, sizeof(env));
+
+    AudioInBuffer = AudioOutBuffer = AudioCount = 0;
+    AudioAuxA = AudioAuxC = AudioAuxE = 0;
+    Vol_Left = Vol_Right = VolTrg_Left = VolTrg_Right = 0;
+    VolRamp_Left = VolRamp_Right = 0;
+    Env_Dry = Env_Wet = 0;
+    loopval = setaddr = 0;
+    t3 = s5 = s6 = 0;
+    isMKABI = isZeldaABI = false;
+
+    mp3_reset();
+}
+
+/**
+ * \brief Copies samples out of the sample buffer into a linear array.
+ * \remarks The buffer holds host-order words, so the two samples of every word are swapped in memory.
+ */
+static void load_samples(int16_t *dst, const uint32_t index, const size_t count)
+{
+    const auto mem = reinterpret_cast<const int16_t *>(BufferSpace);
+    size_t i = 0;
+    if ((index & 1) == 0)
+    {
+        i = count & ~static_cast<size_t>(1);
+        EndianUtils::swap32_halves(dst, mem + index, i * sizeof(int16_t));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = mem[(index + i) ^ 1];
+    }
+}
+
+/**
+ * \brief Copies samples from a linear array into the sample buffer.
+ */
+static void store_samples(const int16_t *src, const uint32_t index, const size_t count)
+{
+    const auto mem = reinterpret_cast<int16_t *>(BufferSpace);
+    size_t i = 0;
+    if ((index & 1) == 0)
+    {
+        i = count & ~static_cast<size_t>(1);
+        EndianUtils::swap32_halves(mem + index, src, i * sizeof(int16_t));
+    }
+    for (; i < count; ++i)
+    {
+        mem[(index + i) ^ 1] = src[i];
+    }
+}
+
+void hle_resample(const uint8_t flags, const uint32_t pitch, const uint32_t addy, uint32_t src_ptr, uint32_t dst_ptr,
+                  const uint32_t count)
+{
+    const auto mem = reinterpret_cast<int16_t *>(BufferSpace);
+    const auto lut = reinterpret_cast<const int16_t *>(ResampleLUT);
+    uint32_t accum = 0;
+
+    src_ptr -= 4;
+
+    if ((flags & 0x1) == 0)
+    {
+        for (int x = 0; x < 4; x++) mem[(src_ptr + x) ^ 1] = ((int16_t *)rsp.rdram)[((addy / 2) + x) ^ 1];
+        accum = *(uint16_t *)(rsp.rdram + addy + 10);
+    }
+    else
+    {
+        for (int x = 0; x < 4; x++) mem[(src_ptr + x) ^ 1] = 0;
+    }
+
+    // The taps of the last output end at src_end.
+    constexpr uint64_t limit = sizeof(BufferSpace) / sizeof(int16_t);
+    const uint64_t src_end = src_ptr + ((accum + (uint64_t)count * pitch) >> 16) + 4;
+    const uint64_t dst_end = (uint64_t)dst_ptr + count;
+    const bool disjoint = src_end <= dst_ptr || dst_end <= src_ptr;
+
+    if (src_end <= limit && dst_end <= limit && disjoint)
+    {
+        static int16_t src[limit];
+        static int16_t dst[limit];
+        load_samples(src, src_ptr, src_end - src_ptr);
+        const uint32_t pos = AudioKernels::resample(dst, src, lut, accum, pitch, count);
+        store_samples(dst, dst_ptr, count);
+
+        src_ptr += pos >> 16;
+        accum = pos & 0xffff;
+    }
+    else
+    {
+        // The output feeds back into the input, so the samples are produced one by one.
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const int16_t *l = lut + (accum >> 10) * 4;
+
+            int32_t sum = (mem[(src_ptr + 0) ^ 1] * l[0]) >> 15;
+            sum += (mem[(src_ptr + 1) ^ 1] * l[1]) >> 15;
+            sum += (mem[(src_ptr + 2) ^ 1] * l[2]) >> 15;
+            sum += (mem[(src_ptr + 3) ^ 1] * l[3]) >> 15;
+
+            mem[dst_ptr ^ 1] = (int16_t)std::clamp(sum, -32768, 32767);
+            dst_ptr++;
+            accum += pitch;
+            src_ptr += (accum >> 16);
+            accum &= 0xffff;
+        }
+    }
+
+    for (int x = 0; x < 4; x++) ((int16_t *)rsp.rdram)[((addy / 2) + x) ^ 1] = mem[(src_ptr + x) ^ 1];
+    *(uint16_t *)(rsp.rdram + addy + 10) = (uint16_t)accum;
+}
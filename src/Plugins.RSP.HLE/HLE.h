@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/*
+ * High-level emulation of the audio, JPEG and MP3 microcodes.
+ *
+ * This library holds no platform-specific code, so it can be built and tested without the plugin around it. The host
+ * fills in `rsp` and runs tasks by dispatching alist commands through the ABI tables or by calling the task functions.
+ */
+
+#include <core_plugin.h>
+
+#define S 1
+#define S8 3
+
+/*
+ * Audio flags
+ */
+
+#define A_INIT 0x01
+#define A_CONTINUE 0x00
+#define A_LOOP 0x02
+#define A_OUT 0x02
+#define A_LEFT 0x02
+#define A_RIGHT 0x00
+#define A_VOL 0x04
+#define A_RATE 0x00
+#define A_AUX 0x08
+#define A_NOAUX 0x00
+#define A_MAIN 0x00
+#define A_MIX 0x10
+
+extern core_rsp_info rsp;
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t flags;
+
+    uint32_t ucode_boot;
+    uint32_t ucode_boot_size;
+
+    uint32_t ucode;
+    uint32_t ucode_size;
+
+    uint32_t ucode_data;
+    uint32_t ucode_data_size;
+
+    uint32_t dram_stack;
+    uint32_t dram_stack_size;
+
+    uint32_t output_buff;
+    uint32_t output_buff_size;
+
+    uint32_t data_ptr;
+    uint32_t data_size;
+
+    uint32_t yield_data_ptr;
+    uint32_t yield_data_size;
+} OSTask_t;
+
+/**
+ * \brief Called when a task or command can't be emulated. Prints the message to stderr by default.
+ */
+extern void (*g_hle_error)(const std::wstring &message);
+
+void jpg_uncompress(OSTask_t *task);
+
+/**
+ * \brief A command handler of an audio microcode.
+ * \param inst1 The first word of the command, whose top byte selects the handler.
+ * \param inst2 The second word of the command.
+ */
+typedef void (*hle_alist_handler)(uint32_t inst1, uint32_t inst2);
+
+extern hle_alist_handler ABI1[0x20];
+extern hle_alist_handler ABI2[0x20];
+extern hle_alist_handler ABI3[0x20];
+
+/**
+ * \brief Runs an audio command list through the command table of a microcode.
+ * \param abi The command table.
+ * \param alist The commands, two words each.
+ * \param words The amount of words in the command list.
+ */
+void hle_run_alist(const hle_alist_handler *abi, const uint32_t *alist, size_t words);
+
+/**
+ * \brief Clears the state the microcodes carry over between tasks, as on a fresh boot.
+ */
+void hle_reset();
+
+extern uint8_t BufferSpace[0x10000];
+extern uint16_t AudioInBuffer, AudioOutBuffer, AudioCount;
+extern uint16_t AudioAuxA, AudioAuxC, AudioAuxE;
+extern uint32_t loopval; // Value set by A_SETLOOP : Possible conflict with SETVOLUME???
+extern uint16_t ResampleLUT[0x200];
+
+/**
+ * \brief Runs the 4-tap resampler shared by all audio ABIs over the sample buffer.
+ * \param flags The command flags. Bit 0 starts from silence instead of the state saved in RDRAM.
+ * \param pitch The pitch as a 16.16 fixed-point step.
+ * \param addy The RDRAM address of the resampler state.
+ * \param src_ptr The halfword index of the first input sample.
+ * \param dst_ptr The halfword index of the first output sample.
+ * \param count The amount of samples to produce.
+ */
+void hle_resample(uint8_t flags, uint32_t pitch, uint32_t addy, uint32_t src_ptr, uint32_t dst_ptr, uint32_t count);
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "HLE.h"
+#include "JpegKernels.h"
+
+static struct
+{
+    uint32_t pic;
+    int32_t w;
+    int32_t h;
+    uint32_t m1;
+    uint32_t m2;
+    uint32_t m3;
+} jpg_data;
+
+static short *q[3];
+static short *pic;
+static uint32_t len1, len2;
+
+/**
+ * \brief The position of every coefficient of a block in row-major order, indexed by its position in the stream.
+ */
+static constexpr uint8_t ZIGZAG[JpegKernels::BLOCK_SIZE] = {
+    0,  8,  1,  2,  9,  16, 24, 17, 10, 3,  4,  11, 18, 25, 32, 40, 33, 26, 19, 12, 5,  6,  13, 20, 27, 34, 41, 48,
+    56, 49, 42, 35, 28, 21, 14, 7,  15, 22, 29, 36, 43, 50, 57, 58, 51, 44, 37, 30, 23, 31, 38, 45, 52, 59, 60, 53,
+    46, 39, 47, 54, 61, 62, 55, 63,
+};
+
+void jpg_uncompress(OSTask_t *task)
+{
+    constexpr size_t BLOCK_SIZE = JpegKernels::BLOCK_SIZE;
+
+    if (!task->flags & 1)
+    {
+        memcpy(&jpg_data, rsp.rdram + task->data_ptr, task->data_size);
+        q[0] = (short *)(rsp.rdram + jpg_data.m1);
+        q[1] = (short *)(rsp.rdram + jpg_data.m2);
+        q[2] = (short *)(rsp.rdram + jpg_data.m3);
+
+        if (jpg_data.h == 0)
+        {
+            len1 = 512;
+            len2 = 255;
+        }
+        else
+        {
+            len1 = 768;
+            len2 = 511;
+        }
+    }
+    else
+    {
+        g_hle_error(L"jpg_uncompress: !flags");
+    }
+    pic = (short *)(rsp.rdram + jpg_data.pic);
+
+    // The constants and tables are unswapped once per task, so the kernels can work on linear halfwords.
+    int16_t c[32];
+    int16_t qt[3][BLOCK_SIZE];
+    EndianUtils::swap32_halves(c, rsp.rdram + task->ucode_data, sizeof(c));
+    for (size_t i = 0; i < 3; ++i)
+    {
+        EndianUtils::swap32_halves(qt[i], q[i], sizeof(qt[i]));
+    }
+
+    // The color conversion always reads 6 blocks, even if the macroblock has fewer.
+    const size_t blocks = jpg_data.h + 4;
+    std::vector<int16_t> temp1(std::max<size_t>(blocks, 6) * BLOCK_SIZE);
+    std::vector<int16_t> temp2(temp1.size());
+    int16_t out[256];
+    int w = jpg_data.w;
+
+    do
+    {
+        EndianUtils::swap32_halves(temp1.data(), pic, blocks * BLOCK_SIZE * sizeof(int16_t));
+
+        for (size_t i = 0; i < blocks; ++i)
+        {
+            int16_t *block = temp1.data() + i * BLOCK_SIZE;
+            const size_t table = i < blocks - 2 ? 0 : i == blocks - 2 ? 1 : 2;
+            JpegKernels::dequantize(block, block, qt[table], c[0]);
+
+            for (size_t n = 0; n < BLOCK_SIZE; ++n)
+            {
+                temp2[i * BLOCK_SIZE + ZIGZAG[n]] = block[n];
+            }
+
+            JpegKernels::idct(block, temp2.data() + i * BLOCK_SIZE, c);
+        }
+
+        if (jpg_data.h == 0)
+        {
+            g_hle_error(L"h==0");
+        }
+        else
+        {
+            JpegKernels::color_convert(out, temp1.data(), c);
+            EndianUtils::swap32_halves(pic, out, sizeof(out));
+        }
+        pic += len1 / 2;
+    } while (w-- != 1 && !(*rsp.sp_status_reg & 0x80));
+
+    pic -= len1 * jpg_data.w / 2;
+}
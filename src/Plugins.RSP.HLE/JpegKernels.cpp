@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "JpegKernels.h"
+
+// Everything the kernels need is in SSE2, which every x64 CPU has.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JPEG_KERNELS_SSE2
+#endif
+
+#pragma region Scalar
+
+/**
+ * \brief Computes <c>(a * ca * 2 + 0x8000 + b * cb * 2) >> 16</c>, wrapping around like the RSP's accumulator.
+ */
+static int16_t mul_sum(const int16_t a, const int16_t ca, const int16_t b, const int16_t cb)
+{
+    const uint32_t accum = (uint32_t)(a * ca) * 2 + 0x8000 + (uint32_t)(b * cb) * 2;
+    return (int16_t)((int32_t)accum >> 16);
+}
+
+/**
+ * \brief Computes the high half of the product of a signed and an unsigned halfword.
+ */
+static int16_t mulhi_unsigned(const int16_t x, const int16_t u)
+{
+    return (int16_t)((x * (int32_t)(uint16_t)u) >> 16);
+}
+
+/**
+ * \brief Runs the butterflies shared by both passes of the inverse DCT on column <c>j</c>.
+ * Output rows <c>n</c> and <c>7 - n</c> are made from <c>even[n]</c> and <c>odd[n]</c>.
+ */
+static void idct_stage(const int16_t *t, const size_t j, const int16_t *c, int16_t even[4], int16_t odd[4])
+{
+    const auto row = [&](const size_t r) { return t[r * 8 + j]; };
+
+    const int16_t m8 = mul_sum(row(1), c[16], row(7), c[17]);
+    const int16_t m9 = mul_sum(row(5), c[18], row(3), c[19]);
+    const int16_t m10 = mul_sum(row(3), c[18], row(5), c[20]);
+    const int16_t m11 = mul_sum(row(7), c[16], row(1), c[21]);
+    const int16_t m6 = mul_sum(row(0), c[24], row(4), c[25]);
+
+    const auto d0 = (int16_t)(m11 - m10);
+    const auto d1 = (int16_t)(m8 - m9);
+    odd[0] = (int16_t)(m11 + m10);
+    odd[1] = mul_sum(d0, c[24], d1, c[24]);
+    odd[2] = mul_sum(d0, c[24], d1, c[25]);
+    odd[3] = (int16_t)(m8 + m9);
+
+    const int16_t m4 = mul_sum(row(0), c[24], row(4), c[24]);
+    const int16_t m5 = mul_sum(row(6), c[26], row(2), c[28]);
+    const int16_t m7 = mul_sum(row(2), c[26], row(6), c[27]);
+    even[0] = (int16_t)(m4 + m5);
+    even[1] = (int16_t)(m6 + m7);
+    even[2] = (int16_t)(m6 - m7);
+    even[3] = (int16_t)(m4 - m5);
+}
+
+/**
+ * \brief Converts one pixel to RGBA.
+ * \param y The luma.
+ * \param u The blue-difference chroma, already scaled.
+ * \param v The red-difference chroma, already scaled.
+ */
+static int16_t to_rgba(int16_t y, const int16_t u, const int16_t v, const int16_t *c)
+{
+    y = (int16_t)(y + c[15]);
+    int16_t rgb[3] = {
+        (int16_t)(mulhi_unsigned(v, c[8]) + v + y),
+        (int16_t)(y - (mulhi_unsigned(u, c[9]) + mulhi_unsigned(v, c[10]))),
+        (int16_t)(mulhi_unsigned(u, c[11]) + u + y),
+    };
+
+    int16_t pixel = c[6];
+    for (size_t n = 0; n < 3; ++n)
+    {
+        const int16_t x = mulhi_unsigned(std::min(std::max(rgb[n], (int16_t)0), c[12]), c[14]);
+        pixel |= (int16_t)(x * c[3 + n]);
+    }
+    return pixel;
+}
+
+void JpegKernels::scalar::dequantize(int16_t *dst, const int16_t *src, const int16_t *q, const int16_t scale)
+{
+    for (size_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+        dst[i] = (int16_t)((uint16_t)(src[i] * q[i]) * scale);
+    }
+}
+
+void JpegKernels::scalar::idct(int16_t *dst, const int16_t *src, const int16_t *c)
+{
+    int16_t tmp[BLOCK_SIZE];
+    int16_t transposed[BLOCK_SIZE];
+    int16_t even[4];
+    int16_t odd[4];
+
+    for (size_t j = 0; j < 8; ++j)
+    {
+        idct_stage(src, j, c, even, odd);
+        for (size_t n = 0; n < 4; ++n)
+        {
+            tmp[n * 8 + j] = (int16_t)(even[n] + odd[n]);
+            tmp[(7 - n) * 8 + j] = (int16_t)(even[n] - odd[n]);
+        }
+    }
+
+    for (size_t j = 0; j < 8; ++j)
+    {
+        for (size_t k = 0; k < 8; ++k)
+        {
+            transposed[j * 8 + k] = tmp[k * 8 + j];
+        }
+    }
+
+    for (size_t j = 0; j < 8; ++j)
+    {
+        idct_stage(transposed, j, c, even, odd);
+        for (size_t n = 0; n < 4; ++n)
+        {
+            const uint32_t accum = (uint32_t)(even[n] * c[1]) * 2 + 0x8000 + (uint32_t)(odd[n] * c[1]) * 2;
+            dst[n * 8 + j] = (int16_t)((int32_t)accum >> 16);
+            dst[(7 - n) * 8 + j] = (int16_t)((int32_t)(accum + (uint32_t)(odd[n] * c[2]) * 2) >> 16);
+        }
+    }
+}
+
+void JpegKernels::scalar::color_convert(int16_t *dst, const int16_t *blocks, const int16_t *c)
+{
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            // Every chroma row covers two rows of the left and right luma blocks.
+            const int16_t *luma = blocks + i * 128 + j * 16;
+            const int16_t *u = blocks + 256 + i * 32 + j * 8;
+            const int16_t *v = u + 64;
+            int16_t *out = dst + i * 128 + j * 32;
+
+            for (size_t k = 0; k < 8; ++k)
+            {
+                const int16_t scale = c[6 + (k & 1)];
+                const auto u_left = (int16_t)(u[k >> 1] * scale);
+                const auto u_right = (int16_t)(u[4 + (k >> 1)] * scale);
+                const auto v_left = (int16_t)(v[k >> 1] * scale);
+                const auto v_right = (int16_t)(v[4 + (k >> 1)] * scale);
+
+                out[k] = to_rgba(luma[k], u_left, v_left, c);
+                out[8 + k] = to_rgba(luma[64 + k], u_right, v_right, c);
+                out[16 + k] = to_rgba(luma[8 + k], u_left, v_left, c);
+                out[24 + k] = to_rgba(luma[72 + k], u_right, v_right, c);
+            }
+        }
+    }
+}
+
+#pragma endregion
+
+#pragma region Vectorised
+
+#if defined(JPEG_KERNELS_SSE2)
+
+static __m128i load(const int16_t *p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+static void store(int16_t *p, const __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+}
+
+/**
+ * \brief Broadcasts a pair of constants for <c>_mm_madd_epi16</c> on interleaved operands.
+ */
+static __m128i pair(const int16_t ca, const int16_t cb)
+{
+    return _mm_set1_epi32((int32_t)((uint32_t)(uint16_t)ca | (uint32_t)(uint16_t)cb << 16));
+}
+
+/**
+ * \brief Rounds and narrows the accumulators of <c>mul_sum</c>. The arithmetic shift always fits into a halfword, so
+ * the saturating pack is exact.
+ */
+static __m128i narrow(const __m128i lo, const __m128i hi)
+{
+    return _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_srai_epi32(hi, 16));
+}
+
+static __m128i mul_sum(const __m128i a, const __m128i b, const __m128i cc)
+{
+    const __m128i round = _mm_set1_epi32(0x8000);
+    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), cc);
+    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), cc);
+    return narrow(_mm_add_epi32(_mm_slli_epi32(lo, 1), round), _mm_add_epi32(_mm_slli_epi32(hi, 1), round));
+}
+
+static __m128i mulhi_unsigned(const __m128i x, const __m128i u)
+{
+    // The signed high product is short by x in the lanes where u has its top bit set.
+    return _mm_add_epi16(_mm_mulhi_epi16(x, u), _mm_and_si128(x, _mm_srai_epi16(u, 15)));
+}
+
+static void transpose(__m128i r[8])
+{
+    const __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    const __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    const __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+    const __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    const __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+    const __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    const __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+    const __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+    const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+    r[0] = _mm_unpacklo_epi64(b0, b4);
+    r[1] = _mm_unpackhi_epi64(b0, b4);
+    r[2] = _mm_unpacklo_epi64(b1, b5);
+    r[3] = _mm_unpackhi_epi64(b1, b5);
+    r[4] = _mm_unpacklo_epi64(b2, b6);
+    r[5] = _mm_unpackhi_epi64(b2, b6);
+    r[6] = _mm_unpacklo_epi64(b3, b7);
+    r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/**
+ * \brief Runs the butterflies of <c>idct_stage</c> on all columns at once.
+ */
+static void idct_stage(const __m128i t[8], const int16_t *c, __m128i even[4], __m128i odd[4])
+{
+    const __m128i m8 = mul_sum(t[1], t[7], pair(c[16], c[17]));
+    const __m128i m9 = mul_sum(t[5], t[3], pair(c[18], c[19]));
+    const __m128i m10 = mul_sum(t[3], t[5], pair(c[18], c[20]));
+    const __m128i m11 = mul_sum(t[7], t[1], pair(c[16], c[21]));
+    const __m128i m6 = mul_sum(t[0], t[4], pair(c[24], c[25]));
+
+    const __m128i d0 = _mm_sub_epi16(m11, m10);
+    const __m128i d1 = _mm_sub_epi16(m8, m9);
+    odd[0] = _mm_add_epi16(m11, m10);
+    odd[1] = mul_sum(d0, d1, pair(c[24], c[24]));
+    odd[2] = mul_sum(d0, d1, pair(c[24], c[25]));
+    odd[3] = _mm_add_epi16(m8, m9);
+
+    const __m128i m4 = mul_sum(t[0], t[4], pair(c[24], c[24]));
+    const __m128i m5 = mul_sum(t[6], t[2], pair(c[26], c[28]));
+    const __m128i m7 = mul_sum(t[2], t[6], pair(c[26], c[27]));
+    even[0] = _mm_add_epi16(m4, m5);
+    even[1] = _mm_add_epi16(m6, m7);
+    even[2] = _mm_sub_epi16(m6, m7);
+    even[3] = _mm_sub_epi16(m4, m5);
+}
+
+struct rgba_constants
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i bias;
+    __m128i r_v;
+    __m128i g_u;
+    __m128i g_v;
+    __m128i b_u;
+    __m128i max;
+    __m128i level;
+    __m128i shift[3];
+    __m128i alpha;
+};
+
+static __m128i to_rgba(__m128i y, const __m128i u, const __m128i v, const rgba_constants &k)
+{
+    y = _mm_add_epi16(y, k.bias);
+    const __m128i rgb[3] = {
+        _mm_add_epi16(_mm_add_epi16(mulhi_unsigned(v, k.r_v), v), y),
+        _mm_sub_epi16(y, _mm_add_epi16(mulhi_unsigned(u, k.g_u), mulhi_unsigned(v, k.g_v))),
+        _mm_add_epi16(_mm_add_epi16(mulhi_unsigned(u, k.b_u), u), y),
+    };
+
+    __m128i pixel = k.alpha;
+    for (size_t n = 0; n < 3; ++n)
+    {
+        const __m128i x = mulhi_unsigned(_mm_min_epi16(_mm_max_epi16(rgb[n], k.zero), k.max), k.level);
+        pixel = _mm_or_si128(pixel, _mm_mullo_epi16(x, k.shift[n]));
+    }
+    return pixel;
+}
+
+void JpegKernels::dequantize(int16_t *dst, const int16_t *src, const int16_t *q, const int16_t scale)
+{
+    const __m128i s = _mm_set1_epi16(scale);
+    for (size_t i = 0; i < BLOCK_SIZE; i += 8)
+    {
+        store(dst + i, _mm_mullo_epi16(_mm_mullo_epi16(load(src + i), load(q + i)), s));
+    }
+}
+
+void JpegKernels::idct(int16_t *dst, const int16_t *src, const int16_t *c)
+{
+    __m128i t[8];
+    __m128i even[4];
+    __m128i odd[4];
+
+    for (size_t r = 0; r < 8; ++r)
+    {
+        t[r] = load(src + r * 8);
+    }
+
+    idct_stage(t, c, even, odd);
+    for (size_t n = 0; n < 4; ++n)
+    {
+        t[n] = _mm_add_epi16(even[n], odd[n]);
+        t[7 - n] = _mm_sub_epi16(even[n], odd[n]);
+    }
+
+    transpose(t);
+    idct_stage(t, c, even, odd);
+
+    const __m128i round = _mm_set1_epi32(0x8000);
+    const __m128i scale = pair(c[1], c[1]);
+    const __m128i tail = pair(0, c[2]);
+    for (size_t n = 0; n < 4; ++n)
+    {
+        const __m128i lo = _mm_unpacklo_epi16(even[n], odd[n]);
+        const __m128i hi = _mm_unpackhi_epi16(even[n], odd[n]);
+        const __m128i accum_lo = _mm_add_epi32(_mm_slli_epi32(_mm_madd_epi16(lo, scale), 1), round);
+        const __m128i accum_hi = _mm_add_epi32(_mm_slli_epi32(_mm_madd_epi16(hi, scale), 1), round);
+        const __m128i tail_lo = _mm_slli_epi32(_mm_madd_epi16(lo, tail), 1);
+        const __m128i tail_hi = _mm_slli_epi32(_mm_madd_epi16(hi, tail), 1);
+
+        store(dst + n * 8, narrow(accum_lo, accum_hi));
+        store(dst + (7 - n) * 8, narrow(_mm_add_epi32(accum_lo, tail_lo), _mm_add_epi32(accum_hi, tail_hi)));
+    }
+}
+
+void JpegKernels::color_convert(int16_t *dst, const int16_t *blocks, const int16_t *c)
+{
+    rgba_constants k;
+    k.bias = _mm_set1_epi16(c[15]);
+    k.r_v = _mm_set1_epi16(c[8]);
+    k.g_u = _mm_set1_epi16(c[9]);
+    k.g_v = _mm_set1_epi16(c[10]);
+    k.b_u = _mm_set1_epi16(c[11]);
+    k.max = _mm_set1_epi16(c[12]);
+    k.level = _mm_set1_epi16(c[14]);
+    k.shift[0] = _mm_set1_epi16(c[3]);
+    k.shift[1] = _mm_set1_epi16(c[4]);
+    k.shift[2] = _mm_set1_epi16(c[5]);
+    k.alpha = _mm_set1_epi16(c[6]);
+
+    // Duplicating every chroma sample makes the scales alternate between c[6] and c[7] along the row.
+    const __m128i scale = pair(c[6], c[7]);
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            const int16_t *luma = blocks + i * 128 + j * 16;
+            const __m128i u = load(blocks + 256 + i * 32 + j * 8);
+            const __m128i v = load(blocks + 320 + i * 32 + j * 8);
+            int16_t *out = dst + i * 128 + j * 32;
+
+            const __m128i u_left = _mm_mullo_epi16(_mm_unpacklo_epi16(u, u), scale);
+            const __m128i u_right = _mm_mullo_epi16(_mm_unpackhi_epi16(u, u), scale);
+            const __m128i v_left = _mm_mullo_epi16(_mm_unpacklo_epi16(v, v), scale);
+            const __m128i v_right = _mm_mullo_epi16(_mm_unpackhi_epi16(v, v), scale);
+
+            store(out, to_rgba(load(luma), u_left, v_left, k));
+            store(out + 8, to_rgba(load(luma + 64), u_right, v_right, k));
+            store(out + 16, to_rgba(load(luma + 8), u_left, v_left, k));
+            store(out + 24, to_rgba(load(luma + 72), u_right, v_right, k));
+        }
+    }
+}
+
+#else
+
+void JpegKernels::dequantize(int16_t *dst, const int16_t *src, const int16_t *q, const int16_t scale)
+{
+    scalar::dequantize(dst, src, q, scale);
+}
+
+void JpegKernels::idct(int16_t *dst, const int16_t *src, const int16_t *c)
+{
+    scalar::idct(dst, src, c);
+}
+
+void JpegKernels::color_convert(int16_t *dst, const int16_t *blocks, const int16_t *c)
+{
+    scalar::color_convert(dst, blocks, c);
+}
+
+#endif
+
+#pragma endregion
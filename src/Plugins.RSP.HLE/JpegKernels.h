@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+/**
+ * \brief A module providing the block processing kernels of the JPEG microcode HLE.
+ * \remarks The kernels work on linear arrays of host-order halfwords, so the task data has to be unswapped with
+ * <c>EndianUtils::swap32_halves</c> first. As with <c>AudioKernels</c>, the vectorised implementations are picked at
+ * compile time and must match their references in <c>JpegKernels::scalar</c> bit for bit.
+ */
+namespace JpegKernels
+{
+/**
+ * \brief The amount of values in a block.
+ */
+constexpr size_t BLOCK_SIZE = 64;
+
+/**
+ * \brief Dequantizes a block.
+ * Equivalent to <c>dst[i] = (uint16_t)(src[i] * q[i]) * scale</c>, truncated to 16 bits.
+ * \param dst The destination block. May be the same as <c>src</c>.
+ * \param src The source block.
+ * \param q The quantization table.
+ * \param scale The scale all values are multiplied with after quantization.
+ */
+void dequantize(int16_t *dst, const int16_t *src, const int16_t *q, int16_t scale);
+
+/**
+ * \brief Transforms a block back into the spatial domain with the microcode's fixed-point inverse DCT.
+ * \param dst The destination block. Mustn't overlap <c>src</c>.
+ * \param src The source block, with its coefficients already in row-major order.
+ * \param c The first 32 halfwords of the task's microcode data.
+ */
+void idct(int16_t *dst, const int16_t *src, const int16_t *c);
+
+/**
+ * \brief Converts a 16x16 macroblock from YUV 4:2:0 to packed 16-bit RGBA.
+ * \param dst The destination, 256 pixels in 16 rows.
+ * \param blocks The source blocks, 4 luma blocks in row-major order followed by the 2 chroma blocks.
+ * \param c The first 32 halfwords of the task's microcode data.
+ */
+void color_convert(int16_t *dst, const int16_t *blocks, const int16_t *c);
+
+/**
+ * \brief The reference implementations of the kernels.
+ */
+namespace scalar
+{
+void dequantize(int16_t *dst, const int16_t *src, const int16_t *q, int16_t scale);
+void idct(int16_t *dst, const int16_t *src, const int16_t *c);
+void color_convert(int16_t *dst, const int16_t *blocks, const int16_t *c);
+} // namespace scalar
+} // namespace JpegKernels
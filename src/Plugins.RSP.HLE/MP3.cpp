@@ -4,8 +4,9 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-#include "Main.h"
+#include <CommonPCH.h>
 #include "HLE.h"
+#include "AudioKernels.h"
 
 static uint16_t DeWindowLUT[0x420] = {
     0x0000, 0xFFF3, 0x005D, 0xFF38, 0x037A, 0xF736, 0x0B37, 0xC00E, 0x7FFF, 0x3FF2, 0x0B37, 0x08CA, 0x037A, 0x00C8,
@@ -135,7 +136,16 @@ uint32_t t6; // = 0x08A0; // I think these are temporary storage buffers
 uint32_t t5; // = 0x0AC0;
 uint32_t t4; // = (inst1 & 0x1E);
 
-void MP3()
+void mp3_reset()
+{
+    memset(myVector, 0, sizeof(myVector));
+    memset(mp3data, 0, sizeof(mp3data));
+    memset(v, 0, sizeof(v));
+    inPtr = outPtr = 0;
+    t4 = t5 = t6 = 0;
+}
+
+void MP3(const uint32_t inst1, const uint32_t inst2)
 {
     // Initialization Code
     uint32_t readPtr;        // s5
@@ -503,32 +513,22 @@ static void InnerLoop()
     int32_t z2 = 0, z4 = 0, z6 = 0, z8 = 0;
 
     offset = 0x10 - (t4 >> 1); // + x*0x40;
+    const auto window = reinterpret_cast<const int16_t *>(DeWindowLUT);
     int x;
     for (x = 0; x < 8; x++)
     {
-        v2 = v4 = v6 = v8 = 0;
-
-        // addptr = t1;
-
-        for (i = 7; i >= 0; i--)
-        {
-            v2 += ((int)*(int16_t *)(mp3data + (addptr) + 0x00) * (short)DeWindowLUT[offset + 0x00] + 0x4000) >> 0xF;
-            v4 += ((int)*(int16_t *)(mp3data + (addptr) + 0x10) * (short)DeWindowLUT[offset + 0x08] + 0x4000) >> 0xF;
-            v6 += ((int)*(int16_t *)(mp3data + (addptr) + 0x20) * (short)DeWindowLUT[offset + 0x20] + 0x4000) >> 0xF;
-            v8 += ((int)*(int16_t *)(mp3data + (addptr) + 0x30) * (short)DeWindowLUT[offset + 0x28] + 0x4000) >> 0xF;
-            addptr += 2;
-            offset++;
-        }
-        int32_t v0 = v2 + v4;
-        int32_t v18 = v6 + v8;
+        // Each output weights 16 consecutive samples by 16 consecutive coefficients, the second one 0x20 further in.
+        const auto samples = reinterpret_cast<const int16_t *>(mp3data + addptr);
+        int32_t v0 = AudioKernels::dewindow(samples, window + offset, 16, false);
+        int32_t v18 = AudioKernels::dewindow(samples + 16, window + offset + 0x20, 16, false);
         // Clamp(v0);
         // Clamp(v18);
         //  clamp???
         *(int16_t *)(mp3data + (outPtr ^ 2)) = v0;
         *(int16_t *)(mp3data + ((outPtr + 2) ^ 2)) = v18;
         outPtr += 4;
-        addptr += 0x30;
-        offset += 0x38;
+        addptr += 0x40;
+        offset += 0x40;
     }
 
     offset = 0x10 - (t4 >> 1) + 8 * 0x40;
@@ -561,36 +561,19 @@ static void InnerLoop()
 
     for (x = 0; x < 8; x++)
     {
-        v2 = v4 = v6 = v8 = 0;
-
         offset = (0x22F - (t4 >> 1) + x * 0x40);
 
-        for (i = 0; i < 4; i++)
-        {
-            v2 += ((int)*(int16_t *)(mp3data + (addptr) + 0x20) * (short)DeWindowLUT[offset + 0x00] + 0x4000) >> 0xF;
-            v2 -= ((int)*(int16_t *)(mp3data + ((addptr + 2)) + 0x20) * (short)DeWindowLUT[offset + 0x01] + 0x4000) >>
-                  0xF;
-            v4 += ((int)*(int16_t *)(mp3data + (addptr) + 0x30) * (short)DeWindowLUT[offset + 0x08] + 0x4000) >> 0xF;
-            v4 -= ((int)*(int16_t *)(mp3data + ((addptr + 2)) + 0x30) * (short)DeWindowLUT[offset + 0x09] + 0x4000) >>
-                  0xF;
-            v6 += ((int)*(int16_t *)(mp3data + (addptr) + 0x00) * (short)DeWindowLUT[offset + 0x20] + 0x4000) >> 0xF;
-            v6 -= ((int)*(int16_t *)(mp3data + ((addptr + 2)) + 0x00) * (short)DeWindowLUT[offset + 0x21] + 0x4000) >>
-                  0xF;
-            v8 += ((int)*(int16_t *)(mp3data + (addptr) + 0x10) * (short)DeWindowLUT[offset + 0x28] + 0x4000) >> 0xF;
-            v8 -= ((int)*(int16_t *)(mp3data + ((addptr + 2)) + 0x10) * (short)DeWindowLUT[offset + 0x29] + 0x4000) >>
-                  0xF;
-            addptr += 4;
-            offset += 2;
-        }
-        int32_t v0 = v2 + v4;
-        int32_t v18 = v6 + v8;
+        // As above, but with the sample halves swapped and every other term subtracted.
+        const auto samples = reinterpret_cast<const int16_t *>(mp3data + addptr);
+        int32_t v0 = AudioKernels::dewindow(samples + 16, window + offset, 16, true);
+        int32_t v18 = AudioKernels::dewindow(samples, window + offset + 0x20, 16, true);
         // Clamp(v0);
         // Clamp(v18);
         //  clamp???
         *(int16_t *)(mp3data + ((outPtr + 2) ^ 2)) = v0;
         *(int16_t *)(mp3data + ((outPtr + 4) ^ 2)) = v18;
         outPtr += 4;
-        addptr -= 0x50;
+        addptr -= 0x40;
     }
 
     int tmp = outPtr;
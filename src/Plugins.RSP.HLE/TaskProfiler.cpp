@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "TaskProfiler.h"
+#include "HLE.h"
+
+using namespace TaskProfiler;
+
+static constexpr const char *TASK_KIND_NAMES[] = {"graphics", "audio", "jpeg", "boot", "unknown"};
+static_assert(std::size(TASK_KIND_NAMES) == static_cast<size_t>(task_kind::count));
+
+static uint64_t elapsed_ns(const std::chrono::steady_clock::time_point start,
+                           const std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * \brief Writes a histogram as a JSON object, listing only the buckets which hold anything.
+ */
+static void append_json(std::string &out, const histogram &histogram)
+{
+    out += std::format(R"({{"count":{},"total_ns":{},"min_ns":{},"max_ns":{},"buckets":[)", histogram.count,
+                       histogram.total_ns, histogram.count ? histogram.min_ns : 0, histogram.max_ns);
+
+    bool first = true;
+    for (size_t i = 0; i < histogram.buckets.size(); ++i)
+    {
+        if (!histogram.buckets[i])
+        {
+            continue;
+        }
+        out += std::format("{}[{},{}]", first ? "" : ",", histogram::bucket_limit(i), histogram.buckets[i]);
+        first = false;
+    }
+    out += "]}";
+}
+
+size_t histogram::bucket_of(const uint64_t ns)
+{
+    const size_t width = std::bit_width(ns);
+    if (width <= FIRST_BUCKET_SHIFT)
+    {
+        return 0;
+    }
+    return std::min(width - FIRST_BUCKET_SHIFT, BUCKET_COUNT - 1);
+}
+
+uint64_t histogram::bucket_limit(const size_t bucket)
+{
+    if (bucket == BUCKET_COUNT - 1)
+    {
+        return UINT64_MAX;
+    }
+    return 1ull << (bucket + FIRST_BUCKET_SHIFT);
+}
+
+void histogram::add(const uint64_t ns)
+{
+    ++count;
+    total_ns += ns;
+    min_ns = std::min(min_ns, ns);
+    max_ns = std::max(max_ns, ns);
+    ++buckets[bucket_of(ns)];
+}
+
+void profiler::set_enabled(const bool enabled)
+{
+    if (enabled && !this->enabled())
+    {
+        reset();
+    }
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void profiler::record_task(const task_kind kind, const uint32_t ucode, const uint64_t ns)
+{
+    std::lock_guard lock(m_mutex);
+    m_tasks[static_cast<size_t>(kind)].add(ns);
+    if (kind != task_kind::graphics)
+    {
+        m_ucodes[ucode].add(ns);
+    }
+}
+
+void profiler::run(const uint32_t abi, const hle_alist_handler *table, const uint32_t *alist, const size_t words)
+{
+    m_pending.clear();
+
+    auto last = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + 1 < words; i += 2)
+    {
+        table[alist[i] >> 24](alist[i], alist[i + 1]);
+
+        const auto now = std::chrono::steady_clock::now();
+        m_pending.emplace_back(static_cast<uint8_t>((alist[i] >> 24) & 0x1F), elapsed_ns(last, now));
+        last = now;
+    }
+
+    std::lock_guard lock(m_mutex);
+    auto &commands = m_commands[std::min<size_t>(abi, ABI_COUNT - 1)];
+    for (const auto &[op, ns] : m_pending)
+    {
+        commands[op].add(ns);
+    }
+}
+
+void profiler::reset()
+{
+    std::lock_guard lock(m_mutex);
+    m_tasks = {};
+    m_ucodes.clear();
+    m_commands = {};
+}
+
+std::string profiler::to_json() const
+{
+    std::lock_guard lock(m_mutex);
+    std::string out = R"({"tasks":{)";
+
+    for (size_t i = 0; i < m_tasks.size(); ++i)
+    {
+        out += std::format(R"({}"{}":)", i ? "," : "", TASK_KIND_NAMES[i]);
+        append_json(out, m_tasks[i]);
+    }
+
+    out += R"(},"ucodes":{)";
+    bool first = true;
+    for (const auto &[ucode, histogram] : m_ucodes)
+    {
+        out += std::format(R"({}"0x{:X}":)", first ? "" : ",", ucode);
+        append_json(out, histogram);
+        first = false;
+    }
+
+    out += R"(},"commands":{)";
+    first = true;
+    for (size_t abi = 0; abi < m_commands.size(); ++abi)
+    {
+        if (std::ranges::none_of(m_commands[abi], [](const auto &h) { return h.count != 0; }))
+        {
+            continue;
+        }
+
+        out += std::format(R"({}"abi{}":{{)", first ? "" : ",", abi);
+        first = false;
+
+        bool first_op = true;
+        for (size_t op = 0; op < m_commands[abi].size(); ++op)
+        {
+            if (!m_commands[abi][op].count)
+            {
+                continue;
+            }
+            out += std::format(R"({}"0x{:02X}":)", first_op ? "" : ",", op);
+            append_json(out, m_commands[abi][op]);
+            first_op = false;
+        }
+        out += "}";
+    }
+    out += "}}";
+
+    return out;
+}
+
+task_scope::task_scope(profiler &profiler) : m_profiler(profiler)
+{
+    if (m_profiler.enabled())
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+task_scope::~task_scope()
+{
+    if (m_profiler.enabled() && m_start != std::chrono::steady_clock::time_point{})
+    {
+        m_profiler.record_task(kind, ucode, elapsed_ns(m_start, std::chrono::steady_clock::now()));
+    }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "HLE.h"
+
+/**
+ * \brief A module which records how long RSP tasks and audio commands take, so slow scenes can be attributed to the
+ * RSP HLE instead of the CPU core or the video plugin.
+ * \remarks Recording is off by default and costs a single load per task while off.
+ */
+namespace TaskProfiler
+{
+enum class task_kind
+{
+    graphics,
+    audio,
+    jpeg,
+    boot,
+    unknown,
+    count,
+};
+
+/**
+ * \brief A histogram of durations with power-of-two buckets.
+ */
+struct histogram
+{
+    /**
+     * \brief The upper bound of the first bucket is 2^<c>FIRST_BUCKET_SHIFT</c> ns.
+     */
+    static constexpr size_t FIRST_BUCKET_SHIFT = 8;
+    static constexpr size_t BUCKET_COUNT = 24;
+
+    uint64_t count{};
+    uint64_t total_ns{};
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns{};
+    std::array<uint64_t, BUCKET_COUNT> buckets{};
+
+    /**
+     * \brief Gets the index of the bucket a duration falls into. The last bucket holds everything above.
+     */
+    static size_t bucket_of(uint64_t ns);
+
+    /**
+     * \brief Gets the exclusive upper bound of a bucket in ns.
+     */
+    static uint64_t bucket_limit(size_t bucket);
+
+    void add(uint64_t ns);
+};
+
+class profiler
+{
+  public:
+    /**
+     * \brief Starts or stops recording. Starting discards everything recorded before.
+     */
+    void set_enabled(bool enabled);
+
+    bool enabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Records a finished task.
+     * \param kind The kind of task.
+     * \param ucode The checksum identifying the task's microcode, or 0 for graphics tasks.
+     * \param ns The time the task took.
+     */
+    void record_task(task_kind kind, uint32_t ucode, uint64_t ns);
+
+    /**
+     * \brief Runs a command list like <c>hle_run_alist</c>, recording how long every command takes.
+     * \param abi The number of the audio ABI the command table belongs to.
+     * \param table The command table.
+     * \param alist The commands, two words each.
+     * \param words The amount of words in the command list.
+     */
+    void run(uint32_t abi, const hle_alist_handler *table, const uint32_t *alist, size_t words);
+
+    /**
+     * \brief Discards everything recorded so far.
+     */
+    void reset();
+
+    /**
+     * \brief Gets the recorded statistics as a JSON object. Can be called from any thread.
+     */
+    std::string to_json() const;
+
+  private:
+    static constexpr size_t ABI_COUNT = 4;
+
+    std::atomic<bool> m_enabled = false;
+    mutable std::mutex m_mutex;
+    std::array<histogram, static_cast<size_t>(task_kind::count)> m_tasks{};
+    std::map<uint32_t, histogram> m_ucodes;
+    std::array<std::array<histogram, 0x20>, ABI_COUNT> m_commands{};
+
+    // Holds the command timings of the running task, so the lock is only taken once per task.
+    std::vector<std::pair<uint8_t, uint64_t>> m_pending;
+};
+
+/**
+ * \brief Times a task from construction to destruction and records it if the profiler is enabled.
+ */
+class task_scope
+{
+  public:
+    explicit task_scope(profiler &profiler);
+    ~task_scope();
+
+    task_scope(const task_scope &) = delete;
+    task_scope &operator=(const task_scope &) = delete;
+
+    task_kind kind = task_kind::unknown;
+    uint32_t ucode{};
+
+  private:
+    profiler &m_profiler;
+    std::chrono::steady_clock::time_point m_start{};
+};
+} // namespace TaskProfiler
@@ -4,8 +4,9 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-#include "Main.h"
-#include "hle.h"
+#include <CommonPCH.h>
+#include "HLE.h"
+#include "AudioKernels.h"
 
 /******** DMEM Memory Map for ABI 1 ***************
 Address/Range		Description
@@ -42,7 +43,7 @@ Address/Range		Description
 0xF80..0xFFF		<Unknown>
 ***************************************************/
 
-static void SPNOOP()
+static void SPNOOP(uint32_t, uint32_t)
 {
     // MessageBox (NULL, "Unknown Audio Command in ABI 1", "Audio HLE Error", MB_OK);
 }
@@ -93,7 +94,7 @@ uint16_t ResampleLUT[0x200] = {
     0x65CD, 0x087D, 0xFFC8, 0x10B4, 0x6626, 0x095A, 0xFFD0, 0x0F83, 0x6669, 0x0A44, 0xFFD8, 0x0E5F, 0x6696, 0x0B39,
     0xFFDF, 0x0D46, 0x66AD, 0x0C39};
 
-static void CLEARBUFF()
+static void CLEARBUFF(const uint32_t inst1, const uint32_t inst2)
 {
     uint32_t addr = (uint32_t)(inst1 & 0xffff);
     uint32_t count = (uint32_t)(inst2 & 0xffff);
@@ -101,7 +102,7 @@ static void CLEARBUFF()
     memset(BufferSpace + addr, 0, (count + 3) & 0xFFFC);
 }
 
-static void ENVMIXER()
+static void ENVMIXER(const uint32_t inst1, const uint32_t inst2)
 {
     // static int envmixcnt = 0;
     uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
@@ -122,10 +123,9 @@ static void ENVMIXER()
     int32_t MainL;
     int32_t AuxR;
     int32_t AuxL;
-    int i1, o1, a1, a2, a3;
-    WORD AuxIncRate = 1;
-    short zero[8];
-    memset(zero, 0, 16);
+    bool AuxIncRate = true;
+    // The volume of every sample, computed up front so the mixing itself can be vectorised.
+    static int32_t vol[4][0x8000];
     int32_t LVol, RVol;
     int32_t LAcc, RAcc;
     int32_t LTrg, RTrg;
@@ -172,8 +172,7 @@ static void ENVMIXER()
 
     if (!(flags & A_AUX))
     {
-        AuxIncRate = 0;
-        aux2 = aux3 = zero;
+        AuxIncRate = false;
     }
 
     oMainL = (Dry * (LTrg >> 16) + 0x4000) >> 15;
@@ -211,14 +210,6 @@ static void ENVMIXER()
 
         for (int x = 0; x < 8; x++)
         {
-            i1 = (int)inp[ptr ^ 1];
-            o1 = (int)out[ptr ^ 1];
-            a1 = (int)aux1[ptr ^ 1];
-            if (AuxIncRate)
-            {
-                a2 = (int)aux2[ptr ^ 1];
-                a3 = (int)aux3[ptr ^ 1];
-            }
             // TODO: here...
             // LAcc = LTrg;
             // RAcc = RTrg;
@@ -290,43 +281,18 @@ static void ENVMIXER()
                 }
             }
 
-            o1 += ((i1 * MainR) + 0x4000) >> 15;
-            a1 += ((i1 * MainL) + 0x4000) >> 15;
-
-            if (o1 > 32767)
-                o1 = 32767;
-            else if (o1 < -32768)
-                o1 = -32768;
-
-            if (a1 > 32767)
-                a1 = 32767;
-            else if (a1 < -32768)
-                a1 = -32768;
-
-            out[ptr ^ 1] = o1;
-            aux1[ptr ^ 1] = a1;
-            if (AuxIncRate)
-            {
-                a2 += ((i1 * AuxR) + 0x4000) >> 15;
-                a3 += ((i1 * AuxL) + 0x4000) >> 15;
-
-                if (a2 > 32767)
-                    a2 = 32767;
-                else if (a2 < -32768)
-                    a2 = -32768;
-
-                if (a3 > 32767)
-                    a3 = 32767;
-                else if (a3 < -32768)
-                    a3 = -32768;
-
-                aux2[ptr ^ 1] = a2;
-                aux3[ptr ^ 1] = a3;
-            }
+            vol[0][ptr ^ 1] = MainR;
+            vol[1][ptr ^ 1] = MainL;
+            vol[2][ptr ^ 1] = AuxR;
+            vol[3][ptr ^ 1] = AuxL;
             ptr++;
         }
     }
 
+    int16_t *dst[4] = {out, aux1, aux2, aux3};
+    const int32_t *vols[4] = {vol[0], vol[1], vol[2], vol[3]};
+    AudioKernels::envmix(inp, dst, vols, AuxIncRate ? 4 : 2, ptr);
+
     *(int16_t *)(hleMixerWorkArea + 0) = Wet;          // 0-1
     *(int16_t *)(hleMixerWorkArea + 2) = Dry;          // 2-3
     *(int32_t *)(hleMixerWorkArea + 4) = LTrg;         // 4-5
@@ -340,7 +306,7 @@ static void ENVMIXER()
     memcpy(rsp.rdram + addy, (uint8_t *)hleMixerWorkArea, 80);
 }
 
-static void ENVMIXERo()
+static void ENVMIXERo(const uint32_t inst1, const uint32_t inst2)
 {
     // Borrowed from RCP...
     uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
@@ -358,7 +324,7 @@ static void ENVMIXERo()
     int AuxR;
     int AuxL;
 
-    WORD AuxIncRate = 1;
+    uint16_t AuxIncRate = 1;
     short zero[8];
     memset(zero, 0, 16);
     if (flags & A_INIT)
@@ -429,69 +395,16 @@ static void ENVMIXERo()
     memcpy(rsp.rdram + addy, (uint8_t *)hleMixerWorkArea, 80);
 }
 
-static void RESAMPLE()
+static void RESAMPLE(const uint32_t inst1, const uint32_t inst2)
 {
-    BYTE Flags = (uint8_t)((inst1 >> 16) & 0xff);
-    DWORD Pitch = ((inst1 & 0xffff)) << 1;
+    uint8_t Flags = (uint8_t)((inst1 >> 16) & 0xff);
+    uint32_t Pitch = ((inst1 & 0xffff)) << 1;
     uint32_t addy = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
-    DWORD Accum = 0;
-    DWORD location;
-    int16_t *lut, *lut2;
-    short *dst;
-    int16_t *src;
-    dst = (short *)(BufferSpace);
-    src = (int16_t *)(BufferSpace);
-    uint32_t srcPtr = (AudioInBuffer / 2);
-    uint32_t dstPtr = (AudioOutBuffer / 2);
-    int32_t temp;
-    int32_t accum;
-
-    srcPtr -= 4;
-
-    if ((Flags & 0x1) == 0)
-    {
-        // memcpy (src+srcPtr, rsp.rdram+addy, 0x8);
-        for (int x = 0; x < 4; x++) src[(srcPtr + x) ^ 1] = ((uint16_t *)rsp.rdram)[((addy / 2) + x) ^ 1];
-        Accum = *(uint16_t *)(rsp.rdram + addy + 10);
-    }
-    else
-    {
-        for (int x = 0; x < 4; x++) src[(srcPtr + x) ^ 1] = 0;
-    }
-
-    for (int i = 0; i < ((AudioCount + 0xf) & 0xFFF0) / 2; i++)
-    {
-        location = (Accum >> 0xa) << 0x3;
-        lut = (int16_t *)(((uint8_t *)ResampleLUT) + location);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 0) ^ 1)) * ((int32_t)((int16_t)lut[0])));
-        accum = (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 1) ^ 1)) * ((int32_t)((int16_t)lut[1])));
-        accum += (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 2) ^ 1)) * ((int32_t)((int16_t)lut[2])));
-        accum += (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 3) ^ 1)) * ((int32_t)((int16_t)lut[3])));
-        accum += (int32_t)(temp >> 15);
-
-        if (accum > 32767) accum = 32767;
-        if (accum < -32768) accum = -32768;
 
-        dst[dstPtr ^ 1] = (accum);
-        dstPtr++;
-        Accum += Pitch;
-        srcPtr += (Accum >> 16);
-        Accum &= 0xffff;
-    }
-    for (int x = 0; x < 4; x++) ((uint16_t *)rsp.rdram)[((addy / 2) + x) ^ 1] = src[(srcPtr + x) ^ 1];
-
-    // memcpy (RSWORK, src+srcPtr, 0x8);
-    *(uint16_t *)(rsp.rdram + addy + 10) = Accum;
+    hle_resample(Flags, Pitch, addy, AudioInBuffer / 2, AudioOutBuffer / 2, ((AudioCount + 0xf) & 0xFFF0) / 2);
 }
 
-static void SETVOL()
+static void SETVOL(const uint32_t inst1, const uint32_t inst2)
 {
     // Might be better to unpack these depending on the flags...
     uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
@@ -538,30 +451,30 @@ static void SETVOL()
     }
 }
 
-static void UNKNOWN()
+static void UNKNOWN(uint32_t, uint32_t)
 {
 }
 
-static void SETLOOP()
+static void SETLOOP(const uint32_t inst1, const uint32_t inst2)
 {
     loopval = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
 }
 
-static void ADPCM()
+static void ADPCM(const uint32_t inst1, const uint32_t inst2)
 {
     // Work in progress! :)
-    BYTE Flags = (uint8_t)(inst1 >> 16) & 0xff;
-    WORD Gain = (uint16_t)(inst1 & 0xffff);
-    DWORD Address = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
-    WORD inPtr = 0;
+    uint8_t Flags = (uint8_t)(inst1 >> 16) & 0xff;
+    uint16_t Gain = (uint16_t)(inst1 & 0xffff);
+    uint32_t Address = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
+    uint16_t inPtr = 0;
     short *out = (short *)(BufferSpace + AudioOutBuffer);
-    BYTE *in = (BYTE *)(BufferSpace + AudioInBuffer);
+    uint8_t *in = (uint8_t *)(BufferSpace + AudioInBuffer);
     short count = (short)AudioCount;
-    BYTE icode;
-    BYTE code;
+    uint8_t icode;
+    uint8_t code;
     int vscale;
-    WORD index;
-    WORD j;
+    uint16_t index;
+    uint16_t j;
     int a[8];
     short *book1, *book2;
     memset(out, 0, 32);
@@ -796,7 +709,7 @@ static void ADPCM()
     memcpy(&rsp.rdram[Address], out, 32);
 }
 
-static void LOADBUFF()
+static void LOADBUFF(const uint32_t inst1, const uint32_t inst2)
 {
     // memcpy causes static... endianess issue :(
     uint32_t v0;
@@ -806,7 +719,7 @@ static void LOADBUFF()
     memcpy(BufferSpace + (AudioInBuffer & 0xFFFC), rsp.rdram + v0, (AudioCount + 3) & 0xFFFC);
 }
 
-static void SAVEBUFF()
+static void SAVEBUFF(const uint32_t inst1, const uint32_t inst2)
 {
     // memcpy causes static... endianess issue :(
     uint32_t v0;
@@ -816,13 +729,13 @@ static void SAVEBUFF()
     memcpy(rsp.rdram + v0, BufferSpace + (AudioOutBuffer & 0xFFFC), (AudioCount + 3) & 0xFFFC);
 }
 
-static void SEGMENT()
+static void SEGMENT(const uint32_t inst1, const uint32_t inst2)
 {
     // Should work
     SEGMENTS[(inst2 >> 24) & 0xf] = (inst2 & 0xffffff);
 }
 
-static void SETBUFF()
+static void SETBUFF(const uint32_t inst1, const uint32_t inst2)
 {
     // Should work ;-)
     if ((inst1 >> 0x10) & 0x8)
@@ -841,7 +754,7 @@ static void SETBUFF()
     }
 }
 
-static void DMEMMOVE()
+static void DMEMMOVE(const uint32_t inst1, const uint32_t inst2)
 {
     // Doesn't sound just right?... will fix when HLE is ready - 03-11-01
     uint32_t v0, v1;
@@ -862,7 +775,7 @@ static void DMEMMOVE()
     }
 }
 
-static void LOADADPCM()
+static void LOADADPCM(const uint32_t inst1, const uint32_t inst2)
 {
     // Loads an ADPCM table - Works 100% Now 03-13-01
     uint32_t v0;
@@ -885,7 +798,7 @@ static void LOADADPCM()
     }
 }
 
-static void INTERLEAVE()
+static void INTERLEAVE(const uint32_t inst1, const uint32_t inst2)
 {
     // Works... - 3-11-01
     uint32_t inL, inR;
@@ -912,43 +825,21 @@ static void INTERLEAVE()
     }
 }
 
-static void MIXER()
+static void MIXER(const uint32_t inst1, const uint32_t inst2)
 {
     // Fixed a sign issue... 03-14-01
     uint32_t dmemin = (uint16_t)(inst2 >> 0x10);
     uint32_t dmemout = (uint16_t)(inst2 & 0xFFFF);
-    uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
-    int32_t gain = (int16_t)(inst1 & 0xFFFF);
-    int32_t temp;
+    int16_t gain = (int16_t)(inst1 & 0xFFFF);
 
     if (AudioCount == 0) return;
 
-    for (int x = 0; x < AudioCount; x += 2)
-    {
-        // I think I can do this a lot easier
-        temp = (*(int16_t *)(BufferSpace + dmemin + x) * gain) >> 15;
-        temp += *(int16_t *)(BufferSpace + dmemout + x);
-
-        if ((int32_t)temp > 32767) temp = 32767;
-        if ((int32_t)temp < -32768) temp = -32768;
-
-        *(uint16_t *)(BufferSpace + dmemout + x) = (uint16_t)(temp & 0xFFFF);
-    }
+    AudioKernels::mix((int16_t *)(BufferSpace + dmemout), (int16_t *)(BufferSpace + dmemin), gain,
+                      (AudioCount + 1) / 2);
 }
 
-// TOP Performance Hogs:
-// Command: ADPCM    - Calls:  48 - Total Time: 331226 - Avg Time:  6900.54 - Percent: 31.53%
-// Command: ENVMIXER - Calls:  48 - Total Time: 408563 - Avg Time:  8511.73 - Percent: 38.90%
-// Command: LOADBUFF - Calls:  56 - Total Time:  21551 - Avg Time:   384.84 - Percent:  2.05%
-// Command: RESAMPLE - Calls:  48 - Total Time: 225922 - Avg Time:  4706.71 - Percent: 21.51%
-
-// Command: ADPCM    - Calls:  48 - Total Time: 391600 - Avg Time:  8158.33 - Percent: 32.52%
-// Command: ENVMIXER - Calls:  48 - Total Time: 444091 - Avg Time:  9251.90 - Percent: 36.88%
-// Command: LOADBUFF - Calls:  58 - Total Time:  29945 - Avg Time:   516.29 - Percent:  2.49%
-// Command: RESAMPLE - Calls:  48 - Total Time: 276354 - Avg Time:  5757.38 - Percent: 22.95%
-
-void (*ABI1[0x20])() = {
-    // TOP Performace Hogs: MIXER, RESAMPLE, ENVMIXER
+hle_alist_handler ABI1[0x20] = {
+    // Run `RSP.HLE.Tests [benchmark]` for the cost of each command.
     SPNOOP,    ADPCM,  CLEARBUFF,  ENVMIXER, LOADBUFF, RESAMPLE, SAVEBUFF, UNKNOWN, SETBUFF, SETVOL, DMEMMOVE,
     LOADADPCM, MIXER,  INTERLEAVE, UNKNOWN,  SETLOOP,  SPNOOP,   SPNOOP,   SPNOOP,  SPNOOP,  SPNOOP, SPNOOP,
     SPNOOP,    SPNOOP, SPNOOP,     SPNOOP,   SPNOOP,   SPNOOP,   SPNOOP,   SPNOOP,  SPNOOP,  SPNOOP};
@@ -4,31 +4,23 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-#include "Main.h"
+#include <CommonPCH.h>
 #include "HLE.h"
+#include "AudioKernels.h"
 
-extern uint8_t BufferSpace[0x10000];
-
-static void SPNOOP()
+static void SPNOOP(const uint32_t inst1, const uint32_t inst2)
 {
-    MessageBox(NULL, std::format(L"Unknown/Unimplemented Audio Command {} in ABI 2", inst1 >> 24).c_str(),
-               L"Audio HLE Error", MB_OK);
+    g_hle_error(std::format(L"Unknown/Unimplemented Audio Command {} in ABI 2", inst1 >> 24));
 }
 
-extern uint16_t AudioInBuffer;  // 0x0000(T8)
-extern uint16_t AudioOutBuffer; // 0x0002(T8)
-extern uint16_t AudioCount;     // 0x0004(T8)
-extern uint32_t loopval;        // 0x0010(T8)
 extern uint32_t SEGMENTS[0x10];
 
 extern uint16_t adpcmtable[0x88];
 
-extern uint16_t ResampleLUT[0x200];
-
 bool isMKABI = false;
 bool isZeldaABI = false;
 
-static void LOADADPCM2()
+static void LOADADPCM2(const uint32_t inst1, const uint32_t inst2)
 {
     // Loads an ADPCM table - Works 100% Now 03-13-01
     uint32_t v0;
@@ -52,34 +44,34 @@ static void LOADADPCM2()
     }
 }
 
-static void SETLOOP2()
+static void SETLOOP2(const uint32_t inst1, const uint32_t inst2)
 {
     loopval = inst2 & 0xffffff; // No segment?
 }
 
-static void SETBUFF2()
+static void SETBUFF2(const uint32_t inst1, const uint32_t inst2)
 {
     AudioInBuffer = uint16_t(inst1);            // 0x00
     AudioOutBuffer = uint16_t((inst2 >> 0x10)); // 0x02
     AudioCount = uint16_t(inst2);               // 0x04
 }
 
-static void ADPCM2()
+static void ADPCM2(const uint32_t inst1, const uint32_t inst2)
 {
     // Verified to be 100% Accurate...
-    BYTE Flags = (uint8_t)(inst1 >> 16) & 0xff;
-    WORD Gain = (uint16_t)(inst1 & 0xffff);
-    DWORD Address = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
-    WORD inPtr = 0;
+    uint8_t Flags = (uint8_t)(inst1 >> 16) & 0xff;
+    uint16_t Gain = (uint16_t)(inst1 & 0xffff);
+    uint32_t Address = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
+    uint16_t inPtr = 0;
     // short *out=(int16_t *)(testbuff+(AudioOutBuffer>>2));
     short *out = (short *)(BufferSpace + AudioOutBuffer);
-    BYTE *in = (BYTE *)(BufferSpace + AudioInBuffer);
+    uint8_t *in = (uint8_t *)(BufferSpace + AudioInBuffer);
     short count = (short)AudioCount;
-    BYTE icode;
-    BYTE code;
+    uint8_t icode;
+    uint8_t code;
     int vscale;
-    WORD index;
-    WORD j;
+    uint16_t index;
+    uint16_t j;
     int a[8];
     short *book1, *book2;
 
@@ -374,14 +366,14 @@ static void ADPCM2()
     memcpy(&rsp.rdram[Address], out, 32);
 }
 
-static void CLEARBUFF2()
+static void CLEARBUFF2(const uint32_t inst1, const uint32_t inst2)
 {
     uint16_t addr = (uint16_t)(inst1 & 0xffff);
     uint16_t count = (uint16_t)(inst2 & 0xffff);
     if (count > 0) memset(BufferSpace + addr, 0, count);
 }
 
-static void LOADBUFF2()
+static void LOADBUFF2(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint32_t v0;
@@ -390,7 +382,7 @@ static void LOADBUFF2()
     memcpy(BufferSpace + (inst1 & 0xfffc), rsp.rdram + v0, (cnt + 3) & 0xFFFC);
 }
 
-static void SAVEBUFF2()
+static void SAVEBUFF2(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint32_t v0;
@@ -399,97 +391,28 @@ static void SAVEBUFF2()
     memcpy(rsp.rdram + v0, BufferSpace + (inst1 & 0xfffc), (cnt + 3) & 0xFFFC);
 }
 
-static void MIXER2()
+static void MIXER2(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint16_t dmemin = (uint16_t)(inst2 >> 0x10);
     uint16_t dmemout = (uint16_t)(inst2 & 0xFFFF);
     uint32_t count = ((inst1 >> 12) & 0xFF0);
-    int32_t gain = (int16_t)(inst1 & 0xFFFF) * 2;
-    int32_t temp;
-
-    for (int x = 0; x < count; x += 2)
-    {
-        // I think I can do this a lot easier
-
-        temp = (*(int16_t *)(BufferSpace + dmemin + x) * gain) >> 16;
-        temp += *(int16_t *)(BufferSpace + dmemout + x);
-
-        if ((int32_t)temp > 32767) temp = 32767;
-        if ((int32_t)temp < -32768) temp = -32768;
+    // NOTE: This used to be computed as (in * gain * 2) >> 16, which is the same except where that overflowed.
+    int16_t gain = (int16_t)(inst1 & 0xFFFF);
 
-        *(uint16_t *)(BufferSpace + dmemout + x) = (uint16_t)(temp & 0xFFFF);
-    }
+    AudioKernels::mix((int16_t *)(BufferSpace + dmemout), (int16_t *)(BufferSpace + dmemin), gain, count / 2);
 }
 
-static void RESAMPLE2()
+static void RESAMPLE2(const uint32_t inst1, const uint32_t inst2)
 {
-    BYTE Flags = (uint8_t)((inst1 >> 16) & 0xff);
-    DWORD Pitch = ((inst1 & 0xffff)) << 1;
+    uint8_t Flags = (uint8_t)((inst1 >> 16) & 0xff);
+    uint32_t Pitch = ((inst1 & 0xffff)) << 1;
     uint32_t addy = (inst2 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
-    DWORD Accum = 0;
-    DWORD location;
-    int16_t *lut;
-    short *dst;
-    int16_t *src;
-    dst = (short *)(BufferSpace);
-    src = (int16_t *)(BufferSpace);
-    uint32_t srcPtr = (AudioInBuffer / 2);
-    uint32_t dstPtr = (AudioOutBuffer / 2);
-    int32_t temp;
-    int32_t accum;
-
-    if (addy > (1024 * 1024 * 8)) addy = (inst2 & 0xffffff);
 
-    srcPtr -= 4;
-
-    if ((Flags & 0x1) == 0)
-    {
-        for (int x = 0; x < 4; x++) // memcpy (src+srcPtr, rsp.rdram+addy, 0x8);
-            src[(srcPtr + x) ^ 1] = ((uint16_t *)rsp.rdram)[((addy / 2) + x) ^ 1];
-        Accum = *(uint16_t *)(rsp.rdram + addy + 10);
-    }
-    else
-    {
-        for (int x = 0; x < 4; x++) src[(srcPtr + x) ^ 1] = 0; //*(uint16_t *)(rsp.rdram+((addy+x)^2));
-    }
-
-    //	if ((Flags & 0x2))
-    //		__asm int 3;
-
-    for (int i = 0; i < ((AudioCount + 0xf) & 0xFFF0) / 2; i++)
-    {
-        location = (((Accum * 0x40) >> 0x10) * 8);
-        // location = (Accum >> 0xa) << 0x3;
-        lut = (int16_t *)(((uint8_t *)ResampleLUT) + location);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 0) ^ 1)) * ((int32_t)((int16_t)lut[0])));
-        accum = (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 1) ^ 1)) * ((int32_t)((int16_t)lut[1])));
-        accum += (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 2) ^ 1)) * ((int32_t)((int16_t)lut[2])));
-        accum += (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 3) ^ 1)) * ((int32_t)((int16_t)lut[3])));
-        accum += (int32_t)(temp >> 15);
-
-        if (accum > 32767) accum = 32767;
-        if (accum < -32768) accum = -32768;
-
-        dst[dstPtr ^ 1] = (int16_t)(accum);
-        dstPtr++;
-        Accum += Pitch;
-        srcPtr += (Accum >> 16);
-        Accum &= 0xffff;
-    }
-    for (int x = 0; x < 4; x++) ((uint16_t *)rsp.rdram)[((addy / 2) + x) ^ 1] = src[(srcPtr + x) ^ 1];
-    *(uint16_t *)(rsp.rdram + addy + 10) = (uint16_t)Accum;
-    // memcpy (RSWORK, src+srcPtr, 0x8);
+    hle_resample(Flags, Pitch, addy, AudioInBuffer / 2, AudioOutBuffer / 2, ((AudioCount + 0xf) & 0xFFF0) / 2);
 }
 
-static void DMEMMOVE2()
+static void DMEMMOVE2(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint32_t v0, v1;
@@ -513,7 +436,7 @@ static void DMEMMOVE2()
 uint32_t t3, s5, s6;
 uint16_t env[8];
 
-static void ENVSETUP1()
+static void ENVSETUP1(const uint32_t inst1, const uint32_t inst2)
 {
     uint32_t tmp;
 
@@ -528,7 +451,7 @@ static void ENVSETUP1()
     // fprintf (dfile, "	t3 = %X / s5 = %X / s6 = %X / env[4] = %X / env[5] = %X\n", t3, s5, s6, env[4], env[5]);
 }
 
-static void ENVSETUP2()
+static void ENVSETUP2(const uint32_t inst1, const uint32_t inst2)
 {
     uint32_t tmp;
 
@@ -544,7 +467,7 @@ static void ENVSETUP2()
     // fprintf (dfile, "	env[0] = %X / env[1] = %X / env[2] = %X / env[3] = %X\n", env[0], env[1], env[2], env[3]);
 }
 
-static void ENVMIXER2()
+static void ENVMIXER2(uint32_t inst1, const uint32_t inst2)
 {
     // fprintf (dfile, "ENVMIXER: inst1 = %08X, inst2 = %08X\n", inst1, inst2);
 
@@ -680,13 +603,13 @@ static void ENVMIXER2()
     }
 }
 
-static void DUPLICATE2()
+static void DUPLICATE2(const uint32_t inst1, const uint32_t inst2)
 {
-    WORD Count = (inst1 >> 16) & 0xff;
-    WORD In = inst1 & 0xffff;
-    WORD Out = (inst2 >> 16);
+    uint16_t Count = (inst1 >> 16) & 0xff;
+    uint16_t In = inst1 & 0xffff;
+    uint16_t Out = (inst2 >> 16);
 
-    WORD buff[64];
+    uint16_t buff[64];
 
     memcpy(buff, BufferSpace + In, 128);
 
@@ -701,8 +624,8 @@ static void DUPLICATE2()
 /*
 static void INTERL2 () { // Make your own...
     short Count = inst1 & 0xffff;
-    WORD  Out   = inst2 & 0xffff;
-    WORD In     = (inst2 >> 16);
+    uint16_t  Out   = inst2 & 0xffff;
+    uint16_t In     = (inst2 >> 16);
 
     short *src,*dst,tmp;
     src=(short *)&BufferSpace[In];
@@ -730,15 +653,15 @@ static void INTERL2 () { // Make your own...
 }
 */
 
-static void INTERL2()
+static void INTERL2(const uint32_t inst1, const uint32_t inst2)
 {
     short Count = inst1 & 0xffff;
-    WORD Out = inst2 & 0xffff;
-    WORD In = (inst2 >> 16);
+    uint16_t Out = inst2 & 0xffff;
+    uint16_t In = (inst2 >> 16);
 
-    BYTE *src, *dst, tmp;
-    src = (BYTE *)(BufferSpace); //[In];
-    dst = (BYTE *)(BufferSpace); //[Out];
+    uint8_t *src, *dst, tmp;
+    src = (uint8_t *)(BufferSpace); //[In];
+    dst = (uint8_t *)(BufferSpace); //[Out];
     while (Count)
     {
         *(short *)(dst + (Out ^ 3)) = *(short *)(src + (In ^ 3));
@@ -748,7 +671,7 @@ static void INTERL2()
     }
 }
 
-static void INTERLEAVE2()
+static void INTERLEAVE2(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint32_t inL, inR;
@@ -786,7 +709,7 @@ static void INTERLEAVE2()
     }
 }
 
-static void ADDMIXER()
+static void ADDMIXER(const uint32_t inst1, const uint32_t inst2)
 {
     short Count = (inst1 >> 12) & 0x00ff0;
     uint16_t InBuffer = (inst2 >> 16);
@@ -806,7 +729,7 @@ static void ADDMIXER()
     }
 }
 
-static void HILOGAIN()
+static void HILOGAIN(const uint32_t inst1, const uint32_t inst2)
 {
     uint16_t cnt = inst1 & 0xffff;
     uint16_t out = (inst2 >> 16) & 0xffff;
@@ -832,7 +755,7 @@ static void HILOGAIN()
     }
 }
 
-static void FILTER2()
+static void FILTER2(const uint32_t inst1, const uint32_t inst2)
 {
     static int cnt = 0;
     static int16_t *lutt6;
@@ -963,11 +886,11 @@ static void FILTER2()
     memcpy(BufferSpace + (inst1 & 0xffff), outbuff, cnt);
 }
 
-static void SEGMENT2()
+static void SEGMENT2(const uint32_t inst1, const uint32_t inst2)
 {
     if (isZeldaABI)
     {
-        FILTER2();
+        FILTER2(inst1, inst2);
         return;
     }
     if ((inst1 & 0xffffff) == 0)
@@ -979,11 +902,11 @@ static void SEGMENT2()
     {
         isMKABI = false;
         isZeldaABI = true;
-        FILTER2();
+        FILTER2(inst1, inst2);
     }
 }
 
-static void UNKNOWN()
+static void UNKNOWN(uint32_t, uint32_t)
 {
 }
 
@@ -995,10 +918,11 @@ void (*ABI2[0x20])() = {
     SPNOOP, SPNOOP, SPNOOP, SPNOOP, SPNOOP, SPNOOP, SPNOOP, SPNOOP
 };*/
 
-void (*ABI2[0x20])() = {SPNOOP,   ADPCM2,     CLEARBUFF2, UNKNOWN,    ADDMIXER,  RESAMPLE2,   UNKNOWN,   SEGMENT2,
-                        SETBUFF2, DUPLICATE2, DMEMMOVE2,  LOADADPCM2, MIXER2,    INTERLEAVE2, HILOGAIN,  SETLOOP2,
-                        SPNOOP,   INTERL2,    ENVSETUP1,  ENVMIXER2,  LOADBUFF2, SAVEBUFF2,   ENVSETUP2, SPNOOP,
-                        HILOGAIN, SPNOOP,     DUPLICATE2, UNKNOWN,    SPNOOP,    SPNOOP,      SPNOOP,    SPNOOP};
+hle_alist_handler ABI2[0x20] = {
+    SPNOOP,   ADPCM2,     CLEARBUFF2, UNKNOWN,    ADDMIXER,  RESAMPLE2,   UNKNOWN,   SEGMENT2,
+    SETBUFF2, DUPLICATE2, DMEMMOVE2,  LOADADPCM2, MIXER2,    INTERLEAVE2, HILOGAIN,  SETLOOP2,
+    SPNOOP,   INTERL2,    ENVSETUP1,  ENVMIXER2,  LOADBUFF2, SAVEBUFF2,   ENVSETUP2, SPNOOP,
+    HILOGAIN, SPNOOP,     DUPLICATE2, UNKNOWN,    SPNOOP,    SPNOOP,      SPNOOP,    SPNOOP};
 /*
 void (*ABI2[0x20])() = {
     SPNOOP , ADPCM2, CLEARBUFF2, SPNOOP, SPNOOP, RESAMPLE2  , SPNOOP  , SEGMENT2,
@@ -4,19 +4,15 @@
  * SPDX-License-Identifier: GPL-2.0-or-later
  */
 
-#include "Main.h"
+#include <CommonPCH.h>
 #include "HLE.h"
+#include "AudioKernels.h"
 
-static void SPNOOP()
+static void SPNOOP(const uint32_t inst1, const uint32_t inst2)
 {
-    MessageBox(nullptr, std::format(L"Unknown/Unimplemented Audio Command {} in ABI 3", inst1 >> 24).c_str(),
-               L"Audio HLE Error", MB_OK);
+    g_hle_error(std::format(L"Unknown/Unimplemented Audio Command {} in ABI 3", inst1 >> 24));
 }
 
-extern uint16_t ResampleLUT[0x200];
-
-extern uint32_t loopval;
-
 extern int16_t Env_Dry;
 extern int16_t Env_Wet;
 extern int16_t Vol_Left;
@@ -31,9 +27,7 @@ extern int32_t VolRamp_Right;
 extern short hleMixerWorkArea[256];
 extern uint16_t adpcmtable[0x88];
 
-extern uint8_t BufferSpace[0x10000];
-
-static void SETVOL3()
+static void SETVOL3(const uint32_t inst1, const uint32_t inst2)
 {
     uint8_t Flags = (uint8_t)(inst1 >> 0x10);
     if (Flags & 0x4)
@@ -60,7 +54,7 @@ static void SETVOL3()
     }
 }
 
-static void ENVMIXER3()
+static void ENVMIXER3(const uint32_t inst1, const uint32_t inst2)
 {
     uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
     uint32_t addy = (inst2 & 0xFFFFFF);
@@ -74,10 +68,8 @@ static void ENVMIXER3()
     int32_t MainL;
     int32_t AuxR;
     int32_t AuxL;
-    int i1, o1, a1, a2, a3;
-    WORD AuxIncRate = 1;
-    short zero[8];
-    memset(zero, 0, 16);
+    // The volume of every sample, computed up front so the mixing itself can be vectorised.
+    int32_t vol[4][0x170 / 2];
 
     int32_t LAdder, LAcc, LVol;
     int32_t RAdder, RAcc, RVol;
@@ -171,56 +163,18 @@ static void ENVMIXER3()
         // ****************************************************************
         MainL = ((Dry * LVol) + 0x4000) >> 15;
         MainR = ((Dry * RVol) + 0x4000) >> 15;
-
-        o1 = out[y ^ 1];
-        a1 = aux1[y ^ 1];
-        i1 = inp[y ^ 1];
-
-        o1 += ((i1 * MainL) + 0x4000) >> 15;
-        a1 += ((i1 * MainR) + 0x4000) >> 15;
-
-        // ****************************************************************
-
-        if (o1 > 32767)
-            o1 = 32767;
-        else if (o1 < -32768)
-            o1 = -32768;
-
-        if (a1 > 32767)
-            a1 = 32767;
-        else if (a1 < -32768)
-            a1 = -32768;
-
-        // ****************************************************************
-
-        out[y ^ 1] = o1;
-        aux1[y ^ 1] = a1;
-
-        // ****************************************************************
-        // if (!(flags&A_AUX)) {
-        a2 = aux2[y ^ 1];
-        a3 = aux3[y ^ 1];
-
         AuxL = ((Wet * LVol) + 0x4000) >> 15;
         AuxR = ((Wet * RVol) + 0x4000) >> 15;
 
-        a2 += ((i1 * AuxL) + 0x4000) >> 15;
-        a3 += ((i1 * AuxR) + 0x4000) >> 15;
-
-        if (a2 > 32767)
-            a2 = 32767;
-        else if (a2 < -32768)
-            a2 = -32768;
-
-        if (a3 > 32767)
-            a3 = 32767;
-        else if (a3 < -32768)
-            a3 = -32768;
-
-        aux2[y ^ 1] = a2;
-        aux3[y ^ 1] = a3;
+        vol[0][y ^ 1] = MainL;
+        vol[1][y ^ 1] = MainR;
+        vol[2][y ^ 1] = AuxL;
+        vol[3][y ^ 1] = AuxR;
     }
-    //}
+
+    int16_t *dst[4] = {out, aux1, aux2, aux3};
+    const int32_t *vols[4] = {vol[0], vol[1], vol[2], vol[3]};
+    AudioKernels::envmix(inp, dst, vols, 4, 0x170 / 2);
 
     *(int16_t *)(hleMixerWorkArea + 0) = Wet;     // 0-1
     *(int16_t *)(hleMixerWorkArea + 2) = Dry;     // 2-3
@@ -238,7 +192,7 @@ static void ENVMIXER3()
 }
 
 //*/
-static void ENVMIXER3o()
+static void ENVMIXER3o(const uint32_t inst1, const uint32_t inst2)
 {
     uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
     uint32_t addy = (inst2 & 0xFFFFFF); // + SEGMENTS[(inst2>>24)&0xf];
@@ -246,10 +200,8 @@ static void ENVMIXER3o()
     //  ********* Make sure these conditions are met... ***********
     if ((AudioInBuffer | AudioOutBuffer | AudioAuxA | AudioAuxC | AudioAuxE | AudioCount) & 0x3)
     {
-        MessageBox(NULL,
-                   L"Unaligned EnvMixer... please report this to Azimer with the following information: RomTitle, "
-                   L"Place in the rom it occurred, and any save state just before the error",
-                   L"AudioHLE Error", MB_OK);
+        g_hle_error(L"Unaligned EnvMixer... please report this to Azimer with the following information: RomTitle, "
+                    L"Place in the rom it occurred, and any save state just before the error");
     }
 
     short *inp = (short *)(BufferSpace + 0x4F0);
@@ -263,7 +215,7 @@ static void ENVMIXER3o()
     int AuxR;
     int AuxL;
     int i1, o1, a1, a2, a3;
-    WORD AuxIncRate = 1;
+    uint16_t AuxIncRate = 1;
     short zero[8];
     memset(zero, 0, 16);
     int32_t LVol, RVol;
@@ -409,36 +361,24 @@ static void ENVMIXER3o()
     memcpy(rsp.rdram + addy, (uint8_t *)hleMixerWorkArea, 80);
 }
 
-static void CLEARBUFF3()
+static void CLEARBUFF3(const uint32_t inst1, const uint32_t inst2)
 {
     uint16_t addr = (uint16_t)(inst1 & 0xffff);
     uint16_t count = (uint16_t)(inst2 & 0xffff);
     memset(BufferSpace + addr + 0x4f0, 0, count);
 }
 
-static void MIXER3()
+static void MIXER3(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint16_t dmemin = (uint16_t)(inst2 >> 0x10) + 0x4f0;
     uint16_t dmemout = (uint16_t)(inst2 & 0xFFFF) + 0x4f0;
-    uint8_t flags = (uint8_t)((inst1 >> 16) & 0xff);
-    int32_t gain = (int16_t)(inst1 & 0xFFFF) * 2;
-    int32_t temp;
-
-    for (int x = 0; x < 0x170; x += 2)
-    {
-        // I think I can do this a lot easier
-        temp = (*(int16_t *)(BufferSpace + dmemin + x) * gain) >> 16;
-        temp += *(int16_t *)(BufferSpace + dmemout + x);
+    int16_t gain = (int16_t)(inst1 & 0xFFFF);
 
-        if ((int32_t)temp > 32767) temp = 32767;
-        if ((int32_t)temp < -32768) temp = -32768;
-
-        *(uint16_t *)(BufferSpace + dmemout + x) = (uint16_t)(temp & 0xFFFF);
-    }
+    AudioKernels::mix((int16_t *)(BufferSpace + dmemout), (int16_t *)(BufferSpace + dmemin), gain, 0x170 / 2);
 }
 
-static void LOADBUFF3()
+static void LOADBUFF3(const uint32_t inst1, const uint32_t inst2)
 {
     uint32_t v0;
     uint32_t cnt = (((inst1 >> 0xC) + 3) & 0xFFC);
@@ -447,7 +387,7 @@ static void LOADBUFF3()
     memcpy(BufferSpace + src, rsp.rdram + v0, cnt);
 }
 
-static void SAVEBUFF3()
+static void SAVEBUFF3(const uint32_t inst1, const uint32_t inst2)
 {
     uint32_t v0;
     uint32_t cnt = (((inst1 >> 0xC) + 3) & 0xFFC);
@@ -456,7 +396,7 @@ static void SAVEBUFF3()
     memcpy(rsp.rdram + v0, BufferSpace + src, cnt);
 }
 
-static void LOADADPCM3()
+static void LOADADPCM3(const uint32_t inst1, const uint32_t inst2)
 {
     // Loads an ADPCM table - Works 100% Now 03-13-01
     uint32_t v0;
@@ -481,7 +421,7 @@ static void LOADADPCM3()
     }
 }
 
-static void DMEMMOVE3()
+static void DMEMMOVE3(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     uint32_t v0, v1;
@@ -497,27 +437,27 @@ static void DMEMMOVE3()
     }
 }
 
-static void SETLOOP3()
+static void SETLOOP3(const uint32_t inst1, const uint32_t inst2)
 {
     loopval = (inst2 & 0xffffff);
 }
 
-static void ADPCM3()
+static void ADPCM3(const uint32_t inst1, const uint32_t inst2)
 {
     // Verified to be 100% Accurate...
-    BYTE Flags = (uint8_t)(inst2 >> 0x1c) & 0xff;
-    // WORD Gain=(uint16_t)(inst1&0xffff);
-    DWORD Address = (inst1 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
-    WORD inPtr = (inst2 >> 12) & 0xf;
+    uint8_t Flags = (uint8_t)(inst2 >> 0x1c) & 0xff;
+    // uint16_t Gain=(uint16_t)(inst1&0xffff);
+    uint32_t Address = (inst1 & 0xffffff); // + SEGMENTS[(inst2>>24)&0xf];
+    uint16_t inPtr = (inst2 >> 12) & 0xf;
     // short *out=(int16_t *)(testbuff+(AudioOutBuffer>>2));
     short *out = (short *)(BufferSpace + (inst2 & 0xfff) + 0x4f0);
-    BYTE *in = (BYTE *)(BufferSpace + ((inst2 >> 12) & 0xf) + 0x4f0);
+    uint8_t *in = (uint8_t *)(BufferSpace + ((inst2 >> 12) & 0xf) + 0x4f0);
     short count = (short)((inst2 >> 16) & 0xfff);
-    BYTE icode;
-    BYTE code;
+    uint8_t icode;
+    uint8_t code;
     int vscale;
-    WORD index;
-    WORD j;
+    uint16_t index;
+    uint16_t j;
     int a[8];
     short *book1, *book2;
 
@@ -756,114 +696,18 @@ static void ADPCM3()
     memcpy(&rsp.rdram[Address], out, 32);
 }
 
-static void RESAMPLE3()
+static void RESAMPLE3(const uint32_t inst1, const uint32_t inst2)
 {
-    BYTE Flags = (uint8_t)((inst2 >> 0x1e));
-    DWORD Pitch = ((inst2 >> 0xe) & 0xffff) << 1;
+    uint8_t Flags = (uint8_t)((inst2 >> 0x1e));
+    uint32_t Pitch = ((inst2 >> 0xe) & 0xffff) << 1;
     uint32_t addy = (inst1 & 0xffffff);
-    DWORD Accum = 0;
-    DWORD location;
-    int16_t *lut;
-    short *dst;
-    int16_t *src;
-    dst = (short *)(BufferSpace);
-    src = (int16_t *)(BufferSpace);
     uint32_t srcPtr = ((((inst2 >> 2) & 0xfff) + 0x4f0) / 2);
-    uint32_t dstPtr; //=(AudioOutBuffer/2);
-    int32_t temp;
-    int32_t accum;
-
-    // if (addy > (1024*1024*8))
-    //	addy = (inst2 & 0xffffff);
-
-    srcPtr -= 4;
-
-    if (inst2 & 0x3)
-    {
-        dstPtr = 0x660 / 2;
-    }
-    else
-    {
-        dstPtr = 0x4f0 / 2;
-    }
+    uint32_t dstPtr = (inst2 & 0x3) ? 0x660 / 2 : 0x4f0 / 2;
 
-    if ((Flags & 0x1) == 0)
-    {
-        for (int x = 0; x < 4; x++) // memcpy (src+srcPtr, rsp.rdram+addy, 0x8);
-            src[(srcPtr + x) ^ 1] = ((uint16_t *)rsp.rdram)[((addy / 2) + x) ^ 1];
-        Accum = *(uint16_t *)(rsp.rdram + addy + 10);
-    }
-    else
-    {
-        for (int x = 0; x < 4; x++) src[(srcPtr + x) ^ 1] = 0; //*(uint16_t *)(rsp.rdram+((addy+x)^2));
-    }
-
-    // if ((Flags & 0x2))
-    //	__asm int 3;
-
-    for (int i = 0; i < 0x170 / 2; i++)
-    {
-        location = (((Accum * 0x40) >> 0x10) * 8);
-        // location = (Accum >> 0xa) << 0x3;
-        lut = (int16_t *)(((uint8_t *)ResampleLUT) + location);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 0) ^ 1)) * ((int32_t)((int16_t)lut[0])));
-        accum = (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 1) ^ 1)) * ((int32_t)((int16_t)lut[1])));
-        accum += (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 2) ^ 1)) * ((int32_t)((int16_t)lut[2])));
-        accum += (int32_t)(temp >> 15);
-
-        temp = ((int32_t)*(int16_t *)(src + ((srcPtr + 3) ^ 1)) * ((int32_t)((int16_t)lut[3])));
-        accum += (int32_t)(temp >> 15);
-        /*		temp =  ((int64_t)*(int16_t*)(src+((srcPtr+0)^1))*((int64_t)((int16_t)lut[0]<<1)));
-                if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-                else temp = (temp^0x8000);
-                temp = (int32_t)(temp >> 16);
-                if ((int32_t)temp > 32767) temp = 32767;
-                if ((int32_t)temp < -32768) temp = -32768;
-                accum = (int32_t)(int16_t)temp;
-
-                temp = ((int64_t)*(int16_t*)(src+((srcPtr+1)^1))*((int64_t)((int16_t)lut[1]<<1)));
-                if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-                else temp = (temp^0x8000);
-                temp = (int32_t)(temp >> 16);
-                if ((int32_t)temp > 32767) temp = 32767;
-                if ((int32_t)temp < -32768) temp = -32768;
-                accum += (int32_t)(int16_t)temp;
-
-                temp = ((int64_t)*(int16_t*)(src+((srcPtr+2)^1))*((int64_t)((int16_t)lut[2]<<1)));
-                if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-                else temp = (temp^0x8000);
-                temp = (int32_t)(temp >> 16);
-                if ((int32_t)temp > 32767) temp = 32767;
-                if ((int32_t)temp < -32768) temp = -32768;
-                accum += (int32_t)(int16_t)temp;
-
-                temp = ((int64_t)*(int16_t*)(src+((srcPtr+3)^1))*((int64_t)((int16_t)lut[3]<<1)));
-                if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-                else temp = (temp^0x8000);
-                temp = (int32_t)(temp >> 16);
-                if ((int32_t)temp > 32767) temp = 32767;
-                if ((int32_t)temp < -32768) temp = -32768;
-                accum += (int32_t)(int16_t)temp;*/
-
-        if (accum > 32767) accum = 32767;
-        if (accum < -32768) accum = -32768;
-
-        dst[dstPtr ^ 1] = (accum);
-        dstPtr++;
-        Accum += Pitch;
-        srcPtr += (Accum >> 16);
-        Accum &= 0xffff;
-    }
-    for (int x = 0; x < 4; x++) ((uint16_t *)rsp.rdram)[((addy / 2) + x) ^ 1] = src[(srcPtr + x) ^ 1];
-    *(uint16_t *)(rsp.rdram + addy + 10) = Accum;
+    hle_resample(Flags, Pitch, addy, srcPtr, dstPtr, 0x170 / 2);
 }
 
-static void INTERLEAVE3()
+static void INTERLEAVE3(const uint32_t inst1, const uint32_t inst2)
 {
     // Needs accuracy verification...
     // uint32_t inL, inR;
@@ -902,37 +746,37 @@ static void INTERLEAVE3()
 // static void UNKNOWN ();
 /*
 typedef struct {
-    BYTE sync;
-
-    BYTE error_protection	: 1;	//  0=yes, 1=no
-    BYTE lay				: 2;	// 4-lay = layerI, II or III
-    BYTE version			: 1;	// 3=mpeg 1.0, 2=mpeg 2.5 0=mpeg 2.0
-    BYTE sync2				: 4;
-
-    BYTE extension			: 1;    // Unknown
-    BYTE padding			: 1;    // padding
-    BYTE sampling_freq		: 2;	// see table below
-    BYTE bitrate_index		: 4;	//     see table below
-
-    BYTE emphasis			: 2;	//see table below
-    BYTE original			: 1;	// 0=no 1=yes
-    BYTE copyright			: 1;	// 0=no 1=yes
-    BYTE mode_ext			: 2;    // used with "joint stereo" mode
-    BYTE mode				: 2;    // Channel Mode
+    uint8_t sync;
+
+    uint8_t error_protection	: 1;	//  0=yes, 1=no
+    uint8_t lay				: 2;	// 4-lay = layerI, II or III
+    uint8_t version			: 1;	// 3=mpeg 1.0, 2=mpeg 2.5 0=mpeg 2.0
+    uint8_t sync2				: 4;
+
+    uint8_t extension			: 1;    // Unknown
+    uint8_t padding			: 1;    // padding
+    uint8_t sampling_freq		: 2;	// see table below
+    uint8_t bitrate_index		: 4;	//     see table below
+
+    uint8_t emphasis			: 2;	//see table below
+    uint8_t original			: 1;	// 0=no 1=yes
+    uint8_t copyright			: 1;	// 0=no 1=yes
+    uint8_t mode_ext			: 2;    // used with "joint stereo" mode
+    uint8_t mode				: 2;    // Channel Mode
 } mp3struct;
 
 mp3struct mp3;
 FILE *mp3dat;
 */
 
-static void WHATISTHIS()
+static void WHATISTHIS(uint32_t, uint32_t)
 {
 }
 
 // static FILE *fp = fopen ("d:\\mp3info.txt", "wt");
 uint32_t setaddr;
 
-static void MP3ADDY()
+static void MP3ADDY(const uint32_t inst1, const uint32_t inst2)
 {
     setaddr = (inst2 & 0xffffff);
     //__asm int 3;
@@ -942,7 +786,7 @@ static void MP3ADDY()
 extern "C"
 {
     void rsp_run();
-    void mp3setup(DWORD inst1, DWORD inst2, DWORD t8);
+    void mp3setup(uint32_t inst1, uint32_t inst2, uint32_t t8);
 }
 
 extern uint32_t base, dmembase;
@@ -952,7 +796,7 @@ extern "C"
     extern char *pDMEM;
 }
 
-void MP3();
+void MP3(uint32_t inst1, uint32_t inst2);
 /*
  {
 //	return;
@@ -1001,16 +845,17 @@ achieve near-CD quality, an important specification to enable dual-channel ISDN
 (integrated-services-digital-network) to be the future high-bandwidth pipe to the home.
 
 */
-static void DISABLE()
+static void DISABLE(uint32_t, uint32_t)
 {
     // MessageBox (NULL, "Help", "ABI 3 Command 0", MB_OK);
     // ChangeABI (5);
 }
 
-void (*ABI3[0x20])() = {DISABLE, ADPCM3,  CLEARBUFF3, ENVMIXER3,  LOADBUFF3, RESAMPLE3,   SAVEBUFF3,  MP3,
-                        MP3ADDY, SETVOL3, DMEMMOVE3,  LOADADPCM3, MIXER3,    INTERLEAVE3, WHATISTHIS, SETLOOP3,
-                        SPNOOP,  SPNOOP,  SPNOOP,     SPNOOP,     SPNOOP,    SPNOOP,      SPNOOP,     SPNOOP,
-                        SPNOOP,  SPNOOP,  SPNOOP,     SPNOOP,     SPNOOP,    SPNOOP,      SPNOOP,     SPNOOP};
+hle_alist_handler ABI3[0x20] = {
+    DISABLE, ADPCM3,  CLEARBUFF3, ENVMIXER3,  LOADBUFF3, RESAMPLE3,   SAVEBUFF3,  MP3,
+    MP3ADDY, SETVOL3, DMEMMOVE3,  LOADADPCM3, MIXER3,    INTERLEAVE3, WHATISTHIS, SETLOOP3,
+    SPNOOP,  SPNOOP,  SPNOOP,     SPNOOP,     SPNOOP,    SPNOOP,      SPNOOP,     SPNOOP,
+    SPNOOP,  SPNOOP,  SPNOOP,     SPNOOP,     SPNOOP,    SPNOOP,      SPNOOP,     SPNOOP};
 #if 0
 void (*ABI3[32])(void) =
 {
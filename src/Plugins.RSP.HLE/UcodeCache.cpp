@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include "UcodeCache.h"
+
+uint32_t UcodeCache::checksum(const uint8_t *code, const size_t len)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len; ++i)
+    {
+        sum += code[i];
+    }
+    return sum;
+}
+
+UcodeCache::cache::cache(const size_t capacity) : m_capacity(std::max<size_t>(capacity, 1))
+{
+    m_entries.reserve(m_capacity);
+}
+
+const UcodeCache::ucode &UcodeCache::cache::get(const OSTask_t *task, const uint32_t address, const uint8_t *code,
+                                                const size_t len, ucode (*identify)(const OSTask_t *task, uint32_t sum))
+{
+    ++m_clock;
+
+    // The bytes are hashed again on every task, as the CPU can overwrite them without the plugin knowing.
+    const entry_key key{task->type, task->ucode, task->ucode_size, task->data_ptr};
+    const uint64_t hash = HashUtils::xxh64(code, len);
+
+    entry *slot = nullptr;
+    for (auto &entry : m_entries)
+    {
+        if (entry.key == key)
+        {
+            if (entry.hash == hash)
+            {
+                ++m_hits;
+                entry.last_use = m_clock;
+                return entry.identified;
+            }
+            slot = &entry;
+            break;
+        }
+    }
+
+    ++m_misses;
+
+    // An entry whose microcode changed is identified again in place.
+    if (!slot && m_entries.size() < m_capacity)
+    {
+        slot = &m_entries.emplace_back();
+    }
+    else if (!slot)
+    {
+        slot = &*std::ranges::min_element(m_entries, {}, &entry::last_use);
+    }
+
+    slot->key = key;
+    slot->address = address;
+    slot->len = static_cast<uint32_t>(len);
+    slot->hash = hash;
+    slot->identified = identify(task, checksum(code, len));
+    slot->last_use = m_clock;
+    return slot->identified;
+}
+
+void UcodeCache::cache::invalidate(const uint32_t address, const uint32_t len)
+{
+    const uint64_t end = static_cast<uint64_t>(address) + len;
+    std::erase_if(m_entries, [&](const entry &entry) {
+        return entry.address < end && address < static_cast<uint64_t>(entry.address) + entry.len;
+    });
+}
+
+void UcodeCache::cache::clear()
+{
+    m_entries.clear();
+    m_clock = 0;
+}
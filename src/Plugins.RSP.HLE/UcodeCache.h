@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "HLE.h"
+#include "TaskProfiler.h"
+
+/**
+ * \brief A module which remembers how the microcode of non-graphics tasks was identified.
+ * \remarks Microcode is identified by a checksum over its first bytes. Games run the same microcode several times per
+ * frame, so the result is cached per task type, microcode address, microcode size and data address. A hit also needs
+ * the XXH64 digest of the microcode bytes to match, so microcode overwritten by the CPU is identified again. Entries
+ * whose bytes a DMA wrote, which the core reports to the plugin, are dropped right away.
+ */
+namespace UcodeCache
+{
+/**
+ * \brief Runs a task.
+ * \return Whether the task was handled.
+ */
+using task_handler = bool (*)(OSTask_t *task);
+
+/**
+ * \brief The identification of a microcode.
+ */
+struct ucode
+{
+    /**
+     * \brief The checksum the microcode was identified by.
+     */
+    uint32_t sum{};
+
+    /**
+     * \brief The kind of task the profiler attributes the microcode's tasks to.
+     */
+    TaskProfiler::task_kind kind = TaskProfiler::task_kind::unknown;
+
+    /**
+     * \brief The function which runs the microcode's tasks, or nullptr if the microcode is unknown.
+     */
+    task_handler handler{};
+};
+
+/**
+ * \brief Computes the checksum microcode is identified by, the sum of its bytes.
+ */
+uint32_t checksum(const uint8_t *code, size_t len);
+
+class cache
+{
+  public:
+    explicit cache(size_t capacity = 8);
+
+    /**
+     * \brief Gets the identification of a task's microcode, identifying it if it isn't cached yet.
+     * \param task The task.
+     * \param address The physical address of the bytes the checksum is computed over.
+     * \param code The bytes the checksum is computed over.
+     * \param len The amount of bytes.
+     * \param identify Identifies the microcode from its checksum on a miss.
+     * \return The identification, valid until the next call to <c>get</c>, <c>invalidate</c> or <c>clear</c>.
+     */
+    const ucode &get(const OSTask_t *task, uint32_t address, const uint8_t *code, size_t len,
+                     ucode (*identify)(const OSTask_t *task, uint32_t sum));
+
+    /**
+     * \brief Removes the entries whose checksum was computed over bytes in a range of memory.
+     * \param address The physical address of the range.
+     * \param len The length of the range.
+     */
+    void invalidate(uint32_t address, uint32_t len);
+
+    /**
+     * \brief Removes all entries from the cache.
+     */
+    void clear();
+
+    size_t hits() const
+    {
+        return m_hits;
+    }
+
+    size_t misses() const
+    {
+        return m_misses;
+    }
+
+  private:
+    struct entry_key
+    {
+        uint32_t type;
+        uint32_t ucode;
+        uint32_t ucode_size;
+        uint32_t data;
+
+        bool operator==(const entry_key &) const = default;
+    };
+
+    struct entry
+    {
+        entry_key key;
+        uint32_t address;
+        uint32_t len;
+        uint64_t hash;
+        ucode identified;
+        uint64_t last_use;
+    };
+
+    size_t m_capacity;
+    std::vector<entry> m_entries;
+    uint64_t m_clock = 0;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+};
+} // namespace UcodeCache
@@ -7,6 +7,8 @@
 #include "Main.h"
 #include "Config.h"
 #include "HLE.h"
+#include "TaskProfiler.h"
+#include "UcodeCache.h"
 #include "Disasm.h"
 
 #define EXPORT __declspec(dllexport)
@@ -16,15 +18,16 @@
 #define UCODE_BANJO (2)
 #define UCODE_ZELDA (3)
 
-core_rsp_info rsp;
+#define IMEM_ADDRESS (0x04001000)
+
 bool g_rsp_alive = false;
-extern void (*ABI1[0x20])();
-extern void (*ABI2[0x20])();
-extern void (*ABI3[0x20])();
-void (*ABI[0x20])();
-uint32_t inst1;
-uint32_t inst2;
+const hle_alist_handler *ABI = nullptr;
 void (*g_audio_ucode_func)() = nullptr;
+TaskProfiler::profiler g_profiler;
+UcodeCache::cache g_ucode_cache;
+static uint32_t g_audio_abi = 0;
+// Whether IMEM holds the patched boot code, which stays until IMEM is written again.
+static bool g_boot_code_patched = false;
 HINSTANCE g_instance;
 std::filesystem::path g_app_path;
 // PlatformService g_platform_service;
@@ -100,17 +103,17 @@ void handle_unknown_task(const OSTask_t *task, const uint32_t sum)
 
 void audio_ucode_mario()
 {
-    memcpy(ABI, ABI1, sizeof(ABI[0]) * 0x20);
+    ABI = ABI1;
 }
 
 void audio_ucode_banjo()
 {
-    memcpy(ABI, ABI2, sizeof(ABI[0]) * 0x20);
+    ABI = ABI2;
 }
 
 void audio_ucode_zelda()
 {
-    memcpy(ABI, ABI3, sizeof(ABI[0]) * 0x20);
+    ABI = ABI3;
 }
 
 int audio_ucode_detect_type(const OSTask_t *task)
@@ -169,6 +172,7 @@ int audio_ucode(OSTask_t *task)
             printf("[RSP] Unknown ucode type: %d\n", ucode_type);
             return -1;
         }
+        g_audio_abi = ucode_type;
     }
 
     if (config.ucode_cache_verify)
@@ -178,41 +182,118 @@ int audio_ucode(OSTask_t *task)
 
     g_audio_ucode_func();
 
-    const auto p_alist = (unsigned long *)(rsp.rdram + task->data_ptr);
-
-    for (unsigned int i = 0; i < task->data_size / 4; i += 2)
+    const auto alist = (const uint32_t *)(rsp.rdram + task->data_ptr);
+    if (g_profiler.enabled())
+    {
+        g_profiler.run(g_audio_abi, ABI, alist, task->data_size / 4);
+    }
+    else
     {
-        inst1 = p_alist[i];
-        inst2 = p_alist[i + 1];
-        ABI[inst1 >> 24]();
+        hle_run_alist(ABI, alist, task->data_size / 4);
     }
 
     return 0;
 }
 
+static bool run_audio_task(OSTask_t *task)
+{
+    return audio_ucode(task) == 0;
+}
+
+static bool skip_jpeg_task(OSTask_t *)
+{
+    *rsp.sp_status_reg |= 0x200;
+    return true;
+}
+
+static bool run_jpeg_task(OSTask_t *task)
+{
+    jpg_uncompress(task);
+    return true;
+}
+
+static bool patch_boot_code(OSTask_t *)
+{
+    if (g_boot_code_patched)
+    {
+        return true;
+    }
+    g_boot_code_patched = true;
+    memcpy(rsp.imem + 0x120, rsp.rdram + 0x1e8, 0x1e8);
+    for (int j = 0; j < 0xfc; j++) EndianUtils::xor_copy(rsp.rdram, 0x2fb1f0 + j * 0xff0, rsp.imem, 0x120 + j * 8, 8);
+    return true;
+}
+
+static UcodeCache::ucode identify_ucode(const OSTask_t *task, const uint32_t sum)
+{
+    if (task->ucode_size > 0x1000)
+    {
+        switch (sum)
+        {
+        case 0x9E2: // banjo tooie (U) boot code
+        case 0x9F2: // banjo tooie (E) + zelda oot (E) boot code
+            return {sum, TaskProfiler::task_kind::boot, patch_boot_code};
+        default:
+            return {sum};
+        }
+    }
+
+    switch (task->type)
+    {
+    case 2: // audio
+        return {sum, TaskProfiler::task_kind::audio, run_audio_task};
+    case 4: // jpeg
+        switch (sum)
+        {
+        case 0x278: // used by zelda during boot
+            return {sum, TaskProfiler::task_kind::jpeg, skip_jpeg_task};
+        case 0x2e4fc: // uncompress
+            return {sum, TaskProfiler::task_kind::jpeg, run_jpeg_task};
+        default:
+            return {sum, TaskProfiler::task_kind::jpeg};
+        }
+    default:
+        return {sum};
+    }
+}
+
 bool rsp_alive()
 {
     return g_rsp_alive;
 }
 
+void on_dma_written(const uint32_t address, const uint32_t len)
+{
+    g_ucode_cache.invalidate(address, len);
+    if (address < IMEM_ADDRESS + 0x1000 && IMEM_ADDRESS < static_cast<uint64_t>(address) + len)
+    {
+        g_boot_code_patched = false;
+    }
+}
+
 void on_rom_closed()
 {
     memset(rsp.dmem, 0, 0x1000);
     memset(rsp.imem, 0, 0x1000);
 
     g_audio_ucode_func = nullptr;
+    g_audio_abi = 0;
+    g_ucode_cache.clear();
+    g_boot_code_patched = false;
     g_rsp_alive = false;
+    hle_reset();
 }
 
 uint32_t do_rsp_cycles(uint32_t Cycles)
 {
     OSTask_t *task = (OSTask_t *)(rsp.dmem + 0xFC0);
-    unsigned int i, sum = 0;
+    TaskProfiler::task_scope scope(g_profiler);
 
     g_rsp_alive = true;
 
     if (task->type == 1 && task->data_ptr != 0)
     {
+        scope.kind = TaskProfiler::task_kind::graphics;
         if (rsp.process_dlist_list)
         {
             rsp.process_dlist_list();
@@ -240,65 +321,27 @@ uint32_t do_rsp_cycles(uint32_t Cycles)
         rsp.check_interrupts();
     }
 
-    if (task->ucode_size <= 0x1000)
-    {
-        for (i = 0; i < task->ucode_size / 2; i++) sum += *(rsp.rdram + task->ucode + i);
-    }
-    else
-        for (i = 0; i < 0x1000 / 2; i++)
-        {
-            sum += *(rsp.imem + i);
-        }
+    // Tasks with microcode larger than IMEM are identified by what's in IMEM instead.
+    const bool oversized = task->ucode_size > 0x1000;
+    const uint32_t address = oversized ? IMEM_ADDRESS : task->ucode;
+    const uint8_t *code = oversized ? rsp.imem : rsp.rdram + task->ucode;
+    const size_t len = oversized ? 0x1000 / 2 : task->ucode_size / 2;
+    const auto &ucode = g_ucode_cache.get(task, address, code, len, identify_ucode);
 
-    if (task->ucode_size > 0x1000)
+    scope.ucode = ucode.sum;
+    scope.kind = ucode.kind;
+    if (ucode.handler && ucode.handler(task))
     {
-        switch (sum)
-        {
-        case 0x9E2: // banjo tooie (U) boot code
-        {
-            int i, j;
-            memcpy(rsp.imem + 0x120, rsp.rdram + 0x1e8, 0x1e8);
-            for (j = 0; j < 0xfc; j++)
-                for (i = 0; i < 8; i++)
-                    *(rsp.rdram + (0x2fb1f0 + j * 0xff0 + i ^ S8)) = *(rsp.imem + (0x120 + j * 8 + i ^ S8));
-        }
-            return Cycles;
-        case 0x9F2: // banjo tooie (E) + zelda oot (E) boot code
-        {
-            int i, j;
-            memcpy(rsp.imem + 0x120, rsp.rdram + 0x1e8, 0x1e8);
-            for (j = 0; j < 0xfc; j++)
-                for (i = 0; i < 8; i++)
-                    *(rsp.rdram + (0x2fb1f0 + j * 0xff0 + i ^ S8)) = *(rsp.imem + (0x120 + j * 8 + i ^ S8));
-        }
-            return Cycles;
-        }
+        return Cycles;
     }
-    else
+
+    if (ucode.kind == TaskProfiler::task_kind::jpeg)
     {
-        switch (task->type)
-        {
-        case 2: // audio
-            if (audio_ucode(task) == 0) return Cycles;
-            break;
-        case 4: // jpeg
-            switch (sum)
-            {
-            case 0x278: // used by zelda during boot
-                *rsp.sp_status_reg |= 0x200;
-                return Cycles;
-            case 0x2e4fc: // uncompress
-                jpg_uncompress(task);
-                return Cycles;
-            default:
-                MessageBox(NULL, std::format(L"unknown jpeg: sum: {}", sum).c_str(), L"Error", MB_OK | MB_ICONERROR);
-                break;
-            }
-            break;
-        }
+        MessageBox(NULL, std::format(L"unknown jpeg: sum: {}", ucode.sum).c_str(), L"Error", MB_OK | MB_ICONERROR);
     }
 
-    handle_unknown_task(task, sum);
+    scope.kind = TaskProfiler::task_kind::unknown;
+    handle_unknown_task(task, ucode.sum);
 
     return Cycles;
 }
@@ -324,12 +367,18 @@ char *getExtension(char *str)
         return NULL;
 }
 
+static void show_hle_error(const std::wstring &message)
+{
+    MessageBox(NULL, message.c_str(), L"AudioHLE Error", MB_OK | MB_ICONERROR);
+}
+
 BOOL APIENTRY DllMain(HINSTANCE hinst, DWORD reason, LPVOID)
 {
     switch (reason)
     {
     case DLL_PROCESS_ATTACH:
         g_instance = hinst;
+        g_hle_error = show_hle_error;
         g_app_path = get_app_full_path();
         config_load();
         break;
@@ -389,3 +438,25 @@ EXPORT void CALL ReceiveExtendedFuncs(core_plugin_extended_funcs* funcs)
 {
     g_ef = funcs;
 }
+
+EXPORT void CALL DmaWritten(uint32_t address, uint32_t len)
+{
+    on_dma_written(address, len);
+}
+
+EXPORT void CALL SetRspProfiling(int32_t enabled)
+{
+    g_profiler.set_enabled(enabled != 0);
+}
+
+EXPORT uint32_t CALL GetRspProfile(char *buffer, uint32_t size)
+{
+    const auto json = g_profiler.to_json();
+    if (buffer && size > 0)
+    {
+        const size_t len = std::min<size_t>(json.size(), size - 1);
+        memcpy(buffer, json.data(), len);
+        buffer[len] = '\0';
+    }
+    return static_cast<uint32_t>(json.size() + 1);
+}
@@ -33,4 +33,5 @@ extern core_plugin_extended_funcs* g_ef;
 
 bool rsp_alive();
 void on_rom_closed();
+void on_dma_written(uint32_t address, uint32_t len);
 uint32_t do_rsp_cycles(uint32_t Cycles);
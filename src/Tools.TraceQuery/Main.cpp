@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Queries binary tracelogs through their chunk index.
+ *
+ * Usage:
+ *  tracequery <trace> --info
+ *  tracequery <trace> --pc=<addr> [--limit=<n>]
+ *  tracequery <trace> --write=<addr> [--size=<n>] [--limit=<n>]
+ *  tracequery <trace> --vi=<n> [--limit=<n>]
+ *  tracequery <trace> --reindex
+ */
+
+#include <CommonPCH.h>
+#include <argh.h>
+#include <r4300/tracelog_index.h>
+
+static void print_record(const t_tl_trace &trace, uint64_t index, const t_tl_record &record)
+{
+    fputs(std::format("{} vi={} {:08X}: {:08X} {:08X} {:08X}\n", index, tl_record_vi(trace, index), record.pc,
+                      record.w, record.operand1, record.operand2)
+              .c_str(),
+          stdout);
+}
+
+static uint32_t parse_u32(const std::string &str)
+{
+    return static_cast<uint32_t>(std::stoul(str, nullptr, 0));
+}
+
+int main(int argc, char *argv[])
+{
+    argh::parser cmdl(argc, argv, argh::parser::PREFER_PARAM_FOR_UNREG_OPTION);
+
+    if (cmdl.size() < 2)
+    {
+        fputs("usage: tracequery <trace> [--info | --pc=<addr> | --write=<addr> [--size=<n>] | --vi=<n> | --reindex] "
+              "[--limit=<n>]\n",
+              stderr);
+        return 1;
+    }
+
+    const std::filesystem::path path = cmdl[1];
+
+    if (cmdl["--reindex"])
+    {
+        t_tl_index_builder builder;
+        if (!tl_index_build(path, builder) || !builder.save(tl_index_path(path)))
+        {
+            fputs("failed to reindex trace\n", stderr);
+            return 1;
+        }
+        return 0;
+    }
+
+    t_tl_trace trace;
+    if (!tl_trace_open(path, trace))
+    {
+        fputs("failed to open trace\n", stderr);
+        return 1;
+    }
+
+    size_t limit = SIZE_MAX;
+    if (cmdl("--limit"))
+    {
+        limit = std::stoull(cmdl("--limit").str());
+    }
+
+    size_t matches = 0;
+    const auto on_match = [&](uint64_t index, const t_tl_record &record) {
+        print_record(trace, index, record);
+        return ++matches < limit;
+    };
+
+    if (cmdl("--pc"))
+    {
+        tl_query_pc(trace, parse_u32(cmdl("--pc").str()), on_match);
+    }
+    else if (cmdl("--write"))
+    {
+        tl_query_writes(trace, parse_u32(cmdl("--write").str()), parse_u32(cmdl("--size", "4").str()), on_match);
+    }
+    else if (cmdl("--vi"))
+    {
+        const auto vi = parse_u32(cmdl("--vi").str());
+        const auto records = tl_vi_records(trace, vi);
+        const uint64_t first = records.empty() || vi == 0 ? 0 : trace.vi_records[vi - 1];
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            if (!on_match(first + i, records[i])) break;
+        }
+    }
+    else
+    {
+        fputs(std::format("records: {}\nchunks: {}\nvis: {}\n", trace.records().size(), trace.chunks.size(),
+                          trace.vi_records.size())
+                  .c_str(),
+              stdout);
+    }
+
+    return 0;
+}
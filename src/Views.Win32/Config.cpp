@@ -345,10 +345,12 @@ static void handle_config_ini(const bool is_reading, mINI::INIStructure &ini)
     HANDLE_P_VALUE(core.core_type)
     HANDLE_P_VALUE(core.fps_modifier)
     HANDLE_P_VALUE(core.frame_skip_frequency)
+    HANDLE_P_VALUE(core.seek_render_frames)
     HANDLE_P_VALUE(st_slot)
     HANDLE_P_VALUE(core.fastforward_silent)
     HANDLE_P_VALUE(core.rom_cache_size)
     HANDLE_P_VALUE(core.st_screenshot)
+    HANDLE_P_VALUE(core.st_preview)
     HANDLE_P_VALUE(core.is_movie_loop_enabled)
     HANDLE_P_VALUE(core.counter_factor)
     HANDLE_P_VALUE(is_unfocused_pause_enabled)
@@ -374,6 +376,7 @@ static void handle_config_ini(const bool is_reading, mINI::INIStructure &ini)
     HANDLE_P_VALUE(capture_delay)
     HANDLE_VALUE(ffmpeg_final_options)
     HANDLE_VALUE(ffmpeg_path)
+    HANDLE_P_VALUE(capture_resampler_quality)
     HANDLE_P_VALUE(synchronization_mode)
     HANDLE_P_VALUE(keep_default_working_directory)
     HANDLE_P_VALUE(fast_dispatcher)
@@ -416,6 +419,7 @@ static void handle_config_ini(const bool is_reading, mINI::INIStructure &ini)
     HANDLE_P_VALUE(core.vcr_backups)
     HANDLE_P_VALUE(core.vcr_write_extended_format)
     HANDLE_P_VALUE(core.wait_at_movie_end)
+    HANDLE_P_VALUE(core.vcr_state_digests)
     HANDLE_P_VALUE(automatic_update_checking)
     HANDLE_P_VALUE(silent_mode)
     HANDLE_P_VALUE(core.max_lag)
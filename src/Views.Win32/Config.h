@@ -151,6 +151,11 @@ struct t_config
     /// </summary>
     std::wstring ffmpeg_path = L"C:\\ffmpeg\\bin\\ffmpeg.exe";
 
+    /// <summary>
+    /// The quality of the audio resampling done when capturing with the VFW encoder, from 0 (fastest) to 10 (best)
+    /// </summary>
+    int32_t capture_resampler_quality = 6;
+
     /// <summary>
     /// The audio-video synchronization mode
     /// <para/>
@@ -641,7 +641,7 @@ void on_speed_modifier_changed(std::any data)
 
 void on_emu_paused_changed(std::any data)
 {
-    g_main_ctx.core.callbacks.frame();
+    g_main_ctx.core.events.publish<core_event::frame>();
 }
 
 void on_vis_since_input_poll_exceeded(std::any)
@@ -665,6 +665,12 @@ void on_vis_since_input_poll_exceeded(std::any)
     g_vis_since_input_poll_warning_dismissed = true;
 }
 
+void on_state_digest_mismatch(std::any data)
+{
+    auto value = std::any_cast<size_t>(data);
+    Statusbar::post(std::format(L"Movie desynced at VI {}", value));
+}
+
 void on_movie_loop_changed(std::any data)
 {
     auto value = std::any_cast<bool>(data);
@@ -872,6 +878,9 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT Message, WPARAM wParam, LPARAM lParam)
     case WM_EXECUTE_DISPATCHER:
         g_main_ctx.dispatcher->execute();
         break;
+    case WM_FLUSH_CORE_EVENTS:
+        g_main_ctx.core.events.flush();
+        break;
     case WM_NCCREATE:
         g_main_ctx.hwnd = hwnd;
         break;
@@ -1031,89 +1040,79 @@ static core_result init_core()
 {
     g_main_ctx.core.cfg = &g_config.core;
     // g_main_ctx.core.io_service = &g_main_ctx.io_service;
-    g_main_ctx.core.callbacks = {};
-    g_main_ctx.core.callbacks.vi = [] {
+    auto &events = g_main_ctx.core.events;
+    events.clear();
+    events.set_batch_notifier([](void *) { PostMessage(g_main_ctx.hwnd, WM_FLUSH_CORE_EVENTS, 0, 0); });
+    events.subscribe<core_event::vi>([](void *) {
         LuaCallbacks::call_interval();
         LuaCallbacks::call_vi();
         at_vi();
-    };
-    g_main_ctx.core.callbacks.input = LuaCallbacks::call_input;
-    g_main_ctx.core.callbacks.frame = on_new_frame;
-    g_main_ctx.core.callbacks.interval = LuaCallbacks::call_interval;
-    g_main_ctx.core.callbacks.ai_len_changed = ai_len_changed;
-    g_main_ctx.core.callbacks.play_movie = LuaCallbacks::call_play_movie;
-    g_main_ctx.core.callbacks.stop_movie = [] {
+    });
+    events.subscribe<core_event::input>(
+        [](void *, core_buttons *input, int index) { LuaCallbacks::call_input(input, index); });
+    events.subscribe<core_event::frame>([](void *) { on_new_frame(); });
+    events.subscribe<core_event::interval>([](void *) { LuaCallbacks::call_interval(); });
+    events.subscribe<core_event::ai_len_changed>([](void *) { ai_len_changed(); });
+    events.subscribe<core_event::play_movie>([](void *) { LuaCallbacks::call_play_movie(); });
+    events.subscribe<core_event::stop_movie>([](void *) {
         LuaCallbacks::call_stop_movie();
         if (g_config.stop_capture_at_movie_end && EncodingManager::is_capturing()) EncodingManager::stop_capture();
-    };
-    g_main_ctx.core.callbacks.loop_movie = [] {
+    });
+    events.subscribe<core_event::loop_movie>([](void *) {
         if (g_config.stop_capture_at_movie_end && EncodingManager::is_capturing()) EncodingManager::stop_capture();
-    };
-    g_main_ctx.core.callbacks.save_state = LuaCallbacks::call_save_state;
-    g_main_ctx.core.callbacks.load_state = LuaCallbacks::call_load_state;
-    g_main_ctx.core.callbacks.reset = LuaCallbacks::call_reset;
-    g_main_ctx.core.callbacks.seek_completed = [] {
+    });
+    events.subscribe<core_event::save_state>([](void *) { LuaCallbacks::call_save_state(); });
+    events.subscribe<core_event::load_state>([](void *) { LuaCallbacks::call_load_state(); });
+    events.subscribe<core_event::reset>([](void *) { LuaCallbacks::call_reset(); });
+    events.subscribe<core_event::seek_completed>([](void *) {
         Messenger::broadcast(Messenger::Message::SeekCompleted, nullptr);
         LuaCallbacks::call_seek_completed();
-    };
-    g_main_ctx.core.callbacks.core_executing_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::CoreExecutingChanged, value);
-    };
-    g_main_ctx.core.callbacks.emu_paused_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::EmuPausedChanged, value);
-    };
-    g_main_ctx.core.callbacks.emu_launched_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::EmuLaunchedChanged, value);
-    };
-    g_main_ctx.core.callbacks.emu_starting_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::EmuStartingChanged, value);
-    };
-    g_main_ctx.core.callbacks.emu_starting = [] { PluginUtil::start_plugins(); };
-    g_main_ctx.core.callbacks.emu_stopped = [] { PluginUtil::stop_plugins(); };
-    g_main_ctx.core.callbacks.emu_stopping = []() { Messenger::broadcast(Messenger::Message::EmuStopping, nullptr); };
-    g_main_ctx.core.callbacks.reset_completed = []() {
-        Messenger::broadcast(Messenger::Message::ResetCompleted, nullptr);
-    };
-    g_main_ctx.core.callbacks.speed_modifier_changed = [](int32_t value) {
-        Messenger::broadcast(Messenger::Message::SpeedModifierChanged, value);
-    };
-    g_main_ctx.core.callbacks.warp_modify_status_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::WarpModifyStatusChanged, value);
-    };
-    g_main_ctx.core.callbacks.current_sample_changed = [](int32_t value) {
-        Compare::compare(value);
-        Messenger::broadcast(Messenger::Message::CurrentSampleChanged, value);
-    };
-    g_main_ctx.core.callbacks.task_changed = [](core_vcr_task value) {
-        Messenger::broadcast(Messenger::Message::TaskChanged, value);
-    };
-    g_main_ctx.core.callbacks.rerecords_changed = [](uint64_t value) {
-        Messenger::broadcast(Messenger::Message::RerecordsChanged, value);
-    };
-    g_main_ctx.core.callbacks.unfreeze_completed = []() {
-        Messenger::broadcast(Messenger::Message::UnfreezeCompleted, nullptr);
-    };
-    g_main_ctx.core.callbacks.seek_savestate_changed = [](size_t value) {
-        Messenger::broadcast(Messenger::Message::SeekSavestateChanged, value);
-    };
-    g_main_ctx.core.callbacks.readonly_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::ReadonlyChanged, value);
-    };
-    g_main_ctx.core.callbacks.dacrate_changed = [](core_system_type value) {
-        Messenger::broadcast(Messenger::Message::DacrateChanged, value);
-    };
-    g_main_ctx.core.callbacks.debugger_resumed_changed = [](bool value) {
-        Messenger::broadcast(Messenger::Message::DebuggerResumedChanged, value);
-    };
-    g_main_ctx.core.callbacks.debugger_cpu_state_changed = [](core_dbg_cpu_state *value) {
+    });
+    events.subscribe<core_event::core_executing_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::CoreExecutingChanged, value); });
+    events.subscribe<core_event::emu_paused_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::EmuPausedChanged, value); });
+    events.subscribe<core_event::emu_launched_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::EmuLaunchedChanged, value); });
+    events.subscribe<core_event::emu_starting_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::EmuStartingChanged, value); });
+    events.subscribe<core_event::emu_starting>([](void *) { PluginUtil::start_plugins(); });
+    events.subscribe<core_event::emu_stopped>([](void *) { PluginUtil::stop_plugins(); });
+    events.subscribe<core_event::emu_stopping>(
+        [](void *) { Messenger::broadcast(Messenger::Message::EmuStopping, nullptr); });
+    events.subscribe<core_event::reset_completed>(
+        [](void *) { Messenger::broadcast(Messenger::Message::ResetCompleted, nullptr); });
+    events.subscribe<core_event::speed_modifier_changed>(
+        [](void *, int32_t value) { Messenger::broadcast(Messenger::Message::SpeedModifierChanged, value); });
+    events.subscribe<core_event::warp_modify_status_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::WarpModifyStatusChanged, value); });
+    events.subscribe<core_event::current_sample_changed>([](void *, int32_t value) { Compare::compare(value); });
+    // The sample changes on every poll during movies, while the UI only needs to show the latest one.
+    events.subscribe_batched<core_event::current_sample_changed>(
+        [](void *, int32_t value) { Messenger::broadcast(Messenger::Message::CurrentSampleChanged, value); });
+    events.subscribe<core_event::task_changed>(
+        [](void *, core_vcr_task value) { Messenger::broadcast(Messenger::Message::TaskChanged, value); });
+    events.subscribe<core_event::rerecords_changed>(
+        [](void *, uint64_t value) { Messenger::broadcast(Messenger::Message::RerecordsChanged, value); });
+    events.subscribe<core_event::unfreeze_completed>(
+        [](void *) { Messenger::broadcast(Messenger::Message::UnfreezeCompleted, nullptr); });
+    events.subscribe<core_event::seek_savestate_changed>(
+        [](void *, size_t value) { Messenger::broadcast(Messenger::Message::SeekSavestateChanged, value); });
+    events.subscribe<core_event::readonly_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::ReadonlyChanged, value); });
+    events.subscribe<core_event::dacrate_changed>(
+        [](void *, core_system_type value) { Messenger::broadcast(Messenger::Message::DacrateChanged, value); });
+    events.subscribe<core_event::debugger_resumed_changed>(
+        [](void *, bool value) { Messenger::broadcast(Messenger::Message::DebuggerResumedChanged, value); });
+    events.subscribe<core_event::debugger_cpu_state_changed>([](void *, core_dbg_cpu_state *value) {
         Messenger::broadcast(Messenger::Message::DebuggerCpuStateChanged, value);
-    };
-    g_main_ctx.core.callbacks.lag_limit_exceeded = []() {
-        Messenger::broadcast(Messenger::Message::LagLimitExceeded, nullptr);
-    };
-    g_main_ctx.core.callbacks.seek_status_changed = []() {
-        Messenger::broadcast(Messenger::Message::SeekStatusChanged, nullptr);
-    };
+    });
+    events.subscribe<core_event::lag_limit_exceeded>(
+        [](void *) { Messenger::broadcast(Messenger::Message::LagLimitExceeded, nullptr); });
+    events.subscribe<core_event::seek_status_changed>(
+        [](void *) { Messenger::broadcast(Messenger::Message::SeekStatusChanged, nullptr); });
+    events.subscribe<core_event::state_digest_mismatch>(
+        [](void *, size_t vi) { Messenger::broadcast(Messenger::Message::StateDigestMismatch, vi); });
     g_main_ctx.core.log_trace = [](const auto &str) { g_core_logger->trace(str); };
     g_main_ctx.core.log_info = [](const auto &str) { g_core_logger->info(str); };
     g_main_ctx.core.log_warn = [](const auto &str) { g_core_logger->warn(str); };
@@ -1359,6 +1358,7 @@ int CALLBACK WinMain(const HINSTANCE hInstance, HINSTANCE, LPSTR, const int nSho
     Messenger::subscribe(Messenger::Message::ScriptStarted, on_script_started);
     Messenger::subscribe(Messenger::Message::SpeedModifierChanged, on_speed_modifier_changed);
     Messenger::subscribe(Messenger::Message::LagLimitExceeded, on_vis_since_input_poll_exceeded);
+    Messenger::subscribe(Messenger::Message::StateDigestMismatch, on_state_digest_mismatch);
     Messenger::subscribe(Messenger::Message::FullscreenChanged, on_fullscreen_changed);
     Messenger::subscribe(Messenger::Message::ConfigLoaded, on_config_loaded);
     Messenger::subscribe(Messenger::Message::SeekCompleted, on_seek_completed);
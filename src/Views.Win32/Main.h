@@ -13,6 +13,7 @@
 #define WM_FOCUS_MAIN_WINDOW (WM_USER + 17)
 #define WM_EXECUTE_DISPATCHER (WM_USER + 18)
 #define WM_INVALIDATE_LUA (WM_USER + 23)
+#define WM_FLUSH_CORE_EVENTS (WM_USER + 26)
 
 #define VIEW_DLG_MOVIE_OVERWRITE_WARNING "VIEW_DLG_MOVIE_OVERWRITE_WARNING"
 #define VIEW_DLG_RESET_SETTINGS "VIEW_DLG_RESET_SETTINGS"
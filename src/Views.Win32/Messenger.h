@@ -148,6 +148,12 @@ enum class Message
      */
     LagLimitExceeded,
 
+    /**
+     * \brief The state digest of a movie being played back differs from the stored one.
+     * The payload is the VI index as a size_t.
+     */
+    StateDigestMismatch,
+
     /**
      * \brief The emu has begun or stopped its starting process
      */
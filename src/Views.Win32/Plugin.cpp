@@ -187,6 +187,7 @@ void load_gfx(HMODULE handle)
     FUNC(g_plugin_funcs.video_fb_write, FBWRITE, dummy_fb_write, "FBWrite");
     FUNC(g_plugin_funcs.video_fb_get_frame_buffer_info, FBGETFRAMEBUFFERINFO, dummy_fb_get_framebuffer_info,
          "FBGetFrameBufferInfo");
+    FUNC(g_plugin_funcs.video_set_frame_hidden, SETFRAMEHIDDEN, nullptr, "SetFrameHidden");
     g_plugin_funcs.video_dll_crt_free = get_free_function_in_module(handle);
 
     gfx_info.main_hwnd = g_main_ctx.hwnd;
@@ -236,6 +237,7 @@ void load_input(uint16_t version, HMODULE handle)
     FUNC(g_plugin_funcs.input_close_dll, CLOSEDLL, dummy_void, "CloseDLL");
     FUNC(g_plugin_funcs.input_controller_command, CONTROLLERCOMMAND, dummy_controller_command, "ControllerCommand");
     FUNC(g_plugin_funcs.input_get_keys, GETKEYS, dummy_get_keys, "GetKeys");
+    FUNC(g_plugin_funcs.input_get_all_keys, GETALLKEYS, nullptr, "GetAllKeys");
     FUNC(g_plugin_funcs.input_set_keys, SETKEYS, dummy_set_keys, "SetKeys");
     if (version == 0x0101)
     {
@@ -322,6 +324,9 @@ void load_rsp(HMODULE handle)
     FUNC(g_plugin_funcs.rsp_do_rsp_cycles, DORSPCYCLES, dummy_do_rsp_cycles, "DoRspCycles");
     FUNC(initiate_rsp, INITIATERSP, dummy_initiate_rsp, "InitiateRSP");
     FUNC(g_plugin_funcs.rsp_rom_closed, ROMCLOSED, dummy_void, "RomClosed");
+    FUNC(g_plugin_funcs.rsp_set_profiling, SETRSPPROFILING, nullptr, "SetRspProfiling");
+    FUNC(g_plugin_funcs.rsp_get_profile, GETRSPPROFILE, nullptr, "GetRspProfile");
+    FUNC(g_plugin_funcs.rsp_dma_written, DMAWRITTEN, nullptr, "DmaWritten");
 
     rsp_info.byteswapped = 1;
     rsp_info.rdram = (uint8_t *)g_main_ctx.core_ctx->rdram;
@@ -685,6 +690,7 @@ void PluginUtil::start_plugins()
     g_main_ctx.core.video_fb_read = g_plugin_funcs.video_fb_read;
     g_main_ctx.core.video_fb_write = g_plugin_funcs.video_fb_write;
     g_main_ctx.core.video_fb_get_frame_buffer_info = g_plugin_funcs.video_fb_get_frame_buffer_info;
+    g_main_ctx.core.video_set_frame_hidden = g_plugin_funcs.video_set_frame_hidden;
 
     g_main_ctx.core.audio_ai_dacrate_changed = g_plugin_funcs.audio_ai_dacrate_changed;
     g_main_ctx.core.audio_ai_len_changed = g_plugin_funcs.audio_ai_len_changed;
@@ -694,10 +700,12 @@ void PluginUtil::start_plugins()
 
     g_main_ctx.core.input_controller_command = g_plugin_funcs.input_controller_command;
     g_main_ctx.core.input_get_keys = g_plugin_funcs.input_get_keys;
+    g_main_ctx.core.input_get_all_keys = g_plugin_funcs.input_get_all_keys;
     g_main_ctx.core.input_set_keys = g_plugin_funcs.input_set_keys;
     g_main_ctx.core.input_read_controller = g_plugin_funcs.input_read_controller;
 
     g_main_ctx.core.rsp_do_rsp_cycles = g_plugin_funcs.rsp_do_rsp_cycles;
+    g_main_ctx.core.rsp_dma_written = g_plugin_funcs.rsp_dma_written;
 
     g_plugin_funcs.video_rom_open();
     g_plugin_funcs.input_rom_open();
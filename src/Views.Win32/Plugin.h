@@ -23,6 +23,7 @@ struct plugin_funcs
     FBREAD video_fb_read;
     FBWRITE video_fb_write;
     FBGETFRAMEBUFFERINFO video_fb_get_frame_buffer_info;
+    SETFRAMEHIDDEN video_set_frame_hidden;
     CHANGEWINDOW video_change_window;
     UPDATESCREEN video_update_screen;
     READSCREEN video_read_screen;
@@ -47,6 +48,7 @@ struct plugin_funcs
     core_plugin_extended_funcs input_extended_funcs;
     CONTROLLERCOMMAND input_controller_command;
     GETKEYS input_get_keys;
+    GETALLKEYS input_get_all_keys;
     SETKEYS input_set_keys;
     READCONTROLLER input_read_controller;
     KEYDOWN input_key_down;
@@ -56,6 +58,9 @@ struct plugin_funcs
     CLOSEDLL rsp_close_dll;
     ROMCLOSED rsp_rom_closed;
     DORSPCYCLES rsp_do_rsp_cycles;
+    DMAWRITTEN rsp_dma_written;
+    SETRSPPROFILING rsp_set_profiling;
+    GETRSPPROFILE rsp_get_profile;
 };
 
 class Plugin
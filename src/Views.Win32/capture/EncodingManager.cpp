@@ -35,6 +35,8 @@ size_t m_total_frames = 0;
 
 // Video buffer, allocated once when recording starts and freed when it ends.
 uint8_t *m_video_buf = nullptr;
+// The buffer the current frame is read into, either the encoder's or the video buffer.
+uint8_t *m_frame_buf = nullptr;
 int32_t m_video_width;
 int32_t m_video_height;
 
@@ -51,7 +53,7 @@ void readscreen_plugin(int32_t *width = nullptr, int32_t *height = nullptr)
 {
     if (PluginUtil::mge_available())
     {
-        MGECompositor::copy_video(m_video_buf);
+        MGECompositor::copy_video(m_frame_buf);
         MGECompositor::get_video_size(width, height);
     }
     else
@@ -60,7 +62,7 @@ void readscreen_plugin(int32_t *width = nullptr, int32_t *height = nullptr)
         int32_t w;
         int32_t h;
         g_plugin_funcs.video_read_screen(&buf, &w, &h);
-        memcpy(m_video_buf, buf, w * h * 3);
+        memcpy(m_frame_buf, buf, w * h * 3);
         g_plugin_funcs.video_dll_crt_free(buf);
 
         if (width)
@@ -93,7 +95,7 @@ void readscreen_window()
         bmp_info.bmiHeader.biBitCount = 24;
         bmp_info.bmiHeader.biCompression = BI_RGB;
 
-        GetDIBits(compat_dc, bitmap, 0, m_video_height, m_video_buf, &bmp_info, DIB_RGB_COLORS);
+        GetDIBits(compat_dc, bitmap, 0, m_video_height, m_frame_buf, &bmp_info, DIB_RGB_COLORS);
 
         SelectObject(compat_dc, nullptr);
         DeleteObject(bitmap);
@@ -124,7 +126,7 @@ void readscreen_desktop()
         bmp_info.bmiHeader.biBitCount = 24;
         bmp_info.bmiHeader.biCompression = BI_RGB;
 
-        GetDIBits(compat_dc, bitmap, 0, m_video_height, m_video_buf, &bmp_info, DIB_RGB_COLORS);
+        GetDIBits(compat_dc, bitmap, 0, m_video_height, m_frame_buf, &bmp_info, DIB_RGB_COLORS);
 
         SelectObject(compat_dc, nullptr);
         DeleteObject(bitmap);
@@ -168,7 +170,7 @@ void readscreen_hybrid()
 
             // Copy the raw readscreen output
             StretchDIBits(hy_dc, 0, 0, raw_video_width, raw_video_height, 0, 0, raw_video_width, raw_video_height,
-                          m_video_buf, &bmp_info, DIB_RGB_COLORS, SRCCOPY);
+                          m_frame_buf, &bmp_info, DIB_RGB_COLORS, SRCCOPY);
         }
 
         // First, composite the lua's dxgi surfaces
@@ -196,7 +198,7 @@ void readscreen_hybrid()
         bmp_info.bmiHeader.biBitCount = 24;
         bmp_info.bmiHeader.biCompression = BI_RGB;
 
-        GetDIBits(hy_dc, hy_bmp, 0, m_video_height, m_video_buf, &bmp_info, DIB_RGB_COLORS);
+        GetDIBits(hy_dc, hy_bmp, 0, m_video_height, m_frame_buf, &bmp_info, DIB_RGB_COLORS);
     });
 }
 
@@ -428,9 +430,16 @@ void at_vi()
         Sleep(g_config.capture_delay);
     }
 
+    // Encoders which provide a buffer get the frame read straight into it.
+    m_frame_buf = m_encoder->acquire_video_buffer();
+    if (!m_frame_buf)
+    {
+        m_frame_buf = m_video_buf;
+    }
+
     read_screen();
 
-    if (m_encoder->append_video(m_video_buf))
+    if (m_encoder->append_video(m_frame_buf))
     {
         m_total_frames++;
         return;
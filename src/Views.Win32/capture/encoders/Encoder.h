@@ -56,6 +56,15 @@ class Encoder
      */
     virtual bool stop() = 0;
 
+    /**
+     * \brief Gets a buffer the next frame can be written into, so <c>append_video</c> doesn't have to copy it.
+     * \return The buffer, or nullptr if the encoder doesn't provide one.
+     */
+    virtual uint8_t *acquire_video_buffer()
+    {
+        return nullptr;
+    }
+
     /**
      * \brief Adds one frame of video data
      * \param image The video buffer. Must be freed with the provided video free function.
@@ -9,6 +9,12 @@
 #include <DialogService.h>
 #include <Config.h>
 
+// The memory the queued frames may take up. Higher resolutions get fewer frames, but never less than two.
+constexpr size_t VIDEO_RING_BUDGET = 256 * 1024 * 1024;
+constexpr size_t VIDEO_RING_MAX_SLOTS = 16;
+constexpr size_t AUDIO_RING_SLOTS = 64;
+constexpr size_t AUDIO_RING_SLOT_SIZE = 0x8000;
+
 std::optional<std::wstring> FFmpegEncoder::start(Params params)
 {
     m_params = params;
@@ -60,9 +66,10 @@ std::optional<std::wstring> FFmpegEncoder::start(Params params)
         return std::format(L"Failed to start ffmpeg process! Does ffmpeg exist on disk at '{}'?", g_config.ffmpeg_path);
     }
 
-    m_silence_buffer = static_cast<uint8_t *>(calloc(params.arate, 1));
-    m_blank_buffer = static_cast<uint8_t *>(calloc(m_params.width * m_params.height * 3, 1));
-    m_dropped_frames = 0;
+    const size_t frame_size = m_params.width * m_params.height * 3;
+    const size_t video_slots = std::clamp<size_t>(VIDEO_RING_BUDGET / frame_size, 2, VIDEO_RING_MAX_SLOTS);
+    m_video_ring = std::make_unique<CaptureRing::ring>(video_slots, frame_size);
+    m_audio_ring = std::make_unique<CaptureRing::ring>(AUDIO_RING_SLOTS, AUDIO_RING_SLOT_SIZE);
 
     m_video_thread = std::thread(&FFmpegEncoder::write_video_thread, this);
     m_audio_thread = std::thread(&FFmpegEncoder::write_audio_thread, this);
@@ -74,13 +81,18 @@ std::optional<std::wstring> FFmpegEncoder::start(Params params)
 
 bool FFmpegEncoder::stop()
 {
-    m_stop_thread = true;
-    m_video_cv.notify_all();
-    m_audio_cv.notify_all();
+    // The writer threads exit once they've drained the rings.
+    m_video_ring->close();
+    m_audio_ring->close();
 
     // HACK: Give it some time to maybe accept the last writes...
     Sleep(500);
 
+    const auto video_stats = m_video_ring->get_stats();
+    const auto audio_stats = m_audio_ring->get_stats();
+    const auto video_remaining = video_stats.produced - video_stats.consumed;
+    const auto audio_remaining = audio_stats.produced - audio_stats.consumed;
+
     CancelIo(m_video_pipe);
     CancelIo(m_audio_pipe);
     DisconnectNamedPipe(m_video_pipe);
@@ -92,26 +104,24 @@ bool FFmpegEncoder::stop()
     m_audio_thread.join();
     m_video_thread.join();
 
-    if (!this->m_video_queue.empty() || !this->m_audio_queue.empty())
+    if (video_remaining > 0 || audio_remaining > 0)
     {
         DialogService::show_dialog(std::format(L"Capture stopped with {} video, {} audio elements remaining in "
                                                L"queue!\nThe capture might be corrupted.",
-                                               this->m_video_queue.size(), this->m_audio_queue.size())
+                                               video_remaining, audio_remaining)
                                        .c_str(),
                                    L"FFmpeg");
     }
 
-    if (m_dropped_frames > 0)
-    {
-        DialogService::show_dialog(std::format(L"{} frames were dropped during capture to avoid out-of-memory "
-                                               L"errors.\nThe capture might contain empty frames.",
-                                               m_dropped_frames)
-                                       .c_str(),
-                                   L"FFmpeg");
-    }
+    g_view_logger->info("[FFmpegEncoder] Video: {} frames, {} slots, peak {} queued, {} stalls totalling {}ms",
+                        video_stats.produced, m_video_ring->slot_count(), video_stats.high_water, video_stats.stalls,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(video_stats.stall_time).count());
+    g_view_logger->info("[FFmpegEncoder] Audio: {} chunks, {} slots, peak {} queued, {} stalls totalling {}ms",
+                        audio_stats.produced, m_audio_ring->slot_count(), audio_stats.high_water, audio_stats.stalls,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(audio_stats.stall_time).count());
 
-    free(m_silence_buffer);
-    free(m_blank_buffer);
+    m_video_ring.reset();
+    m_audio_ring.reset();
     return true;
 }
 
@@ -129,26 +139,42 @@ static bool write_pipe_checked(const HANDLE pipe, const char *buffer, const unsi
     return true;
 }
 
-bool FFmpegEncoder::append_audio_impl(uint8_t *audio, size_t length)
+bool FFmpegEncoder::append_audio_impl(const uint8_t *audio, size_t length)
 {
-    uint8_t *buf = m_silence_buffer;
-    if (audio != m_silence_buffer)
-    {
-        buf = static_cast<uint8_t *>(malloc(length));
-        memcpy(buf, audio, length);
-    }
-
     m_last_write_was_video = false;
 
+    // Chunks larger than a slot are split, a null buffer is written as silence.
+    while (length > 0)
     {
-        std::lock_guard lock(m_audio_queue_mutex);
-        this->m_audio_queue.emplace(buf, length);
+        const auto slot = m_audio_ring->acquire();
+        if (!slot)
+        {
+            return false;
+        }
+
+        const size_t size = std::min(length, m_audio_ring->slot_size());
+        if (audio)
+        {
+            memcpy(slot, audio, size);
+            audio += size;
+        }
+        else
+        {
+            memset(slot, 0, size);
+        }
+
+        m_audio_ring->commit(size);
+        length -= size;
     }
-    m_audio_cv.notify_one();
 
     return true;
 }
 
+uint8_t *FFmpegEncoder::acquire_video_buffer()
+{
+    return m_video_ring->acquire();
+}
+
 bool FFmpegEncoder::append_video(uint8_t *image)
 {
     if (g_config.synchronization_mode == 1)
@@ -163,71 +189,41 @@ bool FFmpegEncoder::append_video(uint8_t *image)
         if (g_main_ctx.core_ctx->vr_get_lag_count() > 2)
         {
             const auto samples_per_frame = static_cast<double>(m_params.arate) / 64;
-            append_audio_impl(m_silence_buffer, static_cast<size_t>(round(samples_per_frame)));
+            append_audio_impl(nullptr, static_cast<size_t>(round(samples_per_frame)));
         }
     }
 
     m_last_write_was_video = true;
 
-    auto buf = static_cast<uint8_t *>(malloc(m_params.width * m_params.height * 3));
-
-    // HACK: If we run out of memory, we start writing empty video frames
-    // This can happen when encoding at high resolutions, as ffmpeg might not start processing the pipe writes in time
-    if (!buf)
+    // Frames written into the buffer from acquire_video_buffer are already in place.
+    const auto slot = m_video_ring->acquire();
+    if (!slot)
     {
-        g_view_logger->error("[FFmpegEncoder] Out of memory, writing blank video frame");
-        ++m_dropped_frames;
-
-        {
-            std::lock_guard lock(m_video_queue_mutex);
-            m_video_queue.emplace(m_blank_buffer, false);
-        }
-        m_video_cv.notify_one();
-        return true;
+        return false;
     }
 
-    memcpy(buf, image, m_params.width * m_params.height * 3);
-
+    if (image != slot)
     {
-        std::lock_guard lock(m_video_queue_mutex);
-        m_video_queue.emplace(buf, true);
+        memcpy(slot, image, m_video_ring->slot_size());
     }
-    m_video_cv.notify_one();
+    m_video_ring->commit(m_video_ring->slot_size());
 
     return true;
 }
 
 bool FFmpegEncoder::append_audio(uint8_t *audio, size_t length, uint8_t)
 {
-    auto buf = static_cast<uint8_t *>(malloc(length));
-    memcpy(buf, audio, length);
-
-    return append_audio_impl(buf, length);
+    return append_audio_impl(audio, length);
 }
 
 void FFmpegEncoder::write_audio_thread()
 {
     g_view_logger->trace("[FFmpegEncoder] Audio thread ready");
 
-    while (!this->m_stop_thread)
+    while (const auto chunk = m_audio_ring->front())
     {
-        std::unique_lock lock(m_audio_queue_mutex);
-        m_audio_cv.wait(lock, [this] { return !m_audio_queue.empty() || m_stop_thread; });
-
-        if (this->m_audio_queue.empty()) continue;
-
-        auto tuple = this->m_audio_queue.front();
-        this->m_audio_queue.pop();
-        lock.unlock();
-
-        const auto buf = std::get<0>(tuple);
-        const auto len = std::get<1>(tuple);
-
-        write_pipe_checked(m_audio_pipe, (char *)buf, len, false);
-        if (buf != m_silence_buffer)
-        {
-            free(buf);
-        }
+        write_pipe_checked(m_audio_pipe, (const char *)chunk->data, chunk->size, false);
+        m_audio_ring->release();
     }
 }
 
@@ -235,21 +231,9 @@ void FFmpegEncoder::write_video_thread()
 {
     g_view_logger->trace("[FFmpegEncoder] Video thread ready");
 
-    while (!this->m_stop_thread)
+    while (const auto frame = m_video_ring->front())
     {
-        std::unique_lock lock(m_video_queue_mutex);
-        m_video_cv.wait(lock, [this] { return !m_video_queue.empty() || m_stop_thread; });
-
-        if (m_video_queue.empty()) continue;
-
-        auto pair = this->m_video_queue.front();
-        this->m_video_queue.pop();
-        lock.unlock();
-
-        write_pipe_checked(m_video_pipe, (char *)pair.first, m_params.width * m_params.height * 3, true);
-        if (pair.second)
-        {
-            free(pair.first);
-        }
+        write_pipe_checked(m_video_pipe, (const char *)frame->data, frame->size, true);
+        m_video_ring->release();
     }
 }
@@ -13,11 +13,12 @@ class FFmpegEncoder : public Encoder
   public:
     std::optional<std::wstring> start(Params params) override;
     bool stop() override;
+    uint8_t *acquire_video_buffer() override;
     bool append_video(uint8_t *image) override;
     bool append_audio(uint8_t *audio, size_t length, uint8_t bitrate) override;
 
   private:
-    bool append_audio_impl(uint8_t *audio, size_t length);
+    bool append_audio_impl(const uint8_t *audio, size_t length);
     void write_video_thread();
     void write_audio_thread();
 
@@ -28,20 +29,11 @@ class FFmpegEncoder : public Encoder
     HANDLE m_video_pipe{};
     HANDLE m_audio_pipe{};
 
-    uint8_t *m_silence_buffer{};
-    uint8_t *m_blank_buffer{};
-    size_t m_dropped_frames = 0;
-
-    bool m_stop_thread = false;
     bool m_last_write_was_video = false;
 
+    // Frames and samples are written into the rings once and read from them in place by the writer threads.
+    std::unique_ptr<CaptureRing::ring> m_video_ring;
+    std::unique_ptr<CaptureRing::ring> m_audio_ring;
     std::thread m_audio_thread;
-    std::mutex m_audio_queue_mutex{};
-    std::condition_variable m_audio_cv{};
-    std::queue<std::tuple<uint8_t *, size_t>> m_audio_queue;
-
     std::thread m_video_thread;
-    std::mutex m_video_queue_mutex{};
-    std::condition_variable m_video_cv{};
-    std::queue<std::pair<uint8_t *, bool>> m_video_queue;
 };
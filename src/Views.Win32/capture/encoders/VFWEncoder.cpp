@@ -9,7 +9,6 @@
 #include <DialogService.h>
 
 #include <capture/EncodingManager.h>
-#include <capture/Resampler.h>
 #include <capture/encoders/VFWEncoder.h>
 
 std::optional<std::wstring> VFWEncoder::start(Params params)
@@ -17,6 +16,7 @@ std::optional<std::wstring> VFWEncoder::start(Params params)
     if (!m_splitting)
     {
         m_params = params;
+        m_resampler.set_quality(g_config.capture_resampler_quality);
     }
     m_avi_file_size = 0;
     m_frame = 0;
@@ -281,12 +281,17 @@ bool VFWEncoder::write_sound(uint8_t *buf, int len, const int min_write_size, co
 
     if (sound_buf_pos + len > min_write_size || force)
     {
-        int len2 = Resampler::get_resample_len(RESAMPLED_FREQ, m_params.arate, bitrate, sound_buf_pos);
+        int len2 = AudioResampler::get_resample_len(RESAMPLED_FREQ, m_params.arate, bitrate, sound_buf_pos);
         if ((len2 % 8) == 0 || len > max_write_size)
         {
-            static short *buf2 = nullptr;
-            len2 = Resampler::resample(&buf2, RESAMPLED_FREQ, reinterpret_cast<short *>(m_sound_buf), m_params.arate,
-                                       bitrate, sound_buf_pos);
+            const auto samples =
+                m_resampler.process(m_sound_buf, sound_buf_pos, m_params.arate, RESAMPLED_FREQ, bitrate);
+            if (samples.empty() && sound_buf_pos > 0)
+            {
+                g_view_logger->error("[EncodingManager]: Can't resample {}-bit audio", bitrate);
+            }
+            const auto buf2 = const_cast<int16_t *>(samples.data());
+            len2 = static_cast<int>(samples.size_bytes());
 
             if (len2 > 0)
             {
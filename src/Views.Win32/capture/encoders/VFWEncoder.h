@@ -8,6 +8,7 @@
 
 #include "Encoder.h"
 
+#include <AudioResampler.h>
 #include <Vfw.h>
 
 class VFWEncoder final : public Encoder
@@ -32,6 +33,7 @@ class VFWEncoder final : public Encoder
 
     Params m_params{};
     AVICOMPRESSOPTIONS m_avi_options{};
+    AudioResampler::resampler m_resampler;
 
     bool m_splitting = false;
     size_t m_splits = 0;
@@ -7,13 +7,21 @@
 #include "stdafx.h"
 #include <nlohmann/json.hpp>
 #include <components/Benchmark.h>
+#include <Plugin.h>
 
 static size_t frames{};
+static bool rsp_profiling{};
 static std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
 
-void Benchmark::start()
+void Benchmark::start(bool rsp_profile)
 {
     start_time = std::chrono::high_resolution_clock::now();
+
+    rsp_profiling = rsp_profile && g_plugin_funcs.rsp_set_profiling;
+    if (rsp_profiling)
+    {
+        g_plugin_funcs.rsp_set_profiling(true);
+    }
 }
 
 void Benchmark::stop(t_result *result)
@@ -22,12 +30,40 @@ void Benchmark::stop(t_result *result)
     result->fps =
         (double)frames /
         ((double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_time).count() / 1000000000.0);
+
+    if (!rsp_profiling)
+    {
+        return;
+    }
+
+    g_plugin_funcs.rsp_set_profiling(false);
+    rsp_profiling = false;
+    if (g_plugin_funcs.rsp_get_profile)
+    {
+        // A task which was running when profiling stopped can still grow the profile, so it's read until it fits.
+        uint32_t size = g_plugin_funcs.rsp_get_profile(nullptr, 0);
+        while (true)
+        {
+            result->rsp_profile.resize(size);
+            const uint32_t required = g_plugin_funcs.rsp_get_profile(result->rsp_profile.data(), size);
+            if (required <= size)
+            {
+                result->rsp_profile.resize(std::max(required, 1u) - 1);
+                break;
+            }
+            size = required;
+        }
+    }
 }
 
 void Benchmark::save_result_to_file(const std::filesystem::path &path, const t_result &result)
 {
     nlohmann::json j;
     j["fps"] = result.fps;
+    if (!result.rsp_profile.empty())
+    {
+        j["rsp"] = nlohmann::json::parse(result.rsp_profile, nullptr, false);
+    }
 
     std::ofstream of(path);
     of << j.dump(4);
@@ -14,12 +14,20 @@ namespace Benchmark
 typedef struct
 {
     double fps;
+
+    /**
+     * \brief The RSP plugin's task profile as a JSON object, or empty if profiling wasn't requested or the plugin
+     * doesn't provide one.
+     */
+    std::string rsp_profile;
 } t_result;
 
 /**
  * \brief Starts a benchmark.
+ * \param rsp_profile Whether the RSP plugin should profile its tasks during the benchmark. The profiler's own overhead
+ * is included in the measured fps, so it should only be enabled when the profile is wanted.
  */
-void start();
+void start(bool rsp_profile = false);
 
 /**
  * \brief Stops the benchmark. Writes the result to the provided struct.
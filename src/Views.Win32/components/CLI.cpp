@@ -26,6 +26,7 @@ struct t_cli_params
     std::filesystem::path m64{};
     std::filesystem::path avi{};
     std::filesystem::path benchmark{};
+    bool benchmark_rsp_profile{};
     bool close_on_movie_end{};
     bool wait_for_debugger{};
 };
@@ -50,6 +51,7 @@ static void log_cli_params(const t_cli_params &params)
     g_view_logger->trace("  m64: {}", params.m64.string());
     g_view_logger->trace("  avi: {}", params.avi.string());
     g_view_logger->trace("  benchmark: {}", params.benchmark.string());
+    g_view_logger->trace("  benchmark_rsp_profile: {}", params.benchmark_rsp_profile);
     g_view_logger->trace("  close_on_movie_end: {}", params.close_on_movie_end);
     g_view_logger->trace("  wait_for_debugger: {}", params.wait_for_debugger);
 }
@@ -175,7 +177,7 @@ static void on_core_executing_changed(std::any data)
 
     if (!cli_params.benchmark.empty())
     {
-        Benchmark::start();
+        Benchmark::start(cli_params.benchmark_rsp_profile);
     }
 
     ThreadPool::submit_task([=] {
@@ -227,6 +229,7 @@ void CLI::init()
     cli_params.m64 = cmdl({"--movie", "-m64"}, "").str();
     cli_params.avi = cmdl({"--avi", "-avi"}, "").str();
     cli_params.benchmark = cmdl({"--benchmark", "-b"}, "").str();
+    cli_params.benchmark_rsp_profile = cmdl["--benchmark-rsp-profile"];
     cli_params.close_on_movie_end = cmdl["--close-on-movie-end"];
     cli_params.wait_for_debugger = cmdl["--wait-for-debugger"] || cmdl["--d"];
     bool compare_control = cmdl["--cmp-ctl"] || cmdl["--compare-control"];
@@ -878,6 +878,14 @@ std::vector<t_options_group> get_static_option_groups()
                    L"frame\nn - Render every nth frame",
         GENPROPS(int32_t, core.frame_skip_frequency),
     });
+    core_group.items.emplace_back(t_options_item{
+        .type = t_options_item::Type::Number,
+        .group_id = core_group.id,
+        .name = L"Seek Rendered Frames",
+        .tooltip = L"Amount of frames rendered before a seek finishes.\nEarlier frames of a seek skip rendering "
+                   L"entirely, except in games which depend on their frame buffer.",
+        GENPROPS(int32_t, core.seek_render_frames),
+    });
     core_group.items.emplace_back(t_options_item{
         .type = t_options_item::Type::Bool,
         .group_id = core_group.id,
@@ -890,15 +898,23 @@ std::vector<t_options_group> get_static_option_groups()
         .group_id = core_group.id,
         .name = L"Instant Savestate Update",
         .tooltip = L"Saves and loads game graphics to savestates to allow instant graphics updates when loading "
-                   L"savestates.\nGreatly increases savestate saving and loading time.",
+                   L"savestates.\nIncreases savestate size.",
         GENPROPS(int32_t, core.st_screenshot),
     });
+    core_group.items.emplace_back(t_options_item{
+        .type = t_options_item::Type::Bool,
+        .group_id = core_group.id,
+        .name = L"Savestate Previews",
+        .tooltip = L"Writes a thumbnail and metadata next to savestate files, so they can be previewed without being "
+                   L"loaded.\nThe preview is written in the background.",
+        GENPROPS(int32_t, core.st_preview),
+    });
     core_group.items.emplace_back(t_options_item{
         .type = t_options_item::Type::Number,
         .group_id = core_group.id,
         .name = L"ROM Cache Size",
         .tooltip = L"Size of the ROM cache.\nImproves ROM loading performance at the cost of data staleness and high "
-                   L"memory usage.\n0 - Disabled\nn - Maximum of n ROMs kept in cache",
+                   L"memory and disk usage.\n0 - Disabled\nn - Maximum of n ROMs kept in cache",
         GENPROPS(int32_t, core.rom_cache_size),
     });
 
@@ -919,6 +935,15 @@ std::vector<t_options_group> get_static_option_groups()
                    L"are set to 0.",
         GENPROPS(int32_t, core.vcr_write_extended_format),
     });
+    vcr_group.items.emplace_back(t_options_item{
+        .type = t_options_item::Type::Bool,
+        .group_id = vcr_group.id,
+        .name = L"State Digests",
+        .tooltip = L"Take a digest of the emulator state every VI while a movie is active.\nThe digests are saved next "
+                   L"to the movie and compared against when it's played back, revealing desyncs as soon as they "
+                   L"happen.",
+        GENPROPS(int32_t, core.vcr_state_digests),
+    });
     vcr_group.items.emplace_back(t_options_item{
         .type = t_options_item::Type::Bool,
         .group_id = vcr_group.id,
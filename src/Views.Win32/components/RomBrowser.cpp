@@ -12,6 +12,7 @@
 #include <components/Statusbar.h>
 #include <components/AppActions.h>
 #include <Messenger.h>
+#include <RomIndex.h>
 
 using t_rombrowser_entry = struct s_rombrowser_entry
 {
@@ -72,11 +73,36 @@ std::vector<std::wstring> find_available_roms()
             return false;
         }
         return MiscHelpers::iequals(c_extension, L".z64") || MiscHelpers::iequals(c_extension, L".n64") ||
-               MiscHelpers::iequals(c_extension, L".v64") || MiscHelpers::iequals(c_extension, L".rom");
+               MiscHelpers::iequals(c_extension, L".v64") || MiscHelpers::iequals(c_extension, L".rom") ||
+               MiscHelpers::iequals(c_extension, L".gz");
     });
     return filtered_rom_paths;
 }
 
+/**
+ * \brief Gets the headers of the available ROMs, only reading the ones which changed since the last call.
+ */
+std::vector<RomIndex::entry> index_available_roms()
+{
+    static RomIndex::index index(IOUtils::exe_path_cached().parent_path() / L"rom-index.bin");
+    static std::once_flag loaded;
+    std::call_once(loaded, [] { index.load(); });
+
+    const auto rom_paths = find_available_roms();
+    const auto read = index.update(std::vector<std::filesystem::path>(rom_paths.begin(), rom_paths.end()));
+    index.save();
+
+    g_view_logger->info("[Rombrowser] Indexed {} ROMs, read {} headers", rom_paths.size(), read);
+    return index.entries();
+}
+
+core_rom_header to_rom_header(const RomIndex::entry &entry)
+{
+    core_rom_header header{};
+    memcpy(&header, entry.header.data(), entry.header.size());
+    return header;
+}
+
 int CALLBACK rombrowser_compare(LPARAM lParam1, LPARAM lParam2, LPARAM _)
 {
     auto first = rombrowser_entries[g_config.rombrowser_sort_ascending ? lParam1 : lParam2];
@@ -239,37 +265,23 @@ void build_impl()
     }
     rombrowser_entries.clear();
 
-    auto rom_paths = find_available_roms();
+    const auto roms = index_available_roms();
 
     LV_ITEM lv_item = {0};
     lv_item.mask = LVIF_TEXT | LVIF_IMAGE | LVIF_PARAM;
     lv_item.pszText = LPSTR_TEXTCALLBACK;
 
     int32_t i = 0;
-    for (auto &path : rom_paths)
+    for (const auto &rom : roms)
     {
-        FILE *f = nullptr;
-        if (_wfopen_s(&f, path.c_str(), L"rb"))
-        {
-            g_view_logger->info(L"[Rombrowser] Failed to read file '{}'. Skipping!\n", path.c_str());
-            continue;
-        }
-
-        fseek(f, 0, SEEK_END);
-        const size_t len = ftell(f);
-        fseek(f, 0, SEEK_SET);
-
         auto rombrowser_entry = new t_rombrowser_entry;
-        rombrowser_entry->path = path;
-        rombrowser_entry->size = len;
+        rombrowser_entry->path = rom.path.wstring();
+        rombrowser_entry->size = rom.size;
         rombrowser_entry->rom_header = {};
 
-        if (len > sizeof(core_rom_header))
+        if (rom.valid)
         {
-            core_rom_header header{};
-            fread(&header, sizeof(core_rom_header), 1, f);
-
-            g_main_ctx.core_ctx->vr_byteswap((uint8_t *)&header);
+            core_rom_header header = to_rom_header(rom);
 
             MiscHelpers::strtrim((char *)header.nom, sizeof(header.nom));
 
@@ -285,8 +297,6 @@ void build_impl()
         lv_item.iImage = rombrowser_country_code_to_image_index(rombrowser_entry->rom_header.Country_code);
         ListView_InsertItem(rombrowser_hwnd, &lv_item);
 
-        fclose(f);
-
         rombrowser_entries.push_back(rombrowser_entry);
         i++;
     }
@@ -413,38 +423,12 @@ notify(LPARAM lparam)
 
 std::filesystem::path find_available_rom(const std::function<bool(const core_rom_header &)> &predicate)
 {
-    auto rom_paths = find_available_roms();
-    for (auto rom_path : rom_paths)
+    for (const auto &rom : index_available_roms())
     {
-        FILE *f = nullptr;
-        if (_wfopen_s(&f, rom_path.c_str(), L"rb"))
-        {
-            g_view_logger->info(L"[Rombrowser] Failed to read file '{}'. Skipping!\n", rom_path.c_str());
-            continue;
-        }
-
-        fseek(f, 0, SEEK_END);
-        uint64_t len = ftell(f);
-        fseek(f, 0, SEEK_SET);
-
-        if (len > sizeof(core_rom_header))
+        if (rom.valid && predicate(to_rom_header(rom)))
         {
-            auto header = (core_rom_header *)malloc(sizeof(core_rom_header));
-            fread(header, sizeof(core_rom_header), 1, f);
-
-            g_main_ctx.core_ctx->vr_byteswap((uint8_t *)header);
-
-            if (predicate(*header))
-            {
-                free(header);
-                fclose(f);
-                return rom_path;
-            }
-
-            free(header);
+            return rom.path;
         }
-
-        fclose(f);
     }
 
     return L"";
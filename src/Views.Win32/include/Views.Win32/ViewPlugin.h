@@ -80,6 +80,8 @@ extern "C"
     typedef void(CALL *KEYUP)(uint32_t wParam, int32_t lParam);
 
     typedef void(CALL *INITIATERSP)(core_rsp_info rsp_info, uint32_t *cycles);
+    typedef void(CALL *SETRSPPROFILING)(int32_t enabled);
+    typedef uint32_t(CALL *GETRSPPROFILE)(char *buffer, uint32_t size);
 
 #if defined(PLUGIN_WITH_CALLBACKS)
 
@@ -115,6 +117,11 @@ extern "C"
     EXPORT void CALL UpdateScreen(void);
     EXPORT void CALL ViStatusChanged(void);
     EXPORT void CALL ViWidthChanged(void);
+    /**
+     * Called before the display lists of a frame are processed, telling whether the frame will never be shown.
+     * Hidden frames may skip rasterization, but writes the game reads back from the frame buffer must be kept.
+     */
+    EXPORT void CALL SetFrameHidden(int32_t hidden);
     EXPORT void CALL mge_get_video_size(long *width, long *height);
     EXPORT void CALL mge_read_video(void **);
 
@@ -136,6 +143,11 @@ extern "C"
 
     EXPORT void CALL ControllerCommand(int32_t Control, uint8_t *Command);
     EXPORT void CALL GetKeys(int32_t Control, core_buttons *Keys);
+    /**
+     * Optional. Gets the state of all four controllers at once. The core calls it once per controller poll instead of
+     * calling GetKeys for every controller.
+     */
+    EXPORT void CALL GetAllKeys(core_buttons Keys[4]);
     EXPORT void CALL SetKeys(int32_t controller, core_buttons keys);
 #if defined(CORE_PLUGIN_INPUT_OLD_INITIATE_CONTROLLERS)
     EXPORT void CALL InitiateControllers(void *hwnd, core_controller controls[4]);
@@ -152,6 +164,20 @@ extern "C"
 
     EXPORT uint32_t DoRspCycles(uint32_t Cycles);
     EXPORT void InitiateRSP(core_rsp_info Rsp_Info, uint32_t *CycleCount);
+    /**
+     * Optional. Starts or stops recording task and audio command timings. Starting discards previous recordings.
+     */
+    EXPORT void CALL SetRspProfiling(int32_t enabled);
+    /**
+     * Optional. Writes the recorded timings as a null-terminated JSON object into the buffer, truncating it if needed.
+     * Returns the buffer size required to hold the whole object.
+     */
+    EXPORT uint32_t CALL GetRspProfile(char *buffer, uint32_t size);
+    /**
+     * Optional. Called after a DMA wrote to RDRAM, DMEM or IMEM, and after a savestate replaced them. The address is
+     * physical, so DMEM starts at 0x04000000 and IMEM at 0x04001000.
+     */
+    EXPORT void CALL DmaWritten(uint32_t address, uint32_t len);
 
 #pragma endregion
 
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <unistd.h>
+
+/**
+ * \brief Generates a bottom-up BGR24 image whose pixels are all distinct.
+ */
+static std::vector<uint8_t> make_image(const uint32_t width, const uint32_t height, const uint8_t seed)
+{
+    std::vector<uint8_t> buf(width * height * 3);
+    for (size_t i = 0; i < buf.size(); ++i)
+    {
+        buf[i] = static_cast<uint8_t>(i * 7 + seed);
+    }
+    return buf;
+}
+
+static std::string read_file(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator(file), std::istreambuf_iterator<char>()};
+}
+
+/**
+ * \brief Writes a stand-in for ffmpeg which copies its video input to the output path and its audio input next to it.
+ */
+static std::filesystem::path make_fake_ffmpeg(const std::filesystem::path &dir)
+{
+    const auto path = dir / "ffmpeg";
+    std::ofstream(path) << "#!/bin/sh\n"
+                           "for last; do :; done\n"
+                           "cat <&3 > \"$last.pcm\" &\n"
+                           "cat > \"$last\"\n"
+                           "wait\n";
+    std::filesystem::permissions(path, std::filesystem::perms::owner_all);
+    return path;
+}
+
+TEST_CASE("convert_bgr24_to_yuv444_flips_and_converts", "PipeEncoder")
+{
+    // Bottom row black, top row white and pure blue.
+    const uint8_t image[] = {0, 0, 0, 0, 0, 0, 255, 255, 255, 255, 0, 0};
+    uint8_t yuv[12];
+
+    PipeEncoder::convert_bgr24_to_yuv444(yuv, image, 2, 2);
+
+    const uint8_t expected[] = {
+        235, 41, 16, 16,    // Y
+        128, 240, 128, 128, // U
+        128, 110, 128, 128, // V
+    };
+    REQUIRE(memcmp(yuv, expected, sizeof(yuv)) == 0);
+}
+
+TEST_CASE("build_args_describe_both_inputs", "PipeEncoder")
+{
+    PipeEncoder::params params{.path = "out.mp4", .width = 320, .height = 240, .fps = 60, .arate = 32000};
+    params.output_args = {"-c:v", "ffv1"};
+
+    params.format = PipeEncoder::video_format::y4m;
+    REQUIRE(PipeEncoder::build_args(params) ==
+            std::vector<std::string>{"ffmpeg", "-y", "-hide_banner", "-f", "yuv4mpegpipe", "-i", "pipe:0", "-f",
+                                     "s16le", "-sample_rate", "32000", "-ac", "2", "-i", "pipe:3", "-c:v", "ffv1",
+                                     "out.mp4"});
+
+    params.format = PipeEncoder::video_format::bgr24;
+    const auto args = PipeEncoder::build_args(params);
+    REQUIRE(std::ranges::search(args, std::vector<std::string>{"-video_size", "320x240", "-framerate", "60"}));
+}
+
+TEST_CASE("encoder_streams_frames_and_samples", "PipeEncoder")
+{
+    const auto dir = std::filesystem::temp_directory_path() / std::format("pipe_encoder_tests_{}", getpid());
+    std::filesystem::create_directories(dir);
+
+    constexpr uint32_t width = 64;
+    constexpr uint32_t height = 48;
+
+    for (const auto format : {PipeEncoder::video_format::y4m, PipeEncoder::video_format::bgr24})
+    {
+        PipeEncoder::params params{.path = dir / "out", .width = width, .height = height, .fps = 30, .arate = 32000};
+        params.ffmpeg_path = make_fake_ffmpeg(dir);
+        params.format = format;
+
+        std::string expected_video;
+        std::string expected_audio;
+        if (format == PipeEncoder::video_format::y4m)
+        {
+            expected_video = "YUV4MPEG2 W64 H48 F30:1 Ip A1:1 C444\n";
+        }
+
+        PipeEncoder::encoder encoder;
+        REQUIRE_FALSE(encoder.start(params).has_value());
+
+        for (uint8_t i = 0; i < 20; ++i)
+        {
+            const auto image = make_image(width, height, i);
+
+            // Every other frame is read straight into the encoder's buffer.
+            if (i % 2)
+            {
+                const auto buf = encoder.acquire_video_buffer();
+                memcpy(buf, image.data(), image.size());
+                REQUIRE(encoder.append_video(buf));
+            }
+            else
+            {
+                REQUIRE(encoder.append_video(image.data()));
+            }
+
+            // The audio chunk sizes cover both batching and splitting across slots.
+            const auto audio = make_image(1, 1 + i * 700, i);
+            REQUIRE(encoder.append_audio(audio.data(), audio.size()));
+            expected_audio.append(audio.begin(), audio.end());
+
+            if (format == PipeEncoder::video_format::y4m)
+            {
+                std::vector<uint8_t> yuv(image.size());
+                PipeEncoder::convert_bgr24_to_yuv444(yuv.data(), image.data(), width, height);
+                expected_video += "FRAME\n";
+                expected_video.append(yuv.begin(), yuv.end());
+            }
+            else
+            {
+                for (uint32_t row = height; row-- > 0;)
+                {
+                    expected_video.append(image.begin() + row * width * 3, image.begin() + (row + 1) * width * 3);
+                }
+            }
+        }
+
+        REQUIRE(encoder.stop());
+        REQUIRE(encoder.video_stats().produced == 20);
+        REQUIRE(read_file(params.path) == expected_video);
+        REQUIRE(read_file(dir / "out.pcm") == expected_audio);
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("encoder_reports_missing_ffmpeg", "PipeEncoder")
+{
+    PipeEncoder::params params{.path = "out.mp4", .width = 8, .height = 8, .fps = 30, .arate = 32000};
+    params.ffmpeg_path = "/nonexistent/ffmpeg";
+
+    PipeEncoder::encoder encoder;
+    REQUIRE(encoder.start(params).has_value());
+    REQUIRE(encoder.stop());
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+TEST_CASE("ring_returns_slots_in_order", "CaptureRing")
+{
+    CaptureRing::ring ring(3, 100);
+
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        const auto slot = ring.acquire();
+        REQUIRE(slot != nullptr);
+        REQUIRE(reinterpret_cast<uintptr_t>(slot) % 64 == 0);
+        memset(slot, i, i + 1);
+        ring.commit(i + 1);
+
+        const auto view = ring.front();
+        REQUIRE(view.has_value());
+        REQUIRE(view->data == slot);
+        REQUIRE(view->size == i + 1u);
+        REQUIRE(view->data[i] == i);
+        ring.release();
+    }
+
+    const auto stats = ring.get_stats();
+    REQUIRE(stats.produced == 10);
+    REQUIRE(stats.consumed == 10);
+    REQUIRE(stats.stalls == 0);
+    REQUIRE(stats.high_water == 1);
+}
+
+TEST_CASE("ring_reports_full_and_closed", "CaptureRing")
+{
+    CaptureRing::ring ring(2, 16);
+
+    // An uncommitted slot is handed out again.
+    REQUIRE(ring.try_acquire() == ring.try_acquire());
+
+    ring.acquire();
+    ring.commit(1);
+    ring.acquire();
+    ring.commit(2);
+    REQUIRE(ring.try_acquire() == nullptr);
+    REQUIRE(ring.get_stats().high_water == 2);
+
+    ring.close();
+    REQUIRE(ring.acquire() == nullptr);
+
+    // Whatever was committed before closing is still delivered.
+    REQUIRE(ring.front()->size == 1);
+    ring.release();
+    REQUIRE(ring.try_front()->size == 2);
+    ring.release();
+    REQUIRE_FALSE(ring.try_front().has_value());
+    REQUIRE_FALSE(ring.front().has_value());
+}
+
+TEST_CASE("ring_transfers_between_threads", "CaptureRing")
+{
+    constexpr size_t COUNT = 20000;
+    CaptureRing::ring ring(4, sizeof(uint64_t));
+
+    std::thread consumer([&] {
+        uint64_t expected = 0;
+        while (const auto view = ring.front())
+        {
+            uint64_t value;
+            memcpy(&value, view->data, sizeof(value));
+            REQUIRE(value == expected++);
+            ring.release();
+        }
+        REQUIRE(expected == COUNT);
+    });
+
+    for (uint64_t i = 0; i < COUNT; ++i)
+    {
+        const auto slot = ring.acquire();
+        memcpy(slot, &i, sizeof(i));
+        ring.commit(sizeof(i));
+    }
+    ring.close();
+    consumer.join();
+
+    const auto stats = ring.get_stats();
+    REQUIRE(stats.produced == COUNT);
+    REQUIRE(stats.consumed == COUNT);
+    REQUIRE(stats.high_water <= 4);
+}
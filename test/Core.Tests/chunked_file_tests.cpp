@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+constexpr auto SMALL = ChunkedFile::make_id("SMAL");
+constexpr auto LARGE = ChunkedFile::make_id("LARG");
+constexpr auto EMPTY = ChunkedFile::make_id("EMPT");
+
+static std::vector<uint8_t> make_data(const size_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<uint8_t>(i / 64 + i % 3);
+    }
+    return data;
+}
+
+static std::vector<uint8_t> make_container()
+{
+    ChunkedFile::writer writer(7);
+    writer.add(SMALL, make_data(16), ChunkedFile::compression_method::none);
+    writer.add(LARGE, make_data(0x100000), ChunkedFile::compression_method::deflate);
+    writer.add(EMPTY, {}, ChunkedFile::compression_method::deflate);
+    return writer.finish();
+}
+
+TEST_CASE("sections_round_trip", "ChunkedFile")
+{
+    const auto container = make_container();
+    REQUIRE(ChunkedFile::is_container(container));
+    REQUIRE(container.size() < 0x100000 / 4);
+
+    ChunkedFile::reader reader;
+    REQUIRE(reader.open(container));
+    REQUIRE(reader.content_version() == 7);
+    REQUIRE(reader.sections().size() == 3);
+
+    std::vector<uint8_t> data;
+    REQUIRE(reader.read(LARGE, data));
+    REQUIRE(data == make_data(0x100000));
+    REQUIRE(reader.read(SMALL, data));
+    REQUIRE(data == make_data(16));
+    REQUIRE(reader.read(EMPTY, data));
+    REQUIRE(data.empty());
+
+    REQUIRE(!reader.find(ChunkedFile::make_id("NONE")));
+    REQUIRE(!reader.read(ChunkedFile::make_id("NONE"), data));
+
+    // Containers are deterministic, so they can be compared byte-wise.
+    REQUIRE(make_container() == container);
+}
+
+TEST_CASE("sections_are_read_from_files", "ChunkedFile")
+{
+    const auto dir = std::filesystem::temp_directory_path() / "mupen64-chunked-file-tests";
+    std::filesystem::create_directories(dir);
+    auto container = make_container();
+    REQUIRE(IOUtils::write_entire_file(dir / "a.bin", container));
+
+    ChunkedFile::reader reader;
+    REQUIRE(reader.open(dir / "a.bin"));
+    std::vector<uint8_t> data;
+    REQUIRE(reader.read(SMALL, data));
+    REQUIRE(data == make_data(16));
+    REQUIRE(reader.read(LARGE, data));
+    REQUIRE(data == make_data(0x100000));
+
+    REQUIRE(!reader.open(dir / "missing.bin"));
+}
+
+TEST_CASE("corruption_is_detected", "ChunkedFile")
+{
+    const auto container = make_container();
+    ChunkedFile::reader reader;
+
+    REQUIRE(!reader.open(std::span(container).first(20)));
+
+    // A damaged table of contents fails to open.
+    auto damaged_toc = container;
+    damaged_toc[sizeof(ChunkedFile::file_header) + 8] ^= 1;
+    REQUIRE(!reader.open(damaged_toc));
+
+    // A damaged section fails to read, while the others stay readable.
+    auto damaged_data = container;
+    REQUIRE(reader.open(container));
+    damaged_data[reader.find(SMALL)->offset] ^= 1;
+    REQUIRE(reader.open(damaged_data));
+
+    std::vector<uint8_t> data;
+    REQUIRE(!reader.read(SMALL, data));
+    REQUIRE(reader.read(LARGE, data));
+
+    // A truncated container only loses its last section.
+    auto truncated = container;
+    truncated.resize(truncated.size() - 1);
+    REQUIRE(reader.open(truncated));
+    REQUIRE(!reader.read(EMPTY, data));
+    REQUIRE(reader.read(LARGE, data));
+}
+
+TEST_CASE("corrupt_sizes_are_rejected", "ChunkedFile")
+{
+    // The table of contents claims huge sizes, but its checksum is fixed up so only the bounds checks can catch it.
+    auto container = make_container();
+    ChunkedFile::reader reader;
+    REQUIRE(reader.open(container));
+    const auto index_of = [&](const uint32_t id) {
+        return std::ranges::find(reader.sections(), id, &ChunkedFile::section_info::id) - reader.sections().begin();
+    };
+    const auto small = index_of(SMALL);
+    const auto empty = index_of(EMPTY);
+
+    const auto toc = container.data() + sizeof(ChunkedFile::file_header);
+    const auto sections = reinterpret_cast<ChunkedFile::section_info *>(toc);
+    sections[small].stored_size = ~0ull - 8;
+    sections[empty].size = 1ull << 40;
+    const auto header = reinterpret_cast<ChunkedFile::file_header *>(container.data());
+    header->toc_checksum = HashUtils::xxh64(toc, header->section_count * sizeof(ChunkedFile::section_info));
+
+    const auto dir = std::filesystem::temp_directory_path() / "mupen64-chunked-file-tests";
+    std::filesystem::create_directories(dir);
+    REQUIRE(IOUtils::write_entire_file(dir / "corrupt.bin", container));
+
+    for (const bool from_file : {false, true})
+    {
+        REQUIRE(from_file ? reader.open(dir / "corrupt.bin") : reader.open(container));
+
+        std::vector<uint8_t> data;
+        REQUIRE(!reader.find(SMALL));
+        REQUIRE(!reader.read(SMALL, data));
+        REQUIRE(!reader.read(EMPTY, data));
+        REQUIRE(reader.read(LARGE, data));
+        REQUIRE(data == make_data(0x100000));
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <Core/include/core_events.h>
+
+TEST_CASE("publish_reaches_every_subscriber", "core_event_bus")
+{
+    core_event_bus bus;
+    int32_t first = 0;
+    int32_t second = 0;
+
+    REQUIRE(!bus.has_subscribers(core_event::current_sample_changed));
+    bus.subscribe<core_event::current_sample_changed>(
+        [](void *user, int32_t value) { *static_cast<int32_t *>(user) = value; }, &first);
+    const auto id = bus.subscribe<core_event::current_sample_changed>(
+        [](void *user, int32_t value) { *static_cast<int32_t *>(user) = value * 2; }, &second);
+    REQUIRE(bus.has_subscribers(core_event::current_sample_changed));
+    REQUIRE(!bus.has_subscribers(core_event::vi));
+
+    bus.publish<core_event::current_sample_changed>(21);
+    REQUIRE(first == 21);
+    REQUIRE(second == 42);
+
+    bus.unsubscribe(id);
+    bus.publish<core_event::current_sample_changed>(5);
+    REQUIRE(first == 5);
+    REQUIRE(second == 42);
+
+    bus.clear();
+    REQUIRE(!bus.has_subscribers(core_event::current_sample_changed));
+    bus.publish<core_event::current_sample_changed>(7);
+    REQUIRE(first == 5);
+}
+
+TEST_CASE("handlers_can_modify_arguments", "core_event_bus")
+{
+    core_event_bus bus;
+    bus.subscribe<core_event::input>([](void *, core_buttons *input, int index) { input->value = 0x100 + index; });
+
+    core_buttons input{};
+    bus.publish<core_event::input>(&input, 3);
+    REQUIRE(input.value == 0x103);
+}
+
+TEST_CASE("batched_notifications_are_coalesced", "core_event_bus")
+{
+    core_event_bus bus;
+    std::vector<size_t> seen;
+    size_t notified = 0;
+
+    bus.set_batch_notifier([](void *user) { ++*static_cast<size_t *>(user); }, &notified);
+    bus.subscribe_batched<core_event::seek_savestate_changed>(
+        [](void *user, size_t value) { static_cast<std::vector<size_t> *>(user)->push_back(value); }, &seen);
+
+    // Values of a narrower type are converted to the event's argument type when queued.
+    bus.publish<core_event::seek_savestate_changed>(1);
+    bus.publish<core_event::seek_savestate_changed>(2);
+    bus.publish<core_event::seek_savestate_changed>(static_cast<size_t>(3) << 40);
+    REQUIRE(seen.empty());
+    REQUIRE(notified == 1);
+
+    bus.flush();
+    REQUIRE(seen == std::vector<size_t>{static_cast<size_t>(3) << 40});
+
+    bus.flush();
+    REQUIRE(seen.size() == 1);
+
+    bus.publish<core_event::seek_savestate_changed>(4);
+    REQUIRE(notified == 2);
+    bus.flush();
+    REQUIRE(seen.back() == 4);
+}
+
+TEST_CASE("unsubscribing_drops_pending_notifications", "core_event_bus")
+{
+    core_event_bus bus;
+    bool called = false;
+
+    const auto id =
+        bus.subscribe_batched<core_event::lag_limit_exceeded>([](void *user) { *static_cast<bool *>(user) = true; },
+                                                              &called);
+    bus.publish<core_event::lag_limit_exceeded>();
+    bus.unsubscribe(id);
+    bus.flush();
+    REQUIRE(!called);
+}
+
+TEST_CASE("batched_notifications_keep_the_latest_value", "core_event_bus")
+{
+    core_event_bus bus;
+    std::vector<size_t> seen;
+
+    bus.subscribe_batched<core_event::seek_savestate_changed>(
+        [](void *user, size_t value) { static_cast<std::vector<size_t> *>(user)->push_back(value); }, &seen);
+    bus.subscribe_batched<core_event::current_sample_changed>(
+        [](void *user, int32_t value) { static_cast<std::vector<size_t> *>(user)->push_back(value + 10000); }, &seen);
+
+    // Far more notifications than the queue holds, of which only the latest one of each subscription matters.
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        bus.publish<core_event::seek_savestate_changed>(i);
+        bus.publish<core_event::current_sample_changed>(static_cast<int32_t>(i));
+    }
+    bus.flush();
+
+    REQUIRE(seen == std::vector<size_t>{999, 10999});
+    REQUIRE(bus.batch_stats().pushed == 2);
+    REQUIRE(bus.batch_stats().dropped == 0);
+
+    bus.publish<core_event::seek_savestate_changed>(5);
+    bus.flush();
+    REQUIRE(seen.back() == 5);
+}
+
+TEST_CASE("replaced_subscriber_lists_are_freed", "core_event_bus")
+{
+    core_event_bus bus;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const auto id = bus.subscribe<core_event::vi>([](void *) {});
+        bus.unsubscribe(id);
+    }
+    REQUIRE(bus.list_count() == 1);
+
+    // A list being published from is kept until a later change, as the publisher may still be reading it.
+    struct context
+    {
+        core_event_bus *bus;
+        size_t calls;
+    } ctx{&bus, 0};
+    bus.subscribe<core_event::vi>(
+        [](void *user) {
+            const auto ctx = static_cast<context *>(user);
+            if (++ctx->calls == 1)
+            {
+                ctx->bus->subscribe<core_event::vi>([](void *) {});
+            }
+        },
+        &ctx);
+    bus.publish<core_event::vi>();
+    REQUIRE(bus.list_count() == 2);
+
+    bus.subscribe<core_event::reset>([](void *) {});
+    REQUIRE(bus.list_count() == 2);
+
+    bus.publish<core_event::vi>();
+    REQUIRE(ctx.calls == 2);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+/**
+ * \brief Generates a buffer filled with a deterministic byte pattern.
+ */
+static std::vector<uint8_t> make_pattern(const size_t len)
+{
+    std::vector<uint8_t> buf(len);
+    for (size_t i = 0; i < len; ++i)
+    {
+        buf[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return buf;
+}
+
+#pragma region Swaps
+
+TEST_CASE("swap16_swaps_halfword_bytes", "EndianUtils")
+{
+    // Odd lengths exercise the vector loop, the word tail and the trailing byte.
+    for (const size_t len : {0, 1, 2, 3, 7, 16, 31, 33, 64, 67})
+    {
+        const auto src = make_pattern(len);
+        std::vector<uint8_t> dst(len);
+        EndianUtils::swap16(dst.data(), src.data(), len);
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            const size_t expected = (i ^ 1) < len ? i ^ 1 : i;
+            REQUIRE(dst[i] == src[expected]);
+        }
+    }
+}
+
+TEST_CASE("swap32_reverses_word_bytes", "EndianUtils")
+{
+    for (const size_t len : {0, 3, 4, 15, 16, 32, 35, 100})
+    {
+        const auto src = make_pattern(len);
+        std::vector<uint8_t> dst(len);
+        EndianUtils::swap32(dst.data(), src.data(), len);
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            const size_t expected = (i | 3) < len ? i ^ 3 : i;
+            REQUIRE(dst[i] == src[expected]);
+        }
+    }
+}
+
+TEST_CASE("swap32_halves_swaps_word_halves", "EndianUtils")
+{
+    for (const size_t len : {0, 3, 4, 15, 16, 32, 35, 100})
+    {
+        const auto src = make_pattern(len);
+        std::vector<uint8_t> dst(len);
+        EndianUtils::swap32_halves(dst.data(), src.data(), len);
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            const size_t expected = (i | 3) < len ? i ^ 2 : i;
+            REQUIRE(dst[i] == src[expected]);
+        }
+    }
+}
+
+TEST_CASE("swap32_in_place_matches_out_of_place", "EndianUtils")
+{
+    auto buf = make_pattern(129);
+    std::vector<uint8_t> expected(buf.size());
+    EndianUtils::swap32(expected.data(), buf.data(), buf.size());
+
+    EndianUtils::swap32(buf.data(), buf.data(), buf.size());
+
+    REQUIRE(buf == expected);
+}
+
+TEST_CASE("v64_to_host_order_matches_two_step_conversion", "EndianUtils")
+{
+    const auto v64 = make_pattern(256);
+
+    std::vector<uint8_t> z64(v64.size());
+    std::vector<uint8_t> two_step(v64.size());
+    EndianUtils::swap16(z64.data(), v64.data(), v64.size());
+    EndianUtils::swap32(two_step.data(), z64.data(), z64.size());
+
+    std::vector<uint8_t> one_step(v64.size());
+    EndianUtils::swap32_halves(one_step.data(), v64.data(), v64.size());
+
+    REQUIRE(one_step == two_step);
+}
+
+#pragma endregion
+
+#pragma region XOR Copy
+
+TEST_CASE("xor_copy_matches_bytewise_copy", "EndianUtils")
+{
+    const auto src = make_pattern(256);
+
+    // Covers both matching and mismatching word offsets, as well as lengths which don't cover whole words.
+    for (size_t dst_addr = 0; dst_addr < 8; ++dst_addr)
+    {
+        for (size_t src_addr = 0; src_addr < 8; ++src_addr)
+        {
+            for (const size_t len : {0, 1, 3, 4, 5, 17, 64, 101})
+            {
+                std::vector<uint8_t> actual(256, 0xCC);
+                std::vector<uint8_t> expected(256, 0xCC);
+
+                EndianUtils::xor_copy(actual.data(), dst_addr, src.data(), src_addr, len);
+                for (size_t i = 0; i < len; ++i)
+                {
+                    expected[(dst_addr + i) ^ 3] = src[(src_addr + i) ^ 3];
+                }
+
+                REQUIRE(actual == expected);
+            }
+        }
+    }
+}
+
+#pragma endregion
+
+#pragma region Benchmarks
+
+TEST_CASE("endian_benchmarks", "[.][benchmark]")
+{
+    // Hidden from regular runs, use `Core.Tests [benchmark]` to run it. The buffers are the size of a large ROM.
+    const auto src = make_pattern(64 * 1024 * 1024);
+    std::vector<uint8_t> dst(src.size());
+
+    BENCHMARK("scalar swap32 64MB")
+    {
+        for (size_t i = 0; i < src.size(); i += 4)
+        {
+            uint32_t w;
+            memcpy(&w, src.data() + i, 4);
+            w = std::byteswap(w);
+            memcpy(dst.data() + i, &w, 4);
+        }
+        return dst[0];
+    };
+
+    BENCHMARK("swap32 64MB")
+    {
+        EndianUtils::swap32(dst.data(), src.data(), src.size());
+        return dst[0];
+    };
+
+    BENCHMARK("scalar xor copy 4KB")
+    {
+        for (size_t i = 0; i < 0x1000; ++i)
+        {
+            dst[i ^ 3] = src[(0x100 + i) ^ 3];
+        }
+        return dst[0];
+    };
+
+    BENCHMARK("xor_copy 4KB")
+    {
+        EndianUtils::xor_copy(dst.data(), 0, src.data(), 0x100, 0x1000);
+        return dst[0];
+    };
+}
+
+#pragma endregion
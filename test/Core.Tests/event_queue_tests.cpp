@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+TEST_CASE("queue_returns_records_in_order", "EventQueue")
+{
+    EventQueue::queue<uint32_t> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    uint32_t value;
+    REQUIRE(!queue.try_pop(value));
+
+    for (uint32_t round = 0; round < 3; ++round)
+    {
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            REQUIRE(queue.try_push(round * 10 + i));
+        }
+
+        // A full queue drops the record instead of waiting.
+        REQUIRE(!queue.try_push(99));
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            REQUIRE(queue.try_pop(value));
+            REQUIRE(value == round * 10 + i);
+        }
+        REQUIRE(!queue.try_pop(value));
+    }
+
+    const auto stats = queue.get_stats();
+    REQUIRE(stats.pushed == 12);
+    REQUIRE(stats.dropped == 3);
+}
+
+TEST_CASE("queue_delivers_records_from_concurrent_producers", "EventQueue")
+{
+    struct record
+    {
+        uint32_t producer;
+        uint32_t sequence;
+    };
+
+    constexpr uint32_t PRODUCERS = 4;
+    constexpr uint32_t RECORDS = 20000;
+
+    EventQueue::queue<record> queue(64);
+    std::atomic<uint32_t> done = 0;
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, p] {
+            for (uint32_t i = 0; i < RECORDS;)
+            {
+                if (queue.try_push({p, i}))
+                {
+                    ++i;
+                }
+            }
+            ++done;
+        });
+    }
+
+    // Every producer's records arrive complete and in the order they were pushed.
+    uint32_t next[PRODUCERS]{};
+    record r;
+    while (true)
+    {
+        const bool finished = done == PRODUCERS;
+        if (queue.try_pop(r))
+        {
+            REQUIRE(r.sequence == next[r.producer]);
+            ++next[r.producer];
+            continue;
+        }
+        if (finished)
+        {
+            break;
+        }
+    }
+
+    for (auto &thread : producers)
+    {
+        thread.join();
+    }
+
+    for (const auto n : next)
+    {
+        REQUIRE(n == RECORDS);
+    }
+    REQUIRE(queue.get_stats().pushed == PRODUCERS * RECORDS);
+}
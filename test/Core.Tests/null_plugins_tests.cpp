@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <Core/null_plugins.h>
+
+static core_cfg cfg{};
+static core_params params{};
+static core_ctx *ctx = nullptr;
+
+static void prepare_test(const uint32_t null_plugins)
+{
+    cfg = {};
+    params.cfg = &cfg;
+    params.null_plugins = null_plugins;
+    params.input_get_keys = nullptr;
+    params.input_get_all_keys = nullptr;
+    params.rsp_do_rsp_cycles = nullptr;
+    params.video_fb_read = [](uint32_t) {};
+    core_create(&params, &ctx);
+}
+
+TEST_CASE("null_plugins_replace_every_selected_plugin", "null_plugins")
+{
+    prepare_test(null_plugin_all);
+    null_plugins_install();
+
+    REQUIRE(params.video_process_dlist);
+    REQUIRE(params.audio_ai_len_changed);
+    REQUIRE(params.rsp_do_rsp_cycles(100) == 100);
+
+    // Frame buffer tracking is switched off entirely.
+    REQUIRE(params.video_fb_read == nullptr);
+
+    core_buttons keys[4];
+    std::ranges::fill(keys, core_buttons{0xFFFF});
+    params.input_get_keys(0, &keys[0]);
+    REQUIRE(keys[0].value == 0);
+    params.input_get_all_keys(keys);
+    REQUIRE(std::ranges::all_of(keys, [](const auto &k) { return k.value == 0; }));
+}
+
+TEST_CASE("null_plugins_leave_other_plugins_alone", "null_plugins")
+{
+    prepare_test(null_plugin_rsp);
+    null_plugins_install();
+
+    REQUIRE(null_plugin_active(null_plugin_rsp));
+    REQUIRE(!null_plugin_active(null_plugin_input));
+    REQUIRE(params.rsp_do_rsp_cycles);
+    REQUIRE(params.input_get_keys == nullptr);
+    REQUIRE(params.video_fb_read != nullptr);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <Core/memory/pif_lut.h>
+
+using block = std::array<uint8_t, CIC_CHALLENGE_SIZE>;
+
+static block to_block(const uint8_t *p)
+{
+    block b;
+    std::copy_n(p, b.size(), b.begin());
+    return b;
+}
+
+TEST_CASE("pif_lut_finds_known_challenges", "PIF")
+{
+    const block challenge = {0x00, 0x00, 0x40, 0x00, 0x10, 0x00, 0x04, 0x00,
+                             0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02};
+    const block response = {0xBF, 0x9F, 0xD3, 0x71, 0xC6, 0xEC, 0x62, 0xA8,
+                            0xCB, 0xF9, 0xF9, 0xF9, 0xF9, 0xF9, 0xF9, 0x00};
+
+    const uint8_t *found = pif_lut_find(challenge.data());
+    REQUIRE(found);
+    REQUIRE(to_block(found) == response);
+
+    // The table's response wins over the algorithm's where they differ.
+    const block quirk = {0xEC, 0x3C, 0xB6, 0x76, 0xB8, 0x1D, 0xBB, 0x8F,
+                         0x6B, 0x3A, 0x80, 0xEC, 0xED, 0xEA, 0x5B, 0x02};
+    REQUIRE(pif_lut_find(quirk.data())[6] == 0xB0);
+}
+
+TEST_CASE("pif_lut_rejects_unknown_challenges", "PIF")
+{
+    block challenge{};
+    challenge[15] = 0x02;
+    REQUIRE(pif_lut_find(challenge.data()) == nullptr);
+}
+
+TEST_CASE("cic_6105_solver_matches_table", "PIF")
+{
+    const block challenge = {0x01, 0x00, 0x40, 0x00, 0x10, 0x00, 0x04, 0x00,
+                             0x01, 0x00, 0x40, 0x00, 0x10, 0x00, 0x00, 0x02};
+
+    block response{};
+    REQUIRE(pif_cic_6105_solve(challenge.data(), response.data()));
+    REQUIRE(response == to_block(pif_lut_find(challenge.data())));
+
+    // Solving in place, as PIF RAM is.
+    block in_place = challenge;
+    REQUIRE(pif_cic_6105_solve(in_place.data(), in_place.data()));
+    REQUIRE(in_place == response);
+}
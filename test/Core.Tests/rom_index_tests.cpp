@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <RomIndex.h>
+
+/**
+ * \brief Creates an empty directory for the test's files.
+ */
+static std::filesystem::path make_test_directory(const std::string &name)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "mupen64-rom-index-tests" / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+/**
+ * \brief Generates a ROM image in the big-endian order.
+ */
+static std::vector<uint8_t> make_rom(const uint8_t seed)
+{
+    std::vector<uint8_t> rom(0x1000);
+    for (size_t i = 0; i < rom.size(); ++i)
+    {
+        rom[i] = static_cast<uint8_t>(i * 7 + seed);
+    }
+    rom[0] = 0x80;
+    rom[1] = 0x37;
+    rom[2] = 0x12;
+    rom[3] = 0x40;
+    return rom;
+}
+
+static RomIndex::header_bytes header_of(const std::vector<uint8_t> &rom)
+{
+    RomIndex::header_bytes header;
+    std::copy_n(rom.begin(), header.size(), header.begin());
+    return header;
+}
+
+TEST_CASE("read_header_converts_byte_orders", "RomIndex")
+{
+    const auto dir = make_test_directory("byte_orders");
+    auto rom = make_rom(1);
+
+    auto v64 = rom;
+    EndianUtils::swap16(v64.data(), rom.data(), rom.size());
+    auto n64 = rom;
+    EndianUtils::swap32(n64.data(), rom.data(), rom.size());
+
+    IOUtils::write_entire_file(dir / "a.z64", rom);
+    IOUtils::write_entire_file(dir / "a.v64", v64);
+    IOUtils::write_entire_file(dir / "a.n64", n64);
+
+    for (const auto name : {"a.z64", "a.v64", "a.n64"})
+    {
+        RomIndex::header_bytes header{};
+        REQUIRE(RomIndex::read_header(dir / name, header));
+        REQUIRE(header == header_of(rom));
+    }
+
+    std::vector<uint8_t> junk(0x100, 0x55);
+    IOUtils::write_entire_file(dir / "junk.z64", junk);
+    IOUtils::write_entire_file(dir / "short.z64", std::span(junk).first(0x10));
+
+    RomIndex::header_bytes header{};
+    REQUIRE(!RomIndex::read_header(dir / "junk.z64", header));
+    REQUIRE(!RomIndex::read_header(dir / "short.z64", header));
+    REQUIRE(!RomIndex::read_header(dir / "missing.z64", header));
+
+    // A matching first byte isn't enough for any byte order.
+    for (const uint8_t first : {0x80, 0x37, 0x40})
+    {
+        junk[0] = first;
+        IOUtils::write_entire_file(dir / "junk.z64", junk);
+        REQUIRE(!RomIndex::read_header(dir / "junk.z64", header));
+    }
+}
+
+TEST_CASE("update_only_reads_changed_files", "RomIndex")
+{
+    const auto dir = make_test_directory("update");
+    auto a = make_rom(1);
+    auto b = make_rom(2);
+    IOUtils::write_entire_file(dir / "a.z64", a);
+    IOUtils::write_entire_file(dir / "b.z64", b);
+
+    const std::vector paths = {dir / "a.z64", dir / "b.z64"};
+
+    RomIndex::index index(dir / "index.bin");
+    REQUIRE(index.update(paths) == 2);
+    REQUIRE(index.update(paths) == 0);
+
+    // A file of a different size is read again.
+    b.resize(0x2000);
+    b[0x40] ^= 0xFF;
+    IOUtils::write_entire_file(dir / "b.z64", b);
+    REQUIRE(index.update(paths) == 1);
+
+    const auto entries = index.entries();
+    REQUIRE(entries.size() == 2);
+    REQUIRE(entries[0].valid);
+    REQUIRE(entries[0].header == header_of(a));
+    REQUIRE(entries[1].size == 0x2000);
+
+    // Removed files leave the index.
+    REQUIRE(index.update({dir / "b.z64"}) == 0);
+    REQUIRE(index.entries().size() == 1);
+    REQUIRE(index.entries()[0].path == dir / "b.z64");
+}
+
+TEST_CASE("index_is_persisted", "RomIndex")
+{
+    const auto dir = make_test_directory("persisted");
+    std::vector<std::filesystem::path> paths;
+    for (uint8_t i = 0; i < 40; ++i)
+    {
+        paths.push_back(dir / std::format("{}.z64", i));
+        auto rom = make_rom(i);
+        IOUtils::write_entire_file(paths.back(), rom);
+    }
+    paths.push_back(dir / "missing.z64");
+
+    {
+        RomIndex::index index(dir / "index.bin");
+        REQUIRE(index.update(paths) == paths.size());
+        REQUIRE(index.save());
+    }
+
+    RomIndex::index index(dir / "index.bin");
+    index.load();
+    const auto entries = index.entries();
+    REQUIRE(entries.size() == paths.size());
+    for (uint8_t i = 0; i < 40; ++i)
+    {
+        REQUIRE(entries[i].path == paths[i]);
+        REQUIRE(entries[i].valid);
+        REQUIRE(entries[i].header == header_of(make_rom(i)));
+    }
+    REQUIRE(!entries.back().valid);
+
+    REQUIRE(index.update(paths) == 0);
+
+    // A corrupt index is ignored.
+    std::vector<uint8_t> corrupt(10, 0xFF);
+    IOUtils::write_entire_file(dir / "index.bin", corrupt);
+    index.load();
+    REQUIRE(index.entries().empty());
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <Core/memory/st_preview.h>
+
+static std::filesystem::path make_test_directory(const std::string &name)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "mupen64-st-preview-tests" / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+TEST_CASE("thumbnail_fits_the_maximum_size", "st_preview")
+{
+    constexpr int32_t width = 640;
+    constexpr int32_t height = 480;
+    std::vector<uint8_t> frame(width * height * 3);
+    for (int32_t y = 0; y < height; ++y)
+    {
+        for (int32_t x = 0; x < width; ++x)
+        {
+            // Alternating columns average out to the midpoint.
+            auto pixel = &frame[(y * width + x) * 3];
+            pixel[0] = x % 2 ? 200 : 100;
+            pixel[1] = static_cast<uint8_t>(y / 4);
+            pixel[2] = 7;
+        }
+    }
+
+    core_st_preview preview{};
+    st_preview_set_thumbnail(preview, frame.data(), width, height);
+    REQUIRE(preview.thumbnail_width == ST_THUMBNAIL_MAX_WIDTH);
+    REQUIRE(preview.thumbnail_height == ST_THUMBNAIL_MAX_HEIGHT);
+    REQUIRE(preview.thumbnail.size() == ST_THUMBNAIL_MAX_WIDTH * ST_THUMBNAIL_MAX_HEIGHT * 3);
+    REQUIRE(preview.thumbnail[0] == 150);
+    REQUIRE(preview.thumbnail[1] == 0);
+    REQUIRE(preview.thumbnail[2] == 7);
+    REQUIRE(preview.thumbnail[(10 * ST_THUMBNAIL_MAX_WIDTH) * 3 + 1] == 10);
+
+    // Small frames are kept as they are.
+    st_preview_set_thumbnail(preview, frame.data(), 100, 50);
+    REQUIRE(preview.thumbnail_width == 100);
+    REQUIRE(preview.thumbnail_height == 50);
+
+    st_preview_set_thumbnail(preview, nullptr, width, height);
+    REQUIRE(preview.thumbnail.empty());
+    REQUIRE(preview.thumbnail_width == 0);
+}
+
+TEST_CASE("preview_round_trips", "st_preview")
+{
+    const auto dir = make_test_directory("round_trip");
+    const auto st_path = dir / "a.st0";
+
+    core_st_preview preview{};
+    REQUIRE(!st_read_preview(st_path, preview));
+
+    preview = {
+        .total_frames = 123456,
+        .movie_uid = 42,
+        .movie_sample = 1000,
+        .movie_vi = 2000,
+        .timestamp = 1700000000,
+    };
+    std::vector<uint8_t> frame(320 * 240 * 3, 0x80);
+    st_preview_set_thumbnail(preview, frame.data(), 320, 240);
+    REQUIRE(st_preview_write(st_path, preview));
+    REQUIRE(std::filesystem::exists(st_preview_path(st_path)));
+
+    core_st_preview read{};
+    REQUIRE(st_read_preview(st_path, read));
+    REQUIRE(read.total_frames == 123456);
+    REQUIRE(read.movie_uid == 42);
+    REQUIRE(read.movie_sample == 1000);
+    REQUIRE(read.movie_vi == 2000);
+    REQUIRE(read.timestamp == 1700000000);
+    REQUIRE(read.thumbnail_width == 160);
+    REQUIRE(read.thumbnail_height == 120);
+    REQUIRE(read.thumbnail == preview.thumbnail);
+
+    // Previews without a thumbnail only hold the metadata.
+    preview.thumbnail.clear();
+    REQUIRE(st_preview_write(st_path, preview));
+    REQUIRE(st_read_preview(st_path, read));
+    REQUIRE(read.thumbnail.empty());
+    REQUIRE(read.thumbnail_width == 0);
+    REQUIRE(read.movie_uid == 42);
+
+    // Asynchronous writes land in the order they were requested.
+    for (uint32_t uid = 1; uid <= 3; ++uid)
+    {
+        st_preview_write_async(st_path, {.movie_uid = uid}, frame, 320, 240);
+    }
+    st_preview_wait();
+    REQUIRE(st_read_preview(st_path, read));
+    REQUIRE(read.movie_uid == 3);
+    REQUIRE(read.thumbnail_width == 160);
+}
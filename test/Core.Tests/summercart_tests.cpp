@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+#include <Core/Core.h>
+#include <Core/memory/summercart.h>
+
+constexpr uint32_t SECTORS = 64;
+
+static core_cfg cfg{};
+static core_params params{};
+static core_ctx *ctx = nullptr;
+static std::filesystem::path image_path;
+static std::vector<std::string> errors;
+
+static std::filesystem::path make_test_directory(const std::string &name)
+{
+    const auto dir = std::filesystem::temp_directory_path() / "mupen64-summercart-tests" / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+/**
+ * \brief Creates a zeroed fixed VHD image and points the core at it.
+ */
+static void prepare_test(const std::filesystem::path &dir)
+{
+    std::vector<uint8_t> image(SECTORS * 512 + 512);
+    const auto footer = image.data() + SECTORS * 512;
+    memcpy(footer, "conectix", 8);
+    const uint64_t disk_size = std::byteswap(static_cast<uint64_t>(SECTORS) * 512);
+    const uint32_t type = std::byteswap(2u);
+    memcpy(footer + 40, &disk_size, sizeof(disk_size));
+    memcpy(footer + 60, &type, sizeof(type));
+
+    image_path = dir / "card.vhd";
+    IOUtils::write_entire_file(image_path, image);
+
+    cfg = {};
+    params.cfg = &cfg;
+    params.get_summercart_path = [] { return image_path; };
+    params.show_dialog = [](const char *str, const char *, core_dialog_type) { errors.emplace_back(str); };
+    core_create(&params, &ctx);
+    errors.clear();
+
+    init_summercart();
+    write_summercart(0x10, 0x5F554E4C);
+    write_summercart(0x10, 0x4F434B5F);
+}
+
+static void write_sector(const uint32_t sector, const uint8_t value)
+{
+    memset(summercart.buffer, value, 512);
+    write_summercart(0x04, sector);
+    write_summercart(0x00, 'I');
+    write_summercart(0x04, 0x1ffe0000);
+    write_summercart(0x08, 1);
+    write_summercart(0x00, 'S');
+    REQUIRE(summercart.status == 0);
+}
+
+/**
+ * \brief Gets the first byte of a sector, as stored in the image file.
+ */
+static uint8_t sector_value(const uint32_t sector)
+{
+    std::ifstream file(image_path, std::ios::binary);
+    file.seekg(sector * 512);
+    return static_cast<uint8_t>(file.get());
+}
+
+/**
+ * \brief Makes the core map the image again, as it would in another session.
+ */
+static void remap_image(const std::string &alias)
+{
+    image_path = image_path.parent_path() / alias / ".." / image_path.filename();
+    std::filesystem::create_directories(image_path.parent_path());
+    init_summercart();
+}
+
+TEST_CASE("states_roll_back_writes_made_after_a_reset", "summercart")
+{
+    const auto dir = make_test_directory("reset");
+    prepare_test(dir);
+
+    write_sector(1, 0xAA);
+    save_summercart(dir / "state.vhd");
+
+    write_sector(1, 0xCC);
+    write_sector(2, 0xBB);
+
+    // Resets keep the baseline, so sector 2 is still known to have been zero.
+    init_summercart();
+    write_summercart(0x10, 0x5F554E4C);
+    write_summercart(0x10, 0x4F434B5F);
+    write_sector(3, 0xDD);
+
+    load_summercart(dir / "state.vhd");
+    REQUIRE(errors.empty());
+    REQUIRE(sector_value(1) == 0xAA);
+    REQUIRE(sector_value(2) == 0);
+    REQUIRE(sector_value(3) == 0);
+    REQUIRE(summercart.unlock);
+}
+
+TEST_CASE("states_are_restored_against_another_baseline", "summercart")
+{
+    const auto dir = make_test_directory("baseline");
+    prepare_test(dir);
+
+    write_sector(1, 0xAA);
+    save_summercart(dir / "state.vhd");
+    write_sector(2, 0xBB);
+
+    // The image is mapped again with sector 2 written, so the state's baseline is restored from its copy.
+    remap_image("a");
+    write_summercart(0x10, 0x5F554E4C);
+    write_summercart(0x10, 0x4F434B5F);
+    write_sector(4, 0xEE);
+
+    load_summercart(dir / "state.vhd");
+    REQUIRE(errors.empty());
+    REQUIRE(sector_value(1) == 0xAA);
+    REQUIRE(sector_value(2) == 0);
+    REQUIRE(sector_value(4) == 0);
+
+    // Without the copy, the state can't be restored and the image is left alone.
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+    {
+        if (entry.path().extension() == ".base")
+        {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    write_sector(5, 0x11);
+    remap_image("b");
+    load_summercart(dir / "state.vhd");
+    REQUIRE(errors.size() == 1);
+    REQUIRE(sector_value(5) == 0x11);
+}
+
+static size_t base_copy_count(const std::filesystem::path &dir)
+{
+    return std::ranges::count_if(std::filesystem::directory_iterator(dir),
+                                 [](const auto &entry) { return entry.path().extension() == ".base"; });
+}
+
+TEST_CASE("baselines_are_shared_and_deleted_once_unused", "summercart")
+{
+    const auto dir = make_test_directory("shared");
+    prepare_test(dir);
+
+    // States saved against the same baseline share its copy.
+    write_sector(1, 0xAA);
+    save_summercart(dir / "a.vhd");
+    save_summercart(dir / "b.vhd");
+    REQUIRE(base_copy_count(dir) == 1);
+
+    // Mapping the image again makes a new baseline, while b still needs the old one.
+    close_summercart();
+    init_summercart();
+    write_summercart(0x10, 0x5F554E4C);
+    write_summercart(0x10, 0x4F434B5F);
+    write_sector(2, 0xBB);
+    save_summercart(dir / "a.vhd");
+    REQUIRE(base_copy_count(dir) == 2);
+
+    std::filesystem::remove(dir / "b.vhd");
+    save_summercart(dir / "a.vhd");
+    REQUIRE(base_copy_count(dir) == 1);
+
+    load_summercart(dir / "a.vhd");
+    REQUIRE(errors.empty());
+    REQUIRE(sector_value(1) == 0xAA);
+    REQUIRE(sector_value(2) == 0xBB);
+}
+
+TEST_CASE("whole_image_states_still_load", "summercart")
+{
+    const auto dir = make_test_directory("legacy");
+    prepare_test(dir);
+    write_sector(1, 0xAA);
+
+    // The old format is the whole image, the cart registers and the VHD footer.
+    auto state = IOUtils::read_entire_file(image_path);
+    state.resize(SECTORS * 512);
+    std::fill_n(state.begin() + 512 * 2, 512, 0x77);
+    struct summercart registers{};
+    registers.sd_sector = 9;
+    MiscHelpers::vecwrite(state, &registers, sizeof(registers));
+    IOUtils::write_entire_file(dir / "state.vhd", state);
+
+    load_summercart(dir / "state.vhd");
+    REQUIRE(errors.empty());
+    REQUIRE(sector_value(1) == 0xAA);
+    REQUIRE(sector_value(2) == 0x77);
+    REQUIRE(summercart.sd_sector == 9);
+}
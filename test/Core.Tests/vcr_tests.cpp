@@ -25,6 +25,8 @@ static void prepare_test()
     // params.io_service = &io_helper_service;
     params.input_get_keys = [](int32_t, core_buttons *) {};
     params.input_set_keys = [](int32_t, core_buttons) {};
+    params.input_get_all_keys = nullptr;
+    params.events.clear();
 }
 
 /**
@@ -92,6 +94,31 @@ TEST_CASE("idle_task_returns_input_from_getkeys", "vcr_on_controller_poll")
     REQUIRE(input.value == INPUT_VALUE);
 }
 
+TEST_CASE("idle_task_returns_input_from_getallkeys", "vcr_on_controller_poll")
+{
+    prepare_test();
+
+    static size_t get_keys_calls;
+    get_keys_calls = 0;
+
+    params.input_get_keys = [](int32_t, core_buttons *) { ++get_keys_calls; };
+    params.input_get_all_keys = [](core_buttons *keys) {
+        for (int32_t i = 0; i < 4; ++i)
+        {
+            keys[i] = {static_cast<uint32_t>(0x100 + i)};
+        }
+    };
+    core_create(&params, &ctx);
+
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        core_buttons input{};
+        vcr_on_controller_poll(i, &input);
+        REQUIRE(input.value == 0x100 + i);
+    }
+    REQUIRE(get_keys_calls == 0);
+}
+
 TEST_CASE("playback_returns_correct_input", "vcr_on_controller_poll")
 {
     prepare_test();
@@ -273,7 +300,7 @@ TEST_CASE("input_callback_called_when_using_input_buffer_during_recording", "vcr
     prepare_test();
 
     static bool called = false;
-    params.callbacks.input = [](core_buttons *input, int index) { called = true; };
+    params.events.subscribe<core_event::input>([](void *, core_buttons *input, int index) { called = true; });
 
     const auto inputs = std::vector<core_buttons>{{1}, {2}, {3}, {4}};
 
@@ -321,7 +348,7 @@ TEST_CASE("input_callback_override_works_when_idle", "vcr_on_controller_poll")
 {
     prepare_test();
 
-    params.callbacks.input = [](core_buttons *input, int index) { *input = {0xDEAD}; };
+    params.events.subscribe<core_event::input>([](void *, core_buttons *input, int index) { *input = {0xDEAD}; });
 
     core_create(&params, &ctx);
     vcr.task = task_idle;
@@ -340,7 +367,7 @@ TEST_CASE("input_callback_override_works_when_recording", "vcr_on_controller_pol
 {
     prepare_test();
 
-    params.callbacks.input = [](core_buttons *input, int index) { *input = {0xDEAD}; };
+    params.events.subscribe<core_event::input>([](void *, core_buttons *input, int index) { *input = {0xDEAD}; });
 
     core_create(&params, &ctx);
     vcr.inputs = {};
@@ -363,7 +390,7 @@ TEST_CASE("input_callback_override_works_when_playback", "vcr_on_controller_poll
 {
     prepare_test();
 
-    params.callbacks.input = [](core_buttons *input, int index) { *input = {0xDEAD}; };
+    params.events.subscribe<core_event::input>([](void *, core_buttons *input, int index) { *input = {0xDEAD}; });
 
     core_create(&params, &ctx);
     vcr.inputs = {{1}, {2}, {3}, {4}};
@@ -386,7 +413,7 @@ TEST_CASE("correct_sample_appended_by_input_callback_override_during_recording",
 {
     prepare_test();
 
-    params.callbacks.input = [](core_buttons *input, int index) { *input = {0xDEAD}; };
+    params.events.subscribe<core_event::input>([](void *, core_buttons *input, int index) { *input = {0xDEAD}; });
 
     core_create(&params, &ctx);
     vcr.inputs = {{1}, {2}, {3}, {4}};
@@ -515,7 +542,8 @@ TEST_CASE("seek_stops_at_expected_frame", "seek")
     vcr = param.vcr;
 
     bool seek_completed = false;
-    params.callbacks.seek_completed = [&] { seek_completed = true; };
+    params.events.subscribe<core_event::seek_completed>([](void *user) { *static_cast<bool *>(user) = true; },
+                                                        &seek_completed);
     core_create(&params, &ctx);
 
     ctx->vr_start_rom = [](std::filesystem::path path) {
@@ -754,7 +782,8 @@ TEST_CASE("input_buffer_doesnt_change_if_seeking_while_recording", "vcr_unfreeze
 TEST_CASE("mutex_unlocked_during_input_callback_called_while_idle", "vcr_on_controller_poll")
 {
     prepare_test();
-    params.callbacks.input = [&](core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); };
+    params.events.subscribe<core_event::input>(
+        [](void *, core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); });
     core_create(&params, &ctx);
 
     core_buttons input{};
@@ -769,7 +798,8 @@ TEST_CASE("mutex_unlocked_during_input_callback_called_while_idle", "vcr_on_cont
 TEST_CASE("mutex_unlocked_during_input_callback_called_while_recording_1", "vcr_on_controller_poll")
 {
     prepare_test();
-    params.callbacks.input = [&](core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); };
+    params.events.subscribe<core_event::input>(
+        [](void *, core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); });
 
     const auto inputs = std::vector<core_buttons>{{1}, {2}, {3}, {4}};
 
@@ -793,7 +823,8 @@ TEST_CASE("mutex_unlocked_during_input_callback_called_while_recording_1", "vcr_
 TEST_CASE("mutex_unlocked_during_input_callback_called_while_recording_2", "vcr_on_controller_poll")
 {
     prepare_test();
-    params.callbacks.input = [&](core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); };
+    params.events.subscribe<core_event::input>(
+        [](void *, core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); });
 
     const auto inputs = std::vector<core_buttons>{{1}, {2}, {3}, {4}};
 
@@ -817,7 +848,8 @@ TEST_CASE("mutex_unlocked_during_input_callback_called_while_recording_2", "vcr_
 TEST_CASE("mutex_unlocked_during_input_callback_called_while_playback", "vcr_on_controller_poll")
 {
     prepare_test();
-    params.callbacks.input = [&](core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); };
+    params.events.subscribe<core_event::input>(
+        [](void *, core_buttons *input, int index) { REQUIRE(!is_vcr_lock_held()); });
 
     const auto inputs = std::vector<core_buttons>{{1}, {2}, {3}, {4}};
 
@@ -844,10 +876,12 @@ TEST_CASE("mutex_unlocked_during_emu_pause_changed_callback_called_while_playbac
     prepare_test();
 
     bool called{};
-    params.callbacks.emu_paused_changed = [&](const bool &) {
-        called = true;
-        REQUIRE(!is_vcr_lock_held());
-    };
+    params.events.subscribe<core_event::emu_paused_changed>(
+        [](void *user, bool) {
+            *static_cast<bool *>(user) = true;
+            REQUIRE(!is_vcr_lock_held());
+        },
+        &called);
 
     const auto inputs = std::vector<core_buttons>{{1}, {2}, {3}, {4}};
 
@@ -872,7 +906,7 @@ TEST_CASE("mutex_unlocked_during_emu_pause_changed_callback_called_while_playbac
 TEST_CASE("stopping_vcr_during_input_callback_while_recording_doesnt_do_recording_work", "vcr_on_controller_poll")
 {
     prepare_test();
-    params.callbacks.input = [&](core_buttons *input, int index) { vcr_stop_all(); };
+    params.events.subscribe<core_event::input>([](void *, core_buttons *input, int index) { vcr_stop_all(); });
 
     const auto inputs = std::vector<core_buttons>{{1}, {2}, {3}, {4}};
 
@@ -900,16 +934,20 @@ TEST_CASE("mutex_unlocked_during_callbacks_with_playback_task", "vcr_stop_all")
     prepare_test();
 
     bool task_changed_called = false;
-    params.callbacks.task_changed = [&](auto) {
-        task_changed_called = true;
-        REQUIRE(!is_vcr_lock_held());
-    };
+    params.events.subscribe<core_event::task_changed>(
+        [](void *user, core_vcr_task) {
+            *static_cast<bool *>(user) = true;
+            REQUIRE(!is_vcr_lock_held());
+        },
+        &task_changed_called);
 
     bool stop_movie_called = false;
-    params.callbacks.stop_movie = [&] {
-        stop_movie_called = true;
-        REQUIRE(!is_vcr_lock_held());
-    };
+    params.events.subscribe<core_event::stop_movie>(
+        [](void *user) {
+            *static_cast<bool *>(user) = true;
+            REQUIRE(!is_vcr_lock_held());
+        },
+        &stop_movie_called);
 
     core_create(&params, &ctx);
 
@@ -931,10 +969,12 @@ TEST_CASE("mutex_unlocked_during_emu_paused_changed_callback_when_seek_ends", "v
     prepare_test();
 
     bool called{};
-    params.callbacks.emu_paused_changed = [&](const bool &) {
-        called = true;
-        REQUIRE(!is_vcr_lock_held());
-    };
+    params.events.subscribe<core_event::emu_paused_changed>(
+        [](void *user, bool) {
+            *static_cast<bool *>(user) = true;
+            REQUIRE(!is_vcr_lock_held());
+        },
+        &called);
 
     core_create(&params, &ctx);
 
@@ -964,10 +1004,12 @@ TEST_CASE("mutex_unlocked_during_emu_paused_changed_callback", "vcr_on_vi")
     prepare_test();
 
     bool called{};
-    params.callbacks.emu_paused_changed = [&](const bool &) {
-        called = true;
-        REQUIRE(!is_vcr_lock_held());
-    };
+    params.events.subscribe<core_event::emu_paused_changed>(
+        [](void *user, bool) {
+            *static_cast<bool *>(user) = true;
+            REQUIRE(!is_vcr_lock_held());
+        },
+        &called);
 
     core_create(&params, &ctx);
 
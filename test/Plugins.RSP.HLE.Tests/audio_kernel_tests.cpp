@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+/**
+ * \brief Generates deterministic samples covering the full 16-bit range, including both extremes.
+ */
+static std::vector<int16_t> make_samples(const size_t len, const uint32_t seed)
+{
+    std::vector<int16_t> buf(len);
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < len; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = static_cast<int16_t>(x);
+    }
+    if (len > 1)
+    {
+        buf[0] = INT16_MIN;
+        buf[1] = INT16_MAX;
+    }
+    return buf;
+}
+
+#pragma region Mix
+
+TEST_CASE("mix_matches_reference", "AudioKernels")
+{
+    // Odd counts exercise the vector loop and the scalar tail.
+    for (const size_t count : {0, 1, 7, 8, 15, 16, 17, 33, 184, 0x170})
+    {
+        for (const int16_t gain : {INT16_MIN, -1, 0, 1, 0x4000, INT16_MAX})
+        {
+            const auto src = make_samples(count, 1);
+            auto actual = make_samples(count, 2);
+            auto expected = actual;
+
+            AudioKernels::mix(actual.data(), src.data(), gain, count);
+            AudioKernels::scalar::mix(expected.data(), src.data(), gain, count);
+
+            REQUIRE(actual == expected);
+        }
+    }
+}
+
+TEST_CASE("mix_handles_aliasing", "AudioKernels")
+{
+    for (const ptrdiff_t offset : {0, 1, 3, 8, -1, -9})
+    {
+        auto actual = make_samples(256, 3);
+        auto expected = actual;
+
+        AudioKernels::mix(actual.data() + 64, actual.data() + 64 + offset, 0x5a5a, 100);
+        AudioKernels::scalar::mix(expected.data() + 64, expected.data() + 64 + offset, 0x5a5a, 100);
+
+        REQUIRE(actual == expected);
+    }
+}
+
+#pragma endregion
+
+#pragma region Envmix
+
+TEST_CASE("envmix_matches_reference", "AudioKernels")
+{
+    for (const size_t streams : {2, 4})
+    {
+        for (const size_t count : {0, 1, 9, 16, 17, 0x170 / 2})
+        {
+            const auto src = make_samples(count, 4);
+
+            std::vector<int32_t> vols[4];
+            std::vector<int16_t> actual[4];
+            std::vector<int16_t> expected[4];
+            int16_t *actual_ptrs[4];
+            int16_t *expected_ptrs[4];
+            const int32_t *vol_ptrs[4];
+            for (size_t j = 0; j < 4; ++j)
+            {
+                vols[j].resize(count);
+                const auto v = make_samples(count, 10 + j);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    // Volumes are ramped towards 16-bit targets, so they can slightly exceed the 16-bit range.
+                    vols[j][i] = v[i] * 2 + (int32_t)(i & 1);
+                }
+                actual[j] = make_samples(count, 20 + j);
+                expected[j] = actual[j];
+                actual_ptrs[j] = actual[j].data();
+                expected_ptrs[j] = expected[j].data();
+                vol_ptrs[j] = vols[j].data();
+            }
+
+            AudioKernels::envmix(src.data(), actual_ptrs, vol_ptrs, streams, count);
+            AudioKernels::scalar::envmix(src.data(), expected_ptrs, vol_ptrs, streams, count);
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                REQUIRE(actual[j] == expected[j]);
+            }
+        }
+    }
+}
+
+TEST_CASE("envmix_handles_shared_destinations", "AudioKernels")
+{
+    // ABI 1 points the unused aux outputs at the same buffer, and a misbehaving alist may overlap them arbitrarily.
+    for (const ptrdiff_t offset : {0, 1, 8})
+    {
+        const size_t count = 40;
+        const auto src = make_samples(count, 5);
+        const auto vol = std::vector<int32_t>(count, 0x3456);
+        const int32_t *vols[4] = {vol.data(), vol.data(), vol.data(), vol.data()};
+
+        auto actual = make_samples(128, 6);
+        auto expected = actual;
+        int16_t *actual_ptrs[4] = {actual.data(), actual.data() + 64, actual.data() + offset,
+                                   actual.data() + 64 + offset};
+        int16_t *expected_ptrs[4] = {expected.data(), expected.data() + 64, expected.data() + offset,
+                                     expected.data() + 64 + offset};
+
+        AudioKernels::envmix(src.data(), actual_ptrs, vols, 4, count);
+        AudioKernels::scalar::envmix(src.data(), expected_ptrs, vols, 4, count);
+
+        REQUIRE(actual == expected);
+    }
+}
+
+#pragma endregion
+
+#pragma region Resample
+
+TEST_CASE("resample_matches_reference", "AudioKernels")
+{
+    const auto lut = reinterpret_cast<const int16_t *>(ResampleLUT);
+
+    for (const uint32_t pitch : {0x0, 0x1, 0x8000, 0xffff, 0x10000, 0x12345, 0x1fffe})
+    {
+        for (const uint32_t pos : {0x0, 0x3ff, 0xfc00, 0xffff})
+        {
+            for (const size_t count : {0, 1, 3, 4, 7, 8, 9, 0xb8})
+            {
+                const size_t len = ((pos + count * (uint64_t)pitch) >> 16) + 4;
+                const auto src = make_samples(len, pitch ^ pos);
+
+                std::vector<int16_t> actual(count);
+                std::vector<int16_t> expected(count);
+                const uint32_t actual_pos =
+                    AudioKernels::resample(actual.data(), src.data(), lut, pos, pitch, count);
+                const uint32_t expected_pos =
+                    AudioKernels::scalar::resample(expected.data(), src.data(), lut, pos, pitch, count);
+
+                REQUIRE(actual == expected);
+                REQUIRE(actual_pos == expected_pos);
+            }
+        }
+    }
+}
+
+/**
+ * \brief The per-sample resampler loop the microcode HLE started from.
+ */
+static void reference_resample(uint8_t *rdram, const uint8_t flags, const uint32_t pitch, const uint32_t addy,
+                               uint32_t src_ptr, uint32_t dst_ptr, const uint32_t count)
+{
+    const auto mem = reinterpret_cast<int16_t *>(BufferSpace);
+    const auto lut = reinterpret_cast<const int16_t *>(ResampleLUT);
+    uint32_t accum = 0;
+
+    src_ptr -= 4;
+    if ((flags & 0x1) == 0)
+    {
+        for (int x = 0; x < 4; x++) mem[(src_ptr + x) ^ 1] = ((int16_t *)rdram)[((addy / 2) + x) ^ 1];
+        accum = *(uint16_t *)(rdram + addy + 10);
+    }
+    else
+    {
+        for (int x = 0; x < 4; x++) mem[(src_ptr + x) ^ 1] = 0;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const int16_t *l = lut + (accum >> 10) * 4;
+        int32_t sum = (mem[(src_ptr + 0) ^ 1] * l[0]) >> 15;
+        sum += (mem[(src_ptr + 1) ^ 1] * l[1]) >> 15;
+        sum += (mem[(src_ptr + 2) ^ 1] * l[2]) >> 15;
+        sum += (mem[(src_ptr + 3) ^ 1] * l[3]) >> 15;
+
+        mem[dst_ptr ^ 1] = (int16_t)std::clamp(sum, -32768, 32767);
+        dst_ptr++;
+        accum += pitch;
+        src_ptr += (accum >> 16);
+        accum &= 0xffff;
+    }
+
+    for (int x = 0; x < 4; x++) ((int16_t *)rdram)[((addy / 2) + x) ^ 1] = mem[(src_ptr + x) ^ 1];
+    *(uint16_t *)(rdram + addy + 10) = (uint16_t)accum;
+}
+
+TEST_CASE("hle_resample_matches_reference_loop", "HLE")
+{
+    std::vector<uint8_t> rdram(0x1000);
+
+    struct params
+    {
+        uint8_t flags;
+        uint32_t pitch;
+        uint32_t src;
+        uint32_t dst;
+        uint32_t count;
+    };
+
+    // Covers odd buffer offsets, the state restore path and outputs which overwrite their own input.
+    for (const auto p : {
+             params{1, 0x10000, 0x100, 0x800, 0xb8},
+             params{0, 0x0c000, 0x101, 0x800, 0xb8},
+             params{0, 0x1fffe, 0x100, 0x1001, 0xb8},
+             params{1, 0x08000, 0x200, 0x1f0, 0x40},
+             params{0, 0x10000, 0x200, 0x200, 0x40},
+             params{1, 0x12345, 0x200, 0x210, 0x80},
+         })
+    {
+        const auto seed = make_samples(sizeof(BufferSpace) / 2, p.pitch);
+        const auto state = make_samples(rdram.size() / 2, p.src);
+
+        memcpy(BufferSpace, seed.data(), sizeof(BufferSpace));
+        memcpy(rdram.data(), state.data(), rdram.size());
+        reference_resample(rdram.data(), p.flags, p.pitch, 0x40, p.src, p.dst, p.count);
+        const std::vector<uint8_t> expected_mem(BufferSpace, BufferSpace + sizeof(BufferSpace));
+        const auto expected_rdram = rdram;
+
+        memcpy(BufferSpace, seed.data(), sizeof(BufferSpace));
+        memcpy(rdram.data(), state.data(), rdram.size());
+        rsp.rdram = rdram.data();
+        hle_resample(p.flags, p.pitch, 0x40, p.src, p.dst, p.count);
+        const std::vector<uint8_t> actual_mem(BufferSpace, BufferSpace + sizeof(BufferSpace));
+
+        REQUIRE(actual_mem == expected_mem);
+        REQUIRE(rdram == expected_rdram);
+    }
+}
+
+#pragma endregion
+
+#pragma region Dewindow
+
+TEST_CASE("dewindow_matches_reference", "AudioKernels")
+{
+    for (const size_t count : {0, 1, 7, 8, 15, 16, 17, 33})
+    {
+        for (const bool alternate : {false, true})
+        {
+            const auto src = make_samples(count, (uint32_t)count);
+            const auto win = make_samples(count, (uint32_t)count + 1);
+            const auto extremes = std::vector<int16_t>(count, INT16_MIN);
+
+            REQUIRE(AudioKernels::dewindow(src.data(), win.data(), count, alternate) ==
+                    AudioKernels::scalar::dewindow(src.data(), win.data(), count, alternate));
+            REQUIRE(AudioKernels::dewindow(extremes.data(), extremes.data(), count, alternate) ==
+                    AudioKernels::scalar::dewindow(extremes.data(), extremes.data(), count, alternate));
+        }
+    }
+}
+
+#pragma endregion
+
+#pragma region Benchmarks
+
+TEST_CASE("audio_kernel_benchmarks", "[.][benchmark]")
+{
+    // Hidden from regular runs, use `RSP.HLE.Tests [benchmark]` to run it. The sizes are those of a typical frame.
+    const auto src = make_samples(0x170, 7);
+    auto dst = make_samples(0x170, 8);
+    const auto lut = reinterpret_cast<const int16_t *>(ResampleLUT);
+
+    BENCHMARK("scalar mix")
+    {
+        AudioKernels::scalar::mix(dst.data(), src.data(), 0x4000, dst.size());
+        return dst[0];
+    };
+
+    BENCHMARK("mix")
+    {
+        AudioKernels::mix(dst.data(), src.data(), 0x4000, dst.size());
+        return dst[0];
+    };
+
+    BENCHMARK("scalar resample")
+    {
+        return AudioKernels::scalar::resample(dst.data(), src.data(), lut, 0, 0xc000, 0xb8);
+    };
+
+    BENCHMARK("resample")
+    {
+        return AudioKernels::resample(dst.data(), src.data(), lut, 0, 0xc000, 0xb8);
+    };
+}
+
+#pragma endregion
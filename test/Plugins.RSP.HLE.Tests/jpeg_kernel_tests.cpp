@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+using JpegKernels::BLOCK_SIZE;
+
+/**
+ * \brief Generates deterministic values covering the full 16-bit range, including both extremes.
+ */
+static std::vector<int16_t> make_values(const size_t len, const uint32_t seed)
+{
+    std::vector<int16_t> buf(len);
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < len; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[i] = static_cast<int16_t>(x);
+    }
+    buf[0] = INT16_MIN;
+    buf[1] = INT16_MAX;
+    return buf;
+}
+
+/**
+ * \brief Generates constants in the range the microcode's are in, so the values don't saturate right away.
+ */
+static std::vector<int16_t> make_constants(const uint32_t seed)
+{
+    auto c = make_values(32, seed);
+    for (auto &x : c)
+    {
+        x = static_cast<int16_t>(x >> 2);
+    }
+    return c;
+}
+
+TEST_CASE("dequantize_matches_reference", "JpegKernels")
+{
+    for (uint32_t seed = 0; seed < 16; ++seed)
+    {
+        const auto src = make_values(BLOCK_SIZE, seed);
+        const auto q = make_values(BLOCK_SIZE, seed + 100);
+        const int16_t scale = make_values(32, seed + 200)[2 + seed];
+
+        std::vector<int16_t> actual(BLOCK_SIZE);
+        std::vector<int16_t> expected(BLOCK_SIZE);
+        JpegKernels::dequantize(actual.data(), src.data(), q.data(), scale);
+        JpegKernels::scalar::dequantize(expected.data(), src.data(), q.data(), scale);
+        REQUIRE(actual == expected);
+
+        // In place.
+        auto in_place = src;
+        JpegKernels::dequantize(in_place.data(), in_place.data(), q.data(), scale);
+        REQUIRE(in_place == expected);
+    }
+}
+
+TEST_CASE("idct_matches_reference", "JpegKernels")
+{
+    for (uint32_t seed = 0; seed < 64; ++seed)
+    {
+        // Full-range constants cover the wraparound of the accumulators, scaled ones the usual case.
+        const auto src = make_values(BLOCK_SIZE, seed);
+        const auto c = seed & 1 ? make_values(32, seed + 100) : make_constants(seed + 100);
+
+        std::vector<int16_t> actual(BLOCK_SIZE);
+        std::vector<int16_t> expected(BLOCK_SIZE);
+        JpegKernels::idct(actual.data(), src.data(), c.data());
+        JpegKernels::scalar::idct(expected.data(), src.data(), c.data());
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("color_convert_matches_reference", "JpegKernels")
+{
+    for (uint32_t seed = 0; seed < 64; ++seed)
+    {
+        const auto blocks = make_values(6 * BLOCK_SIZE, seed);
+        const auto c = seed & 1 ? make_values(32, seed + 100) : make_constants(seed + 100);
+
+        std::vector<int16_t> actual(256);
+        std::vector<int16_t> expected(256);
+        JpegKernels::color_convert(actual.data(), blocks.data(), c.data());
+        JpegKernels::scalar::color_convert(expected.data(), blocks.data(), c.data());
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("jpeg_kernel_benchmarks", "[.][benchmark]")
+{
+    // Hidden from regular runs, use `RSP.HLE.Tests [benchmark]` to run it.
+    const auto blocks = make_values(6 * BLOCK_SIZE, 1);
+    const auto c = make_constants(2);
+    std::vector<int16_t> dst(6 * BLOCK_SIZE);
+
+    BENCHMARK("scalar idct")
+    {
+        for (size_t i = 0; i < 6; ++i)
+        {
+            JpegKernels::scalar::idct(dst.data() + i * BLOCK_SIZE, blocks.data() + i * BLOCK_SIZE, c.data());
+        }
+        return dst[0];
+    };
+
+    BENCHMARK("idct")
+    {
+        for (size_t i = 0; i < 6; ++i)
+        {
+            JpegKernels::idct(dst.data() + i * BLOCK_SIZE, blocks.data() + i * BLOCK_SIZE, c.data());
+        }
+        return dst[0];
+    };
+
+    BENCHMARK("scalar color_convert")
+    {
+        JpegKernels::scalar::color_convert(dst.data(), blocks.data(), c.data());
+        return dst[0];
+    };
+
+    BENCHMARK("color_convert")
+    {
+        JpegKernels::color_convert(dst.data(), blocks.data(), c.data());
+        return dst[0];
+    };
+}
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <CommonPCH.h>
+#include <catch2/catch_all.hpp>
+#include <HLE.h>
+#include <AudioKernels.h>
+#include <JpegKernels.h>
+#include <TaskProfiler.h>
+#include <UcodeCache.h>
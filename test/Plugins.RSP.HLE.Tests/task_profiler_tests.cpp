@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+static std::vector<uint32_t> seen_inst2;
+
+static void record_inst2(uint32_t, const uint32_t inst2)
+{
+    seen_inst2.push_back(inst2);
+}
+
+TEST_CASE("histogram_buckets_are_powers_of_two", "TaskProfiler")
+{
+    using TaskProfiler::histogram;
+
+    REQUIRE(histogram::bucket_of(0) == 0);
+    REQUIRE(histogram::bucket_of(255) == 0);
+    REQUIRE(histogram::bucket_of(256) == 1);
+    REQUIRE(histogram::bucket_of(511) == 1);
+    REQUIRE(histogram::bucket_of(512) == 2);
+    REQUIRE(histogram::bucket_of(UINT64_MAX) == histogram::BUCKET_COUNT - 1);
+
+    for (size_t i = 0; i + 1 < histogram::BUCKET_COUNT; ++i)
+    {
+        REQUIRE(histogram::bucket_of(histogram::bucket_limit(i) - 1) == i);
+        REQUIRE(histogram::bucket_of(histogram::bucket_limit(i)) == i + 1);
+    }
+
+    histogram h;
+    h.add(100);
+    h.add(300);
+    h.add(1000);
+    REQUIRE(h.count == 3);
+    REQUIRE(h.total_ns == 1400);
+    REQUIRE(h.min_ns == 100);
+    REQUIRE(h.max_ns == 1000);
+    REQUIRE(h.buckets[0] == 1);
+    REQUIRE(h.buckets[1] == 1);
+    REQUIRE(h.buckets[2] == 1);
+}
+
+TEST_CASE("profiler_records_tasks_by_kind_and_ucode", "TaskProfiler")
+{
+    TaskProfiler::profiler profiler;
+    profiler.set_enabled(true);
+
+    profiler.record_task(TaskProfiler::task_kind::graphics, 0, 1000);
+    profiler.record_task(TaskProfiler::task_kind::audio, 0x1234, 300);
+    profiler.record_task(TaskProfiler::task_kind::jpeg, 0x2E4FC, 5000);
+
+    const auto json = profiler.to_json();
+    REQUIRE(json.starts_with(R"({"tasks":{"graphics":{"count":1,"total_ns":1000,"min_ns":1000,"max_ns":1000,)"
+                             R"("buckets":[[1024,1]]},"audio":{"count":1,)"));
+    REQUIRE(json.contains(R"("unknown":{"count":0,"total_ns":0,"min_ns":0,"max_ns":0,"buckets":[]})"));
+    REQUIRE(json.contains(R"("ucodes":{"0x1234":{"count":1,)"));
+    REQUIRE(json.contains(R"("0x2E4FC":{"count":1,)"));
+    REQUIRE(json.ends_with(R"("commands":{}})"));
+
+    // Re-enabling starts a new session.
+    profiler.set_enabled(false);
+    profiler.set_enabled(true);
+    REQUIRE(profiler.to_json().contains(R"("ucodes":{})"));
+}
+
+TEST_CASE("profiler_runs_and_times_every_command", "TaskProfiler")
+{
+    std::array<hle_alist_handler, 0x20> table{};
+    table[0x02] = record_inst2;
+    table[0x0F] = record_inst2;
+    const std::vector<uint32_t> alist = {0x02000000, 1, 0x0F000000, 2, 0x02000000, 3};
+
+    seen_inst2.clear();
+    TaskProfiler::profiler profiler;
+    profiler.run(1, table.data(), alist.data(), alist.size());
+
+    // The commands run exactly as with hle_run_alist.
+    REQUIRE(seen_inst2 == std::vector<uint32_t>{1, 2, 3});
+
+    const auto json = profiler.to_json();
+    REQUIRE(json.contains(R"("commands":{"abi1":{"0x02":{"count":2,)"));
+    REQUIRE(json.contains(R"("0x0F":{"count":1,)"));
+}
+
+TEST_CASE("task_scope_records_only_while_enabled", "TaskProfiler")
+{
+    TaskProfiler::profiler profiler;
+
+    {
+        TaskProfiler::task_scope scope(profiler);
+        scope.kind = TaskProfiler::task_kind::boot;
+    }
+    REQUIRE(profiler.to_json().contains(R"("boot":{"count":0,)"));
+
+    profiler.set_enabled(true);
+    {
+        TaskProfiler::task_scope scope(profiler);
+        scope.kind = TaskProfiler::task_kind::boot;
+        scope.ucode = 0x9E2;
+    }
+    REQUIRE(profiler.to_json().contains(R"("boot":{"count":1,)"));
+    REQUIRE(profiler.to_json().contains(R"("ucodes":{"0x9E2":{"count":1,)"));
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+static size_t identify_calls = 0;
+
+static bool handle_task(OSTask_t *)
+{
+    return true;
+}
+
+static UcodeCache::ucode identify(const OSTask_t *task, const uint32_t sum)
+{
+    ++identify_calls;
+    return {sum, task->type == 4 ? TaskProfiler::task_kind::jpeg : TaskProfiler::task_kind::audio, handle_task};
+}
+
+static OSTask_t make_task(const uint32_t type, const uint32_t ucode, const uint32_t size, const uint32_t data = 0)
+{
+    OSTask_t task{};
+    task.type = type;
+    task.ucode = ucode;
+    task.ucode_size = size;
+    task.data_ptr = data;
+    return task;
+}
+
+TEST_CASE("checksum_sums_bytes", "UcodeCache")
+{
+    const std::vector<uint8_t> code = {0x01, 0xFF, 0x80, 0x00, 0x7F};
+    REQUIRE(UcodeCache::checksum(code.data(), code.size()) == 0x1FF);
+    REQUIRE(UcodeCache::checksum(code.data(), 0) == 0);
+}
+
+TEST_CASE("cache_identifies_each_ucode_once", "UcodeCache")
+{
+    std::vector<uint8_t> code(0x800, 0x12);
+    auto task = make_task(2, 0x1000, 0x1000);
+    UcodeCache::cache cache;
+    identify_calls = 0;
+
+    const auto &first = cache.get(&task, task.ucode, code.data(), code.size(), identify);
+    REQUIRE(first.sum == 0x12 * 0x800);
+    REQUIRE(first.kind == TaskProfiler::task_kind::audio);
+    REQUIRE(first.handler == handle_task);
+
+    cache.get(&task, task.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 1);
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 1);
+
+    // The same bytes at another address, of another task type or with other data are identified separately.
+    auto moved = make_task(2, 0x2000, 0x1000);
+    cache.get(&moved, moved.ucode, code.data(), code.size(), identify);
+    auto jpeg = make_task(4, 0x1000, 0x1000);
+    REQUIRE(cache.get(&jpeg, jpeg.ucode, code.data(), code.size(), identify).kind == TaskProfiler::task_kind::jpeg);
+    auto other_data = make_task(2, 0x1000, 0x1000, 0x8000);
+    cache.get(&other_data, other_data.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 4);
+}
+
+TEST_CASE("cache_reidentifies_overwritten_ucode", "UcodeCache")
+{
+    std::vector<uint8_t> code(0x800, 0x12);
+    auto task = make_task(2, 0x1000, 0x1000);
+    UcodeCache::cache cache;
+    identify_calls = 0;
+
+    // Bytes changed without a DMA, e.g. by the CPU, are noticed by their digest.
+    cache.get(&task, task.ucode, code.data(), code.size(), identify);
+    code[0x7FF] = 0x13;
+    REQUIRE(cache.get(&task, task.ucode, code.data(), code.size(), identify).sum == 0x12 * 0x800 + 1);
+    REQUIRE(identify_calls == 2);
+    cache.get(&task, task.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 2);
+}
+
+TEST_CASE("cache_reidentifies_ucode_written_by_dma", "UcodeCache")
+{
+    std::vector<uint8_t> code(0x800, 0x12);
+    auto task = make_task(2, 0x1000, 0x1000);
+    UcodeCache::cache cache;
+    identify_calls = 0;
+
+    cache.get(&task, task.ucode, code.data(), code.size(), identify);
+
+    // Writes outside the bytes the checksum was computed over keep the entry.
+    cache.invalidate(0x1800, 0x100);
+    cache.invalidate(0, 0x1000);
+    cache.get(&task, task.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 1);
+
+    cache.invalidate(0x17FF, 1);
+    cache.get(&task, task.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 2);
+
+    // Tasks identified by IMEM are dropped by writes to IMEM.
+    auto oversized = make_task(2, 0x3000, 0x2000);
+    cache.get(&oversized, 0x04001000, code.data(), code.size(), identify);
+    cache.invalidate(0x04000FC0, 0x40);
+    cache.get(&oversized, 0x04001000, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 3);
+    cache.invalidate(0x04001000, 0xD0);
+    cache.get(&oversized, 0x04001000, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 4);
+}
+
+TEST_CASE("cache_evicts_least_recently_used", "UcodeCache")
+{
+    const std::vector<uint8_t> code(0x10, 0x01);
+    UcodeCache::cache cache(2);
+    identify_calls = 0;
+
+    auto a = make_task(2, 0x1000, 0x20);
+    auto b = make_task(2, 0x2000, 0x20);
+    auto c = make_task(2, 0x3000, 0x20);
+    cache.get(&a, a.ucode, code.data(), code.size(), identify);
+    cache.get(&b, b.ucode, code.data(), code.size(), identify);
+    cache.get(&a, a.ucode, code.data(), code.size(), identify);
+    cache.get(&c, c.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 3);
+
+    cache.get(&a, a.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 3);
+    cache.get(&b, b.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 4);
+
+    cache.clear();
+    cache.get(&a, a.ucode, code.data(), code.size(), identify);
+    REQUIRE(identify_calls == 5);
+}
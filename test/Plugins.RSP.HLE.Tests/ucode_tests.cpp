@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2025, Mupen64 maintainers, contributors, and original authors (Hacktarux, ShadowPrince, linker).
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "stdafx.h"
+
+/*
+ * Golden-output tests for the microcode HLE.
+ *
+ * Every task is replayed from a clean state against a deterministic RDRAM image, and the digest of RDRAM and the sample
+ * buffer afterwards is compared against the one recorded when the test was written. A mismatch means the output
+ * changed, so the digest must only be updated when the change in output is intended.
+ *
+ * The command lists follow the frames the games' audio libraries emit: each voice decodes, resamples and mixes its
+ * samples, then the mix is interleaved and saved. Later frames continue from the state the earlier ones saved.
+ */
+
+constexpr uint32_t RDRAM_SIZE = 0x40000;
+
+// RDRAM layout shared by the tasks.
+constexpr uint32_t CODEBOOK_ADDR = 0x1000;
+constexpr uint32_t LOOP_ADDR = 0x1200;
+constexpr uint32_t SAMPLES_ADDR = 0x2000;
+constexpr uint32_t STATE_ADDR = 0x8000;
+constexpr uint32_t OUTPUT_ADDR = 0x10000;
+constexpr uint32_t MP3_ADDR = 0x20000;
+constexpr uint32_t JPEG_ADDR = 0x30000;
+
+constexpr size_t FRAMES = 4;
+
+/**
+ * \brief An audio task along with the digest of the outputs recorded for it.
+ */
+struct audio_task
+{
+    const char *name;
+    hle_alist_handler *abi;
+    std::vector<uint32_t> alist;
+    uint64_t digest;
+};
+
+/**
+ * \brief Encodes an audio command.
+ */
+static void cmd(std::vector<uint32_t> &alist, const uint32_t op, const uint32_t w1, const uint32_t w2)
+{
+    alist.push_back(op << 24 | (w1 & 0xFFFFFF));
+    alist.push_back(w2);
+}
+
+static uint32_t xorshift(uint32_t &x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/**
+ * \brief Builds the RDRAM image the tasks read from.
+ */
+static std::vector<uint8_t> make_rdram()
+{
+    std::vector<uint8_t> rdram(RDRAM_SIZE);
+    uint32_t x = 0x2545F491;
+    for (size_t i = 0; i < rdram.size(); i += 4)
+    {
+        const uint32_t w = xorshift(x);
+        memcpy(rdram.data() + i, &w, sizeof(w));
+    }
+
+    // Keep the codebook in a range which doesn't saturate every sample.
+    const auto book = reinterpret_cast<int16_t *>(rdram.data() + CODEBOOK_ADDR);
+    for (size_t i = 0; i < 0x80; ++i)
+    {
+        book[i] = static_cast<int16_t>(static_cast<int16_t>(xorshift(x)) >> 3);
+    }
+
+    // Every ADPCM frame starts with a header selecting the scale and predictor, which must stay within the codebook.
+    for (uint32_t frame = 0; frame < 0x100; ++frame)
+    {
+        for (const uint32_t size : {9u, 5u})
+        {
+            const uint32_t addr = SAMPLES_ADDR + (size == 9 ? 0 : 0x2000) + frame * size;
+            rdram[addr ^ 3] = static_cast<uint8_t>((xorshift(x) % 12) << 4 | (xorshift(x) & 7));
+        }
+    }
+
+    // The MP3 and JPEG microcodes expect coefficients which don't overflow their intermediates.
+    const auto mp3 = reinterpret_cast<int16_t *>(rdram.data() + MP3_ADDR);
+    for (size_t i = 0; i < 0x1400 / 2; ++i)
+    {
+        mp3[i] = static_cast<int16_t>(static_cast<int16_t>(xorshift(x)) >> 4);
+    }
+
+    const auto jpeg = reinterpret_cast<int16_t *>(rdram.data() + JPEG_ADDR + 0x100);
+    for (size_t i = 0; i < 0x1000 / 2; ++i)
+    {
+        jpeg[i] = static_cast<int16_t>(static_cast<int16_t>(xorshift(x)) >> 3);
+    }
+
+    return rdram;
+}
+
+#pragma region Tasks
+
+static audio_task make_abi1_task()
+{
+    audio_task task{"ABI1", ABI1};
+    auto &a = task.alist;
+
+    cmd(a, 0x0B, 0x80, CODEBOOK_ADDR);             // LOADADPCM
+    cmd(a, 0x0F, 0, LOOP_ADDR);                    // SETLOOP
+    cmd(a, 0x09, 0x06 << 16 | 0x6000, 0);          // SETVOL left start
+    cmd(a, 0x09, 0x04 << 16 | 0x4000, 0);          // SETVOL right start
+    cmd(a, 0x09, 0x02 << 16 | 0x7000, 0x00011000); // SETVOL left target and ramp
+    cmd(a, 0x09, 0x00 << 16 | 0x2000, 0x0000F000); // SETVOL right target and ramp
+    cmd(a, 0x09, 0x08 << 16 | 0x7FFF, 0x00002000); // SETVOL dry and wet
+
+    for (uint32_t frame = 0; frame < FRAMES; ++frame)
+    {
+        const uint32_t init = frame == 0 ? A_INIT : 0;
+
+        cmd(a, 0x02, 0x5C0, 0x5C0); // CLEARBUFF
+
+        for (uint32_t voice = 0; voice < 2; ++voice)
+        {
+            const uint32_t state = STATE_ADDR + voice * 0x100;
+            const uint32_t samples = SAMPLES_ADDR + (voice * FRAMES + frame) * 0x90;
+
+            cmd(a, 0x08, 0xB80, 0x0000 << 16 | 0xA8);                           // SETBUFF
+            cmd(a, 0x04, 0, samples);                                           // LOADBUFF
+            cmd(a, 0x08, 0xB80, 0xC00 << 16 | 0x170);                           // SETBUFF
+            cmd(a, 0x01, (init | voice << 1) << 16, state);                     // ADPCM
+            cmd(a, 0x08, 0xC20, 0xDA0 << 16 | 0x170);                           // SETBUFF
+            cmd(a, 0x05, init << 16 | (0x5000 + voice * 0x1234), state + 0x40); // RESAMPLE
+            cmd(a, 0x08, 0xDA0, 0x5C0 << 16 | 0x170);                           // SETBUFF
+            cmd(a, 0x08, A_AUX << 16 | 0x730, 0x8A0 << 16 | 0xA10);             // SETBUFF aux
+            cmd(a, 0x03, (init | (voice ? A_AUX : 0)) << 16, state + 0x80);     // ENVMIXER
+        }
+
+        cmd(a, 0x0C, 0x4000, 0x8A0 << 16 | 0x5C0);    // MIXER
+        cmd(a, 0x0C, 0xC000, 0xA10 << 16 | 0x730);    // MIXER
+        cmd(a, 0x0A, 0x5C0, 0xF20 << 16 | 0x40);      // DMEMMOVE
+        cmd(a, 0x08, 0, 0xC00 << 16 | 0x170);         // SETBUFF
+        cmd(a, 0x0D, 0, 0x730 << 16 | 0x5C0);         // INTERLEAVE
+        cmd(a, 0x08, 0, 0xC00 << 16 | 0x2E0);         // SETBUFF
+        cmd(a, 0x06, 0, OUTPUT_ADDR + frame * 0x2E0); // SAVEBUFF
+    }
+
+    task.digest = 0x36CC41BA21142E2D;
+    return task;
+}
+
+static audio_task make_abi2_task()
+{
+    audio_task task{"ABI2", ABI2};
+    auto &a = task.alist;
+
+    cmd(a, 0x0B, 0x80, CODEBOOK_ADDR); // LOADADPCM2
+    cmd(a, 0x0F, 0, LOOP_ADDR);        // SETLOOP2
+
+    for (uint32_t frame = 0; frame < FRAMES; ++frame)
+    {
+        const uint32_t init = frame == 0 ? A_INIT : 0;
+
+        cmd(a, 0x02, 0x400, 0x800); // CLEARBUFF2
+
+        for (uint32_t voice = 0; voice < 2; ++voice)
+        {
+            const uint32_t state = STATE_ADDR + voice * 0x100;
+            // The second voice uses the 2-bit encoding, which takes 5 bytes per frame.
+            const uint32_t samples = voice == 0 ? SAMPLES_ADDR + frame * 0x90 : SAMPLES_ADDR + 0x2000 + frame * 0x50;
+            const uint32_t flags = init | (voice ? 0x4 : 0);
+
+            cmd(a, 0x14, 0xA8 << 12 | 0xC00, samples);                          // LOADBUFF2
+            cmd(a, 0x08, 0xC00, 0xD00 << 16 | 0x170);                           // SETBUFF2
+            cmd(a, 0x01, flags << 16, state);                                   // ADPCM2
+            cmd(a, 0x08, 0xD20, 0xE80 << 16 | 0x170);                           // SETBUFF2
+            cmd(a, 0x05, init << 16 | (0x6000 - voice * 0x1000), state + 0x40); // RESAMPLE2
+            cmd(a, 0x12, 0x40 << 16 | 0x0100, 0x0020 << 16 | 0x0010);           // ENVSETUP1
+            cmd(a, 0x16, 0, 0x6000 << 16 | 0x5000);                             // ENVSETUP2
+            // ENVMIXER2, which takes its buffers in units of 16 bytes.
+            cmd(a, 0x13, 0xE8 << 16 | 0xB8 << 8 | voice * 0x13, 0x40 << 24 | 0x57 << 16 | 0x6E << 8 | 0x85);
+        }
+
+        cmd(a, 0x0C, 0x170 << 12 | 0x5A82, 0x570 << 16 | 0x400);        // MIXER2
+        cmd(a, 0x0E, 0x2 << 20 | 0x8000 << 4 | 0x170, 0x400 << 16);     // HILOGAIN
+        cmd(a, 0x09, 0x01 << 16 | 0x400, 0xF00 << 16);                  // DUPLICATE2
+        cmd(a, 0x0A, 0x400, 0xA00 << 16 | 0x80);                        // DMEMMOVE2
+        cmd(a, 0x11, 0x40, 0x400 << 16 | 0xB00);                        // INTERL2
+        cmd(a, 0x0D, 0x170 << 12 | 0x900, 0x400 << 16 | 0x570);         // INTERLEAVE2
+        cmd(a, 0x04, 0x170 << 12, 0x400 << 16 | 0x570);                 // ADDMIXER
+        cmd(a, 0x15, 0x2E0 << 12 | 0x900, OUTPUT_ADDR + frame * 0x2E0); // SAVEBUFF2
+    }
+
+    task.digest = 0x38C17BD08FD677F4;
+    return task;
+}
+
+static audio_task make_abi3_task()
+{
+    audio_task task{"ABI3", ABI3};
+    auto &a = task.alist;
+
+    cmd(a, 0x0B, 0x80, CODEBOOK_ADDR);                        // LOADADPCM3
+    cmd(a, 0x0F, 0, LOOP_ADDR);                               // SETLOOP3
+    cmd(a, 0x09, 0x00 << 16 | 0x6000, 0x00011000);            // SETVOL3 left target and ramp
+    cmd(a, 0x09, 0x04 << 16 | 0x3000, 0x0000F000);            // SETVOL3 right target and ramp
+    cmd(a, 0x09, 0x06 << 16 | 0x5000, 0x7FFF << 16 | 0x2000); // SETVOL3 left start, dry and wet
+
+    for (uint32_t frame = 0; frame < FRAMES; ++frame)
+    {
+        const uint32_t init = frame == 0 ? A_INIT : 0;
+
+        // Buffers are relative to 0x4F0, and the mix goes to the fixed buffers at 0x9D0 through 0xF90.
+        cmd(a, 0x02, 0x4E0, 0x5C0); // CLEARBUFF3
+
+        for (uint32_t voice = 0; voice < 2; ++voice)
+        {
+            const uint32_t state = STATE_ADDR + voice * 0x100;
+            const uint32_t samples = SAMPLES_ADDR + (voice * FRAMES + frame) * 0x90;
+
+            cmd(a, 0x04, 0xA8 << 12 | 0x000, samples);                                                    // LOADBUFF3
+            cmd(a, 0x01, state, (init | voice << 1) << 28 | 0x170 << 16 | 0x0 << 12 | 0x300);             // ADPCM3
+            cmd(a, 0x05, state + 0x40, init << 30 | (0x5000 + voice * 0x800) << 14 | 0x320 << 2 | voice); // RESAMPLE3
+            cmd(a, 0x03, (init | A_AUX) << 16 | (voice ? 0x4000 : 0x7000), state + 0x80);                 // ENVMIXER3
+        }
+
+        cmd(a, 0x0C, 0x4000, (0xB40 - 0x4F0) << 16 | (0x9D0 - 0x4F0));  // MIXER3
+        cmd(a, 0x0A, 0x9D0 - 0x4F0, (0xF20 - 0x4F0) << 16 | 0x40);      // DMEMMOVE3
+        cmd(a, 0x0D, 0, 0);                                             // INTERLEAVE3
+        cmd(a, 0x06, 0x2E0 << 12 | 0x000, OUTPUT_ADDR + frame * 0x2E0); // SAVEBUFF3
+    }
+
+    task.digest = 0x56A05096103758F4;
+    return task;
+}
+
+static audio_task make_mp3_task()
+{
+    audio_task task{"MP3", ABI3};
+    auto &a = task.alist;
+
+    for (uint32_t frame = 0; frame < FRAMES; ++frame)
+    {
+        cmd(a, 0x08, 0, 0);                                         // MP3ADDY
+        cmd(a, 0x07, (frame * 6) & 0x1E, MP3_ADDR + frame * 0x488); // MP3
+    }
+
+    task.digest = 0x37F9B9C0F1D9398A;
+    return task;
+}
+
+static std::vector<audio_task> make_tasks()
+{
+    return {make_abi1_task(), make_abi2_task(), make_abi3_task(), make_mp3_task()};
+}
+
+/**
+ * \brief Computes the digest of the memory the microcodes write to.
+ */
+static uint64_t digest_outputs(const std::vector<uint8_t> &rdram)
+{
+    HashUtils::xxh64_state state;
+    state.update(rdram.data(), rdram.size());
+    state.update(BufferSpace, sizeof(BufferSpace));
+    return state.digest();
+}
+
+/**
+ * \brief Replays a task from a clean state and returns the digest of its outputs.
+ */
+static uint64_t replay(const audio_task &task)
+{
+    auto rdram = make_rdram();
+    hle_reset();
+    rsp.rdram = rdram.data();
+
+    hle_run_alist(task.abi, task.alist.data(), task.alist.size());
+
+    return digest_outputs(rdram);
+}
+
+#pragma endregion
+
+#pragma region Golden Outputs
+
+TEST_CASE("audio_tasks_match_golden_outputs", "HLE")
+{
+    for (const auto &task : make_tasks())
+    {
+        INFO(task.name);
+        REQUIRE(replay(task) == task.digest);
+    }
+}
+
+TEST_CASE("audio_tasks_replay_deterministically", "HLE")
+{
+    // A replay mustn't depend on anything a previous task left behind.
+    const auto tasks = make_tasks();
+    for (const auto &task : tasks)
+    {
+        const auto first = replay(task);
+        for (const auto &other : tasks)
+        {
+            replay(other);
+        }
+        REQUIRE(replay(task) == first);
+    }
+}
+
+TEST_CASE("jpg_uncompress_matches_golden_output", "HLE")
+{
+    auto rdram = make_rdram();
+    hle_reset();
+    rsp.rdram = rdram.data();
+    uint32_t sp_status = 0;
+    rsp.sp_status_reg = &sp_status;
+
+    // Two 16x16 blocks with 4:2:0 chroma, the layout Zelda's file select pictures use.
+    const uint32_t jpg_data[] = {JPEG_ADDR + 0x800, 2, 2, JPEG_ADDR + 0x100, JPEG_ADDR + 0x180, JPEG_ADDR + 0x200};
+    memcpy(rdram.data() + JPEG_ADDR, jpg_data, sizeof(jpg_data));
+
+    OSTask_t task{};
+    task.type = 4;
+    task.ucode_data = JPEG_ADDR + 0x400;
+    task.data_ptr = JPEG_ADDR;
+    task.data_size = sizeof(jpg_data);
+
+    jpg_uncompress(&task);
+
+    REQUIRE(digest_outputs(rdram) == 0xFBC487D791B882C2);
+}
+
+#pragma endregion
+
+#pragma region Benchmarks
+
+/**
+ * \brief Replays a task repeatedly and prints the average time each command type takes.
+ */
+static void profile_commands(const audio_task &task, const size_t iterations)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto rdram = make_rdram();
+    hle_reset();
+    rsp.rdram = rdram.data();
+
+    std::array<clock::duration, 0x20> time{};
+    std::array<size_t, 0x20> calls{};
+
+    for (size_t n = 0; n < iterations; ++n)
+    {
+        for (size_t i = 0; i + 1 < task.alist.size(); i += 2)
+        {
+            const uint32_t op = task.alist[i] >> 24;
+
+            const auto start = clock::now();
+            hle_run_alist(task.abi, task.alist.data() + i, 2);
+            time[op] += clock::now() - start;
+            calls[op]++;
+        }
+    }
+
+    printf("%s\n", task.name);
+    for (size_t op = 0; op < time.size(); ++op)
+    {
+        if (calls[op] == 0)
+        {
+            continue;
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time[op]).count();
+        printf("  command %02zX: %10.1f ns/call (%zu calls)\n", op, (double)ns / calls[op], calls[op]);
+    }
+}
+
+TEST_CASE("ucode_benchmarks", "[.][benchmark]")
+{
+    // Hidden from regular runs, use `RSP.HLE.Tests [benchmark]` to run it.
+    for (const auto &task : make_tasks())
+    {
+        profile_commands(task, 1000);
+    }
+
+    for (const auto &task : make_tasks())
+    {
+        auto rdram = make_rdram();
+        rsp.rdram = rdram.data();
+
+        BENCHMARK(std::format("{} task", task.name))
+        {
+            hle_run_alist(task.abi, task.alist.data(), task.alist.size());
+            return BufferSpace[0];
+        };
+    }
+}
+
+#pragma endregion